@@ -27,9 +27,192 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
+#include <semaphore.h>
+#include <sched.h>
+#ifdef CONFIG_EXAMPLES_HEAP_PERFORMANCE_TEST_LATENCY
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <tinyara/timer.h>
+#endif
 
 #define NUM_ALLOC 100
 
+#if CONFIG_EXAMPLES_HEAP_PERFORMANCE_TEST_NTASKS > 0
+static sem_t g_contention_done;
+static int g_contention_repeat;
+
+/* Each task repeats a cycle of small allocations and releases, so that the
+ * tasks keep contending for the heap.
+ */
+
+static int heap_contention_task(int argc, char *argv[])
+{
+	char *data[NUM_ALLOC];
+	int sizes[4] = {16, 32, 64, 128};
+	int i;
+	int j;
+
+	for (i = 0; i < g_contention_repeat; ++i) {
+		for (j = 0; j < NUM_ALLOC; ++j) {
+			data[j] = (char *)malloc(sizes[j % 4]);
+		}
+		for (j = 0; j < NUM_ALLOC; ++j) {
+			free(data[j]);
+		}
+	}
+
+	sem_post(&g_contention_done);
+	return 0;
+}
+
+static void heap_contention_test(int repeat)
+{
+	struct timespec ts1, ts2;
+	uint32_t elapsed;
+	int ntasks = 0;
+	int i;
+
+	g_contention_repeat = repeat;
+	sem_init(&g_contention_done, 0, 0);
+
+	if (clock_gettime(CLOCK_REALTIME, &ts1) == -1) {
+		printf("gettime error occured.\n");
+		return;
+	}
+
+	for (i = 0; i < CONFIG_EXAMPLES_HEAP_PERFORMANCE_TEST_NTASKS; ++i) {
+		if (task_create("heap contention", 100, 2048, heap_contention_task, NULL) > 0) {
+			ntasks++;
+		}
+	}
+
+	for (i = 0; i < ntasks; ++i) {
+		while (sem_wait(&g_contention_done) != 0) ;
+	}
+
+	if (clock_gettime(CLOCK_REALTIME, &ts2) == -1) {
+		printf("gettime error occured.\n");
+		return;
+	}
+
+	sem_destroy(&g_contention_done);
+
+	elapsed = ((ts2.tv_sec - ts1.tv_sec) * 1000 + (ts2.tv_nsec - ts1.tv_nsec) / 1000000);
+	printf("\n%d tasks doing a cycle of malloc() and free() of 16 ~ 128 bytes %u times each:\n", ntasks, NUM_ALLOC * repeat);
+	printf("Total elapsed time : %u mseconds\n", elapsed);
+}
+#endif
+
+#ifdef CONFIG_EXAMPLES_HEAP_PERFORMANCE_TEST_LATENCY
+#define NUM_FRAG_ALLOC 400
+#define NUM_LATENCY_TRY 2000
+#define MAX_FRAG_SIZE 2048
+
+static uint32_t heap_latency_now(int fd)
+{
+	struct timer_status_s status;
+
+	if (ioctl(fd, TCIOC_GETSTATUS, (unsigned long)(uintptr_t)&status) < 0) {
+		return 0;
+	}
+
+	return status.timeleft;
+}
+
+/* Fragment the heap by releasing every other block of random sizes, then
+ * time each allocation and release separately.  The cost of reading the
+ * timer is measured first and subtracted from every sample.
+ */
+
+static void heap_latency_test(void)
+{
+	char *frag[NUM_FRAG_ALLOC];
+	uint32_t before;
+	uint32_t elapsed;
+	uint32_t overhead = UINT32_MAX;
+	uint32_t max_alloc = 0;
+	uint32_t max_free = 0;
+	uint64_t sum_alloc = 0;
+	uint64_t sum_free = 0;
+	int nalloc = 0;
+	char *data;
+	int fd;
+	int i;
+
+	fd = open(CONFIG_EXAMPLES_HEAP_PERFORMANCE_TEST_FRT_DEVNAME, O_RDONLY);
+	if (fd < 0) {
+		printf("Failed to open %s\n", CONFIG_EXAMPLES_HEAP_PERFORMANCE_TEST_FRT_DEVNAME);
+		return;
+	}
+
+	if (ioctl(fd, TCIOC_SETFREERUN, TRUE) < 0 || ioctl(fd, TCIOC_START, TRUE) < 0) {
+		printf("Failed to start the free-run timer\n");
+		close(fd);
+		return;
+	}
+
+	for (i = 0; i < 100; i++) {
+		before = heap_latency_now(fd);
+		elapsed = heap_latency_now(fd) - before;
+		if (elapsed < overhead) {
+			overhead = elapsed;
+		}
+	}
+
+	srand(1);
+	for (i = 0; i < NUM_FRAG_ALLOC; i++) {
+		frag[i] = (char *)malloc(rand() % MAX_FRAG_SIZE + 1);
+	}
+
+	for (i = 0; i < NUM_FRAG_ALLOC; i += 2) {
+		free(frag[i]);
+		frag[i] = NULL;
+	}
+
+	for (i = 0; i < NUM_LATENCY_TRY; i++) {
+		size_t size = rand() % MAX_FRAG_SIZE + 1;
+
+		before = heap_latency_now(fd);
+		data = (char *)malloc(size);
+		elapsed = heap_latency_now(fd) - before - overhead;
+		if (data == NULL) {
+			continue;
+		}
+
+		nalloc++;
+		sum_alloc += elapsed;
+		if (elapsed > max_alloc) {
+			max_alloc = elapsed;
+		}
+
+		before = heap_latency_now(fd);
+		free(data);
+		elapsed = heap_latency_now(fd) - before - overhead;
+		sum_free += elapsed;
+		if (elapsed > max_free) {
+			max_free = elapsed;
+		}
+	}
+
+	for (i = 1; i < NUM_FRAG_ALLOC; i += 2) {
+		free(frag[i]);
+	}
+
+	ioctl(fd, TCIOC_STOP, 0);
+	close(fd);
+
+	if (nalloc == 0) {
+		printf("Latency test failed due to malloc failure.\n");
+		return;
+	}
+
+	printf("\nLatency on a fragmented heap, %d samples of 1 ~ %d bytes:\n", nalloc, MAX_FRAG_SIZE);
+	printf("malloc() : worst %u useconds, average %u useconds\n", max_alloc, (uint32_t)(sum_alloc / nalloc));
+	printf("free()   : worst %u useconds, average %u useconds\n", max_free, (uint32_t)(sum_free / nalloc));
+}
+#endif
+
 static int heap_performance_test(int argc, char *argv[])
 {
 	struct timespec ts1, ts2;
@@ -105,6 +288,13 @@ static int heap_performance_test(int argc, char *argv[])
 
 	printf("Total elapsed time : %u mseconds\n", total_elapsed);
 
+#if CONFIG_EXAMPLES_HEAP_PERFORMANCE_TEST_NTASKS > 0
+	heap_contention_test(repeat);
+#endif
+#ifdef CONFIG_EXAMPLES_HEAP_PERFORMANCE_TEST_LATENCY
+	heap_latency_test();
+#endif
+
 	return 0;
 }
 
@@ -0,0 +1,171 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <tinyara/config.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <messaging/messaging.h>
+#include "messaging_sample_internal.h"
+
+#define LATENCY_PORT "latency_port"
+#define LATENCY_REPLY "ACK"
+
+#define MSG_PRIO 10
+#define STACKSIZE 2048
+#define SMALL_MSG_SIZE 16
+#define LARGE_MSG_SIZE 1024
+
+extern int fail_cnt;
+
+static int g_latency_loops;
+static int g_latency_msglen;
+
+static uint32_t elapsed_usec(struct timespec *ts1, struct timespec *ts2)
+{
+	return (ts2->tv_sec - ts1->tv_sec) * 1000000 + (ts2->tv_nsec - ts1->tv_nsec) / 1000;
+}
+
+static int latency_recv(int argc, FAR char *argv[])
+{
+	int ret;
+	int loop_idx;
+	msg_recv_buf_t recv_data;
+	msg_send_data_t reply_data;
+
+	recv_data.buf = (char *)malloc(g_latency_msglen);
+	if (recv_data.buf == NULL) {
+		printf("Fail to receive, because out of memory.\n");
+		return ERROR;
+	}
+
+	reply_data.msg = LATENCY_REPLY;
+	reply_data.msglen = sizeof(LATENCY_REPLY);
+
+	/* One more message than measured, for the warm-up send. */
+	for (loop_idx = 0; loop_idx <= g_latency_loops; loop_idx++) {
+		recv_data.buflen = g_latency_msglen;
+		ret = messaging_recv_block(LATENCY_PORT, &recv_data);
+		if (ret != MSG_REPLY_REQUIRED) {
+			printf("Fail to receive with block mode.\n");
+			break;
+		}
+
+		ret = messaging_reply(LATENCY_PORT, recv_data.sender_pid, &reply_data);
+		if (ret != OK) {
+			printf("Fail to reply.\n");
+			break;
+		}
+	}
+
+	(void)messaging_cleanup(LATENCY_PORT);
+	free(recv_data.buf);
+	return OK;
+}
+
+static void sync_latency_run(int loops, int msglen)
+{
+	int ret;
+	int loop_idx;
+	int receiver_pid;
+	char reply_buf[sizeof(LATENCY_REPLY)];
+	struct sched_param param;
+	struct timespec ts1, ts2;
+	uint32_t elapsed;
+	msg_send_data_t send_data;
+	msg_recv_buf_t reply_data;
+
+	send_data.msg = (char *)malloc(msglen);
+	if (send_data.msg == NULL) {
+		fail_cnt++;
+		printf("Fail to sync send message : out of memory.\n");
+		return;
+	}
+	memset(send_data.msg, 'M', msglen);
+	send_data.msglen = msglen;
+	send_data.priority = MSG_PRIO;
+
+	reply_data.buf = reply_buf;
+	reply_data.buflen = sizeof(reply_buf);
+
+	/* The receiver runs at a higher priority, so it is waiting on the port
+	 * again before the sender gets the reply.
+	 */
+	g_latency_loops = loops;
+	g_latency_msglen = msglen;
+	sched_getparam(0, &param);
+	receiver_pid = task_create("latency_recv", param.sched_priority + 1, STACKSIZE, latency_recv, NULL);
+	if (receiver_pid < 0) {
+		fail_cnt++;
+		printf("Fail to create latency_recv task.\n");
+		free(send_data.msg);
+		return;
+	}
+
+	/* The first send creates the reply port of this task. */
+	ret = messaging_send_sync(LATENCY_PORT, &send_data, &reply_data);
+	if (ret != OK) {
+		goto errout;
+	}
+
+	clock_gettime(CLOCK_REALTIME, &ts1);
+	for (loop_idx = 0; loop_idx < loops; loop_idx++) {
+		ret = messaging_send_sync(LATENCY_PORT, &send_data, &reply_data);
+		if (ret != OK) {
+			goto errout;
+		}
+	}
+	clock_gettime(CLOCK_REALTIME, &ts2);
+
+	elapsed = elapsed_usec(&ts1, &ts2);
+	printf("sync send/reply, %4d bytes : %u usec for %d, %u usec each\n", msglen, elapsed, loops, elapsed / loops);
+
+	(void)messaging_cleanup(LATENCY_PORT);
+	free(send_data.msg);
+	return;
+
+errout:
+	fail_cnt++;
+	printf("Fail to sync send message.\n");
+	task_delete(receiver_pid);
+	(void)messaging_cleanup(LATENCY_PORT);
+	free(send_data.msg);
+}
+
+void sync_latency_messaging_sample(int loops)
+{
+	printf("\n--- Start the Sync send/reply latency test. ---\n");
+
+	sync_latency_run(loops, SMALL_MSG_SIZE);
+
+	/* Wait for finishing the receiver task. */
+	sleep(1);
+
+	sync_latency_run(loops, LARGE_MSG_SIZE);
+
+	/* Wait for finishing the receiver task. */
+	sleep(1);
+}
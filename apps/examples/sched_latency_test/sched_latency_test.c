@@ -0,0 +1,435 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/// @file sched_latency_test.c
+
+/// @brief Measure the time to wake up a blocked task while many other tasks are blocked.
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <time.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <mqueue.h>
+#include <signal.h>
+
+#define NBLOCKED       CONFIG_EXAMPLES_SCHED_LATENCY_TEST_NBLOCKED
+#define NREADY         CONFIG_EXAMPLES_SCHED_LATENCY_TEST_NREADY
+#define NLOOPS         CONFIG_EXAMPLES_SCHED_LATENCY_TEST_NLOOPS
+#if !defined(CONFIG_DISABLE_POSIX_TIMERS) && CONFIG_EXAMPLES_SCHED_LATENCY_TEST_NTIMERS > 0
+#define NTIMERS        CONFIG_EXAMPLES_SCHED_LATENCY_TEST_NTIMERS
+#endif
+
+#define TEST_PRIORITY      100
+#define RESPONDER_PRIORITY 110
+#define BLOCKER_PRIORITY   120
+#define READY_PRIORITY     90
+#define TARGET_PRIORITY    50
+#define TEST_STACKSIZE     2048
+#define BLOCKER_STACKSIZE  1024
+
+#define REQ_MQNAME     "sched_lat_req"
+#define IDLE_MQNAME    "sched_lat_idle"
+#define MSGLEN         4
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+static sem_t g_req;
+static sem_t g_ack;
+static sem_t g_exit;
+#if NBLOCKED > 0
+static sem_t g_idle[NBLOCKED];
+#endif
+#ifdef NTIMERS
+static timer_t g_timers[NTIMERS];
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* The background tasks only block, half of them on their own semaphore and
+ * half of them on a shared message queue, until they are released.
+ */
+
+static int blocker_task(int argc, char *argv[])
+{
+	int index = atoi(argv[1]);
+	char msg[MSGLEN];
+	mqd_t mqd;
+
+	if (index & 1) {
+		mqd = mq_open(IDLE_MQNAME, O_RDONLY);
+		if (mqd != (mqd_t)-1) {
+			mq_receive(mqd, msg, MSGLEN, NULL);
+			mq_close(mqd);
+		}
+	} else {
+#if NBLOCKED > 0
+		while (sem_wait(&g_idle[index]) != 0) ;
+#endif
+	}
+
+	sem_post(&g_exit);
+	return 0;
+}
+
+static int blocker_start(void)
+{
+	char arg[12];
+	char *argv[2];
+	int nblocked = 0;
+	int i;
+
+	argv[0] = arg;
+	argv[1] = NULL;
+
+	for (i = 0; i < NBLOCKED; i++) {
+		snprintf(arg, sizeof(arg), "%d", i);
+		if (task_create("sched_lat_blocker", BLOCKER_PRIORITY, BLOCKER_STACKSIZE, blocker_task, argv) > 0) {
+			nblocked++;
+		}
+	}
+
+	return nblocked;
+}
+
+static void blocker_stop(mqd_t idle_mqd, int nblocked)
+{
+	char msg[MSGLEN] = { 0 };
+	int i;
+
+	for (i = 0; i < NBLOCKED; i++) {
+		if (i & 1) {
+			mq_send(idle_mqd, msg, MSGLEN, 0);
+		} else {
+#if NBLOCKED > 0
+			sem_post(&g_idle[i]);
+#endif
+		}
+	}
+
+	for (i = 0; i < nblocked; i++) {
+		while (sem_wait(&g_exit) != 0) ;
+	}
+}
+
+/* The responder runs at a higher priority than the test task, so every
+ * request wakes it up and switches to it at once.
+ */
+
+static int sem_responder(int argc, char *argv[])
+{
+	int i;
+
+	for (i = 0; i < NLOOPS; i++) {
+		while (sem_wait(&g_req) != 0) ;
+		sem_post(&g_ack);
+	}
+
+	return 0;
+}
+
+static int mq_responder(int argc, char *argv[])
+{
+	char msg[MSGLEN];
+	mqd_t mqd;
+	int i;
+
+	mqd = mq_open(REQ_MQNAME, O_RDONLY);
+	if (mqd == (mqd_t)-1) {
+		printf("mq_open failed\n");
+		return 0;
+	}
+
+	for (i = 0; i < NLOOPS; i++) {
+		mq_receive(mqd, msg, MSGLEN, NULL);
+		sem_post(&g_ack);
+	}
+
+	mq_close(mqd);
+	return 0;
+}
+
+static uint32_t elapsed_usec(struct timespec *ts1, struct timespec *ts2)
+{
+	return (ts2->tv_sec - ts1->tv_sec) * 1000000 + (ts2->tv_nsec - ts1->tv_nsec) / 1000;
+}
+
+static void sem_latency_test(int nblocked)
+{
+	struct timespec ts1, ts2;
+	uint32_t elapsed;
+	int i;
+
+	if (task_create("sched_lat_sem", RESPONDER_PRIORITY, TEST_STACKSIZE, sem_responder, NULL) < 0) {
+		printf("task_create failed\n");
+		return;
+	}
+
+	clock_gettime(CLOCK_REALTIME, &ts1);
+	for (i = 0; i < NLOOPS; i++) {
+		sem_post(&g_req);
+		while (sem_wait(&g_ack) != 0) ;
+	}
+	clock_gettime(CLOCK_REALTIME, &ts2);
+
+	elapsed = elapsed_usec(&ts1, &ts2);
+	printf("sem_post() wake-up, %d tasks blocked : %u usec for %d, %u nsec each\n",
+		   nblocked, elapsed, NLOOPS, (uint32_t)((uint64_t)elapsed * 1000 / NLOOPS));
+}
+
+static void mq_latency_test(int nblocked)
+{
+	struct mq_attr attr;
+	struct timespec ts1, ts2;
+	char msg[MSGLEN] = { 0 };
+	uint32_t elapsed;
+	mqd_t mqd;
+	int i;
+
+	attr.mq_maxmsg = 1;
+	attr.mq_msgsize = MSGLEN;
+	attr.mq_flags = 0;
+
+	mqd = mq_open(REQ_MQNAME, O_WRONLY | O_CREAT, 0666, &attr);
+	if (mqd == (mqd_t)-1) {
+		printf("mq_open failed\n");
+		return;
+	}
+
+	if (task_create("sched_lat_mq", RESPONDER_PRIORITY, TEST_STACKSIZE, mq_responder, NULL) < 0) {
+		printf("task_create failed\n");
+		goto errout;
+	}
+
+	clock_gettime(CLOCK_REALTIME, &ts1);
+	for (i = 0; i < NLOOPS; i++) {
+		mq_send(mqd, msg, MSGLEN, 0);
+		while (sem_wait(&g_ack) != 0) ;
+	}
+	clock_gettime(CLOCK_REALTIME, &ts2);
+
+	elapsed = elapsed_usec(&ts1, &ts2);
+	printf("mq_send() wake-up, %d tasks blocked  : %u usec for %d, %u nsec each\n",
+		   nblocked, elapsed, NLOOPS, (uint32_t)((uint64_t)elapsed * 1000 / NLOOPS));
+
+errout:
+	mq_close(mqd);
+	mq_unlink(REQ_MQNAME);
+}
+
+/* The ready-to-run tasks are below the test task, so they only run and
+ * exit once the test task waits for them.
+ */
+
+static int ready_task(int argc, char *argv[])
+{
+	sem_post(&g_exit);
+	return 0;
+}
+
+static void ready_latency_test(int nready)
+{
+	struct sched_param param;
+	struct timespec ts1, ts2;
+	uint32_t elapsed;
+	pid_t target;
+	int ntasks = 0;
+	int i;
+
+	/* The target task stays ready-to-run behind all of the others */
+
+	target = task_create("sched_lat_target", TARGET_PRIORITY, BLOCKER_STACKSIZE, ready_task, NULL);
+	if (target < 0) {
+		printf("task_create failed\n");
+		return;
+	}
+	ntasks++;
+
+	for (i = 0; i < nready; i++) {
+		if (task_create("sched_lat_ready", READY_PRIORITY, BLOCKER_STACKSIZE, ready_task, NULL) > 0) {
+			ntasks++;
+		}
+	}
+
+	clock_gettime(CLOCK_REALTIME, &ts1);
+	for (i = 0; i < NLOOPS; i++) {
+		param.sched_priority = TARGET_PRIORITY + (i & 1);
+		sched_setparam(target, &param);
+	}
+	clock_gettime(CLOCK_REALTIME, &ts2);
+
+	elapsed = elapsed_usec(&ts1, &ts2);
+	printf("sched_setparam() of a ready task, %d tasks ready : %u usec for %d, %u nsec each\n",
+		   ntasks - 1, elapsed, NLOOPS, (uint32_t)((uint64_t)elapsed * 1000 / NLOOPS));
+
+	for (i = 0; i < ntasks; i++) {
+		while (sem_wait(&g_exit) != 0) ;
+	}
+}
+
+#ifdef NTIMERS
+static void timer_latency_test(int narmed)
+{
+	struct sigevent sev;
+	struct itimerspec its;
+	struct itimerspec stop;
+	struct timespec ts1, ts2;
+	uint32_t elapsed;
+	timer_t timer;
+	int ntimers = 0;
+	int i;
+
+	sev.sigev_notify = SIGEV_NONE;
+	sev.sigev_signo = SIGRTMIN;
+	sev.sigev_value.sival_ptr = NULL;
+
+	memset(&its, 0, sizeof(its));
+	memset(&stop, 0, sizeof(stop));
+
+	if (timer_create(CLOCK_REALTIME, &sev, &timer) != OK) {
+		printf("timer_create failed\n");
+		return;
+	}
+
+	/* Arm the background timers with different delays of 10 to 100 secs */
+
+	for (i = 0; i < narmed; i++) {
+		if (timer_create(CLOCK_REALTIME, &sev, &g_timers[ntimers]) != OK) {
+			break;
+		}
+
+		its.it_value.tv_sec = 10 + i % 90;
+		its.it_value.tv_nsec = (i % 1000) * 1000000;
+		timer_settime(g_timers[ntimers], 0, &its, NULL);
+		ntimers++;
+	}
+
+	clock_gettime(CLOCK_REALTIME, &ts1);
+	for (i = 0; i < NLOOPS; i++) {
+		its.it_value.tv_sec = 1 + i % 60;
+		its.it_value.tv_nsec = 0;
+		timer_settime(timer, 0, &its, NULL);
+		timer_settime(timer, 0, &stop, NULL);
+	}
+	clock_gettime(CLOCK_REALTIME, &ts2);
+
+	elapsed = elapsed_usec(&ts1, &ts2);
+	printf("timer_settime() arm and cancel, %d timers armed : %u usec for %d, %u nsec each\n",
+		   ntimers, elapsed, NLOOPS, (uint32_t)((uint64_t)elapsed * 1000 / NLOOPS));
+
+	for (i = 0; i < ntimers; i++) {
+		timer_delete(g_timers[i]);
+	}
+
+	timer_delete(timer);
+}
+#endif
+
+static int sched_latency_test(int argc, char *argv[])
+{
+	struct mq_attr attr;
+	mqd_t idle_mqd;
+	int nblocked;
+	int i;
+
+	sem_init(&g_req, 0, 0);
+	sem_init(&g_ack, 0, 0);
+	sem_init(&g_exit, 0, 0);
+#if NBLOCKED > 0
+	for (i = 0; i < NBLOCKED; i++) {
+		sem_init(&g_idle[i], 0, 0);
+	}
+#endif
+
+	attr.mq_maxmsg = 4;
+	attr.mq_msgsize = MSGLEN;
+	attr.mq_flags = 0;
+
+	idle_mqd = mq_open(IDLE_MQNAME, O_WRONLY | O_CREAT, 0666, &attr);
+	if (idle_mqd == (mqd_t)-1) {
+		printf("mq_open failed\n");
+		return 0;
+	}
+
+	/* Without background tasks */
+
+	sem_latency_test(0);
+	mq_latency_test(0);
+
+	/* With background tasks blocked on other semaphores and a message queue */
+
+	nblocked = blocker_start();
+	sem_latency_test(nblocked);
+	mq_latency_test(nblocked);
+	blocker_stop(idle_mqd, nblocked);
+
+	/* Without and with other tasks ready-to-run */
+
+	ready_latency_test(0);
+	ready_latency_test(NREADY);
+
+#ifdef NTIMERS
+	/* Without and with other timers armed */
+
+	timer_latency_test(0);
+	timer_latency_test(NTIMERS);
+#endif
+
+	mq_close(idle_mqd);
+	mq_unlink(IDLE_MQNAME);
+
+	sem_destroy(&g_req);
+	sem_destroy(&g_ack);
+	sem_destroy(&g_exit);
+#if NBLOCKED > 0
+	for (i = 0; i < NBLOCKED; i++) {
+		sem_destroy(&g_idle[i]);
+	}
+#endif
+
+	return 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int sched_latency_main(int argc, char *argv[])
+#endif
+{
+	printf("Scheduling Latency Test!!\n");
+	task_create("Scheduling latency test", TEST_PRIORITY, TEST_STACKSIZE, sched_latency_test, NULL);
+
+	sleep(1);
+
+	return 0;
+}
@@ -27,6 +27,8 @@
 #include <sys/ioctl.h>
 #include <sys/types.h>
 #include <fcntl.h>
+#include <semaphore.h>
+#include <tinyara/semaphore.h>
 
 #define NUM_LOOPS	1000000
 #define SEC_10	10
@@ -172,6 +174,36 @@ static void syscall_perf_timer_settime(void)
 	measure_performance(timer_settime, 4, timer_id, 0, NULL, NULL);
 }
 
+/*
+ * @fn                   :sem_wait_post
+ * @description          :Take and give back an uncontended semaphore count
+ * @return               :void
+ */
+static void sem_wait_post(sem_t *sem)
+{
+	sem_wait(sem);
+	sem_post(sem);
+}
+
+/*
+ * @fn                   :syscall_perf_sem_wait_post
+ * @description          :Measuring performance for sem_wait and sem_post
+ *                        without contention. Priority inheritance is
+ *                        disabled so that CONFIG_SEM_FASTPATH can apply.
+ * @return               :void
+ */
+static void syscall_perf_sem_wait_post(void)
+{
+	sem_t sem;
+
+	sem_init(&sem, 0, 1);
+	sem_setprotocol(&sem, SEM_PRIO_NONE);
+
+	measure_performance(sem_wait_post, 1, &sem);
+
+	sem_destroy(&sem);
+}
+
 /****************************************************************************
  * Name: Syscall Performance
  ****************************************************************************/
@@ -182,6 +214,7 @@ int syscall_performance_main(void)
 
 	/* System Call 1 */
 	syscall_perf_unsetenv();
+	syscall_perf_sem_wait_post();
 
 	/* System Call 2 */
 	syscall_perf_clock_getres();
@@ -66,6 +66,10 @@
 #include <signal.h>
 #endif
 #include <fcntl.h>
+#ifdef CONFIG_MQ_BUFFER
+#include <sched.h>
+#include <semaphore.h>
+#endif
 #include "tc_internal.h"
 
 /**************************************************************************
@@ -122,6 +126,10 @@ static mqd_t g_timedrecv_mqfd;
 static int enter_notify_handler = 0;
 static int timedsend_check = 0;
 static int timedreceive_check = 0;
+#ifdef CONFIG_MQ_BUFFER
+static sem_t g_mqbuf_sem;
+static volatile int g_mqbuf_nalloc;
+#endif
 /**************************************************************************
 * Private Functions
 **************************************************************************/
@@ -935,6 +943,215 @@ errout:
 }
 
 
+#ifdef CONFIG_MQ_BUFFER
+/**
+* @fn                   :tc_mqueue_mq_bufsend_bufreceive
+* @brief                :Pass a buffer through a message queue by handle
+* @scenario             :Send a buffer with mq_bufsend() and receive the same buffer, payload
+*                        length and priority with mq_bufreceive()
+* API's covered         :mq_bufalloc, mq_bufsend, mq_bufreceive, mq_buffree
+* Preconditions         :none
+* Postconditions        :none
+* @return               :void
+*/
+static void tc_mqueue_mq_bufsend_bufreceive(void)
+{
+	mqd_t mqdes;
+	struct mq_attr attr;
+	void *buf;
+	void *rbuf = NULL;
+	int prio = 0;
+	ssize_t len;
+
+	attr.mq_maxmsg = 2;
+	attr.mq_msgsize = TEST_MSGLEN;
+	attr.mq_flags = 0;
+	mqdes = mq_open("mqbuf", O_CREAT | O_RDWR, 0666, &attr);
+	TC_ASSERT_NEQ("mq_open", mqdes, (mqd_t)ERROR);
+
+	buf = mq_bufalloc(CONFIG_MQ_BUFFER_SIZE);
+	TC_ASSERT_NEQ_CLEANUP("mq_bufalloc", buf, NULL, goto errout);
+	memcpy(buf, TEST_MESSAGE, TEST_MSGLEN);
+
+	/* The payload is not limited by the message size of the queue */
+	TC_ASSERT_EQ_CLEANUP("mq_bufsend", mq_bufsend(mqdes, buf, CONFIG_MQ_BUFFER_SIZE, 3), OK, goto errout_with_buf);
+
+	len = mq_bufreceive(mqdes, &rbuf, &prio);
+	TC_ASSERT_EQ_CLEANUP("mq_bufreceive", len, CONFIG_MQ_BUFFER_SIZE, goto errout);
+	TC_ASSERT_EQ_CLEANUP("mq_bufreceive", rbuf, buf, goto errout_with_rbuf);
+	TC_ASSERT_EQ_CLEANUP("mq_bufreceive", prio, 3, goto errout_with_rbuf);
+	TC_ASSERT_EQ_CLEANUP("mq_bufreceive", strcmp((char *)rbuf, TEST_MESSAGE), 0, goto errout_with_rbuf);
+
+	TC_ASSERT_EQ_CLEANUP("mq_buffree", mq_buffree(rbuf), OK, goto errout);
+
+	/* A buffer which is larger than the pool buffers can not be allocated */
+	buf = mq_bufalloc(CONFIG_MQ_BUFFER_SIZE + 1);
+	TC_ASSERT_EQ_CLEANUP("mq_bufalloc", buf, NULL, goto errout);
+	TC_ASSERT_EQ_CLEANUP("mq_bufalloc", errno, EINVAL, goto errout);
+
+	mq_close(mqdes);
+	mq_unlink("mqbuf");
+	TC_SUCCESS_RESULT();
+	return;
+
+errout_with_rbuf:
+	mq_buffree(rbuf);
+	goto errout;
+errout_with_buf:
+	mq_buffree(buf);
+errout:
+	mq_close(mqdes);
+	mq_unlink("mqbuf");
+}
+
+/**
+* @fn                   :tc_mqueue_mq_bufref_buffree
+* @brief                :Take and drop references to a buffer
+* @scenario             :A buffer with two references stays valid when one is dropped and is
+*                        returned to the pool when the last one is dropped
+* API's covered         :mq_bufalloc, mq_bufref, mq_buffree
+* Preconditions         :none
+* Postconditions        :none
+* @return               :void
+*/
+static void tc_mqueue_mq_bufref_buffree(void)
+{
+	void *buf;
+
+	buf = mq_bufalloc(TEST_MSGLEN);
+	TC_ASSERT_NEQ("mq_bufalloc", buf, NULL);
+
+	TC_ASSERT_EQ_CLEANUP("mq_bufref", mq_bufref(buf), OK, mq_buffree(buf));
+	TC_ASSERT_EQ_CLEANUP("mq_buffree", mq_buffree(buf), OK, mq_buffree(buf));
+
+	/* One reference is left, so the buffer is still held by this task */
+	TC_ASSERT_EQ_CLEANUP("mq_bufref", mq_bufref(buf), OK, mq_buffree(buf));
+	TC_ASSERT_EQ_CLEANUP("mq_buffree", mq_buffree(buf), OK, mq_buffree(buf));
+	TC_ASSERT_EQ("mq_buffree", mq_buffree(buf), OK);
+
+	/* The buffer is back in the pool */
+	TC_ASSERT_EQ("mq_buffree", mq_buffree(buf), ERROR);
+	TC_ASSERT_EQ("mq_bufref", mq_bufref(buf), ERROR);
+	TC_ASSERT_EQ("mq_bufref", mq_bufref(NULL), ERROR);
+	TC_ASSERT_EQ("mq_bufref", errno, EINVAL);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @fn                   :tc_mqueue_mq_bufreceive_ebadmsg
+* @brief                :Mix buffer messages and ordinary messages
+* @scenario             :mq_receive() fails with EBADMSG on a buffer message and mq_bufreceive()
+*                        on an ordinary one, both leaving the message in the queue
+* API's covered         :mq_bufsend, mq_bufreceive, mq_send, mq_receive
+* Preconditions         :none
+* Postconditions        :none
+* @return               :void
+*/
+static void tc_mqueue_mq_bufreceive_ebadmsg(void)
+{
+	mqd_t mqdes;
+	struct mq_attr attr;
+	char msg[TEST_MSGLEN];
+	void *buf;
+	void *rbuf = NULL;
+	int prio;
+
+	attr.mq_maxmsg = 2;
+	attr.mq_msgsize = TEST_MSGLEN;
+	attr.mq_flags = 0;
+	mqdes = mq_open("mqbufbad", O_CREAT | O_RDWR, 0666, &attr);
+	TC_ASSERT_NEQ("mq_open", mqdes, (mqd_t)ERROR);
+
+	buf = mq_bufalloc(TEST_MSGLEN);
+	TC_ASSERT_NEQ_CLEANUP("mq_bufalloc", buf, NULL, goto errout);
+	TC_ASSERT_EQ_CLEANUP("mq_bufsend", mq_bufsend(mqdes, buf, TEST_MSGLEN, 1), OK, mq_buffree(buf); goto errout);
+
+	TC_ASSERT_EQ_CLEANUP("mq_receive", mq_receive(mqdes, msg, TEST_MSGLEN, 0), ERROR, goto errout);
+	TC_ASSERT_EQ_CLEANUP("mq_receive", errno, EBADMSG, goto errout);
+
+	/* The buffer message is still at the head of the queue */
+	TC_ASSERT_EQ_CLEANUP("mq_bufreceive", mq_bufreceive(mqdes, &rbuf, &prio), TEST_MSGLEN, goto errout);
+	TC_ASSERT_EQ_CLEANUP("mq_buffree", mq_buffree(rbuf), OK, goto errout);
+
+	TC_ASSERT_EQ_CLEANUP("mq_send", mq_send(mqdes, TEST_MESSAGE, TEST_MSGLEN, 1), OK, goto errout);
+	TC_ASSERT_EQ_CLEANUP("mq_bufreceive", mq_bufreceive(mqdes, &rbuf, &prio), ERROR, goto errout);
+	TC_ASSERT_EQ_CLEANUP("mq_bufreceive", errno, EBADMSG, goto errout);
+	TC_ASSERT_EQ_CLEANUP("mq_receive", mq_receive(mqdes, msg, TEST_MSGLEN, 0), TEST_MSGLEN, goto errout);
+
+	mq_close(mqdes);
+	mq_unlink("mqbufbad");
+	TC_SUCCESS_RESULT();
+	return;
+
+errout:
+	mq_close(mqdes);
+	mq_unlink("mqbufbad");
+}
+
+static int mqbuf_holder_task(int argc, char *argv[])
+{
+	/* Take every free buffer and exit without dropping them */
+
+	g_mqbuf_nalloc = 0;
+	while (mq_bufalloc(TEST_MSGLEN) != NULL) {
+		g_mqbuf_nalloc++;
+	}
+
+	sem_post(&g_mqbuf_sem);
+	while (1) {
+		sleep(1);
+	}
+
+	return OK;
+}
+
+/**
+* @fn                   :tc_mqueue_mq_bufrecover
+* @brief                :Reclaim the buffers of a deleted task
+* @scenario             :A task takes all buffers of the pool and is deleted, after which
+*                        the same number of buffers can be allocated again
+* API's covered         :mq_bufalloc, mq_buffree
+* Preconditions         :none
+* Postconditions        :none
+* @return               :void
+*/
+static void tc_mqueue_mq_bufrecover(void)
+{
+	void *bufs[CONFIG_MQ_BUFFER_NBUFS];
+	pid_t pid;
+	int nbufs;
+	int i;
+
+	sem_init(&g_mqbuf_sem, 0, 0);
+
+	pid = task_create("mqbuf_holder", SCHED_PRIORITY_DEFAULT, STACKSIZE, mqbuf_holder_task, NULL);
+	TC_ASSERT_GT_CLEANUP("task_create", pid, 0, sem_destroy(&g_mqbuf_sem));
+
+	sem_wait(&g_mqbuf_sem);
+	sem_destroy(&g_mqbuf_sem);
+	TC_ASSERT_GT_CLEANUP("mq_bufalloc", g_mqbuf_nalloc, 0, task_delete(pid));
+
+	/* The pool is empty until the holder is gone */
+	bufs[0] = mq_bufalloc(TEST_MSGLEN);
+	TC_ASSERT_EQ_CLEANUP("mq_bufalloc", bufs[0], NULL, mq_buffree(bufs[0]); task_delete(pid));
+	TC_ASSERT_EQ("task_delete", task_delete(pid), OK);
+
+	for (nbufs = 0; nbufs < g_mqbuf_nalloc; nbufs++) {
+		bufs[nbufs] = mq_bufalloc(TEST_MSGLEN);
+		if (bufs[nbufs] == NULL) {
+			break;
+		}
+	}
+	for (i = 0; i < nbufs; i++) {
+		mq_buffree(bufs[i]);
+	}
+	TC_ASSERT_EQ("mq_bufalloc", nbufs, g_mqbuf_nalloc);
+
+	TC_SUCCESS_RESULT();
+}
+#endif
+
 /****************************************************************************
  * Name: mqueue
  ****************************************************************************/
@@ -949,5 +1166,12 @@ int mqueue_main(void)
 	tc_mqueue_mq_getattr();
 	tc_mqueue_mq_setattr();
 
+#ifdef CONFIG_MQ_BUFFER
+	tc_mqueue_mq_bufsend_bufreceive();
+	tc_mqueue_mq_bufref_buffree();
+	tc_mqueue_mq_bufreceive_ebadmsg();
+	tc_mqueue_mq_bufrecover();
+#endif
+
 	return 0;
 }
@@ -440,6 +440,142 @@ static void utc_arastorage_db_query_p(void)
 	TC_SUCCESS_RESULT();
 }
 
+/**
+* @testcase         utc_arastorage_db_query_stream_p
+* @brief            Query a database as a stream
+* @scenario         Select data with and without streaming and compare the number of rows
+* @apicovered       db_query_stream, cursor_move_first, cursor_move_next, cursor_move_prev
+* @precondition     utc_arastorage_db_exec_p should be passed
+* @postcondition    none
+*/
+static void utc_arastorage_db_query_stream_p(void)
+{
+	db_result_t res;
+	db_cursor_t *cursor;
+	cursor_row_t count;
+	cursor_row_t rows;
+	char query[QUERY_LENGTH];
+
+	snprintf(query, QUERY_LENGTH, "SELECT id, date FROM %s WHERE id < 25 AND id > 10;", RELATION_NAME2);
+	cursor = db_query(query);
+	TC_ASSERT_NEQ("db_query", cursor, NULL);
+	count = cursor_get_count(cursor);
+	res = db_cursor_free(cursor);
+	TC_ASSERT_EQ("db_cursor_free", DB_SUCCESS(res), true);
+
+	g_cursor = db_query_stream(query);
+	TC_ASSERT_NEQ("db_query_stream", g_cursor, NULL);
+	TC_ASSERT_EQ_CLEANUP("cursor_get_count", cursor_get_count(g_cursor), INVALID_CURSOR_VALUE, db_cursor_free(g_cursor));
+
+	rows = 0;
+	if (DB_SUCCESS(cursor_move_first(g_cursor))) {
+		do {
+			TC_ASSERT_EQ_CLEANUP("cursor_get_row", cursor_get_row(g_cursor), rows, db_cursor_free(g_cursor));
+			rows++;
+		} while (DB_SUCCESS(cursor_move_next(g_cursor)));
+	}
+	TC_ASSERT_EQ_CLEANUP("db_query_stream", rows, count, db_cursor_free(g_cursor));
+
+	/* Streaming cursor moves forward only */
+	res = cursor_move_prev(g_cursor);
+	TC_ASSERT_EQ_CLEANUP("cursor_move_prev", DB_SUCCESS(res), false, db_cursor_free(g_cursor));
+
+	res = db_cursor_free(g_cursor);
+	g_cursor = NULL;
+	TC_ASSERT_EQ("db_cursor_free", DB_SUCCESS(res), true);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @testcase         utc_arastorage_db_query_range_p
+* @brief            Query a range of keys over bplus-tree index
+* @scenario         Select a range of dates through the index and compare the number of rows
+*                   with a streaming query which scans the relation
+* @apicovered       db_query, db_query_stream
+* @precondition     utc_arastorage_db_exec_p should be passed
+* @postcondition    none
+*/
+static void utc_arastorage_db_query_range_p(void)
+{
+	db_result_t res;
+	db_cursor_t *cursor;
+	cursor_row_t count;
+	cursor_row_t rows;
+	char query[QUERY_LENGTH];
+
+	snprintf(query, QUERY_LENGTH, "SELECT id, date FROM %s WHERE date >= 2000 AND date <= 5000;", RELATION_NAME2);
+	cursor = db_query(query);
+	TC_ASSERT_NEQ("db_query", cursor, NULL);
+	count = cursor_get_count(cursor);
+	if (count == INVALID_CURSOR_VALUE) {
+		count = 0;
+	}
+	res = db_cursor_free(cursor);
+	TC_ASSERT_EQ("db_cursor_free", DB_SUCCESS(res), true);
+
+	g_cursor = db_query_stream(query);
+	TC_ASSERT_NEQ("db_query_stream", g_cursor, NULL);
+
+	rows = 0;
+	if (DB_SUCCESS(cursor_move_first(g_cursor))) {
+		do {
+			rows++;
+		} while (DB_SUCCESS(cursor_move_next(g_cursor)));
+	}
+	res = db_cursor_free(g_cursor);
+	g_cursor = NULL;
+	TC_ASSERT_EQ("db_cursor_free", DB_SUCCESS(res), true);
+	TC_ASSERT_EQ("db_query", count, rows);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @testcase         utc_arastorage_db_get_cache_stats_p
+* @brief            Get the cache statistics of the loaded indexes
+* @scenario         Select a range of dates through the bplus-tree index, then get the statistics
+* @apicovered       db_get_cache_stats
+* @precondition     utc_arastorage_db_exec_p should be passed
+* @postcondition    none
+*/
+static void utc_arastorage_db_get_cache_stats_p(void)
+{
+	db_result_t res;
+	db_cache_stats_t stats;
+	char query[QUERY_LENGTH];
+
+	snprintf(query, QUERY_LENGTH, "SELECT id, date FROM %s WHERE date >= 2000 AND date <= 5000;", RELATION_NAME2);
+	g_cursor = db_query(query);
+	TC_ASSERT_NEQ("db_query", g_cursor, NULL);
+	res = db_cursor_free(g_cursor);
+	g_cursor = NULL;
+	TC_ASSERT_EQ("db_cursor_free", DB_SUCCESS(res), true);
+
+	res = db_get_cache_stats(&stats);
+	TC_ASSERT_EQ("db_get_cache_stats", DB_SUCCESS(res), true);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @testcase         utc_arastorage_db_get_cache_stats_n
+* @brief            Get the cache statistics with invalid argument
+* @scenario         Pass NULL as the statistics
+* @apicovered       db_get_cache_stats
+* @precondition     none
+* @postcondition    none
+*/
+static void utc_arastorage_db_get_cache_stats_n(void)
+{
+	db_result_t res;
+
+	res = db_get_cache_stats(NULL);
+	TC_ASSERT_EQ("db_get_cache_stats", DB_ERROR(res), true);
+
+	TC_SUCCESS_RESULT();
+}
+
 /**
 * @testcase         utc_arastorage_db_query_n
 * @brief            Query a database with invalid argument
@@ -464,6 +600,233 @@ static void utc_arastorage_db_query_n(void)
 	TC_SUCCESS_RESULT();
 }
 
+/**
+* @testcase         utc_arastorage_db_query_stream_n
+* @brief            Query a database as a stream with invalid argument
+* @scenario         Stream aggregation, data from invalid relation and NULL query
+* @apicovered       db_query_stream
+* @precondition     none
+* @postcondition    none
+*/
+static void utc_arastorage_db_query_stream_n(void)
+{
+	char query[QUERY_LENGTH];
+	char *name = "BAD_RELATION";
+
+	snprintf(query, QUERY_LENGTH, "SELECT COUNT(id) FROM %s;", RELATION_NAME2);
+	g_cursor = db_query_stream(query);
+	TC_ASSERT_EQ("db_query_stream", g_cursor, NULL);
+
+	snprintf(query, QUERY_LENGTH, "SELECT %s, %s FROM %s;", g_attribute_set[0], g_attribute_set[1], name);
+	g_cursor = db_query_stream(query);
+	TC_ASSERT_EQ("db_query_stream", g_cursor, NULL);
+
+	g_cursor = db_query_stream(NULL);
+	TC_ASSERT_EQ("db_query_stream", g_cursor, NULL);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @testcase         utc_arastorage_db_prepare_p
+* @brief            Execute prepared statements with parameters
+* @scenario         Insert tuples and select them again with prepared statements
+* @apicovered       db_prepare, db_bind_int, db_bind_long, db_stmt_exec, db_stmt_query, db_stmt_get_stats, db_finalize
+* @precondition     none
+* @postcondition    none
+*/
+static void utc_arastorage_db_prepare_p(void)
+{
+	db_result_t res;
+	db_stmt_t *stmt;
+	db_stmt_stats_t stats;
+	char query[QUERY_LENGTH];
+	int i;
+
+	snprintf(query, QUERY_LENGTH, "INSERT (?, ?) INTO %s;", RELATION_NAME2);
+	stmt = db_prepare(query);
+	TC_ASSERT_NEQ("db_prepare", stmt, NULL);
+
+	for (i = 0; i < DATA_SET_NUM; i++) {
+		res = db_bind_int(stmt, 0, DATA_SET_NUM * 10 + i);
+		TC_ASSERT_EQ_CLEANUP("db_bind_int", DB_SUCCESS(res), true, db_finalize(stmt));
+		res = db_bind_long(stmt, 1, g_arastorage_data_set[i].long_value);
+		TC_ASSERT_EQ_CLEANUP("db_bind_long", DB_SUCCESS(res), true, db_finalize(stmt));
+		res = db_stmt_exec(stmt);
+		TC_ASSERT_EQ_CLEANUP("db_stmt_exec", DB_SUCCESS(res), true, db_finalize(stmt));
+	}
+
+	res = db_stmt_get_stats(stmt, &stats);
+	TC_ASSERT_EQ_CLEANUP("db_stmt_get_stats", DB_SUCCESS(res), true, db_finalize(stmt));
+	TC_ASSERT_EQ_CLEANUP("db_stmt_get_stats", stats.count, DATA_SET_NUM, db_finalize(stmt));
+
+	res = db_finalize(stmt);
+	TC_ASSERT_EQ("db_finalize", DB_SUCCESS(res), true);
+
+	snprintf(query, QUERY_LENGTH, "SELECT id, date FROM %s WHERE id >= ? AND id < ?;", RELATION_NAME2);
+	stmt = db_prepare(query);
+	TC_ASSERT_NEQ("db_prepare", stmt, NULL);
+
+	/* Select the tuples inserted above, then a part of them with the same statement */
+	for (i = DATA_SET_NUM; i > 0; i -= DATA_SET_NUM / 2) {
+		res = db_bind_int(stmt, 0, DATA_SET_NUM * 10);
+		TC_ASSERT_EQ_CLEANUP("db_bind_int", DB_SUCCESS(res), true, db_finalize(stmt));
+		res = db_bind_int(stmt, 1, DATA_SET_NUM * 10 + i);
+		TC_ASSERT_EQ_CLEANUP("db_bind_int", DB_SUCCESS(res), true, db_finalize(stmt));
+
+		g_cursor = db_stmt_query(stmt);
+		TC_ASSERT_NEQ_CLEANUP("db_stmt_query", g_cursor, NULL, db_finalize(stmt));
+		TC_ASSERT_EQ_CLEANUP("cursor_get_count", cursor_get_count(g_cursor), i, (db_cursor_free(g_cursor), db_finalize(stmt)));
+
+		res = db_cursor_free(g_cursor);
+		g_cursor = NULL;
+		TC_ASSERT_EQ_CLEANUP("db_cursor_free", DB_SUCCESS(res), true, db_finalize(stmt));
+	}
+
+	res = db_finalize(stmt);
+	TC_ASSERT_EQ("db_finalize", DB_SUCCESS(res), true);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @testcase         utc_arastorage_db_stmt_add_batch_p
+* @brief            Insert tuples in a batch with a prepared statement
+* @scenario         Add tuples to the batch of a prepared INSERT, insert them and select them again
+* @apicovered       db_prepare, db_bind_int, db_bind_long, db_stmt_add_batch, db_stmt_exec_batch, db_finalize
+* @precondition     none
+* @postcondition    none
+*/
+static void utc_arastorage_db_stmt_add_batch_p(void)
+{
+	db_result_t res;
+	db_stmt_t *stmt;
+	char query[QUERY_LENGTH];
+	int i;
+
+	snprintf(query, QUERY_LENGTH, "INSERT (?, ?) INTO %s;", RELATION_NAME2);
+	stmt = db_prepare(query);
+	TC_ASSERT_NEQ("db_prepare", stmt, NULL);
+
+	for (i = 0; i < DATA_SET_NUM; i++) {
+		res = db_bind_int(stmt, 0, DATA_SET_NUM * 20 + i);
+		TC_ASSERT_EQ_CLEANUP("db_bind_int", DB_SUCCESS(res), true, db_finalize(stmt));
+		res = db_bind_long(stmt, 1, g_arastorage_data_set[DATA_SET_NUM - 1 - i].long_value);
+		TC_ASSERT_EQ_CLEANUP("db_bind_long", DB_SUCCESS(res), true, db_finalize(stmt));
+		res = db_stmt_add_batch(stmt);
+		TC_ASSERT_EQ_CLEANUP("db_stmt_add_batch", DB_SUCCESS(res), true, db_finalize(stmt));
+	}
+
+	res = db_stmt_exec_batch(stmt);
+	TC_ASSERT_EQ_CLEANUP("db_stmt_exec_batch", DB_SUCCESS(res), true, db_finalize(stmt));
+
+	res = db_finalize(stmt);
+	TC_ASSERT_EQ("db_finalize", DB_SUCCESS(res), true);
+
+	snprintf(query, QUERY_LENGTH, "SELECT id, date FROM %s WHERE id >= %d;", RELATION_NAME2, DATA_SET_NUM * 20);
+	g_cursor = db_query(query);
+	TC_ASSERT_NEQ("db_query", g_cursor, NULL);
+	TC_ASSERT_EQ_CLEANUP("cursor_get_count", cursor_get_count(g_cursor), DATA_SET_NUM, db_cursor_free(g_cursor));
+
+	res = db_cursor_free(g_cursor);
+	g_cursor = NULL;
+	TC_ASSERT_EQ("db_cursor_free", DB_SUCCESS(res), true);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @testcase         utc_arastorage_db_prepare_n
+* @brief            Prepare and execute statements with invalid argument
+* @scenario         Prepare NULL, execute a statement with unbound parameters and bind invalid parameters
+* @apicovered       db_prepare, db_bind_int, db_bind_string, db_stmt_exec, db_stmt_query, db_finalize, db_exec
+* @precondition     none
+* @postcondition    none
+*/
+static void utc_arastorage_db_prepare_n(void)
+{
+	db_result_t res;
+	db_stmt_t *stmt;
+	char query[QUERY_LENGTH];
+
+	stmt = db_prepare(NULL);
+	TC_ASSERT_EQ("db_prepare", stmt, NULL);
+
+	snprintf(query, QUERY_LENGTH, "SELECT id FROM %s WHERE id > ?;", RELATION_NAME2);
+	stmt = db_prepare(query);
+	TC_ASSERT_NEQ("db_prepare", stmt, NULL);
+
+	g_cursor = db_stmt_query(stmt);
+	TC_ASSERT_EQ_CLEANUP("db_stmt_query", g_cursor, NULL, db_finalize(stmt));
+
+	res = db_bind_int(stmt, 1, 0);
+	TC_ASSERT_EQ_CLEANUP("db_bind_int", DB_ERROR(res), true, db_finalize(stmt));
+
+	res = db_bind_string(stmt, 0, "apple");
+	TC_ASSERT_EQ_CLEANUP("db_bind_string", DB_ERROR(res), true, db_finalize(stmt));
+
+	res = db_stmt_exec(stmt);
+	TC_ASSERT_EQ_CLEANUP("db_stmt_exec", DB_ERROR(res), true, db_finalize(stmt));
+
+	res = db_finalize(stmt);
+	TC_ASSERT_EQ("db_finalize", DB_SUCCESS(res), true);
+
+	res = db_finalize(NULL);
+	TC_ASSERT_EQ("db_finalize", DB_ERROR(res), true);
+
+	snprintf(query, QUERY_LENGTH, "INSERT (?, ?) INTO %s;", RELATION_NAME2);
+	res = db_exec(query);
+	TC_ASSERT_EQ("db_exec", DB_ERROR(res), true);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @testcase         utc_arastorage_db_stmt_add_batch_n
+* @brief            Add tuples to the batch of statements with invalid argument
+* @scenario         Add a tuple with unbound parameters and add the tuple of a query statement
+* @apicovered       db_prepare, db_stmt_add_batch, db_stmt_exec_batch, db_finalize
+* @precondition     none
+* @postcondition    none
+*/
+static void utc_arastorage_db_stmt_add_batch_n(void)
+{
+	db_result_t res;
+	db_stmt_t *stmt;
+	char query[QUERY_LENGTH];
+
+	res = db_stmt_add_batch(NULL);
+	TC_ASSERT_EQ("db_stmt_add_batch", DB_ERROR(res), true);
+
+	res = db_stmt_exec_batch(NULL);
+	TC_ASSERT_EQ("db_stmt_exec_batch", DB_ERROR(res), true);
+
+	snprintf(query, QUERY_LENGTH, "INSERT (?, ?) INTO %s;", RELATION_NAME2);
+	stmt = db_prepare(query);
+	TC_ASSERT_NEQ("db_prepare", stmt, NULL);
+
+	res = db_stmt_add_batch(stmt);
+	TC_ASSERT_EQ_CLEANUP("db_stmt_add_batch", DB_ERROR(res), true, db_finalize(stmt));
+
+	res = db_finalize(stmt);
+	TC_ASSERT_EQ("db_finalize", DB_SUCCESS(res), true);
+
+	snprintf(query, QUERY_LENGTH, "SELECT id FROM %s;", RELATION_NAME2);
+	stmt = db_prepare(query);
+	TC_ASSERT_NEQ("db_prepare", stmt, NULL);
+
+	res = db_stmt_add_batch(stmt);
+	TC_ASSERT_EQ_CLEANUP("db_stmt_add_batch", DB_ERROR(res), true, db_finalize(stmt));
+
+	res = db_stmt_exec_batch(stmt);
+	TC_ASSERT_EQ_CLEANUP("db_stmt_exec_batch", DB_ERROR(res), true, db_finalize(stmt));
+
+	res = db_finalize(stmt);
+	TC_ASSERT_EQ("db_finalize", DB_SUCCESS(res), true);
+
+	TC_SUCCESS_RESULT();
+}
+
 /**
 * @testcase         utc_arastorage_db_get_result_message_p
 * @brief            Get database result message
@@ -1526,6 +1889,11 @@ int utc_arastorage_main(int argc, char *argv[])
 	/* Positive TCs */
 	utc_arastorage_db_init_p();
 	utc_arastorage_db_exec_p();
+	utc_arastorage_db_prepare_p();
+	utc_arastorage_db_stmt_add_batch_p();
+	utc_arastorage_db_query_stream_p();
+	utc_arastorage_db_query_range_p();
+	utc_arastorage_db_get_cache_stats_p();
 	utc_arastorage_db_query_p();
 	utc_arastorage_db_get_result_message_p();
 	utc_arastorage_db_print_header_p();
@@ -1557,6 +1925,10 @@ int utc_arastorage_main(int argc, char *argv[])
 	/* Negative TCs */
 	utc_arastorage_db_exec_n();
 	utc_arastorage_db_query_n();
+	utc_arastorage_db_query_stream_n();
+	utc_arastorage_db_get_cache_stats_n();
+	utc_arastorage_db_prepare_n();
+	utc_arastorage_db_stmt_add_batch_n();
 	utc_arastorage_db_get_result_message_n();
 	utc_arastorage_db_print_header_n();
 	utc_arastorage_db_print_tuple_n();
@@ -205,7 +205,12 @@ int utils_heapinfo(int argc, char **args)
 	bool init_flag = false;
 	heapinfo_option_t options;
 	options.heap_type = HEAPINFO_HEAP_TYPE_KERNEL;
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
 	options.mode = HEAPINFO_SIMPLE;
+#else
+	/* Without heapinfo, only the sampled allocations can be shown */
+	options.mode = HEAPINFO_SAMPLE;
+#endif
 	options.pid = HEAPINFO_PID_ALL;
 #ifdef CONFIG_BUILD_PROTECTED
 	char *heap_name = "KERNEL";
@@ -215,7 +220,7 @@ int utils_heapinfo(int argc, char **args)
 		goto usage;
 	}
 
-	while ((opt = getopt(argc, args, "ikub:ap:fgr")) != ERROR) {
+	while ((opt = getopt(argc, args, "ikub:ap:fgrs")) != ERROR) {
 		switch (opt) {
 		/* i : initialize the peak allocated memory size. */
 		case 'i':
@@ -269,6 +274,12 @@ int utils_heapinfo(int argc, char **args)
 			goto usage;
 #endif
 			break;
+#ifdef CONFIG_MM_SAMPLING
+		/* s : show the sampled allocations per call site */
+		case 's':
+			options.mode = HEAPINFO_SAMPLE;
+			break;
+#endif
 		case '?':
 		default:
 			printf("Invalid option\n");
@@ -296,6 +307,10 @@ int utils_heapinfo(int argc, char **args)
 	}
 	close(heapinfo_fd);
 
+	if (options.mode == HEAPINFO_SAMPLE) {
+		return OK;
+	}
+
 	if (init_flag == true) {
 #ifdef CONFIG_BUILD_PROTECTED
 		printf("[%s]", heap_name);
@@ -339,5 +354,8 @@ usage:
 	printf(" -r             Show the all region information\n");
 #endif
 	printf(" -i             Initialize the peak allocated size\n");
+#ifdef CONFIG_MM_SAMPLING
+	printf(" -s             Show the sampled allocations per call site\n");
+#endif
 	return ERROR;
 }
@@ -21,6 +21,8 @@
 #include <errno.h>
 #include <getopt.h>
 #include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include <debug.h>
 #include <sys/types.h>
 #include <sys/ioctl.h>
@@ -30,6 +32,11 @@
 
 #define MAX_TAG_NAMESIZE 4
 
+#ifdef CONFIG_TTRACE_EVENTS
+#define TTRACE_STREAM_NRECORDS   8
+#define TTRACE_STREAM_INTERVAL   10000	/* Polling interval of the event ring in microseconds */
+#endif
+
 struct tag_list {
 	const char *name;
 	const char *longname;
@@ -112,6 +119,10 @@ static void show_help()
 	printf("    -i     Show information(state, available/selected/TP used tags, bufsize)\r\n");
 	printf("    -d     Dump trace buffer, It should be run after finish\r\n");
 	printf("    -p     Print trace buffer, It should be run after finish\r\n");
+#ifdef CONFIG_TTRACE_EVENTS
+	printf("    -e     Stream the binary event ring until tracing is finished,\r\n");
+	printf("           into the file given at tail or to the console\r\n");
+#endif
 }
 
 static int assign_tag(char *name)
@@ -143,10 +154,11 @@ static int parse_args(int argc, char **args)
 	 * -g : TTRACE_FUNC_TAG, TP's tag(hidden to user)
 	 * -d : TTRACE_DUMP, dump mode(hang), It should be run after finish.
 	 * -p : TTRACE_PRINT, print traces, It should be run after finish.
+	 * -e : TTRACE_STREAM, stream the binary event ring.
 	 */
 	while (1) {
 		optarg = NULL;
-		ret = getopt(argc, args, "sofidpb:");
+		ret = getopt(argc, args, "sofidpeb:");
 		if (ret == '?') {
 			show_help();
 			return TTRACE_INVALID;
@@ -255,6 +267,94 @@ static int read_tracebuffer(FILE *file, int bufsize)
 	return TTRACE_VALID;
 }
 
+#ifdef CONFIG_TTRACE_EVENTS
+static void print_event(struct ttrace_event_s *event)
+{
+	/* The name or message comes last, so that it may contain spaces */
+
+	printf("E %u %u %d %u ", event->seq - 1, event->ts, event->pid, event->prio);
+	switch (event->type) {
+	case TTRACE_EVENT_SCHED:
+		printf("s %d %u %u %s\r\n",
+			   event->u.sched.next_pid,
+			   event->u.sched.next_prio,
+			   event->u.sched.prev_state,
+			   event->u.sched.next_comm);
+		break;
+	case TTRACE_EVENT_BEGIN:
+		printf("b %.*s\r\n", TTRACE_EVENT_MSG_BYTES, event->u.message);
+		break;
+	case TTRACE_EVENT_BEGIN_UID:
+		printf("u %d\r\n", event->u.uid);
+		break;
+	default:
+		printf("e\r\n");
+		break;
+	}
+}
+
+static int stream_events(FILE *file, char *path)
+{
+	struct ttrace_event_s events[TTRACE_STREAM_NRECORDS];
+	ssize_t nread;
+	int running;
+	int out = -1;
+	int fd;
+	int i;
+
+	fd = open(CONFIG_TTRACE_EVENTS_DEVPATH, O_RDONLY);
+	if (fd < 0) {
+		printf("Failed to open : %s\r\n", CONFIG_TTRACE_EVENTS_DEVPATH);
+		return TTRACE_INVALID;
+	}
+
+	if (path != NULL) {
+		out = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+		if (out < 0) {
+			printf("Failed to open : %s\r\n", path);
+			close(fd);
+			return TTRACE_INVALID;
+		}
+	}
+
+	/* Stream until tracing is finished and the ring is drained */
+
+	while (1) {
+		running = (run_cmd(file, TTRACE_FUNC_TAG, 0) != 0);
+		nread = read(fd, (char *)events, sizeof(events));
+		if (nread < 0) {
+			break;
+		}
+
+		if (nread == 0) {
+			if (!running) {
+				break;
+			}
+			usleep(TTRACE_STREAM_INTERVAL);
+			continue;
+		}
+
+		if (out >= 0) {
+			if (write(out, events, nread) != nread) {
+				printf("Failed to write : %s\r\n", path);
+				break;
+			}
+		} else {
+			for (i = 0; i < nread / sizeof(struct ttrace_event_s); i++) {
+				print_event(&events[i]);
+			}
+		}
+	}
+
+	if (out >= 0) {
+		close(out);
+	}
+
+	close(fd);
+	return TTRACE_VALID;
+}
+#endif
+
 void wait_ttrace_dump()
 {
 	int i = 0;
@@ -323,6 +423,10 @@ int utils_ttrace(int argc, char **args)
 		printf("3.start tracing at target($ ttrace -s <tags>)\r\n");
 		printf("4.stop tracing and run dumpmode($ ttrace -f; ttrace -d)\r\n");
 		wait_ttrace_dump();
+#ifdef CONFIG_TTRACE_EVENTS
+	} else if (cmd == TTRACE_STREAM) {
+		ret = stream_events(file, (optind < argc) ? args[optind] : NULL);
+#endif
 	} else {
 		ret = send_cmds(file, cmd);
 		if (ret == TTRACE_NODATA) {
@@ -70,6 +70,7 @@
  * Included Files
  ****************************************************************************/
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <float.h>
 
@@ -172,6 +173,31 @@ typedef struct _db_handle_s db_handle_t;
 struct _db_cursor_s;
 typedef struct _db_cursor_s db_cursor_t;
 
+struct _db_stmt_s;
+typedef struct _db_stmt_s db_stmt_t;
+
+/**
+ * @brief Execution statistics of a prepared statement, times in microseconds
+ */
+struct db_stmt_stats_s {
+	uint32_t count;				/* The number of executions */
+	uint32_t last_time;			/* The time of the last execution */
+	uint32_t max_time;			/* The longest time of an execution */
+	uint64_t total_time;		/* The time of all the executions */
+};
+typedef struct db_stmt_stats_s db_stmt_stats_t;
+
+/**
+ * @brief Hit and miss counts of the node and bucket caches of the loaded indexes
+ */
+struct db_cache_stats_s {
+	uint32_t node_hits;			/* Tree node lookups served from the cache */
+	uint32_t node_misses;		/* Tree node lookups read from the storage */
+	uint32_t bucket_hits;		/* Bucket lookups served from the cache */
+	uint32_t bucket_misses;		/* Bucket lookups read from the storage */
+};
+typedef struct db_cache_stats_s db_cache_stats_t;
+
 typedef int db_storage_id_t;
 
 typedef uint32_t cursor_row_t;
@@ -232,6 +258,147 @@ db_result_t db_exec(char *format);
 */
 db_cursor_t *db_query(char *format);
 
+/**
+* @brief process select query of arastorage as a stream
+*
+* @details @b #include <arastorage/arastorage.h>
+* The result is not collected when the query is processed, and so it is not limited by
+* DB_TUPLE_LIMIT. Each cursor_move_first() or cursor_move_next() reads tuples of the relation
+* until the next one that fulfills the condition. The cursor only moves forward, so
+* cursor_move_prev(), cursor_move_last() and cursor_move_to() other than the next row fail,
+* cursor_get_count() returns INVALID_CURSOR_VALUE and cursor_is_last_row() returns false.
+* Aggregation and assignment are not supported. The relation is kept loaded until
+* db_cursor_free() is called.
+* @param[in] format select query sentence
+* @return On success, a pointer to db_cursor_t is returned. On failure, a NULL is returned.
+* @since TizenRT v2.1 PRE
+*/
+db_cursor_t *db_query_stream(char *format);
+
+/**
+* @brief parse a query sentence once, to execute it many times with db_stmt_exec() or db_stmt_query()
+*
+* @details @b #include <arastorage/arastorage.h>
+* The values of INSERT and the operands of WHERE clause may be given as '?' parameters,
+* numbered from 0 in the order they appear, e.g. "SELECT id FROM rel WHERE id > ? AND id < ?;".
+* Every parameter must be bound with db_bind_int(), db_bind_long() or db_bind_string() before
+* the statement is executed, and keeps its value until it is bound again.
+* @param[in] format query sentence
+* @return On success, a pointer to db_stmt_t is returned. On failure, a NULL is returned.
+* @since TizenRT v2.1 PRE
+*/
+db_stmt_t *db_prepare(char *format);
+
+/**
+* @brief bind an int value to a parameter of a prepared statement
+*
+* @details @b #include <arastorage/arastorage.h>
+* @param[in] stmt a pointer to prepared statement
+* @param[in] param_index index of the parameter, starting from 0
+* @param[in] value the value of the parameter
+* @return On success, DB_OK is returned. On failure, a negative value is returned.
+* @since TizenRT v2.1 PRE
+*/
+db_result_t db_bind_int(db_stmt_t *stmt, int param_index, int value);
+
+/**
+* @brief bind a long value to a parameter of a prepared statement
+*
+* @details @b #include <arastorage/arastorage.h>
+* @param[in] stmt a pointer to prepared statement
+* @param[in] param_index index of the parameter, starting from 0
+* @param[in] value the value of the parameter
+* @return On success, DB_OK is returned. On failure, a negative value is returned.
+* @since TizenRT v2.1 PRE
+*/
+db_result_t db_bind_long(db_stmt_t *stmt, int param_index, long value);
+
+/**
+* @brief bind a string value to a parameter of a prepared statement, only for values of INSERT
+*
+* @details @b #include <arastorage/arastorage.h>
+* @param[in] stmt a pointer to prepared statement
+* @param[in] param_index index of the parameter, starting from 0
+* @param[in] value the value of the parameter, it is copied
+* @return On success, DB_OK is returned. On failure, a negative value is returned.
+* @since TizenRT v2.1 PRE
+*/
+db_result_t db_bind_string(db_stmt_t *stmt, int param_index, const char *value);
+
+/**
+* @brief execute a prepared statement which creates or removes relations, attributes and indexes or inserts a tuple
+*
+* @details @b #include <arastorage/arastorage.h>
+* @param[in] stmt a pointer to prepared statement
+* @return On success, DB_OK is returned. On failure, a negative value is returned.
+* @since TizenRT v2.1 PRE
+*/
+db_result_t db_stmt_exec(db_stmt_t *stmt);
+
+/**
+* @brief execute a prepared query statement
+*
+* @details @b #include <arastorage/arastorage.h>
+* @param[in] stmt a pointer to prepared statement
+* @return On success, a pointer to db_cursor_t is returned. On failure, a NULL is returned.
+* @since TizenRT v2.1 PRE
+*/
+db_cursor_t *db_stmt_query(db_stmt_t *stmt);
+
+/**
+* @brief add a tuple with the values bound to a prepared INSERT statement to its batch
+*
+* @details @b #include <arastorage/arastorage.h>
+* The tuples of a batch are inserted together by db_stmt_exec_batch(), which is
+* called automatically when CONFIG_ARASTORAGE_BATCH_SIZE tuples are added.
+* @param[in] stmt a pointer to prepared INSERT statement
+* @return On success, DB_OK is returned. On failure, a negative value is returned.
+* @since TizenRT v2.1 PRE
+*/
+db_result_t db_stmt_add_batch(db_stmt_t *stmt);
+
+/**
+* @brief insert the tuples added to the batch of a prepared INSERT statement
+*
+* @details @b #include <arastorage/arastorage.h>
+* The batch is empty after the call, also on failure.
+* @param[in] stmt a pointer to prepared INSERT statement
+* @return On success, DB_OK is returned. On failure, a negative value is returned.
+* @since TizenRT v2.1 PRE
+*/
+db_result_t db_stmt_exec_batch(db_stmt_t *stmt);
+
+/**
+* @brief get the execution statistics of a prepared statement
+*
+* @details @b #include <arastorage/arastorage.h>
+* @param[in] stmt a pointer to prepared statement
+* @param[out] stats the statistics of the executions so far
+* @return On success, DB_OK is returned. On failure, a negative value is returned.
+* @since TizenRT v2.1 PRE
+*/
+db_result_t db_stmt_get_stats(db_stmt_t *stmt, db_stmt_stats_t *stats);
+
+/**
+* @brief get the cache statistics of the indexes which are loaded
+*
+* @details @b #include <arastorage/arastorage.h>
+* @param[out] stats the hit and miss counts summed over the loaded indexes
+* @return On success, DB_OK is returned. On failure, a negative value is returned.
+* @since TizenRT v2.1 PRE
+*/
+db_result_t db_get_cache_stats(db_cache_stats_t *stats);
+
+/**
+* @brief free a prepared statement
+*
+* @details @b #include <arastorage/arastorage.h>
+* @param[in] stmt a pointer to prepared statement
+* @return On success, DB_OK is returned. On failure, a negative value is returned.
+* @since TizenRT v2.1 PRE
+*/
+db_result_t db_finalize(db_stmt_t *stmt);
+
 /**
 * @brief free allocated cursor data, it should be called before application terminated
 *
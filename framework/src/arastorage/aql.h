@@ -64,6 +64,7 @@
 #include "index.h"
 #include "relation.h"
 #include "result.h"
+#include "lvm.h"
 
 /****************************************************************************
 * Pre-processor Definitions
@@ -126,6 +127,13 @@
 #define AQL_SET_CONDITION(adt, cond)    ((adt)->lvm_instance = (cond))
 #define AQL_ADD_VALUE(adt, domain, value)                               \
 	aql_add_value((adt), (domain), (value))
+#define AQL_ADD_PARAMETER(adt, type)    aql_add_parameter((adt), (type))
+#define AQL_PARAMETER_COUNT(adt)        ((adt)->param_count)
+
+/* A parameter stands either for a value of INSERT or for an operand of
+   the WHERE clause. */
+#define AQL_PARAM_VALUE                 1
+#define AQL_PARAM_OPERAND               2
 
 /****************************************************************************
 * Public Type Definitions
@@ -193,6 +201,7 @@ enum token_e {
 
 	ATTRIBUTE,
 	BPLUSTREE,					/* 48 */
+	PARAMETER,
 
 	INTEGER_VALUE = 251,
 	FLOAT_VALUE = 252,
@@ -233,6 +242,13 @@ struct aql_attribute_s {
 };
 typedef struct aql_attribute_s aql_attribute_t;
 
+struct aql_param_s {
+	uint8_t type;
+	uint8_t index;				/* The value slot of AQL_PARAM_VALUE */
+	lvm_ip_t ip;				/* The operand in the LVM code of AQL_PARAM_OPERAND */
+};
+typedef struct aql_param_s aql_param_t;
+
 struct aql_adt_s {
 	char relations[AQL_RELATION_LIMIT][RELATION_NAME_LENGTH + 1];
 	aql_attribute_t attributes[AQL_ATTRIBUTE_LIMIT];
@@ -245,9 +261,21 @@ struct aql_adt_s {
 	uint32_t optype;
 	uint8_t flags;
 	void *lvm_instance;
+	aql_param_t params[AQL_PARAM_LIMIT];
+	uint8_t param_count;
 };
 typedef struct aql_adt_s aql_adt_t;
 
+/* A prepared statement keeps the result of parsing, including the LVM code
+   of the WHERE clause, to be executed many times with other parameters. */
+struct _db_stmt_s {
+	aql_adt_t adt;
+	uint32_t bound;				/* Bitmap of the parameters bound so far */
+	db_stmt_stats_t stats;
+	attribute_value_t *batch;	/* Values of the tuples added to the batch */
+	uint16_t batch_count;
+};
+
 /****************************************************************************
 * Global Function Prototypes
 ****************************************************************************/
@@ -260,5 +288,10 @@ void aql_add_relation(aql_adt_t *adt, char *rel);
 aql_status_t aql_parse(aql_adt_t *adt, char *query_string);
 db_result_t aql_add_attribute(aql_adt_t *adt, char *name, domain_t domain, unsigned element_size, int processed_only);
 db_result_t aql_add_value(aql_adt_t *adt, domain_t domain, void *value);
+db_result_t aql_add_parameter(aql_adt_t *adt, uint8_t type);
+db_result_t aql_get_parse_result(char *format, aql_adt_t *adt);
+relation_t *aql_get_relation(aql_adt_t *adt);
+db_result_t aql_init_handle(db_handle_t **handle);
+db_result_t aql_deinit_handle(db_handle_t **handle);
 
 #endif							/* !AQL_H */
@@ -85,6 +85,7 @@ void aql_clear(aql_adt_t *adt)
 	adt->attribute_count = 0;
 	adt->value_count = 0;
 	adt->flags = 0;
+	adt->param_count = 0;
 	memset(adt->aggregators, 0, sizeof(adt->aggregators));
 }
 
@@ -146,6 +147,7 @@ db_result_t aql_add_value(aql_adt_t *adt, domain_t domain, void *value_ptr)
 	case DOMAIN_STRING:
 		str_size = strlen((const char *)value_ptr);
 		str = (unsigned char *)malloc(sizeof(char) * str_size + 1);
+		VALUE_STRING(value) = str;
 		if (str != NULL) {
 			memcpy(str, value_ptr, str_size);
 			str[str_size] = '\0';
@@ -160,3 +162,30 @@ db_result_t aql_add_value(aql_adt_t *adt, domain_t domain, void *value_ptr)
 
 	return DB_OK;
 }
+
+db_result_t aql_add_parameter(aql_adt_t *adt, uint8_t type)
+{
+	aql_param_t *param;
+
+	if (adt->param_count == AQL_PARAM_LIMIT) {
+		return DB_LIMIT_ERROR;
+	}
+
+	param = &adt->params[adt->param_count];
+	param->type = type;
+	param->index = 0;
+	param->ip = 0;
+
+	if (type == AQL_PARAM_VALUE) {
+		/* Reserve the value slot, the domain is known once it is bound. */
+		if (adt->value_count == AQL_ATTRIBUTE_LIMIT) {
+			return DB_LIMIT_ERROR;
+		}
+		param->index = adt->value_count;
+		adt->values[adt->value_count++].domain = DOMAIN_UNSPECIFIED;
+	}
+
+	adt->param_count++;
+
+	return DB_OK;
+}
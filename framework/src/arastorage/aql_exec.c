@@ -59,8 +59,10 @@
  ****************************************************************************/
 #include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <fcntl.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "db_debug.h"
@@ -121,55 +123,29 @@ db_result_t aql_deinit_handle(db_handle_t **handle)
 	return res;
 }
 
-/****************************************************************************
-* Public Functions
-****************************************************************************/
-db_result_t aql_get_parse_result(char *format, aql_adt_t *adt)
+static void aql_free_values(aql_adt_t *adt)
 {
-	if (format == NULL) {
-		return DB_ARGUMENT_ERROR;
-	}
-	if (AQL_ERROR(aql_parse(adt, format))) {
-		return DB_PARSING_ERROR;
-	}
-	return DB_OK;
-
-}
+	int i;
 
-relation_t *aql_get_relation(aql_adt_t *adt)
-{
-	int first_rel_arg;
-
-	/* If the ASSIGN flag is set, the first relation in the array is
-	   the desired result relation. */
-	first_rel_arg = ! !(adt->flags & AQL_FLAG_ASSIGN);
-	return relation_load(adt->relations[first_rel_arg]);
+	for (i = 0; i < adt->value_count; i++) {
+		if (adt->values[i].domain == DOMAIN_STRING && VALUE_STRING(&adt->values[i]) != NULL) {
+			free(VALUE_STRING(&adt->values[i]));
+			VALUE_STRING(&adt->values[i]) = NULL;
+		}
+	}
 }
 
-db_result_t db_exec(char *format)
+static db_result_t aql_execute(aql_adt_t *adt)
 {
 	db_result_t res;
-	aql_adt_t adt;
 	relation_t *rel = NULL;
 	aql_attribute_t *attr;
 	attribute_t *relattr = NULL;
 	uint32_t optype;
-	res = aql_get_parse_result(format, &adt);
-
-	if (DB_ERROR(res)) {
-		DB_LOG_E("DB : Parsing Error in db_create : %d\n", res);
-		return DB_PARSING_ERROR;
-	}
 
-	optype = AQL_GET_OP_TYPE(AQL_GET_TYPE(&adt));
-	if (optype == AQL_OP_TYPE_QUERY) {
-		DB_LOG_E("DB : AQL OP TYPE Error \n");
-		return DB_ARGUMENT_ERROR;
-	}
-
-	optype = AQL_GET_EXEC_TYPE(AQL_GET_TYPE(&adt));
+	optype = AQL_GET_EXEC_TYPE(AQL_GET_TYPE(adt));
 	if (optype != AQL_TYPE_CREATE_RELATION) {
-		rel = aql_get_relation(&adt);
+		rel = aql_get_relation(adt);
 		if (rel == NULL) {
 			DB_LOG_E("DB : get relation Failed\n");
 			return DB_RELATIONAL_ERROR;
@@ -180,27 +156,27 @@ db_result_t db_exec(char *format)
 
 	switch (optype) {
 	case AQL_TYPE_CREATE_ATTRIBUTE:
-		attr = &(adt.attributes[0]);
+		attr = &(adt->attributes[0]);
 		if (relation_attribute_add(rel, DB_STORAGE, attr->name, attr->domain, attr->element_size) != NULL) {
 			res = DB_OK;
 		}
 		break;
 	case AQL_TYPE_CREATE_INDEX:
-		relattr = relation_attribute_get(rel, adt.attributes[0].name);
+		relattr = relation_attribute_get(rel, adt->attributes[0].name);
 		if (relattr == NULL) {
 			res = DB_NAME_ERROR;
 			break;
 		}
-		res = index_create(AQL_GET_INDEX_TYPE(&adt), rel, relattr);
+		res = index_create(AQL_GET_INDEX_TYPE(adt), rel, relattr);
 		break;
 	case AQL_TYPE_CREATE_RELATION:
-		if (relation_create(adt.relations[0], DB_STORAGE) != NULL) {
+		if (relation_create(adt->relations[0], DB_STORAGE) != NULL) {
 			res = DB_OK;
 		}
 		break;
 	case AQL_TYPE_INSERT:
 		if (relation_cardinality(rel) < DB_TUPLE_LIMIT) {
-			res = relation_insert(rel, adt.values);
+			res = relation_insert(rel, adt->values);
 			if (DB_SUCCESS(res)) {
 				res = DB_OK;
 			}
@@ -209,10 +185,10 @@ db_result_t db_exec(char *format)
 		}
 		break;
 	case AQL_TYPE_REMOVE_ATTRIBUTE:
-		res = relation_attribute_remove(rel, adt.attributes[0].name);
+		res = relation_attribute_remove(rel, adt->attributes[0].name);
 		break;
 	case AQL_TYPE_REMOVE_INDEX:
-		relattr = relation_attribute_get(rel, adt.attributes[0].name);
+		relattr = relation_attribute_get(rel, adt->attributes[0].name);
 		if (relattr != NULL) {
 			index_load(rel, relattr);
 			if (relattr->index != NULL) {
@@ -236,9 +212,10 @@ db_result_t db_exec(char *format)
 	return res;
 }
 
-db_cursor_t *db_query(char *format)
+/* The condition of adt is freed when the query is done, or when the cursor
+   is freed if the query is streamed. */
+static db_cursor_t *aql_query(aql_adt_t *adt, bool stream)
 {
-	aql_adt_t adt;
 	relation_t *rel;
 	uint32_t optype;
 	db_handle_t *handler;
@@ -248,34 +225,29 @@ db_cursor_t *db_query(char *format)
 	handler = NULL;
 	cursor = NULL;
 
-	if (DB_ERROR(aql_get_parse_result(format, &adt))) {
-		DB_LOG_E("DB : Parsing Error in db_create : %d\n");
-		return NULL;
-	}
-	optype = AQL_GET_OP_TYPE(AQL_GET_TYPE(&adt));
-	if (optype != AQL_OP_TYPE_QUERY) {
-		DB_LOG_E("DB : AQL OP TYPE Error \n");
-		return NULL;
-	}
 #ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
 	if (DB_SUCCESS(storage_flush_insert_buffer())) {
 		DB_LOG_D("DB : flush insert buffer!!\n");
 	}
 #endif
+	/* The index entries of the tuples inserted so far are written with them. */
+	if (DB_ERROR(index_flush())) {
+		DB_LOG_E("DB : Failed to flush indexes\n");
+	}
 
-	rel = aql_get_relation(&adt);
+	rel = aql_get_relation(adt);
 	if (rel == NULL) {
-		return NULL;
+		goto errout;
 	}
 
-	optype = AQL_GET_EXEC_TYPE(AQL_GET_TYPE(&adt));
+	optype = AQL_GET_EXEC_TYPE(AQL_GET_TYPE(adt));
 	switch (optype) {
 	case AQL_TYPE_REMOVE_TUPLES:
 		/* Overwrite the attribute array with a full copy of the original
 		   relation's attributes. */
-		adt.attribute_count = 0;
+		adt->attribute_count = 0;
 		for (attr_ptr = list_head(rel->attributes); attr_ptr != NULL; attr_ptr = attr_ptr->next) {
-			AQL_ADD_ATTRIBUTE(&adt, attr_ptr->name, DOMAIN_UNSPECIFIED, 0);
+			AQL_ADD_ATTRIBUTE(adt, attr_ptr->name, DOMAIN_UNSPECIFIED, 0);
 		}
 	/* FALLTHROUGH */
 	case AQL_TYPE_SELECT:
@@ -283,15 +255,23 @@ db_cursor_t *db_query(char *format)
 			DB_LOG_E("DB: Init handle failed\n");
 			goto errout;
 		}
-		if (DB_ERROR(relation_select(&handler, rel, &adt))) {
+		if (DB_ERROR(relation_select(&handler, rel, adt))) {
 			DB_LOG_E("DB: Failed relation_select\n");
 			goto errout;
 		}
-		cursor = relation_process_result(handler);
+		if (stream) {
+			cursor = relation_process_stream(handler);
+		} else {
+			cursor = relation_process_result(handler);
+		}
 		if (cursor == NULL) {
 			DB_LOG_E("DB: Failed to process cursor tuples\n");
 			goto errout;
 		}
+		if (stream) {
+			/* The cursor owns the handle and the relation from now on. */
+			return cursor;
+		}
 		break;
 	case AQL_TYPE_FLUSH:
 	//TODO flush operation will be implemented later
@@ -304,6 +284,9 @@ db_cursor_t *db_query(char *format)
 			relation_release(rel);
 		}
 	}
+	if (handler == NULL && adt->lvm_instance != NULL) {
+		free(adt->lvm_instance);
+	}
 	aql_deinit_handle(&handler);
 
 	return cursor;
@@ -313,7 +296,441 @@ errout:
 		relation_release(rel);
 	}
 
+	/* The handle owns the condition once relation_select() is called. */
+	if (handler == NULL && adt->lvm_instance != NULL) {
+		free(adt->lvm_instance);
+	}
 	aql_deinit_handle(&handler);
 
 	return NULL;
 }
+
+static uint32_t aql_get_time(void)
+{
+	struct timespec ts;
+
+#ifdef CONFIG_CLOCK_MONOTONIC
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+#else
+	clock_gettime(CLOCK_REALTIME, &ts);
+#endif
+	return (uint32_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void aql_update_stats(db_stmt_t *stmt, uint32_t start)
+{
+	uint32_t elapsed;
+
+	elapsed = aql_get_time() - start;
+
+	stmt->stats.count++;
+	stmt->stats.last_time = elapsed;
+	stmt->stats.total_time += elapsed;
+	if (elapsed > stmt->stats.max_time) {
+		stmt->stats.max_time = elapsed;
+	}
+}
+
+static bool aql_all_bound(db_stmt_t *stmt)
+{
+	return stmt->bound == ((uint32_t)1 << AQL_PARAMETER_COUNT(&stmt->adt)) - 1;
+}
+
+static aql_param_t *aql_get_param(db_stmt_t *stmt, int param_index)
+{
+	if (stmt == NULL || param_index < 0 || param_index >= AQL_PARAMETER_COUNT(&stmt->adt)) {
+		return NULL;
+	}
+	return &stmt->adt.params[param_index];
+}
+
+static db_result_t aql_bind_long(db_stmt_t *stmt, int param_index, domain_t domain, long value)
+{
+	aql_param_t *param;
+	attribute_value_t *attr_value;
+
+	param = aql_get_param(stmt, param_index);
+	if (param == NULL) {
+		return DB_ARGUMENT_ERROR;
+	}
+
+	if (param->type == AQL_PARAM_OPERAND) {
+		if (LVM_ERROR(lvm_bind_parameter(stmt->adt.lvm_instance, param->ip, value))) {
+			return DB_IMPLEMENTATION_ERROR;
+		}
+	} else {
+		attr_value = &stmt->adt.values[param->index];
+		if (attr_value->domain == DOMAIN_STRING) {
+			free(VALUE_STRING(attr_value));
+		}
+		attr_value->domain = domain;
+		VALUE_LONG(attr_value) = value;
+	}
+
+	stmt->bound |= (uint32_t)1 << param_index;
+	return DB_OK;
+}
+
+static void aql_free_batch(db_stmt_t *stmt)
+{
+	int i;
+
+	for (i = 0; i < stmt->batch_count * stmt->adt.value_count; i++) {
+		if (stmt->batch[i].domain == DOMAIN_STRING) {
+			free(VALUE_STRING(&stmt->batch[i]));
+		}
+	}
+	stmt->batch_count = 0;
+}
+
+/****************************************************************************
+* Public Functions
+****************************************************************************/
+db_result_t aql_get_parse_result(char *format, aql_adt_t *adt)
+{
+	if (format == NULL) {
+		return DB_ARGUMENT_ERROR;
+	}
+	if (AQL_ERROR(aql_parse(adt, format))) {
+		return DB_PARSING_ERROR;
+	}
+	return DB_OK;
+
+}
+
+relation_t *aql_get_relation(aql_adt_t *adt)
+{
+	int first_rel_arg;
+
+	/* If the ASSIGN flag is set, the first relation in the array is
+	   the desired result relation. */
+	first_rel_arg = ! !(adt->flags & AQL_FLAG_ASSIGN);
+	return relation_load(adt->relations[first_rel_arg]);
+}
+
+db_result_t db_exec(char *format)
+{
+	db_result_t res;
+	aql_adt_t adt;
+	uint32_t optype;
+	res = aql_get_parse_result(format, &adt);
+
+	if (DB_ERROR(res)) {
+		DB_LOG_E("DB : Parsing Error in db_create : %d\n", res);
+		return DB_PARSING_ERROR;
+	}
+
+	optype = AQL_GET_OP_TYPE(AQL_GET_TYPE(&adt));
+	if (optype == AQL_OP_TYPE_QUERY || AQL_PARAMETER_COUNT(&adt) > 0) {
+		DB_LOG_E("DB : AQL OP TYPE Error \n");
+		res = DB_ARGUMENT_ERROR;
+	} else {
+		res = aql_execute(&adt);
+	}
+
+	aql_free_values(&adt);
+	if (adt.lvm_instance != NULL) {
+		free(adt.lvm_instance);
+	}
+	return res;
+}
+
+db_cursor_t *db_query(char *format)
+{
+	aql_adt_t adt;
+	uint32_t optype;
+
+	if (DB_ERROR(aql_get_parse_result(format, &adt))) {
+		DB_LOG_E("DB : Parsing Error in db_create : %d\n");
+		return NULL;
+	}
+	optype = AQL_GET_OP_TYPE(AQL_GET_TYPE(&adt));
+	if (optype != AQL_OP_TYPE_QUERY || AQL_PARAMETER_COUNT(&adt) > 0) {
+		DB_LOG_E("DB : AQL OP TYPE Error \n");
+		if (adt.lvm_instance != NULL) {
+			free(adt.lvm_instance);
+		}
+		return NULL;
+	}
+
+	return aql_query(&adt, false);
+}
+
+db_cursor_t *db_query_stream(char *format)
+{
+	aql_adt_t adt;
+
+	if (DB_ERROR(aql_get_parse_result(format, &adt))) {
+		DB_LOG_E("DB : Parsing Error in db_query_stream\n");
+		return NULL;
+	}
+	if (AQL_GET_TYPE(&adt) != AQL_TYPE_SELECT || AQL_PARAMETER_COUNT(&adt) > 0) {
+		DB_LOG_E("DB : AQL OP TYPE Error \n");
+		if (adt.lvm_instance != NULL) {
+			free(adt.lvm_instance);
+		}
+		return NULL;
+	}
+
+	return aql_query(&adt, true);
+}
+
+db_stmt_t *db_prepare(char *format)
+{
+	db_stmt_t *stmt;
+
+	stmt = (db_stmt_t *)malloc(sizeof(db_stmt_t));
+	if (stmt == NULL) {
+		DB_LOG_E("DB: Failed to malloc statement\n");
+		return NULL;
+	}
+	memset(stmt, 0, sizeof(db_stmt_t));
+
+	if (DB_ERROR(aql_get_parse_result(format, &stmt->adt))) {
+		DB_LOG_E("DB : Parsing Error in db_prepare\n");
+		db_finalize(stmt);
+		return NULL;
+	}
+
+	if (AQL_GET_TYPE(&stmt->adt) == AQL_TYPE_NONE) {
+		DB_LOG_E("DB : AQL OP TYPE Error \n");
+		db_finalize(stmt);
+		return NULL;
+	}
+
+	return stmt;
+}
+
+db_result_t db_bind_int(db_stmt_t *stmt, int param_index, int value)
+{
+	return aql_bind_long(stmt, param_index, DOMAIN_INT, value);
+}
+
+db_result_t db_bind_long(db_stmt_t *stmt, int param_index, long value)
+{
+	return aql_bind_long(stmt, param_index, DOMAIN_LONG, value);
+}
+
+db_result_t db_bind_string(db_stmt_t *stmt, int param_index, const char *value)
+{
+	aql_param_t *param;
+	attribute_value_t *attr_value;
+	unsigned char *str;
+	size_t str_size;
+
+	param = aql_get_param(stmt, param_index);
+	if (param == NULL || value == NULL) {
+		return DB_ARGUMENT_ERROR;
+	}
+
+	/* The LVM only compares integers. */
+	if (param->type != AQL_PARAM_VALUE) {
+		return DB_TYPE_ERROR;
+	}
+
+	str_size = strlen(value);
+	if (str_size >= DB_MAX_ELEMENT_SIZE) {
+		return DB_LIMIT_ERROR;
+	}
+	str = (unsigned char *)malloc(str_size + 1);
+	if (str == NULL) {
+		return DB_ALLOCATION_ERROR;
+	}
+	memcpy(str, value, str_size + 1);
+
+	attr_value = &stmt->adt.values[param->index];
+	if (attr_value->domain == DOMAIN_STRING) {
+		free(VALUE_STRING(attr_value));
+	}
+	attr_value->domain = DOMAIN_STRING;
+	VALUE_STRING(attr_value) = str;
+
+	stmt->bound |= (uint32_t)1 << param_index;
+	return DB_OK;
+}
+
+db_result_t db_stmt_exec(db_stmt_t *stmt)
+{
+	db_result_t res;
+	uint32_t start;
+
+	if (stmt == NULL || AQL_GET_OP_TYPE(AQL_GET_TYPE(&stmt->adt)) != AQL_OP_TYPE_EXEC) {
+		return DB_ARGUMENT_ERROR;
+	}
+	if (!aql_all_bound(stmt)) {
+		DB_LOG_E("DB: Not all parameters are bound\n");
+		return DB_ARGUMENT_ERROR;
+	}
+
+	start = aql_get_time();
+	res = aql_execute(&stmt->adt);
+	aql_update_stats(stmt, start);
+
+	return res;
+}
+
+db_cursor_t *db_stmt_query(db_stmt_t *stmt)
+{
+	aql_adt_t adt;
+	lvm_instance_t *lvm;
+	db_cursor_t *cursor;
+	uint32_t start;
+
+	if (stmt == NULL || AQL_GET_OP_TYPE(AQL_GET_TYPE(&stmt->adt)) != AQL_OP_TYPE_QUERY) {
+		return NULL;
+	}
+	if (!aql_all_bound(stmt)) {
+		DB_LOG_E("DB: Not all parameters are bound\n");
+		return NULL;
+	}
+
+	start = aql_get_time();
+
+	/* The query consumes the condition and derives the ranges of the
+	   variables in it, so run it on a copy of the prepared one. */
+	memcpy(&adt, &stmt->adt, sizeof(aql_adt_t));
+	if (stmt->adt.lvm_instance != NULL) {
+		lvm = (lvm_instance_t *)malloc(sizeof(lvm_instance_t));
+		if (lvm == NULL) {
+			DB_LOG_E("DB: Failed to malloc lvm instance\n");
+			return NULL;
+		}
+		lvm_clone(lvm, stmt->adt.lvm_instance);
+		AQL_SET_CONDITION(&adt, lvm);
+	}
+
+	cursor = aql_query(&adt, false);
+	aql_update_stats(stmt, start);
+
+	return cursor;
+}
+
+db_result_t db_stmt_add_batch(db_stmt_t *stmt)
+{
+	attribute_value_t *values;
+	unsigned char *str;
+	size_t str_size;
+	int i;
+
+	if (stmt == NULL || AQL_GET_EXEC_TYPE(AQL_GET_TYPE(&stmt->adt)) != AQL_TYPE_INSERT) {
+		return DB_ARGUMENT_ERROR;
+	}
+	if (!aql_all_bound(stmt)) {
+		DB_LOG_E("DB: Not all parameters are bound\n");
+		return DB_ARGUMENT_ERROR;
+	}
+
+	if (stmt->batch == NULL) {
+		stmt->batch = (attribute_value_t *)malloc(sizeof(attribute_value_t) * stmt->adt.value_count * DB_BATCH_LIMIT);
+		if (stmt->batch == NULL) {
+			DB_LOG_E("DB: Failed to malloc batch\n");
+			return DB_ALLOCATION_ERROR;
+		}
+	}
+
+	/* The bound strings are kept by the statement for the next tuple,
+	   so the batch holds its own copies. */
+	values = &stmt->batch[stmt->batch_count * stmt->adt.value_count];
+	for (i = 0; i < stmt->adt.value_count; i++) {
+		values[i] = stmt->adt.values[i];
+		if (values[i].domain != DOMAIN_STRING) {
+			continue;
+		}
+		str_size = strlen((char *)VALUE_STRING(&stmt->adt.values[i]));
+		str = (unsigned char *)malloc(str_size + 1);
+		if (str == NULL) {
+			/* Free the strings copied so far. */
+			while (--i >= 0) {
+				if (values[i].domain == DOMAIN_STRING) {
+					free(VALUE_STRING(&values[i]));
+				}
+			}
+			return DB_ALLOCATION_ERROR;
+		}
+		memcpy(str, VALUE_STRING(&stmt->adt.values[i]), str_size + 1);
+		VALUE_STRING(&values[i]) = str;
+	}
+	stmt->batch_count++;
+
+	if (stmt->batch_count == DB_BATCH_LIMIT) {
+		return db_stmt_exec_batch(stmt);
+	}
+	return DB_OK;
+}
+
+db_result_t db_stmt_exec_batch(db_stmt_t *stmt)
+{
+	db_result_t res;
+	relation_t *rel;
+	uint32_t start;
+
+	if (stmt == NULL || AQL_GET_EXEC_TYPE(AQL_GET_TYPE(&stmt->adt)) != AQL_TYPE_INSERT) {
+		return DB_ARGUMENT_ERROR;
+	}
+	if (stmt->batch_count == 0) {
+		return DB_OK;
+	}
+
+	start = aql_get_time();
+
+	rel = aql_get_relation(&stmt->adt);
+	if (rel == NULL) {
+		DB_LOG_E("DB : get relation Failed\n");
+		res = DB_RELATIONAL_ERROR;
+		goto errout;
+	}
+
+	if (relation_cardinality(rel) + stmt->batch_count <= DB_TUPLE_LIMIT) {
+		res = relation_insert_batch(rel, stmt->batch, stmt->adt.value_count, stmt->batch_count);
+		if (DB_SUCCESS(res)) {
+			res = DB_OK;
+		}
+	} else {
+		res = DB_LIMIT_ERROR;
+	}
+	relation_release(rel);
+
+errout:
+	/* The batch is dropped on failure as well, like a single insertion
+	   that fails is not retried. */
+	aql_free_batch(stmt);
+	aql_update_stats(stmt, start);
+
+	return res;
+}
+
+db_result_t db_stmt_get_stats(db_stmt_t *stmt, db_stmt_stats_t *stats)
+{
+	if (stmt == NULL || stats == NULL) {
+		return DB_ARGUMENT_ERROR;
+	}
+	memcpy(stats, &stmt->stats, sizeof(db_stmt_stats_t));
+	return DB_OK;
+}
+
+db_result_t db_get_cache_stats(db_cache_stats_t *stats)
+{
+	if (stats == NULL) {
+		return DB_ARGUMENT_ERROR;
+	}
+	return index_get_cache_stats(stats);
+}
+
+db_result_t db_finalize(db_stmt_t *stmt)
+{
+	if (stmt == NULL) {
+		return DB_ARGUMENT_ERROR;
+	}
+
+	aql_free_values(&stmt->adt);
+	if (stmt->adt.lvm_instance != NULL) {
+		free(stmt->adt.lvm_instance);
+	}
+	if (stmt->batch != NULL) {
+		aql_free_batch(stmt);
+		free(stmt->batch);
+	}
+	free(stmt);
+
+	return DB_OK;
+}
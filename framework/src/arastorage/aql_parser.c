@@ -261,6 +261,11 @@ PARSER(values)
 	case INTEGER_VALUE:
 		AQL_ADD_VALUE(adt, DOMAIN_INT, VALUE);
 		break;
+	case PARAMETER:
+		if (DB_ERROR(AQL_ADD_PARAMETER(adt, AQL_PARAM_VALUE))) {
+			RETURN(SYNTAX_ERROR);
+		}
+		break;
 	default:
 		RETURN(SYNTAX_ERROR);
 	}
@@ -298,6 +303,13 @@ PARSER(operand)
 			RETURN(SYNTAX_ERROR);
 		}
 		break;
+	case PARAMETER:
+		/* The operand is located by its parameter number once the code
+		   is complete, see resolve_parameters(). */
+		if (DB_ERROR(AQL_ADD_PARAMETER(adt, AQL_PARAM_OPERAND)) || LVM_ERROR(lvm_set_parameter(p, AQL_PARAMETER_COUNT(adt) - 1))) {
+			RETURN(SYNTAX_ERROR);
+		}
+		break;
 	default:
 		RETURN(SYNTAX_ERROR);
 	}
@@ -847,6 +859,30 @@ PARSER(create)
 	RETURN(STATUS_OK);
 }
 
+/* Locate the operands of the parameters in the final LVM code, the code is
+   shifted around while the WHERE clause is parsed. */
+static aql_status_t resolve_parameters(aql_adt_t *adt)
+{
+	int i;
+	aql_param_t *param;
+
+	for (i = 0; i < AQL_PARAMETER_COUNT(adt); i++) {
+		param = &adt->params[i];
+		if (param->type != AQL_PARAM_OPERAND) {
+			continue;
+		}
+		if (adt->lvm_instance == NULL) {
+			return SYNTAX_ERROR;
+		}
+		param->ip = lvm_get_parameter(adt->lvm_instance, i);
+		if (param->ip < 0) {
+			return SYNTAX_ERROR;
+		}
+	}
+
+	return STATUS_OK;
+}
+
 /****************************************************************************
 * Public Functions
 ****************************************************************************/
@@ -923,6 +959,10 @@ aql_status_t aql_parse(aql_adt_t *adt, char *input_string)
 		}
 	}
 
+	if (!AQL_ERROR(result)) {
+		result = resolve_parameters(adt);
+	}
+
 	if (AQL_ERROR(result)) {
 		DB_LOG_E("Error in function %s, line %d: input \"%s\"\n", error_function, error_line, error_message);
 	}
@@ -28,6 +28,30 @@
 #include "db_debug.h"
 #include "storage.h"
 #include "relation.h"
+#include "aql.h"
+
+/****************************************************************************
+* Private Functions
+****************************************************************************/
+
+/* A streaming cursor only moves forward, one row at a time. */
+static db_result_t cursor_move_stream(db_cursor_t *cursor, tuple_id_t row_id)
+{
+	if (row_id != cursor->current_cursor_row + 1) {
+		DB_LOG_E("streaming cursor moves to the next row only\n");
+		return DB_CURSOR_ERROR;
+	}
+
+	if (relation_process_stream_next(cursor) != DB_OK) {
+		return DB_CURSOR_ERROR;
+	}
+
+	cursor->current_cursor_row = row_id;
+	cursor->cursor_rows = row_id + 1;
+	DB_LOG_D("set current cursor id = %d, storage id = %d\n", cursor->current_cursor_row, cursor->current_storage_row);
+
+	return DB_OK;
+}
 
 /****************************************************************************
 * Public Functions
@@ -36,6 +60,10 @@
 /* Update current cursor id and storage id. */
 db_result_t cursor_move_to(db_cursor_t *cursor, tuple_id_t row_id)
 {
+	if (IS_STREAM_CURSOR(cursor)) {
+		return cursor_move_stream(cursor, row_id);
+	}
+
 	if (IS_EMPTY_CURSOR(cursor)) {
 		DB_LOG_E("Empty Cursor\n");
 		return DB_CURSOR_ERROR;
@@ -124,6 +152,9 @@ bool cursor_is_first_row(db_cursor_t *cursor)
 	if (cursor->current_cursor_row != 0) {
 		return false;
 	}
+	if (IS_STREAM_CURSOR(cursor)) {
+		return true;
+	}
 	//check whether pointing storage row id is true
 	for (i = 0; i < cursor->total_rows; i++) {
 		index = GET_INDEX(i);
@@ -145,6 +176,10 @@ bool cursor_is_last_row(db_cursor_t *cursor)
 	if (cursor == NULL) {
 		return false;
 	}
+	//the rows after current row of streaming cursor are not read yet
+	if (IS_STREAM_CURSOR(cursor)) {
+		return false;
+	}
 	//check whether pointing cursor id is correct
 	if (cursor->current_cursor_row != cursor->cursor_rows - 1) {
 		return false;
@@ -192,7 +227,8 @@ db_result_t cursor_data_add(db_cursor_t *cursor, tuple_id_t tuple_id)
 /* Get the number of tuples in a cursor */
 cursor_row_t cursor_get_count(db_cursor_t *cursor)
 {
-	if (IS_EMPTY_CURSOR(cursor)) {
+	/* The number of tuples of streaming cursor is not known until its end. */
+	if (IS_EMPTY_CURSOR(cursor) || IS_STREAM_CURSOR(cursor)) {
 		return INVALID_CURSOR_VALUE;
 	}
 
@@ -257,7 +293,7 @@ db_result_t cursor_get_value_storage(attribute_value_t *value, db_cursor_t *curs
 		return DB_CURSOR_ERROR;
 	}
 
-	if (IS_INVALID_STORAGE_ROW(cursor)) {
+	if (!IS_STREAM_CURSOR(cursor) && IS_INVALID_STORAGE_ROW(cursor)) {
 		DB_LOG_E("invalid storage row id\n");
 		return DB_CURSOR_ERROR;
 	}
@@ -272,6 +308,9 @@ db_result_t cursor_get_value_storage(attribute_value_t *value, db_cursor_t *curs
 		/* If the type of value is aggregate value, we don't need to read storage.
 		 Because aggregate result is already calculated and stored in buffer. */
 		buf += cursor->attr_map[col].offset;
+	} else if (IS_STREAM_CURSOR(cursor)) {
+		/* Streaming cursor already holds the current tuple. */
+		memcpy(buf, cursor->row + cursor->attr_map[col].offset, attr.element_size);
 	} else {
 		/* Otherwise, Read tuple value from storage. */
 		offset = cursor->current_storage_row * cursor->storage_row_length + cursor->attr_map[col].offset;
@@ -441,6 +480,28 @@ db_result_t cursor_init(db_cursor_t **cursor, relation_t *rel)
 	return DB_OK;
 }
 
+/* Streaming cursor has no bitmap of the result, only a buffer for current tuple. */
+db_result_t cursor_init_stream(db_cursor_t **cursor, relation_t *rel)
+{
+	if (*cursor == NULL) {
+		return DB_CURSOR_ERROR;
+	}
+
+	cursor_clean_data(*cursor);
+
+	(*cursor)->row = (unsigned char *)malloc(sizeof(char) * rel->row_length + 1);
+	if ((*cursor)->row == NULL) {
+		return DB_CURSOR_ERROR;
+	}
+	memset((*cursor)->row, 0, rel->row_length + 1);
+
+	(*cursor)->storage_row_length = rel->row_length;
+	memcpy((*cursor)->name, rel->tuple_filename, sizeof(rel->tuple_filename));
+	memcpy((*cursor)->rel_name, rel->name, sizeof(rel->name));
+
+	return DB_OK;
+}
+
 db_result_t cursor_deinit(db_cursor_t *cursor)
 {
 	if (cursor == NULL) {
@@ -450,6 +511,14 @@ db_result_t cursor_deinit(db_cursor_t *cursor)
 		free(cursor->row_arr);
 		cursor->row_arr = NULL;
 	}
+	if (cursor->row) {
+		free(cursor->row);
+		cursor->row = NULL;
+	}
+	if (cursor->handle) {
+		/* Release the relation which streaming cursor reads. */
+		aql_deinit_handle(&cursor->handle);
+	}
 	free(cursor);
 	return DB_OK;
 }
@@ -127,6 +127,11 @@
 #define AQL_ATTRIBUTE_LIMIT             9
 #endif							/* AQL_ATTRIBUTE_LIMIT */
 
+/* The maximum number of parameters in a prepared statement. */
+#ifndef AQL_PARAM_LIMIT
+#define AQL_PARAM_LIMIT                 AQL_ATTRIBUTE_LIMIT
+#endif							/* AQL_PARAM_LIMIT */
+
 /*----------------------------------------------------------------------------*/
 
 /*
@@ -168,6 +173,15 @@
 #define DB_TUPLE_LIMIT          1000
 #endif							/* DB_TUPLE_LIMIT */
 
+/* The maximum number of tuples in a batch insertion. */
+#ifndef DB_BATCH_LIMIT
+#ifdef CONFIG_ARASTORAGE_BATCH_SIZE
+#define DB_BATCH_LIMIT          CONFIG_ARASTORAGE_BATCH_SIZE
+#else
+#define DB_BATCH_LIMIT          16
+#endif
+#endif							/* DB_BATCH_LIMIT */
+
 /* The number of int array in a cursor. */
 #ifndef DB_CURSOR_LIMIT
 #define DB_CURSOR_LIMIT          ((DB_TUPLE_LIMIT / (sizeof(uint32_t)*8)) + 1)
@@ -223,12 +237,21 @@
 
 /* The maximum number of buckets cached in the MaxHeap index. */
 #ifndef DB_HEAP_CACHE_LIMIT
+#ifdef CONFIG_ARASTORAGE_BUCKET_CACHE_LIMIT
+#define DB_HEAP_CACHE_LIMIT             CONFIG_ARASTORAGE_BUCKET_CACHE_LIMIT
+#else
 #define DB_HEAP_CACHE_LIMIT             6
+#endif
 #endif							/* DB_HEAP_CACHE_LIMIT */
 
+/* The maximum number of nodes cached in the bplus-tree index. */
 #ifndef DB_TREE_CACHE_LIMIT
+#ifdef CONFIG_ARASTORAGE_NODE_CACHE_LIMIT
+#define DB_TREE_CACHE_LIMIT             CONFIG_ARASTORAGE_NODE_CACHE_LIMIT
+#else
 #define DB_TREE_CACHE_LIMIT             10
 #endif
+#endif
 
 #ifdef DB_WIP
 #undef DB_WIP						/* DB WORK IN PROGRESS */
@@ -121,6 +121,8 @@ struct index_api_s {
 	db_result_t(*insert)(index_t *, attribute_value_t *, tuple_id_t);
 	db_result_t(*delete)(index_t *, attribute_value_t *);
 	tuple_id_t(*get_next)(index_iterator_t *, uint8_t);
+	db_result_t(*flush)(index_t *);
+	db_result_t(*get_cache_stats)(index_t *, db_cache_stats_t *);
 };
 
 typedef struct index_api_s index_api_t;
@@ -139,6 +141,8 @@ db_result_t index_create(index_type_t, relation_t *, attribute_t *);
 db_result_t index_destroy(index_t *);
 db_result_t index_load(relation_t *, attribute_t *);
 db_result_t index_release(index_t *);
+db_result_t index_flush(void);
+db_result_t index_get_cache_stats(db_cache_stats_t *);
 db_result_t index_insert(index_t *, attribute_value_t *, tuple_id_t);
 db_result_t index_delete(index_t *, attribute_value_t *);
 db_result_t index_get_iterator(index_iterator_t *, index_t *, attribute_value_t *, attribute_value_t *);
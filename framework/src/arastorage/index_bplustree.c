@@ -75,6 +75,7 @@
 #define LEAF_NODES      pow(BRANCH_FACTOR, NODE_DEPTH)
 #define EMPTY_NODE(node)        (node)->val[BRANCH_FACTOR-1] == 0
 #define KEY_MAX INT_MAX
+#define KEY_MIN INT_MIN
 #define ROW_XOR 0xf6U
 #define NODE_STATE_VALID 1
 #define NODE_STATE_LOCK 2
@@ -83,6 +84,12 @@
 
 /* The total number of states possible of a node */
 #define NODE_STATES 255
+
+/* The position of a cache entry is stored in a uint8_t */
+#if DB_TREE_CACHE_LIMIT > 254 || DB_HEAP_CACHE_LIMIT > 254
+#error "The bplus-tree caches hold at most 254 entries"
+#endif
+
 #define CONFIG_VACUUM_THRESHOLD 40
 
 #ifdef CONFIG_ARASTORAGE_ENABLE_VACUUM
@@ -162,6 +169,23 @@ struct queue_s {
 };
 typedef struct queue_s queue_t;
 
+/* The LRU state of a cache. The entries are allocated with the cache and
+ * entries[i] describes the i-th cached node or bucket, so a lookup is an
+ * index into slots and a miss does not allocate anything.
+ */
+struct cache_ctl_s {
+	queue_t in_cache;			/* From the least recently used entry at head to the most recently used at tail */
+	qnode_t ends[2];			/* The head and the tail of in_cache */
+	qnode_t *entries;
+	uint8_t *slots;				/* Position + 1 of the entry caching each id, 0 if the id is not cached */
+	uint16_t id_limit;
+	uint8_t limit;
+	uint8_t num;
+	uint32_t hits;
+	uint32_t misses;
+};
+typedef struct cache_ctl_s cache_ctl_t;
+
 /* A Bucket Cache Entry */
 struct bucket_cache_s {
 	bucket_t bucket;
@@ -175,15 +199,20 @@ struct tree_cache_s {
 /* Bucket Cache Structure */
 typedef struct {
 	struct bucket_cache_s cache_t[DB_HEAP_CACHE_LIMIT];
-	queue_t in_cache;
-	uint8_t num;
+	qnode_t entries[DB_HEAP_CACHE_LIMIT];
+	uint8_t slots[CONFIG_BUCKETS_LIMIT];
+	cache_ctl_t ctl;
 } bucket_cache_t;
 
-/* Tree Cache Structure */
+/* Tree Cache Structure. tree_dirty lives here because tree_t itself is
+ * written to the storage as is.
+ */
 typedef struct {
 	struct tree_cache_s cache_t[DB_TREE_CACHE_LIMIT];
-	queue_t in_cache;
-	uint8_t num;
+	qnode_t entries[DB_TREE_CACHE_LIMIT];
+	uint8_t slots[CONFIG_NODE_LIMIT];
+	cache_ctl_t ctl;
+	bool tree_dirty;			/* The tree was modified since it was last flushed */
 } tree_cache_t;
 
 typedef enum {
@@ -258,6 +287,7 @@ static int base_offset = 0;
  * Private Function Prototypes
  ****************************************************************************/
 static int transform_key(int);
+static int value_to_key(attribute_value_t *);
 static tree_node_t *tree_read(tree_t *, int);
 static int tree_write(tree_t *, int, tree_node_t *);
 static tree_result_t tree_insert(tree_t *, int);
@@ -270,6 +300,10 @@ static bsplit_status_t bucket_split(tree_t *, int, int, pair_t *);
 static cache_result_t cache_bucket_append(tree_t *, int, pair_t *);
 static cache_result_t cache_write_bucket(tree_t *, int, bucket_t *);
 
+static db_result_t cache_init(tree_t *);
+static void cache_flush(tree_t *);
+static cache_ctl_t *cache_lock(tree_t *, cache_type_t);
+static void cache_unlock(tree_t *, cache_type_t);
 static cache_result_t modify_cache(tree_t *, int, cache_type_t, op_type_t);
 static cache_result_t cache_write_node(tree_t *, int, tree_node_t *);
 static cache_result_t cache_replace_node(tree_t *, int, tree_node_t *);
@@ -279,6 +313,8 @@ static db_result_t create(index_t *);
 static db_result_t destroy(index_t *);
 static db_result_t load(index_t *);
 static db_result_t release(index_t *);
+static db_result_t flush(index_t *);
+static db_result_t get_cache_stats(index_t *, db_cache_stats_t *);
 static db_result_t insert(index_t *, attribute_value_t *, tuple_id_t);
 static db_result_t delete(index_t *, attribute_value_t *);
 static tuple_id_t get_next(index_iterator_t *, uint8_t);
@@ -302,7 +338,9 @@ index_api_t index_bplustree = {
 	release,
 	insert,
 	delete,
-	get_next
+	get_next,
+	flush,
+	get_cache_stats
 };
 
 /****************************************************************************
@@ -350,7 +388,6 @@ static db_result_t create(index_t *index)
 	size_t buck_size = 0;
 	int offset = 0;
 	db_result_t result;
-	uint8_t success = 0;
 	int curtime;
 
 	curtime = time(NULL);
@@ -437,76 +474,13 @@ static db_result_t create(index_t *index)
 	/* Initialize the tree metadata. */
 	memset(&tree->lock_buckets, 0, sizeof(tree->lock_buckets));
 
-	/* Allocating node cache and initialising it */
-	tree->node_cache = bptree_malloc(sizeof(tree_cache_t));
-	if (tree->node_cache != NULL) {
-		success |= 1;
-		qnode_t *head = (qnode_t *)bptree_malloc(sizeof(qnode_t));
-		if (head != NULL) {
-			success |= 2;
-			tree->node_cache->in_cache.head = head;
-			qnode_t *end = (qnode_t *)bptree_malloc(sizeof(qnode_t));
-			if (end != NULL) {
-				success |= 4;
-				head->prev = NULL;
-				end->next = NULL;
-				head->next = end;
-				end->prev = head;
-				tree->node_cache->in_cache.tail = end;
-				tree->node_cache->num = 0;
-			}
-		}
-	}
-	if (success != 7) {
-		DB_LOG_E("FAILED TO ALLOCATE NODE CACHE\n");
-		result = DB_ALLOCATION_ERROR;
-		storage_remove(tree_filename);
-		storage_remove(bucket_filename);
-		if (success & 1) {
-			if (success & 2) {
-				free(tree->node_cache->in_cache.head);
-			}
-			free(tree->node_cache);
-		}
-		free(tree);
-		return result;
-	}
-
-	/* Allocating bucket cache and initialising it */
-	tree->buck_cache = bptree_malloc(sizeof(bucket_cache_t));
-	success = 0;
-	if (tree->buck_cache != NULL) {
-		success |= 1;
-		qnode_t *head = (qnode_t *)bptree_malloc(sizeof(qnode_t));
-		if (head != NULL) {
-			success |= 2;
-			tree->buck_cache->in_cache.head = head;
-			qnode_t *end = (qnode_t *)bptree_malloc(sizeof(qnode_t));
-			if (end != NULL) {
-				success |= 4;
-				head->prev = NULL;
-				end->next = NULL;
-				head->next = end;
-				end->prev = head;
-				tree->buck_cache->in_cache.tail = end;
-				tree->buck_cache->num = 0;
-			}
-		}
-	}
-	if (success != 7) {
-		DB_LOG_E("FAILED TO ALLOCATE BUCKET CACHE\n");
-		result = DB_ALLOCATION_ERROR;
-		free(tree->node_cache->in_cache.tail);
-		free(tree->node_cache->in_cache.head);
-		free(tree->node_cache);
+	/* Allocating node and bucket caches and initialising them */
+	result = cache_init(tree);
+	if (DB_ERROR(result)) {
+		storage_close(tree->bucket_storage);
+		storage_close(tree->tree_storage);
 		storage_remove(tree_filename);
 		storage_remove(bucket_filename);
-		if (success & 1) {
-			if (success & 2) {
-				free(tree->buck_cache->in_cache.head);
-			}
-			free(tree->buck_cache);
-		}
 		free(tree);
 		return result;
 	}
@@ -515,14 +489,13 @@ static db_result_t create(index_t *index)
 	tree->deleted = 0;
 
 	/* Initialising Locks for concurrency control */
-	pthread_mutex_init(&(tree->node_cache_lock), NULL);
 	pthread_mutex_init(&(tree->bucket_lock), NULL);
-	pthread_mutex_init(&(tree->buck_cache_lock), NULL);
 	rw_init(&(tree->tree_lock));
 
 	tree->off_nodes = tree->off_buckets = 0;
 
 	/* Inserting first value to initialise the tree data structure */
+	tree->node_cache->tree_dirty = true;
 	if (tree_insert(tree, KEY_MAX) != TREE_OK) {
 		result = DB_STORAGE_ERROR;
 		return result;
@@ -563,7 +536,6 @@ static db_result_t load(index_t *index)
 	db_storage_id_t fd;
 	char bucket_file[DB_MAX_FILENAME_LENGTH];
 	db_result_t result;
-	uint8_t success = 0;
 
 	index->opaque_data = tree = bptree_malloc(sizeof(tree_t));
 	if (tree == NULL) {
@@ -592,71 +564,8 @@ static db_result_t load(index_t *index)
 	}
 	storage_close(fd);
 
-	tree->node_cache = bptree_malloc(sizeof(tree_cache_t));
-	if (tree->node_cache != NULL) {
-		success |= 1;
-		qnode_t *head = (qnode_t *)bptree_malloc(sizeof(qnode_t));
-		if (head != NULL) {
-			success |= 2;
-			tree->node_cache->in_cache.head = head;
-			qnode_t *end = (qnode_t *)bptree_malloc(sizeof(qnode_t));
-			if (end != NULL) {
-				success |= 4;
-				head->prev = NULL;
-				end->next = NULL;
-				head->next = end;
-				end->prev = head;
-				tree->node_cache->in_cache.tail = end;
-				tree->node_cache->num = 0;
-			}
-		}
-	}
-	if (success != 7) {
-		DB_LOG_E("FAILED TO ALLOCATE NODE CACHE\n");
-		result = DB_ALLOCATION_ERROR;
-		if (success & 1) {
-			if (success & 2) {
-				free(tree->node_cache->in_cache.head);
-			}
-			free(tree->node_cache);
-		}
-		free(tree);
-		return result;
-	}
-
-	/* Allocating bucket cache and initialising it  */
-	tree->buck_cache = bptree_malloc(sizeof(bucket_cache_t));
-	success = 0;
-	if (tree->buck_cache != NULL) {
-		success |= 1;
-		qnode_t *head = (qnode_t *)bptree_malloc(sizeof(qnode_t));
-		if (head != NULL) {
-			success |= 2;
-			tree->buck_cache->in_cache.head = head;
-			qnode_t *end = (qnode_t *)bptree_malloc(sizeof(qnode_t));
-			if (end != NULL) {
-				success |= 4;
-				head->prev = NULL;
-				end->next = NULL;
-				head->next = end;
-				end->prev = head;
-				tree->buck_cache->in_cache.tail = end;
-				tree->buck_cache->num = 0;
-			}
-		}
-	}
-	if (success != 7) {
-		DB_LOG_E("FAILED TO ALLOCATE BUCKET CACHE\n");
-		result = DB_ALLOCATION_ERROR;
-		free(tree->node_cache->in_cache.tail);
-		free(tree->node_cache->in_cache.head);
-		free(tree->node_cache);
-		if (success & 1) {
-			if (success & 2) {
-				free(tree->buck_cache->in_cache.head);
-			}
-			free(tree->buck_cache);
-		}
+	result = cache_init(tree);
+	if (DB_ERROR(result)) {
 		free(tree);
 		return result;
 	}
@@ -674,7 +583,6 @@ static db_result_t load(index_t *index)
 static db_result_t release(index_t *index)
 {
 	tree_t *tree;
-	qnode_t *tmp_node;
 
 	tree = index->opaque_data;
 	if (tree == NULL) {
@@ -683,38 +591,8 @@ static db_result_t release(index_t *index)
 	if (tree->node_cache == NULL || tree->buck_cache == NULL) {
 		return DB_ALLOCATION_ERROR;
 	}
-	if ((tree->node_cache->in_cache.tail == NULL) || (tree->node_cache->in_cache.head == NULL)) {
-		return DB_ALLOCATION_ERROR;
-	}
-	if ((tree->buck_cache->in_cache.tail == NULL) || (tree->buck_cache->in_cache.head == NULL)) {
-		return DB_ALLOCATION_ERROR;
-	}
 	storage_write_to(tree->tree_storage, tree, 0, sizeof(tree_t));
-	/* Bucket Cache being flushed */
-	tmp_node = tree->buck_cache->in_cache.head->next;
-	free(tmp_node->prev);
-	while (tmp_node != tree->buck_cache->in_cache.tail) {
-		if ((tmp_node->node_state & NODE_STATE_DIRTY) && (tmp_node->node_state & NODE_STATE_VALID)) {
-			bucket_write(tree, tmp_node->id, &(tree->buck_cache->cache_t[tmp_node->pos].bucket));
-		}
-		tmp_node = tmp_node->next;
-		if (tmp_node->prev) {
-			free(tmp_node->prev);
-		}
-	}
-	free(tree->buck_cache->in_cache.tail);
-	tmp_node = tree->node_cache->in_cache.head->next;
-	free(tmp_node->prev);
-	while (tmp_node != tree->node_cache->in_cache.tail) {
-		if ((tmp_node->node_state & NODE_STATE_DIRTY) && (tmp_node->node_state & NODE_STATE_VALID)) {
-			tree_write(tree, tmp_node->id, &(tree->node_cache->cache_t[tmp_node->pos].node));
-		}
-		tmp_node = tmp_node->next;
-		if (tmp_node->prev) {
-			free(tmp_node->prev);
-		}
-	}
-	free(tree->node_cache->in_cache.tail);
+	cache_flush(tree);
 	storage_close(tree->bucket_storage);
 	storage_close(tree->tree_storage);
 
@@ -724,6 +602,61 @@ static db_result_t release(index_t *index)
 	return DB_OK;
 }
 
+/****************************************************************************
+ * Name: flush
+ *
+ * Description: Writes the tree structure and the dirty cache entries back to
+ *              the flash. The entries stay in the cache. A tree which was not
+ *              modified since the last flush is skipped.
+ *
+ ****************************************************************************/
+static db_result_t flush(index_t *index)
+{
+	tree_t *tree;
+
+	tree = index->opaque_data;
+	if (tree == NULL || tree->node_cache == NULL || tree->buck_cache == NULL) {
+		return DB_ALLOCATION_ERROR;
+	}
+	if (!tree->node_cache->tree_dirty) {
+		return DB_OK;
+	}
+	storage_write_to(tree->tree_storage, tree, 0, sizeof(tree_t));
+	cache_flush(tree);
+	tree->node_cache->tree_dirty = false;
+	return DB_OK;
+}
+
+/****************************************************************************
+ * Name: get_cache_stats
+ *
+ * Description: Adds the hit and miss counts of the node and bucket caches to
+ *              stats.
+ *
+ ****************************************************************************/
+static db_result_t get_cache_stats(index_t *index, db_cache_stats_t *stats)
+{
+	tree_t *tree;
+	cache_ctl_t *ctl;
+
+	tree = index->opaque_data;
+	if (tree == NULL || tree->node_cache == NULL || tree->buck_cache == NULL) {
+		return DB_ALLOCATION_ERROR;
+	}
+
+	ctl = cache_lock(tree, NODE);
+	stats->node_hits += ctl->hits;
+	stats->node_misses += ctl->misses;
+	cache_unlock(tree, NODE);
+
+	ctl = cache_lock(tree, BUCKET);
+	stats->bucket_hits += ctl->hits;
+	stats->bucket_misses += ctl->misses;
+	cache_unlock(tree, BUCKET);
+
+	return DB_OK;
+}
+
 /****************************************************************************
  * Name: insert
  *
@@ -735,10 +668,11 @@ static db_result_t release(index_t *index)
 static db_result_t insert(index_t *index, attribute_value_t *key, tuple_id_t value)
 {
 	tree_t *tree;
-	long long_key;
+	int i_key;
 
 	tree = (tree_t *)index->opaque_data;
-	long_key = db_value_to_long(key);
+	i_key = value_to_key(key);
+	tree->node_cache->tree_dirty = true;
 
 #ifdef CONFIG_ARASTORAGE_ENABLE_FLUSHING
 	if ((tree->inserted) >= DB_TUPLES_LIMIT) {
@@ -746,8 +680,8 @@ static db_result_t insert(index_t *index, attribute_value_t *key, tuple_id_t val
 		value = value - DB_TUPLES_LIMIT / 2;
 	}
 #endif
-	if (insert_item_btree(tree, (int)long_key, (int)value) == TREE_INSERT_FAIL) {
-		DB_LOG_E("DB: Failed to insert key %ld into a bplus-tree index\n", long_key);
+	if (insert_item_btree(tree, i_key, (int)value) == TREE_INSERT_FAIL) {
+		DB_LOG_E("DB: Failed to insert key %d into a bplus-tree index\n", i_key);
 		return DB_INDEX_ERROR;
 	}
 
@@ -757,27 +691,8 @@ static db_result_t insert(index_t *index, attribute_value_t *key, tuple_id_t val
 	 *	and write back is preferred.
 	 ***************************************************************************************/
 #ifdef DB_WIP
-	qnode_t *tmp_node;
 	storage_write_to(tree->tree_storage, tree, 0, sizeof(tree_t));
-
-	/* Bucket Cache being flushed */
-
-	tmp_node = tree->buck_cache->in_cache.head->next;
-	while (tmp_node != tree->buck_cache->in_cache.tail) {
-		if ((tmp_node->node_state & NODE_STATE_DIRTY) && (tmp_node->node_state & NODE_STATE_VALID)) {
-			bucket_write(tree, tmp_node->id, &(tree->buck_cache->cache_t[tmp_node->pos].bucket));
-			UNSET_NODE_STATE(tmp_node, NODE_STATE_DIRTY);
-		}
-		tmp_node = tmp_node->next;
-	}
-	tmp_node = tree->node_cache->in_cache.head->next;
-	while (tmp_node != tree->node_cache->in_cache.tail) {
-		if ((tmp_node->node_state & NODE_STATE_DIRTY) && (tmp_node->node_state & NODE_STATE_VALID)) {
-			tree_write(tree, tmp_node->id, &(tree->node_cache->cache_t[tmp_node->pos].node));
-			UNSET_NODE_STATE(tmp_node, NODE_STATE_DIRTY);
-		}
-		tmp_node = tmp_node->next;
-	}
+	cache_flush(tree);
 #endif
 	return DB_OK;
 }
@@ -786,7 +701,7 @@ static db_result_t delete(index_t *index, attribute_value_t *value)
 {
 	int i_key;
 
-	i_key = db_value_to_long(value);
+	i_key = value_to_key(value);
 	DB_LOG_D("delete index for value %d\n", i_key);
 
 	return delete_item_btree(index, i_key);
@@ -836,8 +751,8 @@ static tuple_id_t get_next(index_iterator_t *iterator, uint8_t matched_condition
 	int key_max;
 	int key_min;
 	tree_t *tree;
-	key_min = *(int *)&iterator->min_value;
-	key_max = *(int *)&iterator->max_value;
+	key_min = value_to_key(&iterator->min_value);
+	key_max = value_to_key(&iterator->max_value);
 	tree = (tree_t *)iterator->index->opaque_data;
 
 	/* To initialize the iterator_cache */
@@ -874,8 +789,8 @@ static tuple_id_t get_next(index_iterator_t *iterator, uint8_t matched_condition
 
 					/* Start Bucket chaining */
 					int iter = 0;
-					uint16_t new_min = cache.bucket->info[1];
-					uint16_t new_max = cache.bucket->info[2];
+					int new_min = cache.bucket->info[1];
+					int new_max = cache.bucket->info[2];
 					for (; iter < cache.bucket->next_free_slot - 1; iter++) {
 						new_min = min(cache.bucket->pairs[iter].key, new_min);
 						new_max = max(cache.bucket->pairs[iter].key, new_max);
@@ -887,6 +802,7 @@ static tuple_id_t get_next(index_iterator_t *iterator, uint8_t matched_condition
 
 				cache.bucket->next_free_slot--;
 				tree->deleted++;
+				tree->node_cache->tree_dirty = true;
 				cache.end--;
 				cache.start = i;
 				return tmp;
@@ -1042,56 +958,221 @@ static db_result_t vacuum(tree_t *tree, relation_t *rel)
 #endif
 
 /****************************************************************************
- * Name: modify_cache
+ * Name: cache_init
  *
- * Description: Modifying the cache entries to mark the entry dirty,
- *              invalid or unlocking it
+ * Description: Allocates the node and bucket caches of a tree.
  *
  ****************************************************************************/
-static cache_result_t modify_cache(tree_t *tree, int id, cache_type_t cache, op_type_t op)
+static void cache_ctl_init(cache_ctl_t *ctl, qnode_t *entries, uint8_t *slots, int limit, int id_limit)
+{
+	ctl->ends[0].prev = NULL;
+	ctl->ends[0].next = &ctl->ends[1];
+	ctl->ends[1].prev = &ctl->ends[0];
+	ctl->ends[1].next = NULL;
+	ctl->in_cache.head = &ctl->ends[0];
+	ctl->in_cache.tail = &ctl->ends[1];
+	ctl->entries = entries;
+	ctl->slots = slots;
+	ctl->limit = limit;
+	ctl->id_limit = id_limit;
+	ctl->num = 0;
+	ctl->hits = 0;
+	ctl->misses = 0;
+}
+
+static db_result_t cache_init(tree_t *tree)
+{
+	tree->node_cache = bptree_malloc(sizeof(tree_cache_t));
+	tree->buck_cache = bptree_malloc(sizeof(bucket_cache_t));
+	if (tree->node_cache == NULL || tree->buck_cache == NULL) {
+		DB_LOG_E("FAILED TO ALLOCATE NODE AND BUCKET CACHE\n");
+		free(tree->node_cache);
+		free(tree->buck_cache);
+		tree->node_cache = NULL;
+		tree->buck_cache = NULL;
+		return DB_ALLOCATION_ERROR;
+	}
+
+	cache_ctl_init(&tree->node_cache->ctl, tree->node_cache->entries, tree->node_cache->slots, DB_TREE_CACHE_LIMIT, CONFIG_NODE_LIMIT);
+	cache_ctl_init(&tree->buck_cache->ctl, tree->buck_cache->entries, tree->buck_cache->slots, DB_HEAP_CACHE_LIMIT, CONFIG_BUCKETS_LIMIT);
+	tree->node_cache->tree_dirty = false;
+
+	pthread_mutex_init(&(tree->node_cache_lock), NULL);
+	pthread_mutex_init(&(tree->buck_cache_lock), NULL);
+
+	return DB_OK;
+}
+
+/****************************************************************************
+ * Name: cache_lock
+ *
+ * Description: Locks the node or bucket cache and returns its LRU state
+ *
+ ****************************************************************************/
+static cache_ctl_t *cache_lock(tree_t *tree, cache_type_t cache)
 {
-	qnode_t *temp;
-	qnode_t *end;
 	if (cache == NODE) {
 		pthread_mutex_lock(&(tree->node_cache_lock));
-		temp = tree->node_cache->in_cache.tail->prev;
-		end = tree->node_cache->in_cache.head;
+		return &(tree->node_cache->ctl);
+	}
+	pthread_mutex_lock(&(tree->buck_cache_lock));
+	return &(tree->buck_cache->ctl);
+}
+
+static void cache_unlock(tree_t *tree, cache_type_t cache)
+{
+	if (cache == NODE) {
+		pthread_mutex_unlock(&(tree->node_cache_lock));
 	} else {
-		pthread_mutex_lock(&(tree->buck_cache_lock));
-		temp = tree->buck_cache->in_cache.tail->prev;
-		end = tree->buck_cache->in_cache.head;
-	}
-	while (temp != end) {
-		if ((temp->id == id) && (temp->node_state & NODE_STATE_VALID)) {
-			if (op == UNLOCK) {
-				UNSET_NODE_STATE(temp, NODE_STATE_LOCK);
-			} else if (op == DIRTY) {
-				SET_NODE_STATE(temp, NODE_STATE_DIRTY);
-			} else {
-				UNSET_NODE_STATE(temp, NODE_STATE_VALID | NODE_STATE_DIRTY | NODE_STATE_LOCK);
-				REMOVE_ENTRY(temp);
+		pthread_mutex_unlock(&(tree->buck_cache_lock));
+	}
+}
+
+/****************************************************************************
+ * Name: cache_find
+ *
+ * Description: Returns the valid cache entry of a node or bucket id, or NULL
+ *              if the id is not cached
+ *
+ ****************************************************************************/
+static qnode_t *cache_find(cache_ctl_t *ctl, int id)
+{
+	qnode_t *entry;
+
+	if (id < 0 || id >= ctl->id_limit || ctl->slots[id] == 0) {
+		return NULL;
+	}
+	entry = &ctl->entries[ctl->slots[id] - 1];
+	if (!(entry->node_state & NODE_STATE_VALID)) {
+		return NULL;
+	}
+	return entry;
+}
+
+/****************************************************************************
+ * Name: cache_insert
+ *
+ * Description: Takes the cache entry for an id and moves it to the most
+ *              recently used end. When the cache is full, the least recently
+ *              used entry which is not locked is evicted and written back to
+ *              the flash if it is dirty. The state of the returned entry is
+ *              cleared. Returns NULL if every entry is locked.
+ *
+ ****************************************************************************/
+static qnode_t *cache_insert(tree_t *tree, cache_type_t cache, cache_ctl_t *ctl, int id)
+{
+	qnode_t *entry;
+
+	if (id < 0 || id >= ctl->id_limit) {
+		DB_LOG_E("PANIC CACHE ENTRY FOR AN INVALID ID %d\n", id);
+		return NULL;
+	}
+
+	entry = cache_find(ctl, id);
+	if (entry != NULL) {
+		REMOVE_ENTRY(entry);
+	} else if (ctl->num < ctl->limit) {
+		entry = &ctl->entries[ctl->num];
+		entry->pos = ctl->num++;
+	} else {
+		entry = ctl->in_cache.head->next;
+		while ((entry->node_state & NODE_STATE_LOCK) && entry != ctl->in_cache.tail) {
+			entry = entry->next;
+		}
+		if (entry == ctl->in_cache.tail) {
+			return NULL;
+		}
+		if (entry->node_state & NODE_STATE_VALID) {
+			if (entry->node_state & NODE_STATE_DIRTY) {
 				if (cache == NODE) {
-					PLACE_AT_HEAD(temp, tree->node_cache);
+					tree_write(tree, entry->id, &(tree->node_cache->cache_t[entry->pos].node));
 				} else {
-					PLACE_AT_HEAD(temp, tree->buck_cache);
+					bucket_write(tree, entry->id, &(tree->buck_cache->cache_t[entry->pos].bucket));
 				}
 			}
-			break;
+			ctl->slots[entry->id] = 0;
 		}
-		temp = temp->prev;
+		/* entry is the one which has to be evicted from cache.
+		 * It is removed the queue maintaining the LRU status.
+		 */
+		REMOVE_ENTRY(entry);
 	}
 
-	if (cache == NODE) {
-		pthread_mutex_unlock(&(tree->node_cache_lock));
-	} else {
-		pthread_mutex_unlock(&(tree->buck_cache_lock));
+	PLACE_AT_TAIL(entry, ctl);
+	entry->id = id;
+	entry->node_state = 0;
+	ctl->slots[id] = entry->pos + 1;
+
+	return entry;
+}
+
+/****************************************************************************
+ * Name: cache_flush
+ *
+ * Description: Writes the dirty entries of both caches back to the flash.
+ *
+ ****************************************************************************/
+static void cache_flush(tree_t *tree)
+{
+	cache_ctl_t *ctl;
+	qnode_t *iter;
+
+	/* Bucket Cache being flushed */
+	ctl = cache_lock(tree, BUCKET);
+	for (iter = ctl->in_cache.head->next; iter != ctl->in_cache.tail; iter = iter->next) {
+		if ((iter->node_state & NODE_STATE_DIRTY) && (iter->node_state & NODE_STATE_VALID)) {
+			bucket_write(tree, iter->id, &(tree->buck_cache->cache_t[iter->pos].bucket));
+			UNSET_NODE_STATE(iter, NODE_STATE_DIRTY);
+		}
+	}
+	DB_LOG_D("DB: Bucket cache hits %u misses %u\n", ctl->hits, ctl->misses);
+	cache_unlock(tree, BUCKET);
+
+	/* Node Cache being flushed */
+	ctl = cache_lock(tree, NODE);
+	for (iter = ctl->in_cache.head->next; iter != ctl->in_cache.tail; iter = iter->next) {
+		if ((iter->node_state & NODE_STATE_DIRTY) && (iter->node_state & NODE_STATE_VALID)) {
+			tree_write(tree, iter->id, &(tree->node_cache->cache_t[iter->pos].node));
+			UNSET_NODE_STATE(iter, NODE_STATE_DIRTY);
+		}
 	}
+	DB_LOG_D("DB: Node cache hits %u misses %u\n", ctl->hits, ctl->misses);
+	cache_unlock(tree, NODE);
+}
+
+/****************************************************************************
+ * Name: modify_cache
+ *
+ * Description: Modifying the cache entries to mark the entry dirty,
+ *              invalid or unlocking it
+ *
+ ****************************************************************************/
+static cache_result_t modify_cache(tree_t *tree, int id, cache_type_t cache, op_type_t op)
+{
+	cache_ctl_t *ctl;
+	qnode_t *temp;
 
-	if (temp == end) {
+	ctl = cache_lock(tree, cache);
+	temp = cache_find(ctl, id);
+	if (temp == NULL) {
+		cache_unlock(tree, cache);
 		DB_LOG_E("PANIC CACHE OPERATION FOR A NON EXISTENT ENTRY\n");
 		return CACHE_NOT_EXIST;
 	}
 
+	if (op == UNLOCK) {
+		UNSET_NODE_STATE(temp, NODE_STATE_LOCK);
+	} else if (op == DIRTY) {
+		SET_NODE_STATE(temp, NODE_STATE_DIRTY);
+	} else {
+		UNSET_NODE_STATE(temp, NODE_STATE_VALID | NODE_STATE_DIRTY | NODE_STATE_LOCK);
+		ctl->slots[id] = 0;
+		REMOVE_ENTRY(temp);
+		PLACE_AT_HEAD(temp, ctl);
+	}
+
+	cache_unlock(tree, cache);
+
 	return CACHE_OK;
 }
 
@@ -1104,49 +1185,21 @@ static cache_result_t modify_cache(tree_t *tree, int id, cache_type_t cache, op_
  ****************************************************************************/
 static cache_result_t cache_write_node(tree_t *tree, int id, tree_node_t *node)
 {
-	pthread_mutex_lock(&(tree->node_cache_lock));
+	cache_ctl_t *ctl;
+	qnode_t *new_node;
 
-	qnode_t *new_node = (qnode_t *)bptree_malloc(sizeof(qnode_t));
+	ctl = cache_lock(tree, NODE);
+	new_node = cache_insert(tree, NODE, ctl, id);
 	if (new_node == NULL) {
-		DB_LOG_E("Failed allocation of node\n");
-		pthread_mutex_unlock(&(tree->node_cache_lock));
-		return CACHE_ALLOCATION_ERROR;
-	}
-
-	if (tree->node_cache->num < DB_TREE_CACHE_LIMIT) {
-		new_node->pos = tree->node_cache->num++;
-	} else {
-		qnode_t *iter_node;
-		iter_node = tree->node_cache->in_cache.head->next;
-		while ((iter_node->node_state & NODE_STATE_LOCK) && iter_node != tree->node_cache->in_cache.tail) {
-			iter_node = iter_node->next;
-		}
-		if (iter_node == tree->node_cache->in_cache.tail) {
-			free(new_node);
-			DB_LOG_E("NO SLOT AVAIABLE IN CACHE\n");
-			pthread_mutex_unlock(&(tree->node_cache_lock));
-			return CACHE_FULL;
-		}
-		if ((iter_node->node_state & NODE_STATE_DIRTY) && (iter_node->node_state & NODE_STATE_DIRTY)) {
-			tree_write(tree, iter_node->id, &(tree->node_cache->cache_t[iter_node->pos].node));
-		}
-		new_node->pos = iter_node->pos;
-		/* iter_node is the node which has to be evicted from cache.
-		 * It is removed the queue maintaining the LRU status.
-		 */
-		REMOVE_ENTRY(iter_node);
-		free(iter_node);
+		DB_LOG_E("NO SLOT AVAIABLE IN CACHE\n");
+		cache_unlock(tree, NODE);
+		return CACHE_FULL;
 	}
-
-	PLACE_AT_TAIL(new_node, tree->node_cache);
-	new_node->id = id;
-	UNSET_NODE_STATE(new_node, NODE_STATE_LOCK);
-	SET_NODE_STATE(new_node, NODE_STATE_VALID);
-	SET_NODE_STATE(new_node, NODE_STATE_DIRTY);
+	SET_NODE_STATE(new_node, NODE_STATE_VALID | NODE_STATE_DIRTY);
 
 	memcpy(&(tree->node_cache->cache_t[new_node->pos].node), node, sizeof(tree_node_t));
 
-	pthread_mutex_unlock(&(tree->node_cache_lock));
+	cache_unlock(tree, NODE);
 
 	return CACHE_OK;
 }
@@ -1160,17 +1213,14 @@ static cache_result_t cache_write_node(tree_t *tree, int id, tree_node_t *node)
  ****************************************************************************/
 static cache_result_t cache_replace_node(tree_t *tree, int id, tree_node_t *node)
 {
-	pthread_mutex_lock(&(tree->node_cache_lock));
-
+	cache_ctl_t *ctl;
 	qnode_t *replace_node;
-	replace_node = tree->node_cache->in_cache.head->next;
 
-	while ((replace_node->id != id) && (replace_node != tree->node_cache->in_cache.tail)) {
-		replace_node = replace_node->next;
-	}
-	if (replace_node == tree->node_cache->in_cache.tail || !(replace_node->node_state & NODE_STATE_LOCK)) {
+	ctl = cache_lock(tree, NODE);
+	replace_node = cache_find(ctl, id);
+	if (replace_node == NULL || !(replace_node->node_state & NODE_STATE_LOCK)) {
 		DB_LOG_E("PANIC REPLACE FOR NON_EXISTENT OR NON_LOCKED ENTRY\n");
-		pthread_mutex_unlock(&(tree->node_cache_lock));
+		cache_unlock(tree, NODE);
 		return CACHE_NOT_EXIST;
 	}
 	UNSET_NODE_STATE(replace_node, NODE_STATE_LOCK);
@@ -1178,7 +1228,7 @@ static cache_result_t cache_replace_node(tree_t *tree, int id, tree_node_t *node
 
 	memcpy(&(tree->node_cache->cache_t[replace_node->pos].node), node, sizeof(tree_node_t));
 
-	pthread_mutex_unlock(&(tree->node_cache_lock));
+	cache_unlock(tree, NODE);
 
 	return CACHE_OK;
 }
@@ -1192,44 +1242,21 @@ static cache_result_t cache_replace_node(tree_t *tree, int id, tree_node_t *node
  ****************************************************************************/
 static cache_result_t cache_write_bucket(tree_t *tree, int id, bucket_t *bucket)
 {
-	pthread_mutex_lock(&(tree->buck_cache_lock));
+	cache_ctl_t *ctl;
+	qnode_t *new_node;
 
-	qnode_t *new_node = (qnode_t *)bptree_malloc(sizeof(qnode_t));
+	ctl = cache_lock(tree, BUCKET);
+	new_node = cache_insert(tree, BUCKET, ctl, id);
 	if (new_node == NULL) {
-		pthread_mutex_unlock(&(tree->buck_cache_lock));
-		return CACHE_ALLOCATION_ERROR;
+		DB_LOG_E("NO SLOT AVAILABLE IN CACHE bucket\n");
+		cache_unlock(tree, BUCKET);
+		return CACHE_FULL;
 	}
-
-	if (tree->buck_cache->num < DB_HEAP_CACHE_LIMIT) {
-		new_node->pos = tree->buck_cache->num++;
-	} else {
-		qnode_t *iter_node;
-		iter_node = tree->buck_cache->in_cache.head->next;
-		while ((iter_node->node_state & NODE_STATE_LOCK) && (iter_node != tree->buck_cache->in_cache.tail)) {
-			iter_node = iter_node->next;
-		}
-		if (iter_node == tree->buck_cache->in_cache.tail) {
-			free(new_node);
-			DB_LOG_E("NO SLOT AVAILABLE IN CACHE bucket\n");
-			pthread_mutex_unlock(&(tree->buck_cache_lock));
-			return CACHE_FULL;
-		}
-
-		if ((iter_node->node_state & NODE_STATE_DIRTY) && (iter_node->node_state & NODE_STATE_VALID)) {
-			bucket_write(tree, iter_node->id, &(tree->buck_cache->cache_t[iter_node->pos].bucket));
-		}
-		new_node->pos = iter_node->pos;
-		REMOVE_ENTRY(iter_node);
-		free(iter_node);
-	}
-	PLACE_AT_TAIL(new_node, tree->buck_cache);
-	new_node->id = id;
-	UNSET_NODE_STATE(new_node, NODE_STATE_LOCK);
 	SET_NODE_STATE(new_node, NODE_STATE_DIRTY | NODE_STATE_VALID);
 
 	memcpy(&(tree->buck_cache->cache_t[new_node->pos].bucket), bucket, sizeof(bucket_t));
 
-	pthread_mutex_unlock(&(tree->buck_cache_lock));
+	cache_unlock(tree, BUCKET);
 
 	return CACHE_OK;
 }
@@ -1247,6 +1274,29 @@ static int transform_key(int key)
 	return key;
 }
 
+/****************************************************************************
+ * Name: value_to_key
+ *
+ * Description: Routine to convert an attribute value to a key of the tree.
+ *              Values out of the range of keys are clamped, so that an open
+ *              bound of a range query such as DB_LONG_MIN does not wrap
+ *              around when long is wider than int.
+ *
+ ****************************************************************************/
+static int value_to_key(attribute_value_t *value)
+{
+	long key;
+
+	key = db_value_to_long(value);
+	if (key < KEY_MIN) {
+		return KEY_MIN;
+	}
+	if (key > KEY_MAX) {
+		return KEY_MAX;
+	}
+	return (int)key;
+}
+
 /****************************************************************************
  * Name: tree_read
  *
@@ -1256,72 +1306,46 @@ static int transform_key(int key)
  ****************************************************************************/
 static tree_node_t *tree_read(tree_t *tree, int bucket_id)
 {
-	pthread_mutex_lock(&(tree->node_cache_lock));
+	cache_ctl_t *ctl;
+	qnode_t *iter;
 
-	bool found = false;
-	qnode_t *iter = (tree->node_cache->in_cache.tail)->prev;
-
-	while (iter != (tree->node_cache->in_cache.head)) {
-		if (bucket_id == iter->id && (iter->node_state & NODE_STATE_VALID)) {
-			found = true;
-			break;
-		}
-		iter = iter->prev;
-	}
-	if (found) {
+	ctl = cache_lock(tree, NODE);
+	iter = cache_find(ctl, bucket_id);
+	if (iter != NULL) {
 		/* Case when node is found in the cache */
+		ctl->hits++;
 		if (iter->node_state & NODE_STATE_LOCK) {
-			pthread_mutex_unlock(&(tree->node_cache_lock));
+			cache_unlock(tree, NODE);
 			return NULL;
 		}
 		SET_NODE_STATE(iter, NODE_STATE_LOCK);
 		REMOVE_ENTRY(iter);
-		PLACE_AT_TAIL(iter, tree->node_cache);
-		pthread_mutex_unlock(&(tree->node_cache_lock));
+		PLACE_AT_TAIL(iter, ctl);
+		cache_unlock(tree, NODE);
 		return &(tree->node_cache->cache_t[iter->pos].node);
-	} else {
-		qnode_t *new_node = (qnode_t *)bptree_malloc(sizeof(qnode_t));
-		if (new_node == NULL) {
-			pthread_mutex_unlock(&(tree->node_cache_lock));
-			return NULL;
-		}
-		if (tree->node_cache->num < DB_TREE_CACHE_LIMIT) {
-			new_node->pos = tree->node_cache->num++;
-		} else {
-			/* Case when the least recently used node needs to be evicted to make place for new node */
-			qnode_t *replace_node = tree->node_cache->in_cache.head->next;
-			while ((replace_node->node_state & NODE_STATE_LOCK) && replace_node != tree->node_cache->in_cache.tail) {
-				replace_node = replace_node->next;
-			}
-			if (replace_node == tree->node_cache->in_cache.tail) {
-				free(new_node);
-				pthread_mutex_unlock(&(tree->node_cache_lock));
-				return NULL;
-			}
-			if ((replace_node->node_state & NODE_STATE_DIRTY) && (replace_node->node_state & NODE_STATE_VALID)) {
-				tree_write(tree, replace_node->id, &(tree->node_cache->cache_t[replace_node->pos].node));
-			}
-			new_node->pos = replace_node->pos;
-			REMOVE_ENTRY(replace_node);
-			free(replace_node);
-		}
-		/* Adjusting the pointers */
-		PLACE_AT_TAIL(new_node, tree->node_cache);
-		new_node->id = bucket_id;
-		SET_NODE_STATE(new_node, NODE_STATE_LOCK | NODE_STATE_VALID | NODE_STATE_DIRTY);
-
-		/* Reading from flash */
-		if (DB_ERROR(storage_read_from(tree->tree_storage, &(tree->node_cache->cache_t[new_node->pos].node), base_offset + (unsigned long)bucket_id * sizeof(tree_node_t), sizeof(tree_node_t)))) {
-			DB_LOG_E("PANIC TREE READ FAILED AT NODE ID %d\n", new_node->id);
-			UNSET_NODE_STATE(new_node, NODE_STATE_LOCK | NODE_STATE_VALID);
-			pthread_mutex_unlock(&(tree->node_cache_lock));
-			return NULL;
-		}
+	}
 
-		pthread_mutex_unlock(&(tree->node_cache_lock));
+	/* The least recently used node is evicted if needed to make place for new node */
+	ctl->misses++;
+	iter = cache_insert(tree, NODE, ctl, bucket_id);
+	if (iter == NULL) {
+		cache_unlock(tree, NODE);
+		return NULL;
+	}
+	SET_NODE_STATE(iter, NODE_STATE_LOCK | NODE_STATE_VALID | NODE_STATE_DIRTY);
 
-		return &(tree->node_cache->cache_t[new_node->pos].node);
+	/* Reading from flash */
+	if (DB_ERROR(storage_read_from(tree->tree_storage, &(tree->node_cache->cache_t[iter->pos].node), base_offset + (unsigned long)bucket_id * sizeof(tree_node_t), sizeof(tree_node_t)))) {
+		DB_LOG_E("PANIC TREE READ FAILED AT NODE ID %d\n", iter->id);
+		UNSET_NODE_STATE(iter, NODE_STATE_LOCK | NODE_STATE_VALID);
+		ctl->slots[bucket_id] = 0;
+		cache_unlock(tree, NODE);
+		return NULL;
 	}
+
+	cache_unlock(tree, NODE);
+
+	return &(tree->node_cache->cache_t[iter->pos].node);
 }
 
 /****************************************************************************
@@ -1529,73 +1553,46 @@ void tree_print(tree_t *tree, int id)
  ****************************************************************************/
 static bucket_t *bucket_read(tree_t *tree, int bucket_id)
 {
-	pthread_mutex_lock(&(tree->buck_cache_lock));
-
-	bool found = false;
-	qnode_t *iter = (tree->buck_cache->in_cache.tail)->prev;
+	cache_ctl_t *ctl;
+	qnode_t *iter;
 
-	while (iter != (tree->buck_cache->in_cache.head)) {
-		if (bucket_id == iter->id && (iter->node_state & NODE_STATE_VALID)) {
-			found = true;
-			break;
-		}
-		iter = iter->prev;
-	}
-	if (found) {
+	ctl = cache_lock(tree, BUCKET);
+	iter = cache_find(ctl, bucket_id);
+	if (iter != NULL) {
 		/* If the bucket is found in the cache */
+		ctl->hits++;
 		if (iter->node_state & NODE_STATE_LOCK) {
-			pthread_mutex_unlock(&(tree->buck_cache_lock));
+			cache_unlock(tree, BUCKET);
 			return NULL;
 		}
 		SET_NODE_STATE(iter, NODE_STATE_LOCK);
 		REMOVE_ENTRY(iter);
-		PLACE_AT_TAIL(iter, tree->buck_cache);
-		pthread_mutex_unlock(&(tree->buck_cache_lock));
+		PLACE_AT_TAIL(iter, ctl);
+		cache_unlock(tree, BUCKET);
 		return &(tree->buck_cache->cache_t[iter->pos].bucket);
-	} else {
-		/* Bucket has to be read from flash into the cache */
-		qnode_t *new_node = (qnode_t *)bptree_malloc(sizeof(qnode_t));
-		if (new_node == NULL) {
-			pthread_mutex_unlock(&(tree->buck_cache_lock));
-			return NULL;
-		}
-		if (tree->buck_cache->num < DB_HEAP_CACHE_LIMIT) {
-			new_node->pos = tree->buck_cache->num++;
-		} else {
-			/* Cache doesn't have enough space and the least recently used bucket needs to be evicted */
-			qnode_t *replace_node = tree->buck_cache->in_cache.head->next;
-			while ((replace_node->node_state & NODE_STATE_LOCK) && (replace_node != tree->buck_cache->in_cache.tail)) {
-				replace_node = replace_node->next;
-			}
-			if (replace_node == tree->buck_cache->in_cache.tail) {
-				free(new_node);
-				pthread_mutex_unlock(&(tree->buck_cache_lock));
-				return NULL;
-			}
-			if ((replace_node->node_state & NODE_STATE_DIRTY) && (replace_node->node_state & NODE_STATE_VALID)) {
-				bucket_write(tree, replace_node->id, &(tree->buck_cache->cache_t[replace_node->pos].bucket));
-			}
-			new_node->pos = replace_node->pos;
-			REMOVE_ENTRY(replace_node);
-			free(replace_node);
-		}
+	}
 
-		/* Adjust the pointers */
-		PLACE_AT_TAIL(new_node, tree->buck_cache);
-		new_node->id = bucket_id;
-		SET_NODE_STATE(new_node, NODE_STATE_LOCK | NODE_STATE_VALID);
-		UNSET_NODE_STATE(new_node, NODE_STATE_DIRTY);
-
-		/* Read from flash */
-		if (DB_ERROR(storage_read_from(tree->bucket_storage, (void *)&(tree->buck_cache->cache_t[new_node->pos].bucket), (unsigned long)bucket_id * sizeof(bucket_t), sizeof(bucket_t)))) {
-			DB_LOG_E("PANIC BUCKET READ FAILED AT ID %d\n", bucket_id);
-			UNSET_NODE_STATE(new_node, (NODE_STATE_LOCK | NODE_STATE_VALID));
-			pthread_mutex_unlock(&(tree->buck_cache_lock));
-			return NULL;
-		}
-		pthread_mutex_unlock(&(tree->buck_cache_lock));
-		return &(tree->buck_cache->cache_t[new_node->pos].bucket);
+	/* Bucket has to be read from flash into the cache, the least recently
+	 * used bucket is evicted if the cache doesn't have enough space.
+	 */
+	ctl->misses++;
+	iter = cache_insert(tree, BUCKET, ctl, bucket_id);
+	if (iter == NULL) {
+		cache_unlock(tree, BUCKET);
+		return NULL;
+	}
+	SET_NODE_STATE(iter, NODE_STATE_LOCK | NODE_STATE_VALID);
+
+	/* Read from flash */
+	if (DB_ERROR(storage_read_from(tree->bucket_storage, (void *)&(tree->buck_cache->cache_t[iter->pos].bucket), (unsigned long)bucket_id * sizeof(bucket_t), sizeof(bucket_t)))) {
+		DB_LOG_E("PANIC BUCKET READ FAILED AT ID %d\n", bucket_id);
+		UNSET_NODE_STATE(iter, (NODE_STATE_LOCK | NODE_STATE_VALID));
+		ctl->slots[bucket_id] = 0;
+		cache_unlock(tree, BUCKET);
+		return NULL;
 	}
+	cache_unlock(tree, BUCKET);
+	return &(tree->buck_cache->cache_t[iter->pos].bucket);
 }
 
 /****************************************************************************
@@ -1779,6 +1776,7 @@ static bsplit_status_t bucket_split(tree_t *tree, int key, int value, pair_t *pa
 	bucket_t *bucket;
 	uint16_t bucket_id = path[tree->levels].key;
 	int i;
+	int off;
 	if (tree->off_buckets == CONFIG_BUCKETS_LIMIT - 1) {
 		DB_LOG_E("TREE FULL !");
 		return BSPLIT_FAIL;
@@ -1800,7 +1798,26 @@ static bsplit_status_t bucket_split(tree_t *tree, int key, int value, pair_t *pa
 
 	qsort(bucket_tuples, BUCKET_SIZE + 1, sizeof(pair_t), compare);
 
-	median = bucket_tuples[(BUCKET_SIZE + 1) / 2].key;
+	/* tree_find() looks up a key equal to the median in the new bucket, so
+	 * split where the key changes rather than among duplicates of the median.
+	 * Otherwise a range which starts at the median misses the duplicates left
+	 * in the old bucket. Keys are only shared if all of them are equal.
+	 */
+	off = (BUCKET_SIZE + 1) / 2;
+	median = bucket_tuples[off].key;
+	while (off > 0 && bucket_tuples[off - 1].key == median) {
+		off--;
+	}
+	if (off == 0) {
+		off = (BUCKET_SIZE + 1) / 2;
+		while (off < BUCKET_SIZE + 1 && bucket_tuples[off].key == median) {
+			off++;
+		}
+		if (off == BUCKET_SIZE + 1) {
+			off = (BUCKET_SIZE + 1) / 2;
+		}
+		median = bucket_tuples[off].key;
+	}
 	/* Call tree_split before creating a new bucket and dividing the entries */
 	int b_id = tree->off_buckets++;
 	int res = tree_split(tree, median, b_id, path, tree->levels - 1);
@@ -1808,15 +1825,10 @@ static bsplit_status_t bucket_split(tree_t *tree, int key, int value, pair_t *pa
 	/* Proceed only if the tree split is successful. This ensures top-down splitting of the tree nodes */
 	if (res == TSPLIT_OK) {
 		bucket_t b1, b2;
-		int ind = 0;
-		int off;
-		for (;; ind++) {
-			if (ind == (BUCKET_SIZE + 1) / 2) {
-				break;
-			}
+		int ind;
+		for (ind = 0; ind < off; ind++) {
 			b1.pairs[ind] = bucket_tuples[ind];
 		}
-		off = ind;
 		for (; ind < BUCKET_SIZE + 1; ind++) {
 			b2.pairs[ind - off] = bucket_tuples[ind];
 		}
@@ -2003,7 +2015,7 @@ static int db_flush(tree_t *tree, relation_t *rel)
 			if (tup >= flush_threshold) {
 				storage_get_row(&old_rel, &tup, temp);
 				storage_put_row(rel, temp, FALSE);
-				uint16_t tmp_key = bucket->pairs[num].key;
+				int tmp_key = bucket->pairs[num].key;
 				bucket->pairs[ind].key = tmp_key;
 				bucket->pairs[ind].value = num_tuples;
 				num_tuples++;
@@ -2015,8 +2027,8 @@ static int db_flush(tree_t *tree, relation_t *rel)
 		}
 		/* Start Bucket chaining */
 		int iter = 0;
-		uint16_t new_min = bucket->info[1];
-		uint16_t new_max = bucket->info[2];
+		int new_min = bucket->info[1];
+		int new_max = bucket->info[2];
 		for (; iter < bucket->next_free_slot; iter++) {
 			new_min = min(bucket->pairs[iter].key, new_min);
 			new_max = max(bucket->pairs[iter].key, new_max);
@@ -2554,6 +2566,7 @@ static db_result_t delete_item_btree(index_t *index, int value)
 	int *rm_value = NULL;
 
 	tree = (tree_t*)index->opaque_data;
+	tree->node_cache->tree_dirty = true;
 	path = tree_find(tree, value);
 	if (path == NULL) {
 		return DB_INDEX_ERROR;
@@ -302,6 +302,35 @@ db_result_t index_release(index_t *index)
 	return DB_OK;
 }
 
+/* Write the data which the loaded indexes keep in RAM back to the storage. */
+db_result_t index_flush(void)
+{
+	index_t *index;
+
+	for (index = list_head(indices); index != NULL; index = index->next) {
+		if (index->api->flush != NULL && DB_ERROR(index->api->flush(index))) {
+			return DB_INDEX_ERROR;
+		}
+	}
+
+	return DB_OK;
+}
+
+/* Sum up the cache statistics of the loaded indexes. */
+db_result_t index_get_cache_stats(db_cache_stats_t *stats)
+{
+	index_t *index;
+
+	memset(stats, 0, sizeof(db_cache_stats_t));
+	for (index = list_head(indices); index != NULL; index = index->next) {
+		if (index->api->get_cache_stats != NULL && DB_ERROR(index->api->get_cache_stats(index, stats))) {
+			return DB_INDEX_ERROR;
+		}
+	}
+
+	return DB_OK;
+}
+
 db_result_t index_insert(index_t *index, attribute_value_t *value, tuple_id_t tuple_id)
 {
 	return index->api->insert(index, value, tuple_id);
@@ -429,18 +429,26 @@ lvm_status_t lvm_set_operand(lvm_instance_t *p, operand_t *op)
 	return LVM_TRUE;
 }
 
-lvm_status_t lvm_set_operand_value(lvm_instance_t *p, attribute_t *attr, unsigned char *value)
+lvm_status_t lvm_set_operand_value(lvm_instance_t *p, variable_id_t id, attribute_t *attr, unsigned char *value)
 {
 	operand_value_t operand_value;
 
+	if (id >= LVM_MAX_VARIABLE_ID) {
+		/* The attribute is not used in the predicate. */
+		return INVALID_IDENTIFIER;
+	}
+
 	/* Update the internal state of the PLE. */
 	if (attr->domain == DOMAIN_INT) {
 		operand_value.l = value[0] << 8 | value[1];
 	} else if (attr->domain == DOMAIN_LONG) {
 		operand_value.l = (uint32_t)value[0] << 24 | (uint32_t)value[1] << 16 | (uint32_t)value[2] << 8 | value[3];
+	} else {
+		return TYPE_ERROR;
 	}
 
-	return lvm_set_variable_value(p, attr->name, operand_value);
+	p->variables[id].value = operand_value;
+	return LVM_TRUE;
 }
 
 lvm_status_t lvm_set_long(lvm_instance_t *p, long l)
@@ -502,6 +510,82 @@ lvm_status_t lvm_set_variable(lvm_instance_t *p, char *name)
 	return lvm_set_operand(p, &op);
 }
 
+variable_id_t lvm_get_variable_id(lvm_instance_t *p, char *name)
+{
+	variable_id_t id;
+
+	id = lookup(p, name);
+	if (id == LVM_MAX_VARIABLE_ID || strcmp(p->variables[id].name, name) != 0) {
+		return LVM_MAX_VARIABLE_ID;
+	}
+
+	return id;
+}
+
+void lvm_clone(lvm_instance_t *dst, lvm_instance_t *src)
+{
+	memcpy(dst, src, sizeof(*dst));
+}
+
+/* A parameter is an operand of type LVM_PARAMETER holding the number of
+   the parameter, until a value is bound to it. */
+lvm_status_t lvm_set_parameter(lvm_instance_t *p, long id)
+{
+	operand_t op;
+
+	op.type = LVM_PARAMETER;
+	op.value.l = id;
+
+	return lvm_set_operand(p, &op);
+}
+
+lvm_ip_t lvm_get_parameter(lvm_instance_t *p, long id)
+{
+	lvm_ip_t ip;
+	node_type_t type;
+	operand_t op;
+
+	/* The code is a sequence of node types, each followed by an operator
+	   or by an operand. */
+	ip = 0;
+	while (ip + (lvm_ip_t)sizeof(type) <= p->end) {
+		memcpy(&type, &p->code[ip], sizeof(type));
+		ip += sizeof(type);
+		switch (type) {
+		case LVM_OPERAND:
+			memcpy(&op, &p->code[ip], sizeof(op));
+			if (op.type == LVM_PARAMETER && op.value.l == id) {
+				return ip;
+			}
+			ip += sizeof(op);
+			break;
+		case LVM_ARITH_OP:
+		case LVM_CMP_OP:
+			ip += sizeof(operator_t);
+			break;
+		default:
+			return -1;
+		}
+	}
+
+	return -1;
+}
+
+lvm_status_t lvm_bind_parameter(lvm_instance_t *p, lvm_ip_t ip, long l)
+{
+	operand_t op;
+
+	if (ip < 0 || ip + (lvm_ip_t)sizeof(op) > p->end) {
+		return INVALID_IDENTIFIER;
+	}
+
+	op.type = LVM_LONG;
+	op.value.l = l;
+	memcpy(&p->code[ip], &op, sizeof(op));
+
+	return LVM_TRUE;
+}
+
 static void create_intersection(derivation_t *result, derivation_t *d1, derivation_t *d2)
 {
 	int i;
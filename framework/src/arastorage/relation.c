@@ -55,6 +55,7 @@
  * Included Files
  ****************************************************************************/
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <limits.h>
 #include <tinyara/config.h>
@@ -508,30 +509,20 @@ db_result_t relation_remove(relation_t *rel, int remove_tuples)
 	return result;
 }
 
-db_result_t relation_insert(relation_t *rel, attribute_value_t *values)
+/* Convert the values of a tuple into a row of the relation. */
+static db_result_t relation_encode_row(relation_t *rel, attribute_value_t *values, unsigned char *record)
 {
 	attribute_t *attr;
-	unsigned char record[rel->row_length];
 	unsigned char *ptr;
 	attribute_value_t *value;
 	db_result_t result;
 
 	value = values;
-
-	DB_LOG_D("DB: Relation %s has a record size of %u bytes\n", rel->name, (unsigned)rel->row_length);
 	ptr = record;
 
 	DB_LOG_V("DB: Insert (");
 
-	attr = list_head(rel->attributes);
-	while (attr != NULL) {
-		/* Verify that the value is in the expected domain. An exception
-		   to this rule is that INT may be promoted to LONG. */
-		if (attr->domain != value->domain && !(attr->domain == DOMAIN_LONG && value->domain == DOMAIN_INT)) {
-			DB_LOG_E("DB: The value domain %d does not match the domain %d of attribute %s\n", value->domain, attr->domain, attr->name);
-			return DB_RELATIONAL_ERROR;
-		}
-
+	for (attr = list_head(rel->attributes); attr != NULL; attr = attr->next) {
 		/* Set the data area for removed attributes to 0. */
 		if (attr->flags & ATTRIBUTE_FLAG_INVALID) {
 			memset(ptr, 0, attr->element_size);
@@ -539,6 +530,13 @@ db_result_t relation_insert(relation_t *rel, attribute_value_t *values)
 			continue;
 		}
 
+		/* Verify that the value is in the expected domain. An exception
+		   to this rule is that INT may be promoted to LONG. */
+		if (attr->domain != value->domain && !(attr->domain == DOMAIN_LONG && value->domain == DOMAIN_INT)) {
+			DB_LOG_E("DB: The value domain %d does not match the domain %d of attribute %s\n", value->domain, attr->domain, attr->name);
+			return DB_RELATIONAL_ERROR;
+		}
+
 		result = db_value_to_phy((unsigned char *)ptr, attr, value);
 		if (DB_ERROR(result)) {
 			return result;
@@ -563,24 +561,174 @@ db_result_t relation_insert(relation_t *rel, attribute_value_t *values)
 			DB_LOG_V(", ");
 		}
 #endif              /* DEBUG */
+		ptr += attr->element_size;
+		value++;
+	}
+
+	DB_LOG_V(")\n");
+
+	return DB_OK;
+}
+
+db_result_t relation_insert(relation_t *rel, attribute_value_t *values)
+{
+	attribute_t *attr;
+	unsigned char record[rel->row_length];
+	attribute_value_t *value;
+	db_result_t result;
+
+	DB_LOG_D("DB: Relation %s has a record size of %u bytes\n", rel->name, (unsigned)rel->row_length);
+
+	result = relation_encode_row(rel, values, record);
+	if (DB_ERROR(result)) {
+		return result;
+	}
+
+	value = values;
+	for (attr = list_head(rel->attributes); attr != NULL; attr = attr->next) {
+		if (attr->flags & ATTRIBUTE_FLAG_INVALID) {
+			continue;
+		}
 		if (attr->index == NULL) {
 			index_load(rel, attr);
 		}
-		ptr += attr->element_size;
 		if (attr->index != NULL) {
 			if (DB_ERROR(index_insert(attr->index, value, rel->next_row))) {
 				return DB_INDEX_ERROR;
 			}
 		}
-		attr = attr->next;
 		value++;
 	}
 
-	DB_LOG_V(")\n");
-
 	return storage_put_row(rel, record, FALSE);
 }
 
+struct batch_key_s {
+	long key;
+	tuple_id_t row;
+};
+
+static int batch_key_compare(const void *p1, const void *p2)
+{
+	long key1 = ((const struct batch_key_s *)p1)->key;
+	long key2 = ((const struct batch_key_s *)p2)->key;
+
+	if (key1 != key2) {
+		return key1 < key2 ? -1 : 1;
+	}
+
+	/* Keep the order of the tuples with the same key. */
+	return ((const struct batch_key_s *)p1)->row < ((const struct batch_key_s *)p2)->row ? -1 : 1;
+}
+
+/* Sort the rows of a batch by the value of an attribute. */
+static void batch_sort(relation_t *rel, attribute_t *attr, unsigned char *records, tuple_id_t count, struct batch_key_s *keys)
+{
+	attribute_value_t value;
+	int offset;
+	tuple_id_t i;
+
+	offset = get_attribute_value_offset(rel, attr);
+	for (i = 0; i < count; i++) {
+		db_phy_to_value(&value, attr, records + i * rel->row_length + offset);
+		keys[i].key = db_value_to_long(&value);
+		keys[i].row = i;
+	}
+
+	qsort(keys, count, sizeof(struct batch_key_s), batch_key_compare);
+}
+
+/*
+ * Insert a batch of tuples at once. The rows are appended to the tuple file
+ * with one write and each index gets the keys of the batch in ascending
+ * order, so that consecutive keys go to the same bucket while it is in the
+ * cache instead of evicting buckets back and forth.
+ */
+db_result_t relation_insert_batch(relation_t *rel, attribute_value_t *values, unsigned value_count, tuple_id_t count)
+{
+	attribute_t *attr;
+	unsigned char *records = NULL;
+	unsigned char *sorted;
+	struct batch_key_s *keys = NULL;
+	attribute_value_t value;
+	db_result_t result;
+	int offset;
+	tuple_id_t i;
+
+	if (count == 0) {
+		return DB_OK;
+	}
+
+	records = (unsigned char *)malloc(rel->row_length * count);
+	keys = (struct batch_key_s *)malloc(sizeof(struct batch_key_s) * count);
+	if (records == NULL || keys == NULL) {
+		DB_LOG_E("DB: Failed to allocate a batch of %d rows\n", count);
+		result = DB_ALLOCATION_ERROR;
+		goto errout;
+	}
+
+	for (i = 0; i < count; i++) {
+		result = relation_encode_row(rel, values + i * value_count, records + i * rel->row_length);
+		if (DB_ERROR(result)) {
+			goto errout;
+		}
+	}
+
+	for (attr = list_head(rel->attributes); attr != NULL; attr = attr->next) {
+		if (attr->flags & ATTRIBUTE_FLAG_INVALID) {
+			continue;
+		}
+		if (attr->index == NULL) {
+			index_load(rel, attr);
+		}
+		if (attr->index == NULL || ((index_t *)attr->index)->type != INDEX_INLINE) {
+			continue;
+		}
+
+		/* An inline index searches the tuple file itself, which has to be
+		   ordered by the attribute, so append the rows in that order. */
+		sorted = (unsigned char *)malloc(rel->row_length * count);
+		if (sorted == NULL) {
+			result = DB_ALLOCATION_ERROR;
+			goto errout;
+		}
+		batch_sort(rel, attr, records, count, keys);
+		for (i = 0; i < count; i++) {
+			memcpy(sorted + i * rel->row_length, records + keys[i].row * rel->row_length, rel->row_length);
+		}
+		free(records);
+		records = sorted;
+		break;
+	}
+
+	for (attr = list_head(rel->attributes); attr != NULL; attr = attr->next) {
+		if ((attr->flags & ATTRIBUTE_FLAG_INVALID) || attr->index == NULL || ((index_t *)attr->index)->type == INDEX_INLINE) {
+			continue;
+		}
+
+		batch_sort(rel, attr, records, count, keys);
+		offset = get_attribute_value_offset(rel, attr);
+		for (i = 0; i < count; i++) {
+			db_phy_to_value(&value, attr, records + keys[i].row * rel->row_length + offset);
+			if (DB_ERROR(index_insert(attr->index, &value, rel->next_row + keys[i].row))) {
+				result = DB_INDEX_ERROR;
+				goto errout;
+			}
+		}
+	}
+
+	result = storage_put_rows(rel, records, count);
+
+errout:
+	if (records != NULL) {
+		free(records);
+	}
+	if (keys != NULL) {
+		free(keys);
+	}
+	return result;
+}
+
 /*
  * Update aggregation value whenever each tuple is read.
  */
@@ -686,7 +834,7 @@ static void select_index(db_handle_t **handle)
 	operand_value_t max;
 	attribute_value_t av_min;
 	attribute_value_t av_max;
-	long range;
+	unsigned long range;
 	unsigned long min_range;
 	index = NULL;
 	min_range = ULONG_MAX;
@@ -697,8 +845,9 @@ static void select_index(db_handle_t **handle)
 	while (attr != NULL) {
 		if (attr->index != NULL && !LVM_ERROR(lvm_get_derived_range((*handle)->lvm_instance, attr->name, &min, &max))) {
 			range = (unsigned long)max.l - (unsigned long)min.l;
-			DB_LOG_D("DB: The search range for attribute \"%s\" comprises %ld values\n", attr->name, range + 1);
+			DB_LOG_D("DB: The search range for attribute \"%s\" comprises %lu values\n", attr->name, range + 1);
 			if (range <= min_range) {
+				min_range = range;
 				index = attr->index;
 				av_min.domain = av_max.domain = DOMAIN_INT;
 				VALUE_LONG(&av_min) = min.l;
@@ -767,6 +916,8 @@ static db_result_t generate_selection_result(db_handle_t **handle, relation_t *r
 	relation_t *result_rel;
 	unsigned attribute_count;
 	attribute_t *attr;
+	source_dest_map_t *attr_map_ptr;
+	unsigned i;
 
 	result_rel = (*handle)->result_rel;
 
@@ -802,6 +953,17 @@ static db_result_t generate_selection_result(db_handle_t **handle, relation_t *r
 		}
 	}
 
+	/* Look up the LVM variables of the attributes once, rather than by
+	   name for every tuple. */
+	for (i = 0; i < attribute_count; i++) {
+		attr_map_ptr = &(*handle)->attr_map[i];
+		if ((*handle)->lvm_instance != NULL) {
+			attr_map_ptr->var_id = lvm_get_variable_id((*handle)->lvm_instance, attr_map_ptr->from_attr->name);
+		} else {
+			attr_map_ptr->var_id = LVM_MAX_VARIABLE_ID;
+		}
+	}
+
 	(*handle)->tuple = (tuple_t)malloc(sizeof(char) * result_rel->row_length + 1);
 	if ((*handle)->tuple == NULL) {
 		DB_LOG_E("DB: Failed to malloc tuple row\n");
@@ -909,8 +1071,8 @@ db_result_t relation_process_select(db_handle_t **handle, db_cursor_t *cursor)
 		from_ptr = row + attr_map_ptr->from_offset;
 		from_attr = attr_map_ptr->from_attr;
 
-		if (from_attr->domain == DOMAIN_INT || from_attr->domain == DOMAIN_LONG) {
-			lvm_set_operand_value((*handle)->lvm_instance, from_attr, from_ptr);
+		if (attr_map_ptr->var_id != LVM_MAX_VARIABLE_ID) {
+			lvm_set_operand_value((*handle)->lvm_instance, attr_map_ptr->var_id, from_attr, from_ptr);
 		}
 
 		if (from_attr->flags & ATTRIBUTE_FLAG_NO_STORE) {
@@ -1036,8 +1198,8 @@ db_result_t relation_process_remove(db_handle_t **handle, db_cursor_t *cursor)
 		from_ptr = row + attr_map_ptr->from_offset;
 		from_attr = attr_map_ptr->from_attr;
 
-		if (from_attr->domain == DOMAIN_INT || from_attr->domain == DOMAIN_LONG) {
-			lvm_set_operand_value((*handle)->lvm_instance, from_attr, from_ptr);
+		if (attr_map_ptr->var_id != LVM_MAX_VARIABLE_ID) {
+			lvm_set_operand_value((*handle)->lvm_instance, attr_map_ptr->var_id, from_attr, from_ptr);
 		}
 
 		if (from_attr->flags & ATTRIBUTE_FLAG_NO_STORE) {
@@ -1166,6 +1328,95 @@ db_cursor_t *relation_process_result(db_handle_t *handler)
 	return NULL;
 }
 
+/* Streaming cursor does not collect the result of query before it is returned.
+   The tuples of relation are read and checked one by one as the cursor moves,
+   so the handle of query is kept by the cursor until the cursor is freed. */
+db_cursor_t *relation_process_stream(db_handle_t *handler)
+{
+	db_cursor_t *cursor;
+
+	if (handler->optype != AQL_TYPE_SELECT || (handler->adt_flags & (AQL_FLAG_AGGREGATE | AQL_FLAG_ASSIGN))) {
+		DB_LOG_E("DB: Only a selection without aggregation or assignment can be streamed\n");
+		return NULL;
+	}
+
+	cursor = (db_cursor_t *)malloc(sizeof(db_cursor_t));
+	if (cursor == NULL) {
+		DB_LOG_E("DB: Failed to malloc cursor\n");
+		return NULL;
+	}
+	memset(cursor, 0, sizeof(db_cursor_t));
+
+	if (DB_ERROR(cursor_init_stream(&cursor, handler->rel)) || DB_ERROR(cursor_data_set(cursor, handler->attr_map, handler->result_rel->attribute_count))) {
+		DB_LOG_E("DB: Failed to init cursor and set cursor data\n");
+		cursor_deinit(cursor);
+		return NULL;
+	}
+
+	/* Index iterators keep their position in static data and may hold the
+	   lock of index between calls, so a cursor which can be left at any
+	   row scans the relation instead. */
+	handler->flags &= ~DB_HANDLE_FLAG_SEARCH_INDEX;
+
+	/* Nothing is written to the result relation. */
+	relation_release(handler->result_rel);
+	handler->result_rel = NULL;
+
+	cursor->handle = handler;
+
+	return cursor;
+}
+
+/* Read tuples of relation until one of them fulfills the condition of query. */
+db_result_t relation_process_stream_next(db_cursor_t *cursor)
+{
+	db_result_t result;
+	db_handle_t *handler;
+	source_dest_map_t *attr_map_ptr, *attr_map_end;
+
+	handler = cursor->handle;
+	attr_map_end = handler->attr_map + cursor->attribute_count;
+
+	while (1) {
+		handler->tuple_id++;
+		result = storage_get_row(handler->rel, &handler->tuple_id, cursor->row);
+		if (DB_ERROR(result)) {
+			DB_LOG_E("DB: Failed to get a row in relation %s!\n", handler->rel->name);
+			return result;
+		} else if (result == DB_FINISHED) {
+			/* Stay at the end for the next call. The tuples which are read
+			   after the current one don't match, so read it again. */
+			handler->tuple_id--;
+			if (cursor->cursor_rows > 0 && handler->tuple_id != cursor->current_storage_row) {
+				result = storage_get_row(handler->rel, &cursor->current_storage_row, cursor->row);
+				if (result != DB_OK) {
+					return DB_STORAGE_ERROR;
+				}
+			}
+			return DB_FINISHED;
+		}
+
+		if (handler->lvm_instance == NULL) {
+			break;
+		}
+
+		for (attr_map_ptr = handler->attr_map; attr_map_ptr < attr_map_end; attr_map_ptr++) {
+			if (attr_map_ptr->var_id != LVM_MAX_VARIABLE_ID) {
+				lvm_set_operand_value(handler->lvm_instance, attr_map_ptr->var_id, attr_map_ptr->from_attr, cursor->row + attr_map_ptr->from_offset);
+			}
+		}
+
+		if (lvm_execute(handler->lvm_instance) == TRUE) {
+			break;
+		}
+	}
+
+	cursor->current_storage_row = handler->tuple_id;
+	cursor->total_rows = handler->tuple_id + 1;
+
+	return DB_OK;
+}
+
 db_result_t relation_select(db_handle_t **handle, relation_t *rel, void *adt_ptr)
 {
 	aql_adt_t *adt;
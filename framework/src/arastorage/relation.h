@@ -99,6 +99,9 @@
 /* check current storage row is valid or invalid*/
 #define IS_INVALID_STORAGE_ROW(a) ((a) == NULL || ((a)->current_storage_row >= (a)->total_rows) || (a)->current_storage_row >= DB_CURSOR_RESULT_ENTRY)
 
+/* Check cursor reads the tuples of its query one by one */
+#define IS_STREAM_CURSOR(a) ((a) != NULL && (a)->handle != NULL)
+
 #define RELATION_HAS_TUPLES(rel) ((rel)->tuple_storage >= 0)
 
 /* Specific API will return Below if cursor value is something wrong */
@@ -159,6 +162,8 @@ struct _db_cursor_s {
 	attribute_id_t attribute_count;
 	size_t storage_row_length;
 	uint32_t *row_arr;
+	db_handle_t *handle;		/* The query of a streaming cursor */
+	unsigned char *row;		/* The current tuple of a streaming cursor */
 	unsigned char tuple[DB_MAX_ELEMENT_SIZE + 1];
 	char name[TUPLE_NAME_LENGTH + 1];
 	char rel_name[RELATION_NAME_LENGTH + 1];
@@ -170,6 +175,7 @@ struct _db_cursor_s {
  ****************************************************************************/
 /* Operations for cursor processing */
 db_result_t cursor_init(db_cursor_t **cursor, relation_t *rel);
+db_result_t cursor_init_stream(db_cursor_t **cursor, relation_t *rel);
 db_result_t cursor_load(db_cursor_t **target, db_cursor_t *src);
 db_result_t cursor_data_add(db_cursor_t *cursor, tuple_id_t tuple_id);
 db_result_t cursor_deinit(db_cursor_t *cursor);
@@ -181,6 +187,8 @@ db_result_t relation_deinit(void);
 db_result_t relation_process_remove(db_handle_t **, db_cursor_t *);
 db_result_t relation_process_select(db_handle_t **, db_cursor_t *);
 db_cursor_t *relation_process_result(db_handle_t *);
+db_cursor_t *relation_process_stream(db_handle_t *);
+db_result_t relation_process_stream_next(db_cursor_t *);
 relation_t *relation_load(char *);
 db_result_t relation_release(relation_t *);
 relation_t *relation_create(char *, db_direction_t);
@@ -192,6 +200,7 @@ db_result_t relation_attribute_remove(relation_t *, char *);
 db_result_t relation_set_primary_key(relation_t *, char *);
 db_result_t relation_remove(relation_t *, int);
 db_result_t relation_insert(relation_t *, attribute_value_t *);
+db_result_t relation_insert_batch(relation_t *, attribute_value_t *, unsigned, tuple_id_t);
 db_result_t relation_select(db_handle_t **, relation_t *, void *);
 tuple_id_t relation_cardinality(relation_t *);
 
@@ -61,6 +61,7 @@
 #include "index.h"
 #include "storage.h"
 #include "relation.h"
+#include "lvm.h"
 
 /****************************************************************************
 * Pre-processor Definitions
@@ -91,6 +92,7 @@ struct source_dest_map_s {
 	unsigned from_offset;
 	unsigned to_offset;
 	db_value_type_t valuetype;
+	variable_id_t var_id;		/* The LVM variable of from_attr, if any */
 };
 typedef struct source_dest_map_s source_dest_map_t;
 
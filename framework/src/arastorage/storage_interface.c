@@ -550,6 +550,40 @@ db_result_t storage_put_row(relation_t *rel, storage_row_t row, uint8_t flag)
 	return result;
 }
 
+/* Append a number of consecutive rows to the tuple file with one write. */
+db_result_t storage_put_rows(relation_t *rel, storage_row_t rows, tuple_id_t count)
+{
+	unsigned length;
+
+	length = rel->row_length * count;
+#ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
+	if (length < storage_get_write_buffer_size()) {
+		if (DB_ERROR(storage_write_row(rel->tuple_storage, rows, length, rel->tuple_filename))) {
+			return DB_STORAGE_ERROR;
+		}
+	} else {
+		/* The rows do not fit in the write buffer, the rows already in it
+		   have to be written first to keep the order of the tuples. */
+		if (DB_ERROR(storage_flush_insert_buffer())) {
+			return DB_STORAGE_ERROR;
+		}
+		if (storage_write(rel->tuple_storage, rows, length) != (ssize_t)length) {
+			DB_LOG_E("DB: Failed to store %u bytes\n", length);
+			return DB_STORAGE_ERROR;
+		}
+	}
+#else
+	if (DB_ERROR(storage_write_row(rel->tuple_storage, rows, length, rel->tuple_filename))) {
+		DB_LOG_E("DB: Failed to store %u bytes\n", length);
+		return DB_STORAGE_ERROR;
+	}
+#endif
+
+	rel->cardinality += count;
+	rel->next_row += count;
+	return DB_OK;
+}
+
 db_result_t storage_write_row(db_storage_id_t fd, storage_row_t row, unsigned length, char *filename)
 {
 #ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
@@ -78,6 +78,9 @@ int messaging_cleanup(const char *port_name)
 		return ERROR;
 	}
 
+	/* Close the reply port which was kept for sync send to this port. */
+	messaging_drop_reply_port(port_name);
+
 	ret = FREE_MSG_RECEIVER(port_name);
 	if (ret != OK) {
 		return ERROR;
@@ -95,7 +98,7 @@ int messaging_cleanup(const char *port_name)
 	do {
 		if ((strncmp(port_info->name, port_name, strlen(port_name) + 1) == 0) && (my_pid == port_info->pid)) {
 			cleanup_pid = port_info->pid;
-			mq_close(port_info->mqdes);
+			messaging_close_port(port_info->mqdes);
 			sq_rem((FAR sq_entry_t *)port_info, port_info_list_ptr);
 			MSG_FREE(port_info->data);
 			MSG_FREE(port_info);
@@ -22,6 +22,7 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <mqueue.h>
+#include <semaphore.h>
 #include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
@@ -108,6 +109,96 @@ int messaging_set_notify_signal(int signo, _sa_sigaction_t func)
 	}
 	return OK;
 }
+#ifdef CONFIG_MESSAGING_SHAREDBUF
+static void messaging_sharedbuf_lock(messaging_sharedbuf_t *shared)
+{
+	while (sem_wait(&shared->lock) != OK) {
+		/* Only a signal can interrupt the wait. Try again. */
+	}
+}
+/****************************************************************************
+ * Name : messaging_sharedbuf_create
+ *
+ * Description:
+ *  Create the reference through which a sync message is passed. The sender
+ *  holds it until it has got the reply.
+ ****************************************************************************/
+messaging_sharedbuf_t *messaging_sharedbuf_create(msg_send_data_t *send_data)
+{
+	messaging_sharedbuf_t *shared;
+
+	shared = (messaging_sharedbuf_t *)MSG_ALLOC(sizeof(messaging_sharedbuf_t));
+	if (shared == NULL) {
+		return NULL;
+	}
+	sem_init(&shared->lock, 0, 1);
+	shared->buf = send_data->msg;
+	shared->len = send_data->msglen;
+	shared->refs = 1;
+	shared->copy = NULL;
+
+	return shared;
+}
+/****************************************************************************
+ * Name : messaging_sharedbuf_release
+ *
+ * Description:
+ *  Drop a reference. If the sender drops its reference while the receiver
+ *  still holds one, the message is copied first, because the sender's
+ *  buffer may be reused as soon as the send returns.
+ ****************************************************************************/
+void messaging_sharedbuf_release(messaging_sharedbuf_t *shared, bool sender)
+{
+	uint8_t refs;
+
+	messaging_sharedbuf_lock(shared);
+	refs = --shared->refs;
+	if (sender && refs > 0) {
+		shared->copy = MSG_ALLOC(shared->len);
+		if (shared->copy != NULL) {
+			memcpy(shared->copy, shared->buf, shared->len);
+		} else {
+			msgdbg("[Messaging] out of memory for the copy of a shared message.\n");
+		}
+		shared->buf = shared->copy;
+	}
+	sem_post(&shared->lock);
+
+	if (refs == 0) {
+		sem_destroy(&shared->lock);
+		MSG_FREE(shared->copy);
+		MSG_FREE(shared);
+	}
+}
+/****************************************************************************
+ * Name : messaging_sharedbuf_read
+ *
+ * Description:
+ *  Copy a message passed by reference into the receiver's buffer and drop
+ *  the receiver's reference.
+ ****************************************************************************/
+static int messaging_sharedbuf_read(messaging_sharedbuf_t *shared, char *buf, int buflen)
+{
+	int ret = OK;
+
+	messaging_sharedbuf_lock(shared);
+	if ((int)shared->len > buflen) {
+		/* Like a copied message that does not fit the receive buffer */
+		msgdbg("[Messaging] recv fail : message size %u is bigger than buffer.\n", shared->len);
+		errno = EMSGSIZE;
+		ret = ERROR;
+	} else if (shared->buf == NULL) {
+		errno = ENOMEM;
+		ret = ERROR;
+	} else {
+		memcpy(buf, shared->buf, shared->len);
+	}
+	sem_post(&shared->lock);
+
+	messaging_sharedbuf_release(shared, false);
+	return ret;
+}
+#endif
 /****************************************************************************
  * Name : messaging_parse_packet
  *
@@ -121,6 +212,9 @@ int messaging_parse_packet(char *packet, char *buf, int buflen, pid_t *sender_pi
 	uint32_t parsing_version;
 	int ret = OK;
 	uint32_t offset;
+#ifdef CONFIG_MESSAGING_SHAREDBUF
+	messaging_sharedbuf_t *shared;
+#endif
 
 	my_version = messaging_get_version();
 
@@ -141,6 +235,14 @@ int messaging_parse_packet(char *packet, char *buf, int buflen, pid_t *sender_pi
 	case 1:
 		*sender_pid = ((messaging_packet_t *)packet)->sender_pid;
 		*msg_type = ((messaging_packet_t *)packet)->msg_type;
+#ifdef CONFIG_MESSAGING_SHAREDBUF
+		if (*msg_type & MSG_PACKET_SHAREDBUF) {
+			*msg_type &= ~MSG_PACKET_SHAREDBUF;
+			memcpy(&shared, packet + offset, sizeof(shared));
+			ret = messaging_sharedbuf_read(shared, buf, buflen);
+			break;
+		}
+#endif
 		memcpy(buf, packet + offset, buflen);
 		ret = OK;
 		break;
@@ -152,6 +254,68 @@ int messaging_parse_packet(char *packet, char *buf, int buflen, pid_t *sender_pi
 
 	return ret;
 }
+/****************************************************************************
+ * Name : messaging_packet_size
+ *
+ * Description:
+ *  Return the size of a received packet as if the message was copied in it.
+ ****************************************************************************/
+int messaging_packet_size(char *packet, int size)
+{
+#ifdef CONFIG_MESSAGING_SHAREDBUF
+	messaging_packet_t *header = (messaging_packet_t *)packet;
+	messaging_sharedbuf_t *shared;
+
+	if (header->msg_type & MSG_PACKET_SHAREDBUF) {
+		memcpy(&shared, packet + header->offset, sizeof(shared));
+		return header->offset + shared->len;
+	}
+#endif
+
+	return size;
+}
+/****************************************************************************
+ * Name : messaging_close_port
+ *
+ * Description:
+ *  Close a receiver port which is going away. The messages passed by
+ *  reference which are left in it are never read, so the references they
+ *  hold are dropped here.
+ ****************************************************************************/
+void messaging_close_port(mqd_t mqdes)
+{
+#ifdef CONFIG_MESSAGING_SHAREDBUF
+	struct mq_attr attr;
+	struct mq_attr oldattr;
+	messaging_packet_t *header;
+	messaging_sharedbuf_t *shared;
+	char *packet;
+
+	if (mq_getattr(mqdes, &attr) != OK || attr.mq_curmsgs == 0) {
+		goto close_port;
+	}
+
+	packet = (char *)MSG_ALLOC(attr.mq_msgsize);
+	if (packet == NULL) {
+		msgdbg("[Messaging] out of memory for draining the port.\n");
+		goto close_port;
+	}
+
+	attr.mq_flags = O_NONBLOCK;
+	(void)mq_setattr(mqdes, &attr, &oldattr);
+	while (mq_receive(mqdes, packet, attr.mq_msgsize, 0) > 0) {
+		header = (messaging_packet_t *)packet;
+		if (header->msg_type & MSG_PACKET_SHAREDBUF) {
+			memcpy(&shared, packet + header->offset, sizeof(shared));
+			messaging_sharedbuf_release(shared, false);
+		}
+	}
+	MSG_FREE(packet);
+
+close_port:
+#endif
+	mq_close(mqdes);
+}
 /****************************************************************************
  * Name : messaging_set_notification
  * 
@@ -261,7 +425,7 @@ void messaging_run_callback(int signo, siginfo_t *data)
 errout_with_recv_packet:
 	MSG_FREE(recv_packet);
 errout_with_mq_close:
-	mq_close(recv_info->mqdes);
+	messaging_close_port(recv_info->mqdes);
 errout_with_recv_info:
 	MSG_FREE(recv_info);
 }
@@ -17,9 +17,13 @@
  ****************************************************************************/
 #include <tinyara/compiler.h>
 #include <mqueue.h>
+#include <semaphore.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <queue.h>
+#include <sys/prctl.h>
 #include <messaging/messaging.h>
 
 
@@ -46,6 +50,22 @@ struct messaging_packet_s {
 typedef struct messaging_packet_s messaging_packet_t;
 #define MSG_HEADER_SIZE (sizeof(messaging_packet_t) - sizeof(char *)) /* Messaging Version 1 */
 
+/* A synchronous message passed by reference has this bit set in msg_type
+ * and a pointer to a messaging_sharedbuf_t in place of the message.  The
+ * sender and the receiver each hold a reference.  If the sender drops its
+ * reference before the receiver has read the message, the message is
+ * copied into 'copy' so that buf stays valid for the receiver.
+ */
+#define MSG_PACKET_SHAREDBUF 0x80000000
+struct messaging_sharedbuf_s {
+	sem_t lock;
+	const void *buf;
+	uint32_t len;
+	uint8_t refs;
+	void *copy;
+};
+typedef struct messaging_sharedbuf_s messaging_sharedbuf_t;
+
 #define MAX_PORT_NAME_SIZE 64
 
 /**
@@ -66,6 +86,10 @@ typedef enum msg_info_type_e msg_info_type_t;
 #define READ_MSG_RECEIVER(port_name, recv_arr, recv_cnt)  messaging_handle_data(MSG_INFO_READ, port_name, recv_arr, &recv_cnt)
 #define FREE_MSG_RECEIVER(port_name)  messaging_handle_data(MSG_INFO_REMOVE, port_name, NULL, NULL)
 
+#define SAVE_MSG_REPLY_PORT(port_name, mqdes, msgsize)  prctl(PR_MSG_REPLY_SAVE, port_name, mqdes, msgsize)
+#define READ_MSG_REPLY_PORT(port_name, mqdes, msgsize)  prctl(PR_MSG_REPLY_READ, port_name, &mqdes, &msgsize)
+#define FREE_MSG_REPLY_PORT(port_name)  prctl(PR_MSG_REPLY_REMOVE, port_name)
+
 /**
  * @brief The type of sending message
  * @details MSG_SEND_SYNC : Unicast send message type with sync mode\n
@@ -121,11 +145,11 @@ int messaging_handle_data(msg_info_type_t type, const char *port_name, int *data
 /**
  * @brief Internal function for unicast and multicast send APIs.
  */
-int messaging_send_internal(const char *port_name, msg_send_type_t msg_type, msg_send_data_t *send_data, msg_recv_buf_t *recv_data, msg_callback_info_t *cb_info);
+int messaging_send_internal(const char *port_name, msg_send_type_t msg_type, msg_send_data_t *send_data, msg_recv_buf_t *recv_data, msg_callback_info_t *cb_info, messaging_sharedbuf_t *shared);
 /**
  * @brief Internal function for sending message packet which has header and message.
  */
-int messaging_send_packet(const char *port_name, msg_send_type_t msg_type, msg_send_data_t *send_data, msg_callback_info_t *cb_info);
+int messaging_send_packet(const char *port_name, msg_send_type_t msg_type, msg_send_data_t *send_data, msg_callback_info_t *cb_info, messaging_sharedbuf_t *shared);
 /**
  * @brief Internal function for receiving APIs.
  */
@@ -138,6 +162,28 @@ void messaging_run_callback(int signo, siginfo_t *data);
  * @brief Internal function for parsing received packet
  */
 int messaging_parse_packet(char *packet, char *buf, int buflen, pid_t *sender_pid, int *msg_type);
+/**
+ * @brief Internal function for getting the size of a received packet as if the message was in it
+ */
+int messaging_packet_size(char *packet, int size);
+#ifdef CONFIG_MESSAGING_SHAREDBUF
+/**
+ * @brief Internal function for passing a sync message by reference
+ */
+messaging_sharedbuf_t *messaging_sharedbuf_create(msg_send_data_t *send_data);
+/**
+ * @brief Internal function for dropping a reference to a message passed by reference
+ */
+void messaging_sharedbuf_release(messaging_sharedbuf_t *shared, bool sender);
+#endif
+/**
+ * @brief Internal function for closing a receiver port and dropping the references of its unread messages
+ */
+void messaging_close_port(mqd_t mqdes);
+/**
+ * @brief Internal function for closing the reply port which is kept for sync send
+ */
+void messaging_drop_reply_port(const char *port_name);
 /**
  * @brief Internal function for getting g_port_info_list
  */
@@ -65,6 +65,7 @@ static int messaging_rcv_nonblock(mqd_t mqdes, const char *port_name, msg_recv_b
 {
 	int ret;
 	ssize_t recv_size_chk;
+	int packet_size;
 	msg_recv_info_t *nonblock_data;
 	msg_port_info_t *port_info = NULL;
 	int recv_size;
@@ -82,12 +83,14 @@ static int messaging_rcv_nonblock(mqd_t mqdes, const char *port_name, msg_recv_b
 	while (1) {
 		recv_size_chk = mq_receive(mqdes, (char *)recv_packet, recv_size, 0);
 		if (recv_size_chk > 0 && recv_size_chk <= recv_size) {
+			/* The size of a message passed by reference is only known before it is parsed. */
+			packet_size = messaging_packet_size(recv_packet, recv_size_chk);
 			ret = messaging_parse_packet(recv_packet, recv_buf->buf, recv_buf->buflen, &recv_buf->sender_pid, &msg_type);
 			if (ret != OK) {
 				MSG_FREE(recv_packet);
 				goto errout_with_mq;
 			}
-			recv_buf->buflen = recv_size_chk;
+			recv_buf->buflen = packet_size;
 			(*cb_info->cb_func)(msg_type, recv_buf, cb_info->cb_data);
 		} else if (recv_size_chk == ERROR && errno == EAGAIN) {
 			msgdbg("[Messaging] recv : empty queue, but NONBLOCK mode.\n");
@@ -143,7 +146,7 @@ errout_with_msg:
 	sq_rem((FAR sq_entry_t *)port_info, &g_port_info_list);
 	MSG_FREE(port_info);
 errout_with_mq:
-	mq_close(mqdes);
+	messaging_close_port(mqdes);
 	MSG_ASPRINTF(&internal_portname, "%s%d", port_name, getpid());
 	mq_unlink(internal_portname);
 	MSG_FREE(internal_portname);
@@ -196,7 +199,7 @@ static int messaging_rcv_block(mqd_t mqdes, const char *port_name, msg_recv_buf_
 
 cleanup_return:
 	MSG_FREE(recv_packet);
-	mq_close(mqdes);
+	messaging_close_port(mqdes);
 	MSG_ASPRINTF(&internal_portname, "%s%d", port_name, getpid());
 	mq_unlink(internal_portname);
 	MSG_FREE(internal_portname);
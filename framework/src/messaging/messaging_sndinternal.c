@@ -23,6 +23,7 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <mqueue.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
@@ -56,6 +57,11 @@ static int messaging_set_async_callback(const char *port_name, msg_recv_buf_t *r
 	internal_attr.mq_msgsize = recv_size;
 	internal_attr.mq_flags = 0;
 
+	/* The async reply port has the same name as the port kept for sync send,
+	 * and it is unlinked after the reply.  So stop keeping the sync one.
+	 */
+	messaging_drop_reply_port(port_name);
+
 	/* Sender waits the reply with "port_name + sender_pid + _r". */
 	MSG_ASPRINTF(&reply_portname, "%s%d%s", port_name, getpid(), "_r");
 	if (reply_portname == NULL) {
@@ -100,11 +106,12 @@ static int messaging_set_async_callback(const char *port_name, msg_recv_buf_t *r
  *  msg       : The message to be sent
  *  msglen    : The length of message to be sent
  *  priority  : A non-negative integer that specifies the priority of this message
+ *  shared    : The reference to pass instead of the message, or NULL to copy it
  * 
  * Return Value:
  *  On success, 0 (OK) is returned.; On failure, -1 (ERROR) is returned.
  ****************************************************************************/
-int messaging_send_packet(const char *port_name, msg_send_type_t msg_type, msg_send_data_t *send_data, msg_callback_info_t *cb_info)
+int messaging_send_packet(const char *port_name, msg_send_type_t msg_type, msg_send_data_t *send_data, msg_callback_info_t *cb_info, messaging_sharedbuf_t *shared)
 {
 	int ret = OK;
 	mqd_t mqdes;
@@ -115,7 +122,11 @@ int messaging_send_packet(const char *port_name, msg_send_type_t msg_type, msg_s
 	uint32_t msg_offset;
 	uint32_t msg_version;
 
-	send_size = MSG_HEADER_SIZE + send_data->msglen;
+	if (shared != NULL) {
+		send_size = MSG_HEADER_SIZE + sizeof(messaging_sharedbuf_t *);
+	} else {
+		send_size = MSG_HEADER_SIZE + send_data->msglen;
+	}
 
 	internal_attr.mq_maxmsg = CONFIG_MESSAGING_MAXMSG;
 	internal_attr.mq_msgsize = send_size;
@@ -162,14 +173,28 @@ int messaging_send_packet(const char *port_name, msg_send_type_t msg_type, msg_s
 	} else {
 		send_type = MSG_REPLY_REQUIRED;
 	}
+	if (shared != NULL) {
+		send_type |= MSG_PACKET_SHAREDBUF;
+	}
 	((messaging_packet_t *)send_packet)->msg_type = send_type;
 
-	/* Copy the real send message. */
-	memcpy(send_packet + msg_offset, send_data->msg, send_data->msglen);
+	if (shared != NULL) {
+		/* Pass the reference instead of the message. The receiver holds it
+		 * from now on.
+		 */
+		memcpy(send_packet + msg_offset, &shared, sizeof(shared));
+		shared->refs++;
+	} else {
+		/* Copy the real send message. */
+		memcpy(send_packet + msg_offset, send_data->msg, send_data->msglen);
+	}
 
 	ret = mq_send(mqdes, (char *)send_packet, send_size, send_data->priority);
 	if (ret != OK) {
 		msgdbg("[Messaging] send fail : errno %d.\n", errno);
+		if (shared != NULL) {
+			shared->refs--;
+		}
 		MSG_FREE(send_packet);
 		mq_close(mqdes);
 		mq_unlink(port_name);
@@ -199,12 +224,13 @@ static void messaging_init_recv_arr(int *arr)
  *  msg       : The message to be sent
  *  msglen    : The length of message to be sent
  *  priority  : A non-negative integer that specifies the priority of this message
+ *  shared    : The reference to pass instead of the message, or NULL to copy it
  * 
  * Return Value:
  *  On success, the number of waiting receivers is returned.
  *  On failure, -1 (ERROR) is returned.
  ****************************************************************************/
-int messaging_send_internal(const char *port_name, msg_send_type_t msg_type, msg_send_data_t *send_data, msg_recv_buf_t *recv_data, msg_callback_info_t *cb_info)
+int messaging_send_internal(const char *port_name, msg_send_type_t msg_type, msg_send_data_t *send_data, msg_recv_buf_t *recv_data, msg_callback_info_t *cb_info, messaging_sharedbuf_t *shared)
 {
 	int recv_idx;
 	int ret = ERROR;
@@ -244,9 +270,9 @@ int messaging_send_internal(const char *port_name, msg_send_type_t msg_type, msg
 						return ERROR;
 					}
 				}
-				ret = messaging_send_packet(private_portname, msg_type, send_data, cb_info);
+				ret = messaging_send_packet(private_portname, msg_type, send_data, cb_info, NULL);
 			} else {
-				ret = messaging_send_packet(private_portname, msg_type, send_data, NULL);
+				ret = messaging_send_packet(private_portname, msg_type, send_data, NULL, shared);
 			}
 			MSG_FREE(private_portname);
 		}
@@ -47,46 +47,105 @@ static int messaging_send_param_validation(const char *port_name, msg_send_data_
 
 	return OK;
 }
-static int messaging_sync_recv(const char *port_name, msg_recv_buf_t *reply_buf)
+static int messaging_open_reply_port(const char *port_name, int reply_size, mqd_t *reply_mqdes)
 {
-	int ret = OK;
-	mqd_t sync_mqdes;
-	char *sync_portname;
+	mqd_t mqdes;
+	char *reply_portname;
 	struct mq_attr internal_attr;
-	char *reply_data;
-	int reply_size;
-	int msg_type;
-
-	reply_size = reply_buf->buflen + MSG_HEADER_SIZE;
 
 	internal_attr.mq_maxmsg = CONFIG_MESSAGING_MAXMSG;
 	internal_attr.mq_msgsize = reply_size;
 	internal_attr.mq_flags = 0;
 
-	/* sender waits the reply with "port_name + sender_pid + _r". */
-	MSG_ASPRINTF(&sync_portname, "%s%d%s", port_name, getpid(), "_r");
-	if (sync_portname == NULL) {
+	/* Sender waits the reply with "port_name + sender_pid + _r". */
+	MSG_ASPRINTF(&reply_portname, "%s%d%s", port_name, getpid(), "_r");
+	if (reply_portname == NULL) {
 		msgdbg("message send fail : sync portname allocation fail.\n");
 		return ERROR;
 	}
-	sync_mqdes = mq_open(sync_portname, O_RDONLY | O_CREAT, 0666, &internal_attr);
-	if (sync_mqdes == (mqd_t)ERROR) {
+
+	/* The name can be left over from an exited task with the same pid. Start
+	 * with a new queue so that no stale reply is received.
+	 */
+	mqdes = mq_open(reply_portname, O_RDONLY | O_CREAT | O_EXCL, 0666, &internal_attr);
+	if (mqdes == (mqd_t)ERROR && errno == EEXIST) {
+		mq_unlink(reply_portname);
+		mqdes = mq_open(reply_portname, O_RDONLY | O_CREAT | O_EXCL, 0666, &internal_attr);
+	}
+	if (mqdes == (mqd_t)ERROR) {
 		msgdbg("message send fail : sync open fail %d.\n", errno);
-		MSG_FREE(sync_portname);
+		MSG_FREE(reply_portname);
 		return ERROR;
 	}
 
+	/* Keep the reply port for the next sync send. It is closed and unlinked when the task exits. */
+	if (SAVE_MSG_REPLY_PORT(port_name, mqdes, reply_size) != OK) {
+		msgdbg("message send fail : sync port saving fail.\n");
+		mq_close(mqdes);
+		mq_unlink(reply_portname);
+		MSG_FREE(reply_portname);
+		return ERROR;
+	}
+
+	MSG_FREE(reply_portname);
+	*reply_mqdes = mqdes;
+	return OK;
+}
+
+static int messaging_get_reply_port(const char *port_name, int reply_size, mqd_t *reply_mqdes, int *port_size)
+{
+	int ret;
+	mqd_t mqdes;
+	int msgsize;
+
+	ret = READ_MSG_REPLY_PORT(port_name, mqdes, msgsize);
+	if (ret == OK) {
+		if (msgsize >= reply_size) {
+			*reply_mqdes = mqdes;
+			*port_size = msgsize;
+			return OK;
+		}
+
+		/* The kept port is too small for this reply. Make a larger one. */
+		messaging_drop_reply_port(port_name);
+	}
+
+	*port_size = reply_size;
+	return messaging_open_reply_port(port_name, reply_size, reply_mqdes);
+}
+
+static int messaging_sync_recv(const char *port_name, mqd_t sync_mqdes, int reply_size, msg_recv_buf_t *reply_buf)
+{
+	int ret = OK;
+	char *reply_data;
+	int msg_type;
+
+	/* mq_receive() takes a buffer of the message size of the port, which
+	 * may be larger than this reply buffer if the port was kept from an
+	 * earlier send.
+	 */
 	reply_data = (char *)MSG_ALLOC(reply_size);
 	if (reply_data == NULL) {
 		msgdbg("message send fail : out of memory for including header\n");
-		mq_close(sync_mqdes);
-		mq_unlink(sync_portname);
+		messaging_drop_reply_port(port_name);
 		return ERROR;
 	}
 
-	ret = mq_receive(sync_mqdes, reply_data, reply_size, 0);
+	/* The receiver may still read the message from our buffer, so do not
+	 * give up the wait because of a signal.
+	 */
+	do {
+		ret = mq_receive(sync_mqdes, reply_data, reply_size, 0);
+	} while (ret < 0 && errno == EINTR);
+
 	if (ret < 0) {
 		msgdbg("message send fail : sync recv fail %d.\n", errno);
+		/* A late reply must not be taken as the reply of the next send. */
+		messaging_drop_reply_port(port_name);
+		ret = ERROR;
+	} else if (ret - (int)MSG_HEADER_SIZE > reply_buf->buflen) {
+		msgdbg("message send fail : reply size %d is bigger than buffer.\n", ret - (int)MSG_HEADER_SIZE);
+		errno = EMSGSIZE;
 		ret = ERROR;
 	} else {
 		ret = messaging_parse_packet(reply_data, reply_buf->buf, reply_buf->buflen, &reply_buf->sender_pid, &msg_type);
@@ -95,10 +154,7 @@ static int messaging_sync_recv(const char *port_name, msg_recv_buf_t *reply_buf)
 		}
 	}
 
-	mq_close(sync_mqdes);
-	mq_unlink(sync_portname);
 	MSG_FREE(reply_data);
-	MSG_FREE(sync_portname);
 
 	return ret;
 }
@@ -106,12 +162,38 @@ static int messaging_sync_recv(const char *port_name, msg_recv_buf_t *reply_buf)
 /****************************************************************************
  * public functions
  ****************************************************************************/
+/****************************************************************************
+ * messaging_drop_reply_port
+ ****************************************************************************/
+void messaging_drop_reply_port(const char *port_name)
+{
+	mqd_t mqdes;
+	int msgsize;
+	char *reply_portname;
+
+	if (READ_MSG_REPLY_PORT(port_name, mqdes, msgsize) != OK) {
+		return;
+	}
+
+	(void)FREE_MSG_REPLY_PORT(port_name);
+	mq_close(mqdes);
+
+	MSG_ASPRINTF(&reply_portname, "%s%d%s", port_name, getpid(), "_r");
+	if (reply_portname != NULL) {
+		mq_unlink(reply_portname);
+		MSG_FREE(reply_portname);
+	}
+}
+
 /****************************************************************************
  * messaging_send_sync
  ****************************************************************************/
 int messaging_send_sync(const char *port_name, msg_send_data_t *send_data, msg_recv_buf_t *reply_buf)
 {
 	int ret;
+	mqd_t sync_mqdes;
+	int sync_size;
+	messaging_sharedbuf_t *shared = NULL;
 
 	ret = messaging_send_param_validation(port_name, send_data);
 	if (ret == ERROR) {
@@ -123,17 +205,38 @@ int messaging_send_sync(const char *port_name, msg_send_data_t *send_data, msg_r
 		return ERROR;
 	}
 
-	ret = messaging_send_internal(port_name, MSG_SEND_SYNC, send_data, NULL, NULL);
-	if (ret == ERROR) {
+	/* Get the reply port before sending, so that it exists when the receiver replies. */
+	ret = messaging_get_reply_port(port_name, reply_buf->buflen + MSG_HEADER_SIZE, &sync_mqdes, &sync_size);
+	if (ret != OK) {
 		return ERROR;
 	}
 
-	ret = messaging_sync_recv(port_name, reply_buf);
+#ifdef CONFIG_MESSAGING_SHAREDBUF
+	/* A large message is read by the receiver straight from our buffer.
+	 * It falls back to a copy if the reference can not be allocated.
+	 */
+	if (send_data->msglen >= CONFIG_MESSAGING_SHAREDBUF_THRESHOLD && send_data->msglen >= (int)sizeof(messaging_sharedbuf_t *)) {
+		shared = messaging_sharedbuf_create(send_data);
+	}
+#endif
+
+	ret = messaging_send_internal(port_name, MSG_SEND_SYNC, send_data, NULL, NULL, shared);
+	if (ret != ERROR) {
+		ret = messaging_sync_recv(port_name, sync_mqdes, sync_size, reply_buf);
+	}
+
+#ifdef CONFIG_MESSAGING_SHAREDBUF
+	/* If the receiver has not read the message yet, it gets a copy. */
+	if (shared != NULL) {
+		messaging_sharedbuf_release(shared, true);
+	}
+#endif
+
 	if (ret != OK) {
 		return ERROR;
 	}
 
-	return OK;	
+	return OK;
 }
 
 /****************************************************************************
@@ -158,7 +261,7 @@ int messaging_send_async(const char *port_name, msg_send_data_t *send_data, msg_
 		return ERROR;
 	}
 
-	ret = messaging_send_internal(port_name, MSG_SEND_ASYNC, send_data, reply_buf, cb_info);
+	ret = messaging_send_internal(port_name, MSG_SEND_ASYNC, send_data, reply_buf, cb_info, NULL);
 	if (ret == ERROR) {
 		return ERROR;
 	}
@@ -182,7 +285,7 @@ int messaging_send(const char *port_name, msg_send_data_t *send_data)
 		return ERROR;
 	}
 
-	ret = messaging_send_internal(port_name, MSG_SEND_NOREPLY, send_data, NULL, NULL);
+	ret = messaging_send_internal(port_name, MSG_SEND_NOREPLY, send_data, NULL, NULL, NULL);
 	if (ret == ERROR) {
 		return ERROR;
 	}
@@ -214,7 +317,7 @@ int messaging_reply(const char *port_name, pid_t sender_pid, msg_send_data_t *re
 	reply.msg = reply_data->msg;
 	reply.msglen = reply_data->msglen;
 	reply.priority = MSG_REPLY_PRIO;
-	ret = messaging_send_packet(reply_portname, MSG_SEND_REPLY, &reply, NULL);
+	ret = messaging_send_packet(reply_portname, MSG_SEND_REPLY, &reply, NULL, NULL);
 	MSG_FREE(reply_portname);
 	return ret;
 }
@@ -115,6 +115,7 @@ int sem_init(FAR sem_t *sem, int pshared, unsigned int value)
 #endif
 
 		sem->flags = FLAGS_INITIALIZED;
+		sem->waitlist = NULL;
 
 		/* Initialize to support priority inheritance */
 
@@ -0,0 +1,62 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <semaphore.h>
+#include <syscall.h>
+
+#include <tinyara/semaphore.h>
+
+#if defined(CONFIG_BUILD_PROTECTED) && !defined(__KERNEL__)
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sem_post
+ *
+ * Description:
+ *   The user space sem_post() of the protected build.  The count is given
+ *   back in user space; the system call is only made when a task waits
+ *   for the semaphore or the semaphore does not allow the fast path.
+ *
+ * Parameters:
+ *   sem - Semaphore descriptor.
+ *
+ * Return Value:
+ *   As for the sem_post() system call.
+ *
+ ****************************************************************************/
+
+int sem_post(FAR sem_t *sem)
+{
+	if (sem_fastgive(sem)) {
+		return OK;
+	}
+
+	return (int)sys_call1((unsigned int)SYS_sem_post, (uintptr_t)sem);
+}
+
+#endif							/* CONFIG_BUILD_PROTECTED && !__KERNEL__ */
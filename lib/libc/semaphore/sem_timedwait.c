@@ -0,0 +1,64 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <time.h>
+#include <semaphore.h>
+#include <syscall.h>
+
+#include <tinyara/semaphore.h>
+
+#if defined(CONFIG_BUILD_PROTECTED) && !defined(__KERNEL__)
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sem_timedwait
+ *
+ * Description:
+ *   The user space sem_timedwait() of the protected build.  An available
+ *   count is taken in user space; as allowed by POSIX, abstime is then not
+ *   checked.
+ *
+ * Parameters:
+ *   sem     - Semaphore descriptor.
+ *   abstime - The absolute time to wait until a timeout is declared.
+ *
+ * Return Value:
+ *   As for the sem_timedwait() system call.
+ *
+ ****************************************************************************/
+
+int sem_timedwait(FAR sem_t *sem, FAR const struct timespec *abstime)
+{
+	if (sem_fasttake(sem)) {
+		return OK;
+	}
+
+	return (int)sys_call2((unsigned int)SYS_sem_timedwait, (uintptr_t)sem, (uintptr_t)abstime);
+}
+
+#endif							/* CONFIG_BUILD_PROTECTED && !__KERNEL__ */
@@ -36,6 +36,14 @@
 #define TTRACE_EVENT_TYPE_END      'e'
 #define TTRACE_EVENT_TYPE_SCHED    's'
 
+/* The trace points in kernel space record into the binary event ring
+ * directly instead of writing to the T-trace device.
+ */
+
+#if defined(CONFIG_TTRACE_EVENTS) && (!defined(CONFIG_BUILD_PROTECTED) || defined(__KERNEL__))
+#define TTRACE_DIRECT 1
+#endif
+
 /****************************************************************************
  * Private Type Declarations
  ****************************************************************************/
@@ -68,6 +76,7 @@ int fd = -1;
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
+#ifndef TTRACE_DIRECT
 static int is_fd_available(void)
 {
 	if (fd < 0) {
@@ -219,12 +228,16 @@ static int create_packet_uid(struct trace_packet *packet, char type, int8_t uniq
 
 	return ret;
 }
+#endif
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 int trace_sched(struct tcb_s *prev_tcb, struct tcb_s *next_tcb)
 {
+#ifdef TTRACE_DIRECT
+	return ttrace_event_sched(prev_tcb, next_tcb);
+#else
 	int ret = TTRACE_VALID;
 	int tag = TTRACE_TAG_TASK;
 	struct trace_packet packet;
@@ -245,7 +258,7 @@ int trace_sched(struct tcb_s *prev_tcb, struct tcb_s *next_tcb)
 	ret = send_packet_sched(&packet);
 
 	return ret;
-
+#endif
 }
 
 /****************************************************************************
@@ -263,6 +276,17 @@ int trace_begin(int tag, char *str, ...)
 	struct trace_packet packet;
 	va_list ap;
 
+#ifdef TTRACE_DIRECT
+	if (!ttrace_tag_enabled(tag)) {
+		return TTRACE_INVALID;
+	}
+
+	va_start(ap, str);
+	vsnprintf(packet.msg.message, TTRACE_EVENT_MSG_BYTES + 1, str, ap);
+	va_end(ap);
+
+	ret = ttrace_event_begin(tag, packet.msg.message);
+#else
 	if (is_fd_available() < 0 || !is_tag_available(tag)) {
 		return TTRACE_INVALID;
 	}
@@ -279,12 +303,16 @@ int trace_begin(int tag, char *str, ...)
 #endif
 
 	ret = send_packet(&packet);
+#endif
 
 	return ret;
 }
 
 int trace_begin_uid(int tag, int8_t uniqueid)
 {
+#ifdef TTRACE_DIRECT
+	return ttrace_event_begin_uid(tag, uniqueid);
+#else
 	int ret = TTRACE_VALID;
 	struct trace_packet packet;
 
@@ -304,6 +332,7 @@ int trace_begin_uid(int tag, int8_t uniqueid)
 	ret = send_packet(&packet);
 
 	return ret;
+#endif
 }
 
 /****************************************************************************
@@ -318,6 +347,9 @@ int trace_begin_uid(int tag, int8_t uniqueid)
 
 int trace_end(int tag)
 {
+#ifdef TTRACE_DIRECT
+	return ttrace_event_end(tag);
+#else
 	int ret = TTRACE_VALID;
 	struct trace_packet packet;
 
@@ -337,6 +369,7 @@ int trace_end(int tag)
 	ret = send_packet(&packet);
 
 	return ret;
+#endif
 }
 
 int trace_end_uid(int tag)
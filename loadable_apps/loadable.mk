@@ -33,7 +33,7 @@ LDLIBS += $(LIBGCC)
 OBJCOPY = $(CROSSDEV)objcopy
 
 ifeq ($(CONFIG_COMPRESSED_BINARY),y)
-COMPRESSION_TYPE = $(CONFIG_COMPRESSION_TYPE)
+COMPRESSION_TYPE ?= $(CONFIG_COMPRESSION_TYPE)
 BLOCK_SIZE = $(CONFIG_COMPRESSION_BLOCK_SIZE)
 else
 COMPRESSION_TYPE = 0
@@ -2532,12 +2532,11 @@ static void imxrt_asynch_completion(struct imxrt_epinfo_s *epinfo)
 		nbytes = (ssize_t) result;
 	}
 
-	uaw = (usb_asynch_work *)kmm_malloc(sizeof(usb_asynch_work));
+	uaw = (usb_asynch_work *)kmm_zalloc(sizeof(usb_asynch_work));
 	if (!uaw) {
 		udbg("Failed to alloc uaw\n");
 		return;
 	}
-	memset(uaw, 0, sizeof(usb_asynch_work));
 	uaw->nbytes = nbytes;
 	uaw->arg = arg;
 	uaw->callback = callback;
@@ -164,12 +164,10 @@ static off_t elf_cache_read_block(int filfd, uint16_t binary_header_size, FAR ui
 	}
 #ifdef CONFIG_COMPRESSED_BINARY
 	else {
-		if (elf_compress_type == CONFIG_COMPRESSION_TYPE) {
-			/* Read readsize bytes from offset from uncompressed file into user buffer */
-			nbytes = compress_read(filfd, binary_header_size, buf, readsize, rpos - binary_header_size);
-		} else {
-			berr("No support for decompression of compression format %d of this binary\n", elf_compress_type);
-		}
+		/* Read readsize bytes from offset from uncompressed file into user buffer.
+		 * The compression format was checked by compress_init().
+		 */
+		nbytes = compress_read(filfd, binary_header_size, buf, readsize, rpos - binary_header_size);
 	}
 #endif
 
@@ -0,0 +1,160 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <tinyara/config.h>
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <tinyara/binfmt/compression/compress_read.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Each sequence of an LZ4 block is a token, whose high nibble is the number
+ * of literals and whose low nibble is the match length minus LZ4_MINMATCH,
+ * the literals, then the 16 bits little endian offset of the match.  A
+ * nibble of LZ4_RUNMASK is followed by bytes adding to it, up to the first
+ * byte which is not 255.  The last sequence has literals only.
+ */
+
+#define LZ4_MINMATCH  4
+#define LZ4_RUNMASK   15
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lz4_getlength
+ *
+ * Description:
+ *   Add the extension bytes of a literal or match length to 'length'
+ *
+ * Returned Value:
+ *   OK (0) on Success
+ *   ERROR (-1) if the input ends or the length is larger than 'limit'
+ ****************************************************************************/
+static int lz4_getlength(FAR const uint8_t **ip, FAR const uint8_t *iend, FAR unsigned int *length, unsigned int limit)
+{
+	uint8_t byte;
+
+	do {
+		if (*ip >= iend) {
+			return ERROR;
+		}
+		byte = *(*ip)++;
+		*length += byte;
+		if (*length > limit) {
+			return ERROR;
+		}
+	} while (byte == 255);
+
+	return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lz4_decompress
+ *
+ * Description:
+ *   Decompress the LZ4 block of 'srclen' bytes in 'src' into 'dst' of
+ *   'dstlen' bytes.  Every length and offset is checked against both
+ *   buffers, so a corrupted block can not make it read or write out of
+ *   them.
+ *
+ * Returned Value:
+ *   Number of bytes written into dst on Success
+ *   ERROR (-1) if the block is corrupted or does not fit in dst
+ ****************************************************************************/
+int lz4_decompress(FAR const uint8_t *src, unsigned int srclen, FAR uint8_t *dst, unsigned int dstlen)
+{
+	FAR const uint8_t *ip = src;
+	FAR const uint8_t *iend = src + srclen;
+	FAR uint8_t *op = dst;
+	FAR uint8_t *oend = dst + dstlen;
+	FAR const uint8_t *match;
+	unsigned int token;
+	unsigned int length;
+	unsigned int offset;
+
+	while (ip < iend) {
+		token = *ip++;
+
+		/* Copy the literals */
+		length = token >> 4;
+		if (length == LZ4_RUNMASK && lz4_getlength(&ip, iend, &length, dstlen) < 0) {
+			goto error;
+		}
+		if (length > (unsigned int)(iend - ip) || length > (unsigned int)(oend - op)) {
+			goto error;
+		}
+		memcpy(op, ip, length);
+		ip += length;
+		op += length;
+
+		/* The last sequence ends the block right after its literals */
+		if (ip == iend) {
+			break;
+		}
+
+		/* Copy the match, byte per byte when it overlaps the output */
+		if (iend - ip < 2) {
+			goto error;
+		}
+		offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+		if (offset == 0 || offset > (unsigned int)(op - dst)) {
+			goto error;
+		}
+
+		length = token & LZ4_RUNMASK;
+		if (length == LZ4_RUNMASK && lz4_getlength(&ip, iend, &length, dstlen) < 0) {
+			goto error;
+		}
+		length += LZ4_MINMATCH;
+		if (length > (unsigned int)(oend - op)) {
+			goto error;
+		}
+
+		match = op - offset;
+		if (offset >= length) {
+			memcpy(op, match, length);
+			op += length;
+		} else {
+			while (length-- > 0) {
+				*op++ = *match++;
+			}
+		}
+	}
+
+	return op - dst;
+
+error:
+	bmdbg("Corrupted LZ4 block at input offset %d\n", (int)(ip - src));
+	return ERROR;
+}
@@ -35,6 +35,15 @@
 #include <tinyara/lzma/LzmaLib.h>
 #endif
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Room for the LZMA properties which precede a compressed block, which is
+ * itself never larger than the block size.
+ */
+#define COMPRESS_READ_SLACK	5
+
 /****************************************************************************
  * Private Declarations
  ****************************************************************************/
@@ -59,6 +68,7 @@ static struct s_buffer buffers;
 static int compress_decompress_block(unsigned char *out_buffer, unsigned int *writesize, unsigned char *read_buffer, unsigned int *size, int index)
 {
 	int ret = ERROR;
+	unsigned int blocklen;
 
 #if CONFIG_COMPRESSION_TYPE == 1
 	if (compression_header->compression_format == COMPRESSION_TYPE_LZMA) {
@@ -75,6 +85,28 @@ static int compress_decompress_block(unsigned char *out_buffer, unsigned int *wr
 	}
 #endif
 
+	if (compression_header->compression_format == COMPRESSION_TYPE_LZ4) {
+		/* Only the last block is shorter than blocksize */
+		blocklen = compression_header->binary_size - index * compression_header->blocksize;
+		if (blocklen > compression_header->blocksize) {
+			blocklen = compression_header->blocksize;
+		}
+
+		/* Blocks which do not shrink are stored uncompressed */
+		if (*size == blocklen) {
+			memcpy(out_buffer, read_buffer, blocklen);
+			ret = blocklen;
+		} else {
+			ret = lz4_decompress(read_buffer, *size, out_buffer, blocklen);
+		}
+
+		if (ret != blocklen) {
+			bmdbg("Failure to decompress LZ4 block %d\n", index);
+			return ERROR;
+		}
+		*writesize = ret;
+	}
+
 	return ret;
 }
 
@@ -95,7 +127,7 @@ static void compress_blocks_to_read(int *first_block, int *last_block, int *no_b
 	blocksize = compression_header->blocksize;
 
 	*first_block = offset / blocksize;
-	*last_block = (offset + readsize) / blocksize;
+	*last_block = (offset + readsize - 1) / blocksize;
 	*no_blocks = *last_block - *first_block + 1;
 }
 
@@ -163,7 +195,7 @@ static int compress_parse_header(int filfd, uint16_t offset)
  *   'block_offset' value (positive) on Success
  *   Negative value on Failure
  ****************************************************************************/
-static off_t compress_offset_block(int filfd, uint16_t binary_header_size, int block_number)
+static off_t compress_offset_block(uint16_t binary_header_size, int block_number)
 {
 	off_t position;
 
@@ -173,39 +205,6 @@ static off_t compress_offset_block(int filfd, uint16_t binary_header_size, int b
 	return position;
 }
 
-/****************************************************************************
- * Name: compress_lseek_block
- *
- * Description:
- *   Seek to start of "block_number" block in compressed blocks section
- *
- * Returned Value:
- *   Starting offset (positive) of 'block_number' block in binary on Success
- *   Negative value on Failure
- ****************************************************************************/
-static off_t compress_lseek_block(int filfd, uint16_t binary_header_size, int block_number)
-{
-	off_t rpos;
-	off_t block_offset;
-
-	/* Calculate block offset from start of file for start of 'block_number' block */
-	block_offset = compress_offset_block(filfd, binary_header_size, block_number);
-	if (block_offset < 0) {
-		bmdbg("Incorrect offset for block number %d\n", block_number);
-		return block_offset;
-	}
-
-	/* Seek to location of this block in compressed file */
-	rpos = lseek(filfd, block_offset, SEEK_SET);
-	if (rpos != block_offset) {
-		int errval = get_errno();
-		bmdbg("Failed to seek to position %lu: %d\n", (unsigned long)block_offset, errval);
-		return -errval;
-	}
-
-	return rpos;
-}
-
 /****************************************************************************
  * Name: compress_read_block
  *
@@ -216,42 +215,41 @@ static off_t compress_lseek_block(int filfd, uint16_t binary_header_size, int bl
  *   Number of bytes read into read_buffer on Success
  *   Negative value on Failure
  ****************************************************************************/
-static off_t compress_read_block(int filfd, uint16_t binary_header_size, FAR uint8_t *buf, int block_number)
+static ssize_t compress_read_block(FAR struct file *filep, uint16_t binary_header_size, FAR uint8_t *buf, int block_number)
 {
-	off_t rpos;
-	size_t readsize;
+	ssize_t readsize;
 	ssize_t nbytes;
 	off_t current_block_offset;
 	off_t next_block_offset;
 
+	if (block_number < 0 || block_number >= compression_header->sections - 1) {
+		bmdbg("Block number %d out of range\n", block_number);
+		return ERROR;
+	}
+
 	/* Find out size of 'block_number' block in compressed file. Assign to readsize */
-	next_block_offset = compress_offset_block(filfd, binary_header_size, block_number + 1);
+	next_block_offset = compress_offset_block(binary_header_size, block_number + 1);
 	if (next_block_offset < 0) {
 		bmdbg("Incorrect offset for block number %d\n", block_number + 1);
 		return ERROR;
 	}
 
-	current_block_offset = compress_offset_block(filfd, binary_header_size, block_number);
+	current_block_offset = compress_offset_block(binary_header_size, block_number);
 	if (current_block_offset < 0) {
 		bmdbg("Incorrect offset for block number %d\n", block_number);
 		return ERROR;
 	}
 
 	readsize = next_block_offset - current_block_offset;
-	if (readsize < 0) {
-		bmdbg("Incorrect readsize %d for block, has to be positive\n", readsize);
-		return readsize;
-	}
-
-	/* Seek to location of 'block_number' block in compressed file */
-	rpos = compress_lseek_block(filfd, binary_header_size, block_number);
-	if (rpos < 0) {
-		bmdbg("Failed to seek to offset of block number %d\n", block_number);
-		return rpos;
+	if (readsize <= 0 || readsize > compression_header->blocksize + COMPRESS_READ_SLACK) {
+		bmdbg("Incorrect readsize %d for block %d\n", readsize, block_number);
+		return ERROR;
 	}
 
-	/* Read 'block_number' block into buf */
-	nbytes = read(filfd, buf, readsize);
+	/* Read 'block_number' block into buf.  The file position is left as
+	 * is, so that this may run on the work queue while the loader uses it.
+	 */
+	nbytes = file_pread(filep, buf, readsize, current_block_offset);
 	if (nbytes != readsize) {
 		bmdbg("Read for compressed block %d failed\n", block_number);
 		return ERROR;
@@ -260,6 +258,116 @@ static off_t compress_read_block(int filfd, uint16_t binary_header_size, FAR uin
 	return nbytes;
 }
 
+#ifdef CONFIG_COMPRESSION_PIPELINE
+/****************************************************************************
+ * Name: compress_read_ahead
+ *
+ * Description:
+ *   Work queue handler reading the block following the one being
+ *   decompressed into next_buffer
+ *
+ * Returned Value:
+ *   None
+ ****************************************************************************/
+static void compress_read_ahead(FAR void *arg)
+{
+	buffers.next_size = compress_read_block(buffers.next_filep, buffers.next_header_size, buffers.next_buffer, buffers.next_block);
+	sem_post(&buffers.next_sem);
+}
+
+/****************************************************************************
+ * Name: compress_wait_ahead
+ *
+ * Description:
+ *   Wait for the read ahead in progress, if any.  It must be done before
+ *   the file or next_buffer is used.
+ *
+ * Returned Value:
+ *   None
+ ****************************************************************************/
+static void compress_wait_ahead(void)
+{
+	if (buffers.next_pending) {
+		while (sem_wait(&buffers.next_sem) < 0) {
+			/* EINTR just means that we received a signal */
+		}
+		buffers.next_pending = false;
+	}
+}
+#endif
+
+/****************************************************************************
+ * Name: compress_load_block
+ *
+ * Description:
+ *   Make 'block_number' block available decompressed in out_buffer.  With
+ *   CONFIG_COMPRESSION_PIPELINE, the compressed block following it is read
+ *   on the work queue while this one is decompressed.
+ *
+ * Returned Value:
+ *   OK (0) on Success
+ *   Negative value on Failure
+ ****************************************************************************/
+static int compress_load_block(FAR struct file *filep, uint16_t binary_header_size, int block_number)
+{
+	ssize_t nbytes;
+	unsigned int size;
+	unsigned int writesize;
+	int ret;
+#ifdef CONFIG_COMPRESSION_PIPELINE
+	FAR unsigned char *tmp;
+#endif
+
+	if (buffers.out_block == block_number) {
+		return OK;
+	}
+	buffers.out_block = -1;
+
+#ifdef CONFIG_COMPRESSION_PIPELINE
+	compress_wait_ahead();
+	if (buffers.next_block == block_number && buffers.next_filep == filep && buffers.next_size > 0) {
+		tmp = buffers.read_buffer;
+		buffers.read_buffer = buffers.next_buffer;
+		buffers.next_buffer = tmp;
+		nbytes = buffers.next_size;
+	} else
+#endif
+	{
+		/* Read compressed 'block_number' block into read_buffer */
+		nbytes = compress_read_block(filep, binary_header_size, buffers.read_buffer, block_number);
+	}
+
+	if (nbytes < 0) {
+		bmdbg("Read for compressed block %d failed\n", block_number);
+		return nbytes;
+	}
+
+#ifdef CONFIG_COMPRESSION_PIPELINE
+	buffers.next_block = -1;
+	if (block_number + 1 < compression_header->sections - 1) {
+		buffers.next_block = block_number + 1;
+		buffers.next_filep = filep;
+		buffers.next_header_size = binary_header_size;
+		buffers.next_pending = true;
+		if (work_queue(LPWORK, &buffers.next_work, compress_read_ahead, NULL, 0) != OK) {
+			buffers.next_pending = false;
+			buffers.next_block = -1;
+		}
+	}
+#endif
+
+	/* Decompress block in read_buffer to out_buffer */
+	size = nbytes;
+	ret = compress_decompress_block(buffers.out_buffer, &writesize, buffers.read_buffer, &size, block_number);
+	if (ret == ERROR) {
+		bmdbg("Failed to decompress %d block of this binary\n", block_number);
+		return ret;
+	}
+
+	buffers.out_block = block_number;
+	return OK;
+}
+
 /****************************************************************************
  * Name: compress_read
  *
@@ -284,8 +392,12 @@ int compress_read(int filfd, uint16_t binary_header_size, FAR uint8_t *buffer, s
 	int block_size_to_write;	/* Size to write into buffer from decompressed block */
 	int buffer_index;
 	int blocksize;
-	unsigned int writesize;
-	unsigned int size;
+	FAR struct file *filep;
+
+	filep = fs_getfilep(filfd);
+	if (!filep) {
+		return -get_errno();
+	}
 
 	/* Setting first block, end block and number of blocks to read and decompressed */
 	blocksize = compression_header->blocksize;
@@ -303,18 +415,9 @@ int compress_read(int filfd, uint16_t binary_header_size, FAR uint8_t *buffer, s
 
 	/* Reading and decompressing blocks from first_block to last_block. Then writing to buffer. */
 	for (; index < first_block + no_blocks; index++) {
-		/* Read compressed 'index' block into read_buffer */
-		size = compress_read_block(filfd, binary_header_size, buffers.read_buffer, index);
-		if (size < 0) {
-			bmdbg("Read for compressed block %d failed\n", index);
-			buffer_index = size;
-			goto error_compress_read;
-		}
-
-		/* Decompress block in read_buffer to out_buffer */
-		ret = compress_decompress_block(buffers.out_buffer, &writesize, buffers.read_buffer, &size, index);
-		if (ret == ERROR) {
-			bmdbg("Failed to decompress %d block of this binary\n", index);
+		/* Read and decompress 'index' block into out_buffer, unless it is there already */
+		ret = compress_load_block(filep, binary_header_size, index);
+		if (ret < 0) {
 			buffer_index = ret;
 			goto error_compress_read;
 		}
@@ -365,6 +468,7 @@ error_compress_read:
 int compress_init(int filfd, uint16_t offset, off_t *filelen)
 {
 	int ret;
+	int readsize;
 
 	/* Parsing compression header for compressed file */
 	ret = compress_parse_header(filfd, offset);
@@ -376,12 +480,39 @@ int compress_init(int filfd, uint16_t offset, off_t *filelen)
 	/* Assign file length as that of uncompressed file */
 	*filelen = compression_header->binary_size;
 
+	/* Allocating memory for read and out buffer to be used for decompression */
+	if (compression_header->compression_format == COMPRESSION_TYPE_LZ4) {
+		readsize = compression_header->blocksize;
+	}
 #if CONFIG_COMPRESSION_TYPE == 1
-	/* Allocating memory for read and out buffer to be used for LZMA decompression */
-	if (compression_header->compression_format == COMPRESSION_TYPE_LZMA) {
-		buffers.read_buffer = (unsigned char *)kmm_malloc(compression_header->blocksize + 5);
-		buffers.out_buffer = (unsigned char *)kmm_malloc(compression_header->blocksize);
+	else if (compression_header->compression_format == COMPRESSION_TYPE_LZMA) {
+		readsize = compression_header->blocksize + LZMA_PROPS_SIZE;
 	}
+#endif
+	else {
+		bmdbg("No support for decompression of compression format %d\n", compression_header->compression_format);
+		ret = -ENOTSUP;
+		goto error_compress_init;
+	}
+
+	buffers.read_buffer = (unsigned char *)kmm_malloc(readsize);
+	buffers.out_buffer = (unsigned char *)kmm_malloc(compression_header->blocksize);
+	buffers.out_block = -1;
+	if (!buffers.read_buffer || !buffers.out_buffer) {
+		bmdbg("Failed kmm_malloc for decompression buffers\n");
+		ret = -ENOMEM;
+		goto error_compress_init;
+	}
+
+#ifdef CONFIG_COMPRESSION_PIPELINE
+	/* Without this buffer, blocks are only read synchronously */
+	buffers.next_buffer = (unsigned char *)kmm_malloc(readsize);
+	buffers.next_block = -1;
+	buffers.next_pending = false;
+	sem_init(&buffers.next_sem, 0, 0);
+#ifdef CONFIG_PRIORITY_INHERITANCE
+	sem_setprotocol(&buffers.next_sem, SEM_PRIO_NONE);
+#endif
 #endif
 
 error_compress_init:
@@ -399,20 +530,28 @@ error_compress_init:
  ****************************************************************************/
 void compress_uninit(void)
 {
-#if CONFIG_COMPRESSION_TYPE == 1
-	/* Freeing memory allocated to read_buffer and out_buffer for file decompression */
-	if (compression_header->compression_format == COMPRESSION_TYPE_LZMA) {
-		if (buffers.read_buffer) {
-			kmm_free(buffers.read_buffer);
-			buffers.read_buffer = NULL;
-		}
-		if (buffers.out_buffer) {
-			kmm_free(buffers.out_buffer);
-			buffers.out_buffer = NULL;
-		}
+#ifdef CONFIG_COMPRESSION_PIPELINE
+	/* The read ahead uses the file which is about to be closed */
+	compress_wait_ahead();
+	sem_destroy(&buffers.next_sem);
+	if (buffers.next_buffer) {
+		kmm_free(buffers.next_buffer);
+		buffers.next_buffer = NULL;
 	}
+	buffers.next_block = -1;
 #endif
 
+	/* Freeing memory allocated to read_buffer and out_buffer for file decompression */
+	if (buffers.read_buffer) {
+		kmm_free(buffers.read_buffer);
+		buffers.read_buffer = NULL;
+	}
+	if (buffers.out_buffer) {
+		kmm_free(buffers.out_buffer);
+		buffers.out_buffer = NULL;
+	}
+	buffers.out_block = -1;
+
 	kmm_free(compression_header);
 	compression_header = NULL;
 }
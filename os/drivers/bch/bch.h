@@ -69,20 +69,47 @@
 #define bchlib_semgive(d)	sem_post(&(d)->sem)	/* To match bchlib_semtake */
 #define MAX_OPENCNT			(255)				/* Limit of uint8_t */
 
+/* Sector cache geometry.  Sector 's' may be held by any of the
+ * CONFIG_BCH_CACHE_WAYS entries of the set s % BCH_CACHE_NSETS.  Entry
+ * 'ndx' belongs to way ndx / BCH_CACHE_NSETS and set ndx % BCH_CACHE_NSETS,
+ * so that consecutive sectors in the same way are contiguous in the buffer.
+ */
+#ifndef CONFIG_BCH_CACHE_SECTORS
+#define CONFIG_BCH_CACHE_SECTORS	1
+#endif
+#ifndef CONFIG_BCH_CACHE_WAYS
+#define CONFIG_BCH_CACHE_WAYS		1
+#endif
+
+#if CONFIG_BCH_CACHE_SECTORS < 1 || CONFIG_BCH_CACHE_WAYS < 1 || \
+	(CONFIG_BCH_CACHE_SECTORS % CONFIG_BCH_CACHE_WAYS) != 0
+#error "CONFIG_BCH_CACHE_SECTORS must be a multiple of CONFIG_BCH_CACHE_WAYS"
+#endif
+
+#define BCH_CACHE_NSETS			(CONFIG_BCH_CACHE_SECTORS / CONFIG_BCH_CACHE_WAYS)
+#define BCH_CACHE_DATA(b, ndx)	(&(b)->buffer[(ndx) * (b)->sectsize])
+#define BCH_NOSECTOR			((size_t)-1)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
+struct bch_cache_s {
+	size_t sector;				/* The sector in this entry, BCH_NOSECTOR if none */
+	uint32_t lru;				/* Value of cacheclock at the last access */
+	bool dirty;					/* true: Data has been written to the entry */
+};
+
 struct bchlib_s {
 	FAR struct inode *inode;	/* I-node of the block driver */
 	uint32_t sectsize;			/* The size of one sector on the device */
 	size_t nsectors;			/* Number of sectors supported by the device */
-	size_t sector;				/* The current sector in the buffer */
 	sem_t sem;					/* For atomic accesses to this structure */
 	uint8_t refs;				/* Number of references */
-	bool dirty;					/* true: Data has been written to the buffer */
 	bool readonly;				/* true: Only read operations are supported */
 	bool unlinked;				/* true: The driver has been unlinked */
-	FAR uint8_t *buffer;		/* One sector buffer */
+	FAR uint8_t *buffer;		/* CONFIG_BCH_CACHE_SECTORS sector buffers */
+	uint32_t cacheclock;		/* Incremented on each cache access */
+	struct bch_cache_s cache[CONFIG_BCH_CACHE_SECTORS];
 
 #if defined(CONFIG_BCH_ENCRYPTION)
 	uint8_t key[CONFIG_BCH_ENCRYPTION_KEY_SIZE];	/* Encryption key */
@@ -106,8 +133,11 @@ EXTERN const struct file_operations bch_fops;
  * Public Function Prototypes
  ****************************************************************************/
 EXTERN void bchlib_semtake(FAR struct bchlib_s *bch);
-EXTERN int  bchlib_flushsector(FAR struct bchlib_s *bch);
+EXTERN int  bchlib_flushcache(FAR struct bchlib_s *bch);
 EXTERN int  bchlib_readsector(FAR struct bchlib_s *bch, size_t sector);
+EXTERN int  bchlib_allocsector(FAR struct bchlib_s *bch, size_t sector);
+EXTERN int  bchlib_findsector(FAR struct bchlib_s *bch, size_t sector);
+EXTERN void bchlib_initcache(FAR struct bchlib_s *bch);
 
 #undef EXTERN
 #if defined(__cplusplus)
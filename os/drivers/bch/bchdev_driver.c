@@ -157,7 +157,7 @@ static int bch_close(FAR struct file *filep)
 
 	/* Flush any dirty pages remaining in the cache */
 	bchlib_semtake(bch);
-	(void)bchlib_flushsector(bch);
+	(void)bchlib_flushcache(bch);
 
 	/*
 	 * Decrement the reference count (I don't use bchlib_decref() because I
@@ -334,10 +334,20 @@ static int bch_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 #ifdef CONFIG_BCH_ENCRYPTION
 	/* Is this a request to set the encryption key? */
 	else if (cmd == DIOC_SETKEY) {
+			/* Cached sectors were decrypted with the old key */
+			bchlib_semtake(bch);
+			ret = bchlib_flushcache(bch);
+			bchlib_initcache(bch);
 			memcpy(bch->key, (FAR void *)arg, CONFIG_BCH_ENCRYPTION_KEY_SIZE);
-			ret = OK;
+			bchlib_semgive(bch);
 	}
 #endif
+	/* Is this a request to write back the sector cache? */
+	else if (cmd == DIOC_FLUSH) {
+		bchlib_semtake(bch);
+		ret = bchlib_flushcache(bch);
+		bchlib_semgive(bch);
+	}
 	/* Otherwise, pass the IOCTL command on to the contained block driver */
 	else {
 		FAR struct inode *bchinode = bch->inode;
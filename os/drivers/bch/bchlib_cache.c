@@ -88,16 +88,16 @@ static void bch_xor(uint32_t *R, uint32_t *A, uint32_t *B)
  * Name: bch_cypher
  ****************************************************************************/
 #if defined(CONFIG_BCH_ENCRYPTION)
-static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
+static int bch_cypher(FAR struct bchlib_s *bch, FAR uint8_t *data, size_t sector, int encrypt)
 {
 	int blocks = bch->sectsize / 16;
-	FAR uint32_t *buffer = (FAR uint32_t *)bch->buffer;
+	FAR uint32_t *buffer = (FAR uint32_t *)data;
 	int i;
 
 	for (i = 0; i < blocks; i++, buffer += 16 / sizeof(uint32_t)) {
 		uint32_t T[4];
 		uint32_t X[4] = {
-			bch->sector, 0, 0, i
+			sector, 0, 0, i
 		};
 
 		aes_cypher(X, X, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
@@ -115,86 +115,236 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
 #endif
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-/****************************************************************************
- * Name: bchlib_flushsector
+ * Name: bch_flushrun
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
- *
- * Assumptions:
- *   Caller must assume mutual exclusion
+ *   Write the dirty entry 'ndx' to the media, together with the dirty
+ *   entries holding the sectors before and after it in the same way.  Those
+ *   are contiguous in the buffer, so the whole run is written with a single
+ *   call to the block driver.
  *
  ****************************************************************************/
-int bchlib_flushsector(FAR struct bchlib_s *bch)
+static int bch_flushrun(FAR struct bchlib_s *bch, int ndx)
 {
-	FAR struct inode *inode;
-	ssize_t ret = OK;
+	FAR struct inode *inode = bch->inode;
+	int first = ndx;
+	int last = ndx;
+	int way = ndx / BCH_CACHE_NSETS;
+	int i;
+	ssize_t ret;
 
-	/*
-	 * Check if the sector has been modified and is out of sync with the
-	 * media.
-	 */
-	if (bch->dirty) {
-		inode = bch->inode;
+	while (first > way * BCH_CACHE_NSETS && bch->cache[first - 1].dirty &&
+		   bch->cache[first - 1].sector + 1 == bch->cache[first].sector) {
+		first--;
+	}
+
+	while (last + 1 < (way + 1) * BCH_CACHE_NSETS && bch->cache[last + 1].dirty &&
+		   bch->cache[last + 1].sector == bch->cache[last].sector + 1) {
+		last++;
+	}
 
 #if defined(CONFIG_BCH_ENCRYPTION)
-		/* Encrypt data as necessary */
-		bch_cypher(bch, CYPHER_ENCRYPT);
+	/* Encrypt data as necessary */
+	for (i = first; i <= last; i++) {
+		bch_cypher(bch, BCH_CACHE_DATA(bch, i), bch->cache[i].sector, CYPHER_ENCRYPT);
+	}
 #endif
 
-		/* Write the sector to the media */
-		ret = inode->u.i_bops->write(inode, bch->buffer, bch->sector, 1);
-		if (ret < 0) {
-			fdbg("Write failed: %d\n");
-		}
+	/* Write the sectors to the media */
+	ret = inode->u.i_bops->write(inode, BCH_CACHE_DATA(bch, first), bch->cache[first].sector, last - first + 1);
+	if (ret < 0) {
+		fdbg("Write failed: %d\n", ret);
+	}
 
+	for (i = first; i <= last; i++) {
 #if defined(CONFIG_BCH_ENCRYPTION)
 		/*
 		 * Computation overhead to save memory for extra sector buffer
 		 * TODO: Add configuration switch for extra sector buffer
 		 */
-		bch_cypher(bch, CYPHER_DECRYPT);
+		bch_cypher(bch, BCH_CACHE_DATA(bch, i), bch->cache[i].sector, CYPHER_DECRYPT);
 #endif
 
 		/* The sector is now in sync with the media */
-		bch->dirty = false;
+		bch->cache[i].dirty = false;
 	}
 
 	return (int)ret;
 }
 
 /****************************************************************************
- * Name: bchlib_readsector
+ * Name: bch_getsector
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
- *
- * Assumptions:
- *   Caller must assume mutual exclusion
+ *   Return the cache entry of 'sector', taking one for it if the sector is
+ *   not cached.  The entry taken is a free one, else the one following the
+ *   previous sector in its way, to keep sequential sectors contiguous, else
+ *   the least recently used one.  If 'fill' is true, a newly taken entry is
+ *   read from the media.
  *
  ****************************************************************************/
-int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
+static int bch_getsector(FAR struct bchlib_s *bch, size_t sector, bool fill)
 {
-	FAR struct inode *inode;
-	ssize_t ret = OK;
+	FAR struct inode *inode = bch->inode;
+	int set = sector % BCH_CACHE_NSETS;
+	int victim = -1;
+	int prev;
+	int ndx;
+	int way;
+	ssize_t ret;
+
+	ndx = bchlib_findsector(bch, sector);
+	if (ndx >= 0) {
+		bch->cache[ndx].lru = ++bch->cacheclock;
+		return ndx;
+	}
+
+	for (way = 0; way < CONFIG_BCH_CACHE_WAYS; way++) {
+		ndx = way * BCH_CACHE_NSETS + set;
+		if (bch->cache[ndx].sector == BCH_NOSECTOR) {
+			victim = ndx;
+			break;
+		}
+
+		if (victim < 0 || bch->cacheclock - bch->cache[ndx].lru > bch->cacheclock - bch->cache[victim].lru) {
+			victim = ndx;
+		}
+	}
 
-	if (bch->sector != sector) {
-		inode = bch->inode;
+	if (bch->cache[victim].sector != BCH_NOSECTOR && sector > 0 && set > 0) {
+		prev = bchlib_findsector(bch, sector - 1);
+		if (prev >= 0 && !bch->cache[prev + 1].dirty) {
+			victim = prev + 1;
+		}
+	}
 
-		(void)bchlib_flushsector(bch);
-		bch->sector = (size_t)-1;
+	if (bch->cache[victim].dirty) {
+		ret = bch_flushrun(bch, victim);
+		if (ret < 0) {
+			return (int)ret;
+		}
+	}
 
-		ret = inode->u.i_bops->read(inode, bch->buffer, sector, 1);
+	bch->cache[victim].sector = BCH_NOSECTOR;
+	if (fill) {
+		ret = inode->u.i_bops->read(inode, BCH_CACHE_DATA(bch, victim), sector, 1);
 		if (ret < 0) {
-			fdbg("Read failed: %d\n");
+			fdbg("Read failed: %d\n", ret);
+			return (int)ret;
 		}
-		bch->sector = sector;
 #if defined(CONFIG_BCH_ENCRYPTION)
-		bch_cypher(bch, CYPHER_DECRYPT);
+		bch_cypher(bch, BCH_CACHE_DATA(bch, victim), sector, CYPHER_DECRYPT);
 #endif
 	}
-	return (int)ret;
+
+	bch->cache[victim].sector = sector;
+	bch->cache[victim].lru = ++bch->cacheclock;
+	return victim;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+/****************************************************************************
+ * Name: bchlib_flushcache
+ *
+ * Description:
+ *   Write all of the dirty sectors of the cache to the media, with one
+ *   block driver write per run of consecutive sectors.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+int bchlib_flushcache(FAR struct bchlib_s *bch)
+{
+	int ret = OK;
+	int err;
+	int ndx;
+
+	for (ndx = 0; ndx < CONFIG_BCH_CACHE_SECTORS; ndx++) {
+		if (bch->cache[ndx].dirty) {
+			err = bch_flushrun(bch, ndx);
+			if (err < 0) {
+				ret = err;
+			}
+		}
+	}
+
+	return ret;
+}
+
+/****************************************************************************
+ * Name: bchlib_findsector
+ *
+ * Description:
+ *   Return the cache entry holding 'sector', or -1 if it is not cached
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+int bchlib_findsector(FAR struct bchlib_s *bch, size_t sector)
+{
+	int ndx;
+
+	for (ndx = sector % BCH_CACHE_NSETS; ndx < CONFIG_BCH_CACHE_SECTORS; ndx += BCH_CACHE_NSETS) {
+		if (bch->cache[ndx].sector == sector) {
+			return ndx;
+		}
+	}
+
+	return -1;
+}
+
+/****************************************************************************
+ * Name: bchlib_readsector
+ *
+ * Description:
+ *   Bring 'sector' into the cache, reading it from the media if needed.
+ *   A dirty sector is written back if its entry has to be reused.
+ *
+ * Returned Value:
+ *   The cache entry holding the sector, or a negated errno value
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
+{
+	return bch_getsector(bch, sector, true);
 }
 
+/****************************************************************************
+ * Name: bchlib_allocsector
+ *
+ * Description:
+ *   Like bchlib_readsector(), but a sector which is not cached is not read
+ *   from the media because the caller overwrites all of it.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+int bchlib_allocsector(FAR struct bchlib_s *bch, size_t sector)
+{
+	return bch_getsector(bch, sector, false);
+}
+
+/****************************************************************************
+ * Name: bchlib_initcache
+ *
+ * Description:
+ *   Mark all of the cache entries as free
+ *
+ ****************************************************************************/
+void bchlib_initcache(FAR struct bchlib_s *bch)
+{
+	int ndx;
+
+	for (ndx = 0; ndx < CONFIG_BCH_CACHE_SECTORS; ndx++) {
+		bch->cache[ndx].sector = BCH_NOSECTOR;
+		bch->cache[ndx].dirty = false;
+	}
+}
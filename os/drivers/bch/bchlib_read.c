@@ -100,6 +100,8 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
 	uint16_t	sectoffset;
 	size_t		nbytes;
 	size_t		bytesread;
+	size_t		i;
+	int			ndx;
 	int			ret;
 
 	/* Get rid of this special case right away */
@@ -120,8 +122,11 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
 
 	bytesread = 0;
 	if (sectoffset > 0) {
-		/* Read the sector into the sector buffer */
-		bchlib_readsector(bch, sector);
+		/* Read the sector into the sector cache */
+		ndx = bchlib_readsector(bch, sector);
+		if (ndx < 0) {
+			return ndx;
+		}
 
 		/* Copy the tail end of the sector to the user buffer */
 		if (sectoffset + len > bch->sectsize) {
@@ -130,7 +135,7 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
 			nbytes = len;
 		}
 
-		memcpy(buffer, &bch->buffer[sectoffset], nbytes);
+		memcpy(buffer, BCH_CACHE_DATA(bch, ndx) + sectoffset, nbytes);
 
 		/* Adjust pointers and counts */
 		sector++;
@@ -157,10 +162,19 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
 		ret = bch->inode->u.i_bops->read(bch->inode, (FAR uint8_t *)buffer,
 						sector, nsectors);
 		if (ret < 0) {
-			fdbg("ERROR: Read failed: %d\n");
+			fdbg("ERROR: Read failed: %d\n", ret);
 			return ret;
 		}
 
+		/* The cache may hold newer data than the media for some of them */
+		for (i = 0; i < CONFIG_BCH_CACHE_SECTORS; i++) {
+			if (bch->cache[i].dirty && bch->cache[i].sector >= sector &&
+				bch->cache[i].sector < sector + nsectors) {
+				memcpy(buffer + (bch->cache[i].sector - sector) * bch->sectsize,
+					   BCH_CACHE_DATA(bch, i), bch->sectsize);
+			}
+		}
+
 		/* Adjust pointers and counts */
 		sector    += nsectors;
 		nbytes     = nsectors * bch->sectsize;
@@ -176,11 +190,14 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
 
 	/* Then read any partial final sector */
 	if (len > 0) {
-		/* Read the sector into the sector buffer */
-		bchlib_readsector(bch, sector);
+		/* Read the sector into the sector cache */
+		ndx = bchlib_readsector(bch, sector);
+		if (ndx < 0) {
+			return ndx;
+		}
 
 		/* Copy the head end of the sector to the user buffer */
-		memcpy(buffer, bch->buffer, len);
+		memcpy(buffer, BCH_CACHE_DATA(bch, ndx), len);
 
 		/* Adjust counts */
 		bytesread += len;
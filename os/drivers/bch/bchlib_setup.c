@@ -128,13 +128,13 @@ int bchlib_setup(const char *blkdev, bool readonly, FAR void **handle)
 	sem_init(&bch->sem, 0, 1);
 	bch->nsectors = geo.geo_nsectors;
 	bch->sectsize = geo.geo_sectorsize;
-	bch->sector   = (size_t)-1;
 	bch->readonly = readonly;
+	bchlib_initcache(bch);
 
-	/* Allocate the sector I/O buffer */
-	bch->buffer = (FAR uint8_t *)kmm_malloc(bch->sectsize);
+	/* Allocate the sector cache buffers */
+	bch->buffer = (FAR uint8_t *)kmm_malloc(bch->sectsize * CONFIG_BCH_CACHE_SECTORS);
 	if (!bch->buffer) {
-		fdbg("ERROR: Failed to allocate sector buffer\n");
+		fdbg("ERROR: Failed to allocate sector cache\n");
 		ret = -ENOMEM;
 		goto errout_with_bch;
 	}
@@ -87,6 +87,8 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset, si
 	uint16_t sectoffset;
 	size_t   nbytes;
 	size_t   byteswritten;
+	size_t   i;
+	int      ndx;
 	int      ret;
 
 	/* Get rid of this special case right away */
@@ -106,8 +108,11 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset, si
 
 	byteswritten = 0;
 	if (sectoffset > 0) {
-		/* Read the full sector into the sector buffer */
-		bchlib_readsector(bch, sector);
+		/* Read the full sector into the sector cache */
+		ndx = bchlib_readsector(bch, sector);
+		if (ndx < 0) {
+			return ndx;
+		}
 
 		/* Copy the tail end of the sector from the user buffer */
 		if (sectoffset + len > bch->sectsize) {
@@ -116,8 +121,8 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset, si
 			nbytes = len;
 		}
 
-		memcpy(&bch->buffer[sectoffset], buffer, nbytes);
-		bch->dirty = true;
+		memcpy(BCH_CACHE_DATA(bch, ndx) + sectoffset, buffer, nbytes);
+		bch->cache[ndx].dirty = true;
 
 		/* Adjust pointers and counts */
 		sector++;
@@ -132,8 +137,10 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset, si
 	}
 
 	/*
-	 * Then write all of the full sectors following the partial sector
-	 * directly from the user buffer.
+	 * Then write all of the full sectors following the partial sector.
+	 * Runs shorter than the cache are written to the cache, where they are
+	 * coalesced with neighbouring writes and flushed together; longer runs
+	 * are written directly from the user buffer.
 	 */
 	if (len >= bch->sectsize) {
 		nsectors = len / bch->sectsize;
@@ -141,12 +148,33 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset, si
 			nsectors = bch->nsectors - sector;
 		}
 
-		/* Write the contiguous sectors */
-		ret = bch->inode->u.i_bops->write(bch->inode, (FAR uint8_t *)buffer,
-				sector, nsectors);
-		if (ret < 0) {
-			fdbg("ERROR: Write failed: %d\n", ret);
-			return ret;
+		if (nsectors < CONFIG_BCH_CACHE_SECTORS) {
+			for (i = 0; i < nsectors; i++) {
+				ndx = bchlib_allocsector(bch, sector + i);
+				if (ndx < 0) {
+					return ndx;
+				}
+
+				memcpy(BCH_CACHE_DATA(bch, ndx), buffer + i * bch->sectsize, bch->sectsize);
+				bch->cache[ndx].dirty = true;
+			}
+		} else {
+			/* Write the contiguous sectors */
+			ret = bch->inode->u.i_bops->write(bch->inode, (FAR uint8_t *)buffer,
+					sector, nsectors);
+			if (ret < 0) {
+				fdbg("ERROR: Write failed: %d\n", ret);
+				return ret;
+			}
+
+			/* Drop any cached copies of the sectors just written */
+			for (i = 0; i < CONFIG_BCH_CACHE_SECTORS; i++) {
+				if (bch->cache[i].sector != BCH_NOSECTOR &&
+					bch->cache[i].sector >= sector && bch->cache[i].sector < sector + nsectors) {
+					bch->cache[i].sector = BCH_NOSECTOR;
+					bch->cache[i].dirty = false;
+				}
+			}
 		}
 
 		/* Adjust pointers and counts */
@@ -164,24 +192,33 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset, si
 
 	/* Then write any partial final sector */
 	if (len > 0) {
-		/* Read the sector into the sector buffer */
-		bchlib_readsector(bch, sector);
+		/* Read the sector into the sector cache */
+		ndx = bchlib_readsector(bch, sector);
+		if (ndx < 0) {
+			return ndx;
+		}
 
 		/* Copy the head end of the sector from the user buffer */
-		memcpy(bch->buffer, buffer, len);
-		bch->dirty = true;
+		memcpy(BCH_CACHE_DATA(bch, ndx), buffer, len);
+		bch->cache[ndx].dirty = true;
 
 		/* Adjust counts */
 		byteswritten += len;
 	}
 
+#ifndef CONFIG_BCH_WRITEBACK
 	/* Finally, flush any cached writes to the device as well */
-	ret = bchlib_flushsector(bch);
+	ret = bchlib_flushcache(bch);
 	if (ret < 0) {
 		fdbg("ERROR: Flush failed: %d\n", ret);
 		return ret;
 	}
+#endif
 
+	/*
+	 * With CONFIG_BCH_WRITEBACK, dirty sectors stay in the cache until they
+	 * are evicted or until the cache is flushed by fsync() or close().
+	 */
 	return byteswritten;
 }
 
@@ -109,12 +109,20 @@ static int heapinfo_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 		if (heap == NULL) {
 			return ERROR;
 		}
+#ifdef CONFIG_MM_SAMPLING
+		if (option->mode == HEAPINFO_SAMPLE) {
+			mm_sample_dump(heap);
+			return OK;
+		}
+#endif
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
 		if (option->mode == HEAPINFO_INIT_PEAK) {
 			heap->peak_alloc_size = 0;
 			return OK;
 		}
 		heapinfo_parse(heap, option->mode, option->pid);
 		ret = OK;
+#endif
 		break;
 	default:
 		break;
@@ -216,6 +216,7 @@ static int taskmgr_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 			/* tcb is waiting another signal, e.g. sleep */
 			wd_cancel(tcb->waitdog);
 		} else if (tcb->task_state == TSTATE_WAIT_SEM) {
+			sched_removewaiter(tcb, &tcb->waitsem->waitlist);
 			tcb->waitsem = NULL;
 			sched_removeblocked(tcb);
 			sched_addblocked(tcb, TSTATE_WAIT_SIG);
@@ -41,6 +41,7 @@
 #include <tinyara/fs/fs.h>
 #include <tinyara/arch.h>
 #include <tinyara/ringbuf.h>
+#include <tinyara/ttrace.h>
 
 #include <arch/irq.h>
 
@@ -192,6 +193,9 @@ static int ttrace_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 	case TTRACE_START:
 		g_state = TTRACE_STATE_RUNNING;
 		priv->ttrace_head = 0;
+#ifdef CONFIG_TTRACE_EVENTS
+		ttrace_event_start();
+#endif
 		break;
 	case TTRACE_OVERWRITE:
 		g_ringbuf.is_overwritable = arg;
@@ -244,6 +248,22 @@ static int ttrace_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
  * Public Functions
  ****************************************************************************/
 
+#ifdef CONFIG_TTRACE_EVENTS
+/****************************************************************************
+ * Name: ttrace_tag_enabled
+ *
+ * Description:
+ *   Check whether tracing is running with 'tag' selected.  It may be called
+ *   from interrupt handlers.
+ *
+ ****************************************************************************/
+
+bool ttrace_tag_enabled(int tag)
+{
+	return g_state == TTRACE_STATE_RUNNING && (g_selected_tag & tag) != 0;
+}
+#endif
+
 /****************************************************************************
  * Name: ttrace_init
  *
@@ -255,6 +275,15 @@ static int ttrace_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
 int ttrace_init(void)
 {
+	int ret;
+
 	/* Register the syslog character driver */
-	return register_driver(CONFIG_TTRACE_DEVPATH, &g_ttracefops, 0666, &g_sysdev);
+	ret = register_driver(CONFIG_TTRACE_DEVPATH, &g_ttracefops, 0666, &g_sysdev);
+#ifdef CONFIG_TTRACE_EVENTS
+	if (ret == OK) {
+		ret = ttrace_event_init();
+	}
+#endif
+
+	return ret;
 }
@@ -0,0 +1,411 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <tinyara/fs/fs.h>
+#include <tinyara/arch.h>
+#include <tinyara/irq.h>
+#include <tinyara/sched.h>
+#include <tinyara/clock.h>
+#include <tinyara/ttrace.h>
+
+#ifdef CONFIG_TTRACE_EVENTS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if (CONFIG_TTRACE_EVENTS_NRECORDS & (CONFIG_TTRACE_EVENTS_NRECORDS - 1)) != 0
+#error "CONFIG_TTRACE_EVENTS_NRECORDS must be a power of two"
+#endif
+
+#define TTRACE_EVENT_MASK      (CONFIG_TTRACE_EVENTS_NRECORDS - 1)
+#define TTRACE_EVENT_SLOT(seq) (&g_events[(seq) & TTRACE_EVENT_MASK])
+
+/* Keep the compiler from moving the accesses to a record across the
+ * update of its sequence number.  There is a single CPU, so no hardware
+ * barrier is needed.
+ */
+
+#define TTRACE_EVENT_BARRIER() __asm__ __volatile__("" ::: "memory")
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int ttrace_event_open(FAR struct file *filep);
+static ssize_t ttrace_event_read(FAR struct file *filep, FAR char *buffer, size_t len);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_ttrace_eventfops = {
+	ttrace_event_open, /* open */
+	0,                 /* close */
+	ttrace_event_read, /* read */
+	0,                 /* write */
+	0,                 /* seek */
+	0                  /* ioctl */
+};
+
+/* The records and the sequence number of the next record to be reserved.
+ * Record 'seq' lives in the slot seq % CONFIG_TTRACE_EVENTS_NRECORDS.
+ */
+
+static struct ttrace_event_s g_events[CONFIG_TTRACE_EVENTS_NRECORDS];
+static volatile uint32_t g_event_head;
+
+/* Sequence number of the first record of the current tracing session */
+
+static volatile uint32_t g_event_start;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ttrace_event_timestamp
+ *
+ * Description:
+ *   Return the time since boot in microseconds.  It wraps after about 71
+ *   minutes, which the host tools undo using the sequence numbers.
+ *
+ ****************************************************************************/
+
+static uint32_t ttrace_event_timestamp(void)
+{
+#ifdef CONFIG_SCHED_TICKLESS
+	struct timespec ts;
+
+	up_timer_gettime(&ts);
+	return (uint32_t)ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+#else
+	return (uint32_t)clock_systimer() * USEC_PER_TICK;
+#endif
+}
+
+/****************************************************************************
+ * Name: ttrace_event_reserve
+ *
+ * Description:
+ *   Reserve the next record of the ring and fill its header.  Interrupts
+ *   are disabled only to advance the head, so producers in tasks and in
+ *   interrupt handlers never wait for each other.  The record is marked as
+ *   being written until ttrace_event_commit() is called.
+ *
+ ****************************************************************************/
+
+static FAR struct ttrace_event_s *ttrace_event_reserve(uint8_t type, FAR uint32_t *seq)
+{
+	FAR struct ttrace_event_s *event;
+	FAR struct tcb_s *tcb;
+	irqstate_t flags;
+
+	flags = irqsave();
+	*seq = g_event_head++;
+	irqrestore(flags);
+
+	event = TTRACE_EVENT_SLOT(*seq);
+	event->seq = 0;
+	TTRACE_EVENT_BARRIER();
+
+	tcb = sched_self();
+	event->ts = ttrace_event_timestamp();
+	event->type = type;
+	event->pid = tcb->pid;
+	event->prio = tcb->sched_priority;
+
+	return event;
+}
+
+/****************************************************************************
+ * Name: ttrace_event_commit
+ *
+ * Description:
+ *   Publish a record filled after ttrace_event_reserve() to the readers.
+ *
+ ****************************************************************************/
+
+static void ttrace_event_commit(FAR struct ttrace_event_s *event, uint32_t seq)
+{
+	TTRACE_EVENT_BARRIER();
+	event->seq = seq + 1;
+}
+
+/****************************************************************************
+ * Name: ttrace_event_open
+ *
+ * Description:
+ *   Each reader has its own position, kept in f_pos as a sequence number.
+ *   It starts at the oldest record of the current tracing session which
+ *   is still in the ring.
+ *
+ ****************************************************************************/
+
+static int ttrace_event_open(FAR struct file *filep)
+{
+	uint32_t head = g_event_head;
+	uint32_t start = g_event_start;
+
+	if (head - start > CONFIG_TTRACE_EVENTS_NRECORDS) {
+		start = head - CONFIG_TTRACE_EVENTS_NRECORDS;
+	}
+
+	filep->f_pos = (off_t)start;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: ttrace_event_read
+ *
+ * Description:
+ *   Copy the committed records following the position of the reader.  It
+ *   does not block and may be called while tracing is running.  Records
+ *   overwritten before they could be read are skipped; the reader sees the
+ *   gap in the sequence numbers.  Reading stops at a record which is still
+ *   being written.
+ *
+ * Return Value:
+ *   The number of bytes read, always a multiple of the record size, or 0
+ *   if there is no new record.
+ *
+ ****************************************************************************/
+
+static ssize_t ttrace_event_read(FAR struct file *filep, FAR char *buffer, size_t len)
+{
+	FAR struct ttrace_event_s *dest = (FAR struct ttrace_event_s *)buffer;
+	FAR struct ttrace_event_s *src;
+	uint32_t pos = (uint32_t)filep->f_pos;
+	uint32_t head;
+	size_t nread = 0;
+	size_t nmax = len / sizeof(struct ttrace_event_s);
+
+	if (nmax == 0) {
+		return -EINVAL;
+	}
+
+	while (nread < nmax) {
+		head = g_event_head;
+		if (pos == head) {
+			break;
+		}
+
+		if (head - pos > CONFIG_TTRACE_EVENTS_NRECORDS) {
+			/* The writers went around the ring past the reader */
+
+			pos = head - CONFIG_TTRACE_EVENTS_NRECORDS;
+			continue;
+		}
+
+		src = TTRACE_EVENT_SLOT(pos);
+		if (src->seq != pos + 1) {
+			if (src->seq == 0 || (int32_t)(src->seq - (pos + 1)) < 0) {
+				/* Not committed yet */
+
+				break;
+			}
+
+			/* Already reused by a later record */
+
+			continue;
+		}
+
+		/* The record may be reused while it is copied, by an interrupt
+		 * handler or by a task preempting the reader.
+		 */
+
+		memcpy(&dest[nread], src, sizeof(struct ttrace_event_s));
+		TTRACE_EVENT_BARRIER();
+		if (src->seq != pos + 1) {
+			continue;
+		}
+
+		nread++;
+		pos++;
+	}
+
+	filep->f_pos = (off_t)pos;
+	return nread * sizeof(struct ttrace_event_s);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ttrace_event_sched
+ *
+ * Description:
+ *   Record a context switch.  'prev' is NULL if the previous task is not
+ *   known to the caller.
+ *
+ ****************************************************************************/
+
+int ttrace_event_sched(FAR struct tcb_s *prev, FAR struct tcb_s *next)
+{
+	FAR struct ttrace_event_s *event;
+	uint32_t seq;
+
+	if (!ttrace_tag_enabled(TTRACE_TAG_TASK)) {
+		return TTRACE_INVALID;
+	}
+
+	event = ttrace_event_reserve(TTRACE_EVENT_SCHED, &seq);
+
+	if (prev != NULL) {
+		event->pid = prev->pid;
+		event->prio = prev->sched_priority;
+		event->u.sched.prev_state = prev->task_state;
+	} else {
+		event->pid = -1;
+		event->prio = 0;
+		event->u.sched.prev_state = 0;
+	}
+
+	if (next != NULL) {
+		event->u.sched.next_pid = next->pid;
+		event->u.sched.next_prio = next->sched_priority;
+#if CONFIG_TASK_NAME_SIZE > 0
+		strncpy(event->u.sched.next_comm, next->name, TTRACE_COMM_BYTES);
+#else
+		event->u.sched.next_comm[0] = '\0';
+#endif
+	} else {
+		event->u.sched.next_pid = 0;
+		event->u.sched.next_prio = 0;
+		strncpy(event->u.sched.next_comm, "Idle Task", TTRACE_COMM_BYTES);
+	}
+
+	event->u.sched.next_comm[TTRACE_COMM_BYTES - 1] = '\0';
+
+	ttrace_event_commit(event, seq);
+	return TTRACE_VALID;
+}
+
+/****************************************************************************
+ * Name: ttrace_event_begin
+ *
+ * Description:
+ *   Record the beginning of an event named by 'str' in the running task.
+ *   Names longer than TTRACE_EVENT_MSG_BYTES are truncated.
+ *
+ ****************************************************************************/
+
+int ttrace_event_begin(int tag, FAR const char *str)
+{
+	FAR struct ttrace_event_s *event;
+	uint32_t seq;
+
+	if (!ttrace_tag_enabled(tag)) {
+		return TTRACE_INVALID;
+	}
+
+	event = ttrace_event_reserve(TTRACE_EVENT_BEGIN, &seq);
+	strncpy(event->u.message, str, TTRACE_EVENT_MSG_BYTES);
+	ttrace_event_commit(event, seq);
+	return TTRACE_VALID;
+}
+
+/****************************************************************************
+ * Name: ttrace_event_begin_uid
+ *
+ * Description:
+ *   Record the beginning of an event identified by 'uniqueid' in the
+ *   running task.
+ *
+ ****************************************************************************/
+
+int ttrace_event_begin_uid(int tag, int8_t uniqueid)
+{
+	FAR struct ttrace_event_s *event;
+	uint32_t seq;
+
+	if (!ttrace_tag_enabled(tag)) {
+		return TTRACE_INVALID;
+	}
+
+	event = ttrace_event_reserve(TTRACE_EVENT_BEGIN_UID, &seq);
+	event->u.uid = uniqueid;
+	ttrace_event_commit(event, seq);
+	return TTRACE_VALID;
+}
+
+/****************************************************************************
+ * Name: ttrace_event_end
+ *
+ * Description:
+ *   Record the end of the innermost event begun in the running task.
+ *
+ ****************************************************************************/
+
+int ttrace_event_end(int tag)
+{
+	FAR struct ttrace_event_s *event;
+	uint32_t seq;
+
+	if (!ttrace_tag_enabled(tag)) {
+		return TTRACE_INVALID;
+	}
+
+	event = ttrace_event_reserve(TTRACE_EVENT_END, &seq);
+	ttrace_event_commit(event, seq);
+	return TTRACE_VALID;
+}
+
+/****************************************************************************
+ * Name: ttrace_event_start
+ *
+ * Description:
+ *   Mark the beginning of a tracing session.  Readers opened afterwards do
+ *   not see the records of the previous sessions.
+ *
+ ****************************************************************************/
+
+void ttrace_event_start(void)
+{
+	g_event_start = g_event_head;
+}
+
+/****************************************************************************
+ * Name: ttrace_event_init
+ *
+ * Description:
+ *   Register the event ring device at CONFIG_TTRACE_EVENTS_DEVPATH.
+ *
+ ****************************************************************************/
+
+int ttrace_event_init(void)
+{
+	return register_driver(CONFIG_TTRACE_EVENTS_DEVPATH, &g_ttrace_eventfops, 0444, NULL);
+}
+
+#endif /* CONFIG_TTRACE_EVENTS */
@@ -79,6 +79,11 @@
 #include <tinyara/fs/mtd.h>
 #include <tinyara/fs/smart_procfs.h>
 #include <tinyara/fs/smart.h>
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+#include <semaphore.h>
+#include <tinyara/clock.h>
+#include <tinyara/wqueue.h>
+#endif
 
 /****************************************************************************
  * Private Definitions
@@ -162,6 +167,21 @@
 #define smart_free(d, p)        kmm_free(p)
 #endif
 
+#ifndef CONFIG_MTD_SMART_BLOCK_INDEX
+#define smart_index_update(d, b)
+#endif
+
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+#if !defined(CONFIG_SCHED_LPWORK)
+#error "Background garbage collection requires CONFIG_SCHED_LPWORK"
+#endif
+#define smart_devtake(d)        while (sem_wait(&(d)->exclsem) != 0)
+#define smart_devgive(d)        sem_post(&(d)->exclsem)
+#else
+#define smart_devtake(d)
+#define smart_devgive(d)
+#endif
+
 #define SMART_WEAR_FULL_RELOCATE_THRESHOLD  8
 #define SMART_WEAR_REORG_THRESHOLD          14
 #define SMART_WEAR_MIN_LEVEL                5
@@ -240,6 +260,12 @@ struct smart_cache_s {
 	uint16_t physical;			/* Associated physical sector */
 	uint16_t birth;				/* The "birthday" of this entry */
 };
+
+#ifdef CONFIG_MTD_SMART_PAGED_MAP
+#define SMART_MAP_PAGE_SIZE     (1 << CONFIG_MTD_SMART_MAP_PAGE_SHIFT)
+#define SMART_MAP_PAGE_MASK     (SMART_MAP_PAGE_SIZE - 1)
+#define SMART_MAP_NPAGES(d)     (((d)->totalsectors + SMART_MAP_PAGE_MASK) >> CONFIG_MTD_SMART_MAP_PAGE_SHIFT)
+#endif
 #endif
 
 /* When CRC is enabled, we allocate sectors in memory only and only write
@@ -314,10 +340,27 @@ struct smart_struct_s {
 	uint16_t cache_lastlog;	/* Keep track of the last sector accessed */
 	uint16_t cache_lastphys;	/* Keep the physical sector number also */
 	uint16_t cache_nextbirth;	/* Sector cache aging value */
+#ifdef CONFIG_MTD_SMART_PAGED_MAP
+	FAR uint16_t **sMapDir;		/* Pages of the virtual to physical map */
+	uint16_t mappages;			/* Number of map pages allocated */
+	bool mapincomplete;			/* A map page could not be allocated */
+#endif
 #endif
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
 	FAR uint8_t *erasecounts;	/* Number of erases for each erase block */
 #endif
+#ifdef CONFIG_MTD_SMART_BLOCK_INDEX
+	FAR uint16_t *releaseheap;	/* Erase blocks as a max-heap on releasecount */
+	FAR uint16_t *releasepos;	/* Position of each block in releaseheap */
+	FAR uint16_t *freeheap;		/* Erase blocks as a max-heap on freecount */
+	FAR uint16_t *freepos;		/* Position of each block in freeheap */
+	bool indexvalid;			/* The heaps match the counts */
+#endif
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+	sem_t exclsem;				/* Serializes the worker with requests */
+	struct work_s gcwork;		/* Background garbage collection work */
+	clock_t lastaccess;			/* Time of the last block driver request */
+#endif
 #ifdef CONFIG_MTD_SMART_ALLOC_DEBUG
 	size_t bytesalloc;
 	struct smart_alloc_s
@@ -428,6 +471,12 @@ static int smart_relocate_static_data(FAR struct smart_struct_s *dev, uint16_t b
 static void smart_erase_block_if_empty(FAR struct smart_struct_s *dev, uint16_t block, uint8_t forceerase);
 static int smart_relocate_sector(FAR struct smart_struct_s *dev, uint16_t oldsector, uint16_t newsector);
 static int smart_validate_crc(FAR struct smart_struct_s *dev);
+#ifdef CONFIG_MTD_SMART_PAGED_MAP
+static bool smart_map_get(FAR struct smart_struct_s *dev, uint16_t logical, FAR uint16_t *physical);
+static void smart_map_set(FAR struct smart_struct_s *dev, uint16_t logical, uint16_t physical);
+static void smart_map_release(FAR struct smart_struct_s *dev);
+static void smart_map_reset(FAR struct smart_struct_s *dev);
+#endif
 static crc_t smart_calc_sector_crc(FAR struct smart_struct_s *dev);
 
 /****************************************************************************
@@ -637,6 +686,121 @@ static void smart_add_count(struct smart_struct_s *dev, uint8_t *pCount, uint16_
 }
 #endif
 
+/****************************************************************************
+ * Name: smart_index_key
+ *
+ * Description: Return the count of an erase block used as heap key.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BLOCK_INDEX
+static inline uint8_t smart_index_key(FAR struct smart_struct_s *dev, FAR uint8_t *pCount, uint16_t block)
+{
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+	return smart_get_count(dev, pCount, block);
+#else
+	return pCount[block];
+#endif
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_heap_sift
+ *
+ * Description: Restore the max-heap order of 'heap' (keyed on the counts
+ *              in pCount) around the entry at index 'x', the only one whose
+ *              key may have changed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BLOCK_INDEX
+static void smart_heap_sift(FAR struct smart_struct_s *dev, FAR uint16_t *heap, FAR uint16_t *pos, FAR uint8_t *pCount, uint16_t x)
+{
+	uint16_t block = heap[x];
+	uint8_t key = smart_index_key(dev, pCount, block);
+	uint32_t child;
+
+	/* Move the block up while its parent has a smaller count. */
+
+	while (x > 0 && smart_index_key(dev, pCount, heap[(x - 1) >> 1]) < key) {
+		heap[x] = heap[(x - 1) >> 1];
+		pos[heap[x]] = x;
+		x = (x - 1) >> 1;
+	}
+
+	/* Then down while a child has a larger count. */
+
+	while ((child = (x << 1) + 1) < dev->neraseblocks) {
+		if (child + 1 < dev->neraseblocks && smart_index_key(dev, pCount, heap[child + 1]) > smart_index_key(dev, pCount, heap[child])) {
+			child++;
+		}
+
+		if (smart_index_key(dev, pCount, heap[child]) <= key) {
+			break;
+		}
+
+		heap[x] = heap[child];
+		pos[heap[x]] = x;
+		x = child;
+	}
+
+	heap[x] = block;
+	pos[block] = x;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_index_build
+ *
+ * Description: Build the release and free count heaps from scratch.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BLOCK_INDEX
+static void smart_index_build(FAR struct smart_struct_s *dev)
+{
+	uint16_t x;
+
+	if (dev->releaseheap == NULL) {
+		return;
+	}
+
+	for (x = 0; x < dev->neraseblocks; x++) {
+		dev->releaseheap[x] = x;
+		dev->releasepos[x] = x;
+		dev->freeheap[x] = x;
+		dev->freepos[x] = x;
+	}
+
+	for (x = dev->neraseblocks >> 1; x-- > 0;) {
+		smart_heap_sift(dev, dev->releaseheap, dev->releasepos, dev->releasecount, x);
+		smart_heap_sift(dev, dev->freeheap, dev->freepos, dev->freecount, x);
+	}
+
+	dev->indexvalid = true;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_index_update
+ *
+ * Description: Reposition an erase block in the heaps after its free or
+ *              release count changed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BLOCK_INDEX
+static void smart_index_update(FAR struct smart_struct_s *dev, uint16_t block)
+{
+	if (!dev->indexvalid) {
+		return;
+	}
+
+	smart_heap_sift(dev, dev->releaseheap, dev->releasepos, dev->releasecount, dev->releasepos[block]);
+	smart_heap_sift(dev, dev->freeheap, dev->freepos, dev->freecount, dev->freepos[block]);
+}
+#endif
+
 /****************************************************************************
  * Name: smart_checkfree
  *
@@ -775,6 +939,7 @@ static ssize_t smart_reload(struct smart_struct_s *dev, FAR uint8_t *buffer, off
 static ssize_t smart_read(FAR struct inode *inode, unsigned char *buffer, size_t start_sector, unsigned int nsectors)
 {
 	struct smart_struct_s *dev;
+	ssize_t ret;
 
 	fvdbg("SMART: sector: %d nsectors: %d\n", start_sector, nsectors);
 
@@ -784,7 +949,10 @@ static ssize_t smart_read(FAR struct inode *inode, unsigned char *buffer, size_t
 #else
 	dev = (struct smart_struct_s *)inode->i_private;
 #endif
-	return smart_reload(dev, buffer, start_sector, nsectors);
+	smart_devtake(dev);
+	ret = smart_reload(dev, buffer, start_sector, nsectors);
+	smart_devgive(dev);
+	return ret;
 }
 
 /****************************************************************************
@@ -819,7 +987,7 @@ static ssize_t smart_write(FAR struct inode *inode, FAR const unsigned char *buf
 	dev = (FAR struct smart_struct_s *)inode->i_private;
 #endif
 
-	/* I think maybe we need to lock on a mutex here. */
+	smart_devtake(dev);
 
 	/* Get the aligned block.  Here is is assumed: (1) The number of R/W blocks
 	 * per erase block is a power of 2, and (2) the erase begins with that same
@@ -856,8 +1024,7 @@ static ssize_t smart_write(FAR struct inode *inode, FAR const unsigned char *buf
 			if (ret < 0) {
 				fdbg("Erase block=%d failed: %d\n", eraseblock, ret);
 
-				/* Unlock the mutex if we add one. */
-
+				smart_devgive(dev);
 				return ret;
 			}
 		}
@@ -882,8 +1049,7 @@ static ssize_t smart_write(FAR struct inode *inode, FAR const unsigned char *buf
 
 			fdbg("Write block %d failed: %d.\n", nextblock, nxfrd);
 
-			/* Unlock the mutex if we add one. */
-
+			smart_devgive(dev);
 			return -EIO;
 		}
 
@@ -895,6 +1061,7 @@ static ssize_t smart_write(FAR struct inode *inode, FAR const unsigned char *buf
 		alignedblock += mtdBlksPerErase;
 	}
 
+	smart_devgive(dev);
 	return nsectors;
 }
 #endif							/* CONFIG_FS_WRITABLE */
@@ -1009,6 +1176,9 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
 		smart_free(dev, dev->sBitMap);
 		dev->sBitMap = NULL;
 	}
+#ifdef CONFIG_MTD_SMART_PAGED_MAP
+	smart_map_release(dev);
+#endif
 
 	dev->cache_entries = 0;
 	dev->cache_lastlog = 0xFFFF;
@@ -1029,6 +1199,14 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
 		dev->wearstatus = NULL;
 	}
 #endif
+#ifdef CONFIG_MTD_SMART_BLOCK_INDEX
+	if (dev->releaseheap != NULL) {
+		smart_free(dev, dev->releaseheap);
+		dev->releaseheap = NULL;
+	}
+
+	dev->indexvalid = false;
+#endif
 
 #ifdef CONFIG_SMARTFS_BAD_SECTOR
 
@@ -1098,6 +1276,22 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
 		goto errexit;
 	}
 
+#ifdef CONFIG_MTD_SMART_PAGED_MAP
+	/* Allocate the map page directory.  Pages are allocated as logical
+	 * sectors in their range get mapped.
+	 */
+
+	dev->sMapDir = (FAR uint16_t **)smart_malloc(dev, SMART_MAP_NPAGES(dev) * sizeof(FAR uint16_t *), "Map directory");
+	if (dev->sMapDir == NULL) {
+		fdbg("Error allocating SMART map directory\n");
+		goto errexit;
+	}
+
+	memset(dev->sMapDir, 0, SMART_MAP_NPAGES(dev) * sizeof(FAR uint16_t *));
+	dev->mappages = 0;
+	dev->mapincomplete = false;
+#endif
+
 	/* Calculate the alloc size of the freesector and release sector arrays. */
 
 #ifdef CONFIG_MTD_SMART_PACK_COUNTS
@@ -1170,6 +1364,22 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
 	dev->uneven_wearcount = 0;
 #endif
 
+#ifdef CONFIG_MTD_SMART_BLOCK_INDEX
+	/* Allocate the block heaps and their position arrays.  They are built
+	 * once the counts are known, after a scan or a low-level format.
+	 */
+
+	dev->releaseheap = (FAR uint16_t *)smart_malloc(dev, 4 * dev->neraseblocks * sizeof(uint16_t), "Block index");
+	if (!dev->releaseheap) {
+		fdbg("Error allocating block index\n");
+		goto errexit;
+	}
+
+	dev->releasepos = dev->releaseheap + dev->neraseblocks;
+	dev->freeheap = dev->releasepos + dev->neraseblocks;
+	dev->freepos = dev->freeheap + dev->neraseblocks;
+#endif
+
 	/* Allocate a read/write buffer. */
 
 	dev->rwbuffer = (FAR char *)smart_malloc(dev, size, "RW Buffer");
@@ -1213,6 +1423,9 @@ errexit:
 	if (dev->sCache) {
 		smart_free(dev, dev->sCache);
 	}
+#ifdef CONFIG_MTD_SMART_PAGED_MAP
+	smart_map_release(dev);
+#endif
 #endif
 
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
@@ -1227,6 +1440,12 @@ errexit:
 	}
 #endif
 
+#ifdef CONFIG_MTD_SMART_BLOCK_INDEX
+	if (dev->releaseheap) {
+		smart_free(dev, dev->releaseheap);
+	}
+#endif
+
 	kmm_free(dev);
 	return -ENOMEM;
 }
@@ -1292,6 +1511,158 @@ errout:
 	return ret;
 }
 
+/****************************************************************************
+ * Name: smart_map_get
+ *
+ * Description: Look up a logical sector in the paged virtual to physical
+ *              map.  Returns true and sets *physical (0xFFFF if the sector
+ *              is not mapped) when the map knows the answer, false when the
+ *              page of the sector could not be allocated and the caller
+ *              must fall back on the sector cache.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_PAGED_MAP
+static bool smart_map_get(FAR struct smart_struct_s *dev, uint16_t logical, FAR uint16_t *physical)
+{
+	FAR uint16_t *page;
+
+	if (dev->sMapDir == NULL || logical >= dev->totalsectors) {
+		return false;
+	}
+
+	page = dev->sMapDir[logical >> CONFIG_MTD_SMART_MAP_PAGE_SHIFT];
+	if (page != NULL) {
+		*physical = page[logical & SMART_MAP_PAGE_MASK];
+		return true;
+	}
+
+	/* No page means no sector in its range is mapped, unless a page
+	 * allocation has failed since the map was built.
+	 */
+
+	if (dev->mapincomplete) {
+		return false;
+	}
+
+	*physical = 0xFFFF;
+	return true;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_map_set
+ *
+ * Description: Record the physical sector of a logical sector in the paged
+ *              map, allocating the page of the sector if needed.  If the
+ *              page cannot be allocated, the map is marked incomplete and
+ *              lookups of sectors in unallocated pages use the sector cache.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_PAGED_MAP
+static void smart_map_set(FAR struct smart_struct_s *dev, uint16_t logical, uint16_t physical)
+{
+	FAR uint16_t **pagep;
+	int x;
+
+	if (dev->sMapDir == NULL || logical >= dev->totalsectors) {
+		return;
+	}
+
+	pagep = &dev->sMapDir[logical >> CONFIG_MTD_SMART_MAP_PAGE_SHIFT];
+	if (*pagep == NULL) {
+		if (physical == 0xFFFF) {
+			return;
+		}
+
+#if CONFIG_MTD_SMART_MAP_MAX_PAGES > 0
+		if (dev->mappages >= CONFIG_MTD_SMART_MAP_MAX_PAGES) {
+			dev->mapincomplete = true;
+			return;
+		}
+#endif
+
+		/* Pages are not allocated with smart_malloc() as there may be more
+		 * of them than allocation debug slots.
+		 */
+
+		*pagep = (FAR uint16_t *)kmm_malloc(SMART_MAP_PAGE_SIZE * sizeof(uint16_t));
+		if (*pagep == NULL) {
+			fdbg("Error allocating SMART map page\n");
+			dev->mapincomplete = true;
+			return;
+		}
+
+		for (x = 0; x < SMART_MAP_PAGE_SIZE; x++) {
+			(*pagep)[x] = 0xFFFF;
+		}
+
+		dev->mappages++;
+	}
+
+	(*pagep)[logical & SMART_MAP_PAGE_MASK] = physical;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_map_release
+ *
+ * Description: Free the pages and the directory of the paged map.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_PAGED_MAP
+static void smart_map_release(FAR struct smart_struct_s *dev)
+{
+	uint16_t x;
+
+	if (dev->sMapDir == NULL) {
+		return;
+	}
+
+	for (x = 0; x < SMART_MAP_NPAGES(dev); x++) {
+		if (dev->sMapDir[x] != NULL) {
+			kmm_free(dev->sMapDir[x]);
+		}
+	}
+
+	smart_free(dev, dev->sMapDir);
+	dev->sMapDir = NULL;
+	dev->mappages = 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_map_reset
+ *
+ * Description: Free the pages of the paged map but keep its directory, so
+ *              that no logical sector is mapped.  Used when the map is built
+ *              again by a scan or a low-level format.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_PAGED_MAP
+static void smart_map_reset(FAR struct smart_struct_s *dev)
+{
+	uint16_t x;
+
+	if (dev->sMapDir == NULL) {
+		return;
+	}
+
+	for (x = 0; x < SMART_MAP_NPAGES(dev); x++) {
+		if (dev->sMapDir[x] != NULL) {
+			kmm_free(dev->sMapDir[x]);
+			dev->sMapDir[x] = NULL;
+		}
+	}
+
+	dev->mappages = 0;
+	dev->mapincomplete = false;
+}
+#endif
+
 /****************************************************************************
  * Name: smart_add_sector_to_cache
  *
@@ -1311,6 +1682,10 @@ static int smart_add_sector_to_cache(FAR struct smart_struct_s *dev, uint16_t lo
 	uint16_t index, x;
 	uint16_t oldest;
 
+#ifdef CONFIG_MTD_SMART_PAGED_MAP
+	smart_map_set(dev, logical, physical);
+#endif
+
 	/* If we aren't full yet, just add the sector to the end of the list. */
 
 	index = 1;
@@ -1389,6 +1764,14 @@ static uint16_t smart_cache_lookup(FAR struct smart_struct_s *dev, uint16_t logi
 		return dev->cache_lastphys;
 	}
 
+#ifdef CONFIG_MTD_SMART_PAGED_MAP
+	/* The paged map answers without touching the cache or the media. */
+
+	if (smart_map_get(dev, logical, &physical)) {
+		return physical;
+	}
+#endif
+
 	/* First search for the entry in the cache. */
 
 	for (x = 0; x < dev->cache_entries; x++) {
@@ -1418,7 +1801,7 @@ static uint16_t smart_cache_lookup(FAR struct smart_struct_s *dev, uint16_t logi
 			for (block = 0; block < dev->geo.neraseblocks; block++) {
 				/* Calculate the read address for this sector. */
 
-				readaddress = block * dev->erasesize + sector * CONFIG_MTD_SMART_SECTOR_SIZE;
+				readaddress = block * dev->erasesize + sector * dev->sectorsize;
 
 				/* Read the header for this sector. */
 
@@ -1444,7 +1827,7 @@ static uint16_t smart_cache_lookup(FAR struct smart_struct_s *dev, uint16_t logi
 
 				/* Test if this sector has been release and skip it if it has. */
 
-				if (SECOR_IS_RELEASED(header)) {
+				if (SECTOR_IS_RELEASED(header)) {
 					continue;
 				}
 
@@ -1489,6 +1872,10 @@ static void smart_update_cache(FAR struct smart_struct_s *dev, uint16_t logical,
 {
 	uint16_t x;
 
+#ifdef CONFIG_MTD_SMART_PAGED_MAP
+	smart_map_set(dev, logical, physical);
+#endif
+
 	/* Scan through all cache entries and find the logical sector entry */
 
 	for (x = 0; x < dev->cache_entries; x++) {
@@ -1808,9 +2195,12 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 		dev->sMap[sector] = -1;
 	}
 #else
-	/* Clear all logical sector used bits. */
+	/* Clear all logical sector used bits and forget the old mapping. */
 
 	memset(dev->sBitMap, 0, (dev->totalsectors + 7) >> 3);
+#ifdef CONFIG_MTD_SMART_PAGED_MAP
+	smart_map_reset(dev);
+#endif
 #endif
 
 	/* Now scan the MTD device. */
@@ -2089,9 +2479,15 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 			readaddress = dev->sMap[logicalsector] * dev->mtdBlksPerSector * dev->geo.blocksize;
 #else
 			/* For minimize RAM, we have to rescan to find the 1st sector claiming to
-			 * be this logical sector.
+			 * be this logical sector, unless the paged map already has it.
 			 */
 
+#ifdef CONFIG_MTD_SMART_PAGED_MAP
+			if (smart_map_get(dev, logicalsector, &loser) && loser != 0xFFFF) {
+				dupsector = loser;
+				readaddress = dupsector * dev->mtdBlksPerSector * dev->geo.blocksize;
+			} else
+#endif
 			for (dupsector = 0; dupsector < sector; dupsector++) {
 				/* Calculate the read address for this sector. */
 
@@ -2204,9 +2600,20 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 		if (logicalsector < dev->reservedsector) {
 			smart_add_sector_to_cache(dev, logicalsector, winner, __LINE__);
 		}
+#ifdef CONFIG_MTD_SMART_PAGED_MAP
+		else {
+			smart_map_set(dev, logicalsector, winner);
+		}
+#endif
 #endif
 	}
 
+#ifdef CONFIG_MTD_SMART_BLOCK_INDEX
+	/* The free and release counts are final.  Index the erase blocks. */
+
+	smart_index_build(dev);
+#endif
+
 #if defined(CONFIG_MTD_SMART_WEAR_LEVEL) && (SMART_STATUS_VERSION == 1)
 #ifdef CONFIG_MTD_SMART_CONVERT_WEAR_FORMAT
 
@@ -2265,6 +2672,8 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 			smart_add_count(dev, dev->freecount, newsector / dev->sectorsPerBlk, -1);
 			smart_add_count(dev, dev->releasecount, sector / dev->sectorsPerBlk, 1);
 #endif
+			smart_index_update(dev, newsector / dev->sectorsPerBlk);
+			smart_index_update(dev, sector / dev->sectorsPerBlk);
 
 		}
 	}
@@ -2427,6 +2836,7 @@ static void smart_erase_block_if_empty(FAR struct smart_struct_s *dev, uint16_t
 		dev->releasecount[block] = prerelease;
 		dev->freecount[block] = dev->availSectPerBlk - prerelease;
 #endif							/* CONFIG_MTD_SMART_PACK_COUNTS */
+		smart_index_update(dev, block);
 
 		/* Now that we have erased this block and updated the release / free counts,
 		 * if we are in WEAR LEVELING enabled mode, we must check if this erase block's
@@ -2634,6 +3044,7 @@ static int smart_relocate_static_data(FAR struct smart_struct_s *dev, uint16_t b
 #else
 			dev->freecount[block]--;
 #endif							/* CONFIG_MTD_SMART_PACK_COUNTS */
+			smart_index_update(dev, block);
 		}
 
 #ifdef CONFIG_SMART_LOCAL_CHECKFREE
@@ -2956,6 +3367,10 @@ static inline int smart_llformat(FAR struct smart_struct_s *dev, unsigned long a
 	dev->freecount[0]--;
 #endif
 
+#ifdef CONFIG_MTD_SMART_BLOCK_INDEX
+	smart_index_build(dev);
+#endif
+
 	/* Now initialize the logical to physical sector map. */
 
 #ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
@@ -2965,6 +3380,13 @@ static inline int smart_llformat(FAR struct smart_struct_s *dev, unsigned long a
 
 		dev->sMap[x] = -1;
 	}
+#else
+	memset(dev->sBitMap, 0, (dev->totalsectors + 7) >> 3);
+#ifdef CONFIG_MTD_SMART_PAGED_MAP
+	smart_map_reset(dev);
+#endif
+	dev->sBitMap[0] |= 1;
+	smart_add_sector_to_cache(dev, 0, 0, __LINE__);
 #endif
 
 #ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
@@ -3171,6 +3593,7 @@ static int smart_relocate_block(FAR struct smart_struct_s *dev, uint16_t block)
 
 	dev->freecount[block] = 0;
 #endif
+	smart_index_update(dev, block);
 
 	/* Next move all live data in the block to a new home. */
 
@@ -3276,6 +3699,7 @@ static int smart_relocate_block(FAR struct smart_struct_s *dev, uint16_t block)
 #else
 		dev->freecount[newsector / dev->sectorsPerBlk]--;
 #endif
+		smart_index_update(dev, newsector / dev->sectorsPerBlk);
 	}
 
 	/* Now erase the erase block. */
@@ -3324,6 +3748,7 @@ static int smart_relocate_block(FAR struct smart_struct_s *dev, uint16_t block)
 	dev->freecount[block] = dev->availSectPerBlk - prerelease;
 	dev->releasecount[block] = prerelease;
 #endif
+	smart_index_update(dev, block);
 
 #ifdef CONFIG_SMART_LOCAL_CHECKFREE
 	if (smart_checkfree(dev, __LINE__) != OK) {
@@ -3349,9 +3774,39 @@ errout:
 #else
 	dev->freecount[block] = freecount;
 #endif
+	smart_index_update(dev, block);
 	return ret;
 }
 
+/****************************************************************************
+ * Name: smart_index_top
+ *
+ * Description:  Return in *block the erase block with the highest count in
+ *               'heap', or 0xFFFF if that count is zero.  Returns false if
+ *               the heap cannot answer: it is not built, or the top block
+ *               has reached 'wearlimit' and the caller's full scan has to
+ *               weigh wear against the counts.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BLOCK_INDEX
+static bool smart_index_top(FAR struct smart_struct_s *dev, FAR uint16_t *heap, FAR uint8_t *pCount, uint8_t wearlimit, FAR uint16_t *block)
+{
+	if (!dev->indexvalid) {
+		return false;
+	}
+
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+	if (smart_get_wear_level(dev, heap[0]) >= wearlimit) {
+		return false;
+	}
+#endif
+
+	*block = smart_index_key(dev, pCount, heap[0]) > 0 ? heap[0] : 0xFFFF;
+	return true;
+}
+#endif
+
 /****************************************************************************
  * Name: smart_findfreephyssector
  *
@@ -3396,6 +3851,12 @@ retry:
 	}
 
 	block = dev->lastallocblock;
+
+#ifdef CONFIG_MTD_SMART_BLOCK_INDEX
+	/* The free heap gives the block with the most free sectors directly. */
+
+	if (!smart_index_top(dev, dev->freeheap, dev->freecount, SMART_WEAR_FULL_RELOCATE_THRESHOLD, &allocblock))
+#endif
 	for (x = 0; x < dev->neraseblocks; x++) {
 		/* Test if this block has more free blocks than the
 		 * currently selected block.
@@ -3588,6 +4049,8 @@ retry:
 					dev->freecount[x / dev->sectorsPerBlk]--;
 					dev->releasecount[allocblock]++;
 #endif
+					smart_index_update(dev, x / dev->sectorsPerBlk);
+					smart_index_update(dev, allocblock);
 					dev->freesectors--;
 					dev->releasesectors++;
 				}
@@ -3662,6 +4125,9 @@ static int smart_garbagecollect(FAR struct smart_struct_s *dev)
 
 			collectblock = 0xFFFF;
 			releasemax = 0;
+#ifdef CONFIG_MTD_SMART_BLOCK_INDEX
+			if (!smart_index_top(dev, dev->releaseheap, dev->releasecount, SMART_WEAR_REORG_THRESHOLD, &collectblock))
+#endif
 			for (x = 0; x < dev->neraseblocks; x++) {
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
 				/* Don't collect blocks that have been worn completely. */
@@ -3727,6 +4193,80 @@ errout:
 }
 #endif							/* CONFIG_FS_WRITABLE */
 
+/****************************************************************************
+ * Name: smart_gc_worker
+ *
+ * Description:  Low priority work which erases, one per run, the erase
+ *               blocks having at least half of their sectors released,
+ *               once the device has been idle for
+ *               CONFIG_MTD_SMART_GC_IDLE_MSEC.  Doing this ahead of time
+ *               keeps smart_garbagecollect() from having to relocate a
+ *               block in the middle of a write.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+static void smart_gc_worker(FAR void *arg)
+{
+	FAR struct smart_struct_s *dev = (FAR struct smart_struct_s *)arg;
+	clock_t idle;
+	uint16_t block;
+	uint16_t released;
+	uint16_t freecount;
+	uint16_t live;
+
+	smart_devtake(dev);
+
+	/* Wait for the device to be idle. */
+
+	idle = clock_systimer() - dev->lastaccess;
+	if (idle < MSEC2TICK(CONFIG_MTD_SMART_GC_IDLE_MSEC)) {
+		work_queue(LPWORK, &dev->gcwork, smart_gc_worker, dev, MSEC2TICK(CONFIG_MTD_SMART_GC_IDLE_MSEC) - idle);
+		smart_devgive(dev);
+		return;
+	}
+
+	if (smart_index_top(dev, dev->releaseheap, dev->releasecount, SMART_WEAR_REORG_THRESHOLD, &block) && block != 0xFFFF) {
+		released = smart_index_key(dev, dev->releasecount, block);
+		freecount = smart_index_key(dev, dev->freecount, block);
+		live = dev->availSectPerBlk - released - freecount;
+
+		/* Only collect when it is worth an erase and the live sectors fit in
+		 * the other blocks with the writer's reserve to spare.
+		 */
+
+		if (released >= (dev->availSectPerBlk >> 1) && dev->freesectors > freecount + live + dev->sectorsPerBlk + 4) {
+			fvdbg("Background collect block %d, released=%d\n", block, released);
+			if (smart_relocate_block(dev, block) == OK) {
+				/* Look for another block on the next run. */
+
+				work_queue(LPWORK, &dev->gcwork, smart_gc_worker, dev, 0);
+			}
+		}
+	}
+
+	smart_devgive(dev);
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_gc_schedule
+ *
+ * Description:  Queue the background garbage collection if sectors have
+ *               been released and it is not already queued.  Called with
+ *               the device held.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+static void smart_gc_schedule(FAR struct smart_struct_s *dev)
+{
+	if (dev->releasesectors > 0 && dev->indexvalid && work_available(&dev->gcwork)) {
+		work_queue(LPWORK, &dev->gcwork, smart_gc_worker, dev, MSEC2TICK(CONFIG_MTD_SMART_GC_IDLE_MSEC));
+	}
+}
+#endif
+
 /****************************************************************************
  * Name: smart_write_wearstatus
  *
@@ -4387,6 +4927,8 @@ relocate_good_sector:
 		dev->releasecount[block]++;
 		dev->freecount[physsector / dev->sectorsPerBlk]--;
 #endif
+		smart_index_update(dev, block);
+		smart_index_update(dev, physsector / dev->sectorsPerBlk);
 		dev->freesectors--;
 		dev->releasesectors++;
 
@@ -4507,6 +5049,8 @@ errout:
 		dev->releasecount[block]++;
 		dev->freecount[physsector / dev->sectorsPerBlk]--;
 #endif
+		smart_index_update(dev, block);
+		smart_index_update(dev, physsector / dev->sectorsPerBlk);
 		dev->freesectors--;
 		dev->releasesectors++;
 
@@ -4880,6 +5424,7 @@ static inline int smart_allocsector(FAR struct smart_struct_s *dev, unsigned lon
 #else
 	dev->freecount[physicalsector / dev->sectorsPerBlk]--;
 #endif
+	smart_index_update(dev, physicalsector / dev->sectorsPerBlk);
 	dev->freesectors--;
 
 	/* Return the logical sector number. */
@@ -4973,6 +5518,7 @@ static inline int smart_freesector(FAR struct smart_struct_s *dev, unsigned long
 #else
 	dev->releasecount[block]++;
 #endif
+	smart_index_update(dev, block);
 
 	/* Unmap this logical sector. */
 
@@ -5016,6 +5562,7 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 #else
 	dev = (FAR struct smart_struct_s *)inode->i_private;
 #endif
+	smart_devtake(dev);
 
 	/* Process the ioctl's we care about first, pass any we don't respond
 	 * to directly to the underlying MTD device.
@@ -5031,7 +5578,8 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 #ifdef CONFIG_DEBUG
 		if (arg == 0) {
 			fdbg("ERROR: BIOC_XIPBASE argument is NULL\n");
-			return -EINVAL;
+			ret = -EINVAL;
+			goto ok_out;
 		}
 #endif
 
@@ -5163,6 +5711,11 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 	}
 
 ok_out:
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+	dev->lastaccess = clock_systimer();
+	smart_gc_schedule(dev);
+#endif
+	smart_devgive(dev);
 	return ret;
 }
 
@@ -5245,6 +5798,9 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd, FAR const char *partn
 #else
 		dev->sCache = NULL;
 		dev->sBitMap = NULL;
+#ifdef CONFIG_MTD_SMART_PAGED_MAP
+		dev->sMapDir = NULL;
+#endif
 #endif
 		dev->rwbuffer = NULL;
 		dev->bytebuffer = NULL;
@@ -5256,6 +5812,15 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd, FAR const char *partn
 #endif
 #ifdef CONFIG_MTD_SMART_ENABLE_CRC
 		dev->allocsector = NULL;
+#endif
+#ifdef CONFIG_MTD_SMART_BLOCK_INDEX
+		dev->releaseheap = NULL;
+		dev->indexvalid = false;
+#endif
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+		sem_init(&dev->exclsem, 0, 1);
+		memset(&dev->gcwork, 0, sizeof(struct work_s));
+		dev->lastaccess = clock_systimer();
 #endif
 		dev->sectorsize = 0;
 		ret = smart_setsectorsize(dev, CONFIG_MTD_SMART_SECTOR_SIZE);
@@ -5354,6 +5919,9 @@ errout:
 #else
 	smart_free(dev, dev->sBitMap);
 	smart_free(dev, dev->sCache);
+#ifdef CONFIG_MTD_SMART_PAGED_MAP
+	smart_map_release(dev);
+#endif
 #endif
 	if (dev->rwbuffer != NULL) {
 		smart_free(dev, dev->rwbuffer);
@@ -5370,6 +5938,14 @@ errout:
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
 	smart_free(dev, dev->erasecounts);
 #endif
+#ifdef CONFIG_MTD_SMART_BLOCK_INDEX
+	if (dev->releaseheap != NULL) {
+		smart_free(dev, dev->releaseheap);
+	}
+#endif
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+	sem_destroy(&dev->exclsem);
+#endif
 #ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
 	if (rootdirdev) {
 		smart_free(dev, rootdirdev);
@@ -5403,11 +5979,13 @@ int smart_validatesector(FAR struct inode *inode, uint16_t logsector, char *vali
 		return -EINVAL;
 	}
 
+	smart_devtake(dev);
 #ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
 	physsector = dev->sMap[logsector];
 #else
 	physsector = smart_cache_lookup(dev, logsector);
 #endif
+	smart_devgive(dev);
 	if (physsector != 0xFFFF) {
 		SET_TO_TRUE(validsectors, physsector);
 		return OK;
@@ -5444,6 +6022,8 @@ int smart_recoversectors(FAR struct inode *inode, char *validsectors, int *nobso
 		smart_validatesector(inode, logicalsector, validsectors);
 	}
 
+	smart_devtake(dev);
+
 	for (sector = 1; sector < totalsectors; sector++) {
 		readaddress = sector * dev->mtdBlksPerSector * dev->geo.blocksize;
 		ret = MTD_READ(dev->mtd, readaddress, sizeof(struct smart_sect_header_s), (FAR uint8_t *)&header);
@@ -5495,6 +6075,7 @@ int smart_recoversectors(FAR struct inode *inode, char *validsectors, int *nobso
 #else
 			dev->releasecount[block]++;
 #endif
+			smart_index_update(dev, block);
 
 			/* if the mapping is sane, Unmap this logical->physicalsector map. */
 			if (physsector == sector) {
@@ -5513,6 +6094,7 @@ int smart_recoversectors(FAR struct inode *inode, char *validsectors, int *nobso
 
 	ret = OK;
 err_out:
+	smart_devgive(dev);
 	return ret;
 }
 #endif
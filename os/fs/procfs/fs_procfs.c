@@ -94,6 +94,7 @@
 
 extern const struct procfs_operations proc_operations;
 extern const struct procfs_operations cpuload_operations;
+extern const struct procfs_operations meminfo_operations;
 extern const struct procfs_operations uptime_operations;
 extern const struct procfs_operations version_operations;
 
@@ -137,6 +138,10 @@ static const struct procfs_entry_s g_procfsentries[] = {
 	{"irqs", &irqs_operations},
 #endif
 
+#if !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMINFO)
+	{"meminfo", &meminfo_operations},
+#endif
+
 #if defined(CONFIG_MTD) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MTD)
 	{"mtd", &mtd_procfsoperations},
 #endif
@@ -0,0 +1,366 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/statfs.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/kmalloc.h>
+#include <tinyara/mm/mm.h>
+#include <tinyara/fs/fs.h>
+#include <tinyara/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+#ifndef CONFIG_FS_PROCFS_EXCLUDE_MEMINFO
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define MEMINFO_LINELEN 48
+
+/* The user heaps come first, then the kernel heaps */
+
+#ifdef CONFIG_MM_KERNEL_HEAP
+#define MEMINFO_NHEAPS  (CONFIG_MM_NHEAPS + CONFIG_KMM_NHEAPS)
+#else
+#define MEMINFO_NHEAPS  CONFIG_MM_NHEAPS
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct meminfo_file_s {
+	struct procfs_file_s base;	/* Base open file structure */
+	char line[MEMINFO_LINELEN];	/* Pre-allocated buffer for formatted lines */
+	struct mm_fraginfo_s info[MEMINFO_NHEAPS];	/* Sampled free chunk statistics */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int meminfo_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode);
+static int meminfo_close(FAR struct file *filep);
+static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer, size_t buflen);
+
+static int meminfo_dup(FAR const struct file *oldp, FAR struct file *newp);
+
+static int meminfo_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Variables
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations meminfo_operations = {
+	meminfo_open,				/* open */
+	meminfo_close,				/* close */
+	meminfo_read,				/* read */
+	NULL,						/* write */
+
+	meminfo_dup,				/* dup */
+
+	NULL,						/* opendir */
+	NULL,						/* closedir */
+	NULL,						/* readdir */
+	NULL,						/* rewinddir */
+
+	meminfo_stat				/* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: meminfo_sample
+ *
+ * Description:
+ *   Take a snapshot of the free chunk statistics of every heap.
+ *
+ ****************************************************************************/
+
+static void meminfo_sample(FAR struct meminfo_file_s *attr)
+{
+	int heap_idx;
+#ifdef CONFIG_MM_KERNEL_HEAP
+	FAR struct mm_heap_s *kheap = kmm_get_heap();
+#endif
+
+	for (heap_idx = 0; heap_idx < CONFIG_MM_NHEAPS; heap_idx++) {
+		mm_fraginfo(mm_get_heap_with_index(heap_idx), &attr->info[heap_idx]);
+	}
+
+#ifdef CONFIG_MM_KERNEL_HEAP
+	for (heap_idx = 0; heap_idx < CONFIG_KMM_NHEAPS; heap_idx++) {
+		mm_fraginfo(&kheap[heap_idx], &attr->info[CONFIG_MM_NHEAPS + heap_idx]);
+	}
+#endif
+}
+
+/****************************************************************************
+ * Name: meminfo_open
+ ****************************************************************************/
+
+static int meminfo_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode)
+{
+	FAR struct meminfo_file_s *attr;
+
+	fvdbg("Open '%s'\n", relpath);
+
+	/* PROCFS is read-only.  Any attempt to open with any kind of write
+	 * access is not permitted.
+	 */
+
+	if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0) {
+		fdbg("ERROR: Only O_RDONLY supported\n");
+		return -EACCES;
+	}
+
+	/* "meminfo" is the only acceptable value for the relpath */
+
+	if (strcmp(relpath, "meminfo") != 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	/* Allocate a container to hold the file attributes */
+
+	attr = (FAR struct meminfo_file_s *)kmm_zalloc(sizeof(struct meminfo_file_s));
+	if (!attr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	/* Save the attributes as the open-specific state in filep->f_priv */
+
+	filep->f_priv = (FAR void *)attr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: meminfo_close
+ ****************************************************************************/
+
+static int meminfo_close(FAR struct file *filep)
+{
+	FAR struct meminfo_file_s *attr;
+
+	/* Recover our private data from the struct file instance */
+
+	attr = (FAR struct meminfo_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	/* Release the file attributes structure */
+
+	kmm_free(attr);
+	filep->f_priv = NULL;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: meminfo_read
+ ****************************************************************************/
+
+static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
+{
+	FAR struct meminfo_file_s *attr;
+	FAR struct mm_fraginfo_s *info;
+	size_t remaining;
+	size_t linesize;
+	size_t copysize;
+	size_t totalsize;
+	off_t offset;
+	int heap_idx;
+	int ndx;
+
+	fvdbg("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+	/* Recover our private data from the struct file instance */
+
+	attr = (FAR struct meminfo_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	/* If f_pos is zero, then sample the heaps.  Otherwise, use the sample
+	 * of the previous read() so that the output stays consistent when it
+	 * is read in pieces.
+	 */
+
+	if (filep->f_pos == 0) {
+		meminfo_sample(attr);
+	}
+
+	remaining = buflen;
+	totalsize = 0;
+	offset = filep->f_pos;
+
+	for (heap_idx = 0; heap_idx < MEMINFO_NHEAPS && remaining > 0; heap_idx++) {
+		info = &attr->info[heap_idx];
+
+		/* Show the summary of the heap */
+
+		linesize = snprintf(attr->line, MEMINFO_LINELEN, "%s heap %d\n", heap_idx < CONFIG_MM_NHEAPS ? "User" : "Kernel", heap_idx < CONFIG_MM_NHEAPS ? heap_idx : heap_idx - CONFIG_MM_NHEAPS);
+		copysize = procfs_memcpy(attr->line, linesize, buffer, remaining, &offset);
+		totalsize += copysize;
+		buffer += copysize;
+		remaining -= copysize;
+
+		linesize = snprintf(attr->line, MEMINFO_LINELEN, "  %-16s%u\n", "Free:", info->freesize);
+		copysize = procfs_memcpy(attr->line, linesize, buffer, remaining, &offset);
+		totalsize += copysize;
+		buffer += copysize;
+		remaining -= copysize;
+
+		linesize = snprintf(attr->line, MEMINFO_LINELEN, "  %-16s%u\n", "Largest free:", info->largest);
+		copysize = procfs_memcpy(attr->line, linesize, buffer, remaining, &offset);
+		totalsize += copysize;
+		buffer += copysize;
+		remaining -= copysize;
+
+		linesize = snprintf(attr->line, MEMINFO_LINELEN, "  %-16s%d\n", "Free chunks:", info->nfree);
+		copysize = procfs_memcpy(attr->line, linesize, buffer, remaining, &offset);
+		totalsize += copysize;
+		buffer += copysize;
+		remaining -= copysize;
+
+		linesize = snprintf(attr->line, MEMINFO_LINELEN, "  %-16s%d%%\n", "Fragmentation:", info->fragindex);
+		copysize = procfs_memcpy(attr->line, linesize, buffer, remaining, &offset);
+		totalsize += copysize;
+		buffer += copysize;
+		remaining -= copysize;
+
+		/* Show the free chunks per nodelist bucket, skipping the empty ones */
+
+		linesize = snprintf(attr->line, MEMINFO_LINELEN, "  %10s %8s %10s\n", "Up to", "Chunks", "Size");
+		copysize = procfs_memcpy(attr->line, linesize, buffer, remaining, &offset);
+		totalsize += copysize;
+		buffer += copysize;
+		remaining -= copysize;
+
+		for (ndx = 0; ndx < MM_NNODES && remaining > 0; ndx++) {
+			if (info->count[ndx] == 0) {
+				continue;
+			}
+
+			linesize = snprintf(attr->line, MEMINFO_LINELEN, "  %10u %8d %10u\n", 1 << (ndx + MM_MIN_SHIFT + 1), info->count[ndx], info->size[ndx]);
+			copysize = procfs_memcpy(attr->line, linesize, buffer, remaining, &offset);
+			totalsize += copysize;
+			buffer += copysize;
+			remaining -= copysize;
+		}
+	}
+
+	/* Update the file offset */
+
+	filep->f_pos += totalsize;
+	return totalsize;
+}
+
+/****************************************************************************
+ * Name: meminfo_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int meminfo_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+	FAR struct meminfo_file_s *oldattr;
+	FAR struct meminfo_file_s *newattr;
+
+	fvdbg("Dup %p->%p\n", oldp, newp);
+
+	/* Recover our private data from the old struct file instance */
+
+	oldattr = (FAR struct meminfo_file_s *)oldp->f_priv;
+	DEBUGASSERT(oldattr);
+
+	/* Allocate a new container to hold the task and attribute selection */
+
+	newattr = (FAR struct meminfo_file_s *)kmm_malloc(sizeof(struct meminfo_file_s));
+	if (!newattr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	/* The copy the file attributes from the old attributes to the new */
+
+	memcpy(newattr, oldattr, sizeof(struct meminfo_file_s));
+
+	/* Save the new attributes in the new file structure */
+
+	newp->f_priv = (FAR void *)newattr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: meminfo_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int meminfo_stat(const char *relpath, struct stat *buf)
+{
+	/* "meminfo" is the only acceptable value for the relpath */
+
+	if (strcmp(relpath, "meminfo") != 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	/* "meminfo" is the name for a read-only file */
+
+	buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+	buf->st_size = 0;
+	buf->st_blksize = 0;
+	buf->st_blocks = 0;
+	return OK;
+}
+
+#endif							/* CONFIG_FS_PROCFS_EXCLUDE_MEMINFO */
+#endif							/* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
@@ -66,6 +66,9 @@
 
 #include <tinyara/fs/mtd.h>
 #include <tinyara/fs/smart.h>
+#ifdef CONFIG_SMARTFS_JOURNAL_GROUP_COMMIT
+#include <tinyara/wqueue.h>
+#endif
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -359,6 +362,23 @@ struct smartfs_ofile_s {
 								 * causes the sector to change. */
 };
 
+#ifdef CONFIG_SMARTFS_DENTRY_CACHE
+/* This structure is one slot of the directory entry lookup cache.  It
+ * remembers where a (parent directory, name) pair was last found so that
+ * path resolution does not have to rescan the directory chain.
+ */
+
+struct smartfs_dcache_s {
+	uint16_t parent;			/* 1st sector of parent dir, 0 if unused */
+	uint16_t dsector;			/* Sector number of the directory entry */
+	uint16_t doffset;			/* Offset of the directory entry */
+	uint16_t firstsector;		/* Sector number of the name */
+	uint16_t flags;				/* Flags, including mode */
+	uint32_t utc;				/* Time stamp */
+	char name[CONFIG_SMARTFS_MAXNAMLEN];	/* inode name */
+};
+#endif
+
 /* This structure represents the overall mountpoint state.  An instance of this
  * structure is retained as inode private data on each mountpoint that is
  * mounted with a smartfs filesystem.
@@ -383,6 +403,11 @@ struct smartfs_mountpt_s {
 	struct journal_transaction_manager_s *journal;
 #endif
 	uint8_t fs_rootsector;		/* Root directory sector num */
+#ifdef CONFIG_SMARTFS_DENTRY_CACHE
+	uint32_t fs_dcache_hits;	/* Lookups resolved from the cache */
+	uint32_t fs_dcache_misses;	/* Lookups that scanned the directory */
+	struct smartfs_dcache_s fs_dcache[CONFIG_SMARTFS_DENTRY_CACHE_SIZE];
+#endif
 };
 
 #ifdef CONFIG_SMARTFS_JOURNALING
@@ -480,6 +505,14 @@ struct journal_transaction_manager_s {
 	uint8_t *buffer;			/* Buffer to hold logging entry header and data */
 	uint8_t *active_sectors;	/* Map to mark sectors which are written but not yet synced */
 	struct active_write_node_s *list;	/* Linked list to hold information about writes which need sync */
+#ifdef CONFIG_SMARTFS_JOURNAL_GROUP_COMMIT
+	uint8_t npending;			/* Finished transactions not yet marked in the journal */
+	clock_t pendtime;			/* System time the oldest of them finished */
+	uint16_t pendsector[CONFIG_SMARTFS_JOURNAL_GROUP_MAX];	/* Journal sector of each one */
+	uint16_t pendoffset[CONFIG_SMARTFS_JOURNAL_GROUP_MAX];	/* Journal offset of each one */
+	bool flushqueued;			/* flushwork is queued or about to run */
+	struct work_s flushwork;	/* Commits pending marks once they expire */
+#endif
 };
 #endif
 /****************************************************************************
@@ -511,6 +544,12 @@ int smartfs_createentry(struct smartfs_mountpt_s *fs, uint16_t parentdirsector,
 
 int smartfs_deleteentry(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *entry);
 
+#ifdef CONFIG_SMARTFS_DENTRY_CACHE
+void smartfs_dcache_invalidate(struct smartfs_mountpt_s *fs);
+#else
+#define smartfs_dcache_invalidate(fs)
+#endif
+
 int smartfs_countdirentries(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *entry);
 
 int smartfs_truncatefile(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *entry, FAR struct smartfs_ofile_s *sf);
@@ -550,5 +589,12 @@ int smartfs_journal_init(struct smartfs_mountpt_s *fs);
 int smartfs_create_journalentry(struct smartfs_mountpt_s *fs, enum logging_transaction_type_e type, uint16_t curr_sector, uint16_t offset, uint16_t datalen, uint16_t genericdata, uint8_t needsync, const uint8_t *data, uint16_t *t_sector, uint16_t *t_offset);
 int smartfs_finish_journalentry(struct smartfs_mountpt_s *fs, uint16_t curr_sector, uint16_t sector, uint16_t offset, enum logging_transaction_type_e type);
 #endif
+#ifdef CONFIG_SMARTFS_JOURNAL_GROUP_COMMIT
+int smartfs_journal_flush(struct smartfs_mountpt_s *fs);
+void smartfs_journal_stop(struct smartfs_mountpt_s *fs);
+#else
+#define smartfs_journal_flush(fs) (OK)
+#define smartfs_journal_stop(fs)
+#endif
 
 #endif							/* __FS_SMARTFS_SMARTFS_H */
@@ -153,6 +153,9 @@ static size_t smartfs_mem_read(FAR struct file *filep, FAR char *buffer, size_t
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
 static size_t smartfs_erasemap_read(FAR struct file *filep, FAR char *buffer, size_t buflen);
 #endif
+#ifdef CONFIG_SMARTFS_DENTRY_CACHE
+static size_t smartfs_dcache_read(FAR struct file *filep, FAR char *buffer, size_t buflen);
+#endif
 #ifdef CONFIG_SMARTFS_FILE_SECTOR_DEBUG
 static size_t smartfs_files_read(FAR struct file *filep, FAR char *buffer, size_t buflen);
 #endif
@@ -162,6 +165,9 @@ static size_t smartfs_files_read(FAR struct file *filep, FAR char *buffer, size_
  ****************************************************************************/
 
 static const struct smartfs_procfs_entry_s g_direntry[] = {
+#ifdef CONFIG_SMARTFS_DENTRY_CACHE
+	{"dcache", smartfs_dcache_read, NULL, DTYPE_FILE},
+#endif
 	{"debuglevel", NULL, smartfs_debug_write, DTYPE_FILE},
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
 	{"erasemap", smartfs_erasemap_read, NULL, DTYPE_FILE},
@@ -781,6 +787,36 @@ static size_t smartfs_status_read(FAR struct file *filep, FAR char *buffer, size
 	return len;
 }
 
+/****************************************************************************
+ * Name: smartfs_dcache_read
+ *
+ * Description: Performs the read operation for the "dcache" dir entry.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMARTFS_DENTRY_CACHE
+static size_t smartfs_dcache_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
+{
+	FAR struct smartfs_file_s *priv;
+	FAR struct smartfs_mountpt_s *fs;
+	size_t len;
+
+	priv = (FAR struct smartfs_file_s *)filep->f_priv;
+	fs = priv->level1.mount;
+
+	len = 0;
+	if (priv->offset == 0) {
+		len = snprintf(buffer, buflen, "Slots   %d\nHits    %u\nMisses  %u\n", CONFIG_SMARTFS_DENTRY_CACHE_SIZE, (unsigned int)fs->fs_dcache_hits, (unsigned int)fs->fs_dcache_misses);
+
+		/* Indicate we have already provided all the data */
+
+		priv->offset = 0xFF;
+	}
+
+	return len;
+}
+#endif
+
 /****************************************************************************
  * Name: smartfs_mem_read
  *
@@ -1591,6 +1591,10 @@ static int smartfs_bind(FAR struct inode *blkdriver, const void *data, void **ha
 	}
 #endif
 
+	/* Journal replay and recovery may have rewritten directory entries */
+
+	smartfs_dcache_invalidate(fs);
+
 	smartfs_semgive(fs);
 	return ret;
 
@@ -1627,6 +1631,9 @@ static int smartfs_unbind(void *handle, FAR struct inode **blkdriver)
 		smartfs_semgive(fs);
 		return -EBUSY;
 	}
+#ifdef CONFIG_SMARTFS_JOURNALING
+	smartfs_journal_stop(fs);
+#endif
 	/* Unmount ... close the block driver */
 	ret = smartfs_unmount(fs);
 #ifdef CONFIG_SMARTFS_JOURNALING
@@ -2129,6 +2136,7 @@ int smartfs_rename(struct inode *mountpt, const char *oldrelpath, const char *ne
 		readwrite.count = sizeof(uint16_t);
 		readwrite.buffer = (uint8_t *)tmp_pntr;
 		ret = FS_IOCTL(fs, BIOC_WRITESECT, (unsigned long)&readwrite);
+		smartfs_dcache_invalidate(fs);
 #ifdef CONFIG_SMARTFS_JOURNALING
 		retj = smartfs_finish_journalentry(fs, 0, t_sector, t_offset, T_RENAME);
 		if (retj != OK) {
@@ -62,12 +62,14 @@
 #include <string.h>
 #include <time.h>
 #include <semaphore.h>
+#include <unistd.h>
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
 #include <queue.h>
 
 #include <tinyara/kmalloc.h>
+#include <tinyara/clock.h>
 #include <tinyara/fs/fs.h>
 #include <tinyara/fs/ioctl.h>
 
@@ -182,6 +184,11 @@ static int smartfs_verify_transaction(struct smartfs_mountpt_s *fs, uint16_t sec
 #endif
 static uint8_t smartfs_calc_crc_entry(struct journal_transaction_manager_s *j_mgr);
 static uint8_t smartfs_calc_crc_data(struct journal_transaction_manager_s *j_mgr);
+#ifdef CONFIG_SMARTFS_JOURNAL_GROUP_COMMIT
+static bool smartfs_journal_expired(struct journal_transaction_manager_s *j_mgr);
+static bool smartfs_journal_ispending(struct journal_transaction_manager_s *j_mgr, uint16_t sector, uint16_t offset);
+static void smartfs_journal_worker(FAR void *arg);
+#endif
 #endif
 /****************************************************************************
  * Public Variables
@@ -191,6 +198,149 @@ static uint8_t smartfs_calc_crc_data(struct journal_transaction_manager_s *j_mgr
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_SMARTFS_DENTRY_CACHE
+/****************************************************************************
+ * Name: smartfs_dcache_slot
+ *
+ * Description: Returns the dentry cache slot for the (parent, name) pair,
+ *              or NULL if the name cannot be held in the cache.
+ *
+ ****************************************************************************/
+
+static struct smartfs_dcache_s *smartfs_dcache_slot(struct smartfs_mountpt_s *fs, uint16_t parent, const char *name)
+{
+	uint32_t hash;
+	uint16_t len;
+
+	hash = parent;
+	for (len = 0; name[len] != '\0'; len++) {
+		hash = hash * 31 + (uint8_t)name[len];
+	}
+
+	/* Names longer than the slot or the on-media name field are matched
+	 * by prefix during the directory scan.  Leave those to the scan.
+	 */
+
+	if (len > CONFIG_SMARTFS_MAXNAMLEN || len > fs->fs_llformat.namesize) {
+		return NULL;
+	}
+
+	return &fs->fs_dcache[hash % CONFIG_SMARTFS_DENTRY_CACHE_SIZE];
+}
+
+/****************************************************************************
+ * Name: smartfs_dcache_lookup
+ *
+ * Description: Looks for name in the directory starting at parent.
+ *
+ ****************************************************************************/
+
+static struct smartfs_dcache_s *smartfs_dcache_lookup(struct smartfs_mountpt_s *fs, uint16_t parent, const char *name)
+{
+	struct smartfs_dcache_s *dc;
+
+	dc = smartfs_dcache_slot(fs, parent, name);
+	if (dc != NULL && dc->parent == parent && strncmp(dc->name, name, CONFIG_SMARTFS_MAXNAMLEN) == 0) {
+		fs->fs_dcache_hits++;
+		return dc;
+	}
+
+	fs->fs_dcache_misses++;
+	return NULL;
+}
+
+/****************************************************************************
+ * Name: smartfs_dcache_insert
+ *
+ * Description: Remembers the directory entry found at dsector / doffset.
+ *
+ ****************************************************************************/
+
+static void smartfs_dcache_insert(struct smartfs_mountpt_s *fs, uint16_t parent, const char *name, uint16_t dsector, uint16_t doffset, struct smartfs_entry_header_s *entry)
+{
+	struct smartfs_dcache_s *dc;
+
+	dc = smartfs_dcache_slot(fs, parent, name);
+	if (dc == NULL) {
+		return;
+	}
+
+	dc->parent = parent;
+	dc->dsector = dsector;
+	dc->doffset = doffset;
+#ifdef CONFIG_SMARTFS_ALIGNED_ACCESS
+	dc->firstsector = smartfs_rdle16(&entry->firstsector);
+	dc->flags = smartfs_rdle16(&entry->flags);
+	dc->utc = smartfs_rdle32(&entry->utc);
+#else
+	dc->firstsector = entry->firstsector;
+	dc->flags = entry->flags;
+	dc->utc = entry->utc;
+#endif
+	strncpy(dc->name, name, CONFIG_SMARTFS_MAXNAMLEN);
+}
+#endif							/* CONFIG_SMARTFS_DENTRY_CACHE */
+
+/****************************************************************************
+ * Name: smartfs_calc_datlen
+ *
+ * Description: Scan the file's sectors to calculate the length and perform
+ *              a rudimentary check.
+ *
+ ****************************************************************************/
+
+static void smartfs_calc_datlen(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *direntry)
+{
+	int ret;
+	uint16_t sector;
+	struct smartfs_chain_header_s *header;
+	struct smart_read_write_s readwrite;
+#ifdef CONFIG_SMARTFS_DYNAMIC_HEADER
+	int used_value;
+#endif
+
+	header = (struct smartfs_chain_header_s *)fs->fs_rwbuffer;
+	sector = direntry->firstsector;
+	readwrite.count = sizeof(struct smartfs_chain_header_s);
+	readwrite.buffer = (uint8_t *)fs->fs_rwbuffer;
+	readwrite.offset = 0;
+
+	while (sector != SMARTFS_ERASEDSTATE_16BIT) {
+		/* Read the next sector of the file */
+
+		readwrite.logsector = sector;
+		ret = FS_IOCTL(fs, BIOC_READSECT, (unsigned long)&readwrite);
+		if (ret < 0) {
+			fdbg("Error in sector chain at %d!\n", sector);
+			break;
+		}
+#ifdef CONFIG_SMARTFS_DYNAMIC_HEADER
+		if (SMARTFS_NEXTSECTOR(header) == SMARTFS_ERASEDSTATE_16BIT) {
+
+			readwrite.count = fs->fs_llformat.availbytes;
+			readwrite.buffer = (uint8_t *)fs->fs_chunk_buffer;
+
+			ret = FS_IOCTL(fs, BIOC_READSECT, (unsigned long)&readwrite);
+			if (ret < 0) {
+				fdbg("Error %d reading sector %d header\n", ret, sector);
+				break;
+			}
+			used_value = get_leftover_used_byte_count((uint8_t *)readwrite.buffer, get_used_byte_count((uint8_t *)header->used));
+			direntry->datlen += used_value;
+		} else {
+			direntry->datlen += (fs->fs_llformat.availbytes - sizeof(struct smartfs_chain_header_s));
+		}
+		readwrite.buffer = (uint8_t *)fs->fs_rwbuffer;
+#else
+		/* Add used bytes to the total and point to next sector */
+		if (SMARTFS_USED(header) != SMARTFS_ERASEDSTATE_16BIT) {
+			direntry->datlen += SMARTFS_USED(header);
+		}
+#endif
+		sector = SMARTFS_NEXTSECTOR(header);
+	}
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -750,6 +900,21 @@ int smartfs_unmount(struct smartfs_mountpt_s *fs)
 	return ret;
 }
 
+#ifdef CONFIG_SMARTFS_DENTRY_CACHE
+/****************************************************************************
+ * Name: smartfs_dcache_invalidate
+ *
+ * Description: Drops every entry of the dentry cache.  Called whenever a
+ *              directory entry is created, deleted or renamed.
+ *
+ ****************************************************************************/
+
+void smartfs_dcache_invalidate(struct smartfs_mountpt_s *fs)
+{
+	memset(fs->fs_dcache, 0, sizeof(fs->fs_dcache));
+}
+#endif
+
 /****************************************************************************
  * Name: smartfs_finddirentry
  *
@@ -780,8 +945,8 @@ int smartfs_finddirentry(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *d
 	struct smartfs_chain_header_s *header;
 	struct smart_read_write_s readwrite;
 	struct smartfs_entry_header_s *entry;
-#ifdef CONFIG_SMARTFS_DYNAMIC_HEADER
-	int used_value;
+#ifdef CONFIG_SMARTFS_DENTRY_CACHE
+	struct smartfs_dcache_s *dc;
 #endif
 
 	/* Initialize directory level zero as the root sector */
@@ -855,6 +1020,57 @@ int smartfs_finddirentry(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *d
 
 			dirsector = dirstack[depth];
 
+#ifdef CONFIG_SMARTFS_DENTRY_CACHE
+			/* Try the dentry cache before scanning the directory chain */
+
+			dc = smartfs_dcache_lookup(fs, dirsector, fs->fs_workbuffer);
+			if (dc != NULL) {
+				if (*ptr == '\0') {
+					/* We are at the last segment.  Report the entry */
+
+					direntry->firstsector = dc->firstsector;
+					direntry->flags = dc->flags;
+					direntry->utc = dc->utc;
+					direntry->dsector = dc->dsector;
+					direntry->doffset = dc->doffset;
+					direntry->dfirst = dirsector;
+					if (direntry->name == NULL) {
+						direntry->name = (char *)kmm_malloc(fs->fs_llformat.namesize + 1);
+						if (direntry->name == NULL) {
+							ret = ERROR;
+							goto errout;
+						}
+					}
+
+					memset(direntry->name, 0, fs->fs_llformat.namesize + 1);
+					strncpy(direntry->name, dc->name, fs->fs_llformat.namesize);
+					direntry->datlen = 0;
+					if ((direntry->flags & SMARTFS_DIRENT_TYPE) == SMARTFS_DIRENT_TYPE_FILE) {
+						smartfs_calc_datlen(fs, direntry);
+					}
+
+					*parentdirsector = dirsector;
+					*filename = segment;
+					ret = OK;
+					goto errout;
+				}
+
+				if ((dc->flags & SMARTFS_DIRENT_TYPE) != SMARTFS_DIRENT_TYPE_DIR) {
+					ret = -ENOTDIR;
+					goto errout;
+				}
+
+				if (depth >= CONFIG_SMARTFS_DIRDEPTH - 1) {
+					ret = -ENAMETOOLONG;
+					goto errout;
+				}
+
+				dirstack[++depth] = dc->firstsector;
+				segment = ptr + 1;
+				continue;
+			}
+#endif
+
 			/* Read the directory */
 
 			offset = 0xFFFF;
@@ -935,56 +1151,16 @@ int smartfs_finddirentry(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *d
 							memset(direntry->name, 0, fs->fs_llformat.namesize + 1);
 							strncpy(direntry->name, entry->name, fs->fs_llformat.namesize);
 							direntry->datlen = 0;
+#ifdef CONFIG_SMARTFS_DENTRY_CACHE
+							smartfs_dcache_insert(fs, dirstack[depth], fs->fs_workbuffer, readwrite.logsector, offset, entry);
+#endif
 
 							/* Scan the file's sectors to calculate the length and perform
 							 * a rudimentary check.
 							 */
 
-#ifdef CONFIG_SMARTFS_ALIGNED_ACCESS
-							if ((smartfs_rdle16(&entry->flags) & SMARTFS_DIRENT_TYPE) == SMARTFS_DIRENT_TYPE_FILE) {
-								dirsector = smartfs_rdle16(&entry->firstsector);
-#else
-							if ((entry->flags & SMARTFS_DIRENT_TYPE) == SMARTFS_DIRENT_TYPE_FILE) {
-								dirsector = entry->firstsector;
-#endif
-								readwrite.count = sizeof(struct smartfs_chain_header_s);
-								readwrite.buffer = (uint8_t *)fs->fs_rwbuffer;
-								readwrite.offset = 0;
-
-								while (dirsector != SMARTFS_ERASEDSTATE_16BIT) {
-									/* Read the next sector of the file */
-
-									readwrite.logsector = dirsector;
-									ret = FS_IOCTL(fs, BIOC_READSECT, (unsigned long)&readwrite);
-									if (ret < 0) {
-										fdbg("Error in sector chain at %d!\n", dirsector);
-										break;
-									}
-#ifdef CONFIG_SMARTFS_DYNAMIC_HEADER
-									if (SMARTFS_NEXTSECTOR(header) == SMARTFS_ERASEDSTATE_16BIT) {
-
-										readwrite.count = fs->fs_llformat.availbytes;
-										readwrite.buffer = (uint8_t *)fs->fs_chunk_buffer;
-
-										ret = FS_IOCTL(fs, BIOC_READSECT, (unsigned long)&readwrite);
-										if (ret < 0) {
-											fdbg("Error %d reading sector %d header\n", ret, sf->currsector);
-											break;
-										}
-										used_value = get_leftover_used_byte_count((uint8_t *)readwrite.buffer, get_used_byte_count((uint8_t *)header->used));
-										direntry->datlen += used_value;
-									} else {
-										direntry->datlen += (fs->fs_llformat.availbytes - sizeof(struct smartfs_chain_header_s));
-									}
-									readwrite.buffer = (uint8_t *)fs->fs_rwbuffer;
-#else
-									/* Add used bytes to the total and point to next sector */
-									if (SMARTFS_USED(header) != SMARTFS_ERASEDSTATE_16BIT) {
-										direntry->datlen += SMARTFS_USED(header);
-									}
-#endif
-									dirsector = SMARTFS_NEXTSECTOR(header);
-								}
+							if ((direntry->flags & SMARTFS_DIRENT_TYPE) == SMARTFS_DIRENT_TYPE_FILE) {
+								smartfs_calc_datlen(fs, direntry);
 							}
 
 							*parentdirsector = dirstack[depth];
@@ -1014,6 +1190,9 @@ int smartfs_finddirentry(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *d
 								ret = -ENAMETOOLONG;
 								goto errout;
 							}
+#ifdef CONFIG_SMARTFS_DENTRY_CACHE
+							smartfs_dcache_insert(fs, dirstack[depth], fs->fs_workbuffer, readwrite.logsector, offset, entry);
+#endif
 #ifdef CONFIG_SMARTFS_ALIGNED_ACCESS
 							dirstack[++depth] = smartfs_rdle16(&entry->firstsector);
 #else
@@ -1110,6 +1289,8 @@ int smartfs_createentry(struct smartfs_mountpt_s *fs, uint16_t parentdirsector,
 		return -ENAMETOOLONG;
 	}
 
+	smartfs_dcache_invalidate(fs);
+
 	/* Read the parent directory sector and find a place to insert
 	 * the new entry.
 	 */
@@ -1349,6 +1530,8 @@ int smartfs_deleteentry(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *en
 	 *        bytes of the buffer to read in header info.
 	 */
 
+	smartfs_dcache_invalidate(fs);
+
 	nextsector = entry->firstsector;
 	header = (struct smartfs_chain_header_s *)fs->fs_rwbuffer;
 	readwrite.offset = 0;
@@ -1594,6 +1777,17 @@ int smartfs_truncatefile(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *e
 	struct smartfs_chain_header_s *header;
 	struct smart_read_write_s readwrite;
 
+#ifdef CONFIG_SMARTFS_JOURNALING
+	/* Truncation is not logged.  Commit pending marks so that older writes
+	 * are not replayed into the freed sectors.
+	 */
+
+	ret = smartfs_journal_flush(fs);
+	if (ret != OK) {
+		return ret;
+	}
+#endif
+
 	/* Walk through the directory's sectors and count entries */
 
 	nextsector = entry->firstsector;
@@ -1920,6 +2114,11 @@ int smartfs_journal_init(struct smartfs_mountpt_s *fs)
 	fs->journal = journal;
 	journal->jarea = smartfs_get_journal_area(fs);
 	journal->list = NULL;
+#ifdef CONFIG_SMARTFS_JOURNAL_GROUP_COMMIT
+	journal->npending = 0;
+	journal->flushqueued = false;
+	memset(&journal->flushwork, 0, sizeof(struct work_s));
+#endif
 
 	ret = FS_IOCTL(fs, BIOC_GETFORMAT, (unsigned long)&fmt);
 	if (ret != OK) {
@@ -2836,6 +3035,12 @@ static int move_journal_area(struct smartfs_mountpt_s *fs)
 			ret = OK;
 			break;
 		}
+#ifdef CONFIG_SMARTFS_JOURNAL_GROUP_COMMIT
+		/* A finished transaction whose mark is still pending counts as finished */
+		if (smartfs_journal_ispending(j_mgr, readsect, readoffset - sizeof(struct smartfs_logging_entry_s))) {
+			T_SET_TRANSACTION(entry->trans_info, TRANS_FINISHED);
+		}
+#endif
 		/* Check whether this transaction exists, and logging of transaction has been completed */
 		if (T_EXIST_CHECK(entry->trans_info) && T_START_CHECK(entry->trans_info)) {
 			/* If this entry has additional data, read additional data
@@ -2887,6 +3092,9 @@ static int move_journal_area(struct smartfs_mountpt_s *fs)
 	}
 	j_mgr->sector = temp_mgr.sector;
 	j_mgr->offset = temp_mgr.offset;
+#ifdef CONFIG_SMARTFS_JOURNAL_GROUP_COMMIT
+	j_mgr->npending = 0;
+#endif
 
 errout:
 	if (temp_mgr.buffer) {
@@ -2895,6 +3103,39 @@ errout:
 	return ret;
 }
 
+#ifdef CONFIG_SMARTFS_JOURNAL_GROUP_COMMIT
+/****************************************************************************
+ * Name: smartfs_journal_expired
+ *
+ * Description: True if the oldest pending finish mark has waited longer
+ *              than the group commit latency bound.
+ *
+ ****************************************************************************/
+static bool smartfs_journal_expired(struct journal_transaction_manager_s *j_mgr)
+{
+	return j_mgr->npending > 0 && clock_systimer() - j_mgr->pendtime >= MSEC2TICK(CONFIG_SMARTFS_JOURNAL_GROUP_MSEC);
+}
+
+/****************************************************************************
+ * Name: smartfs_journal_ispending
+ *
+ * Description: True if the transaction at 'sector' and 'offset' is
+ *              finished but its mark has not been written yet.
+ *
+ ****************************************************************************/
+static bool smartfs_journal_ispending(struct journal_transaction_manager_s *j_mgr, uint16_t sector, uint16_t offset)
+{
+	uint8_t i;
+
+	for (i = 0; i < j_mgr->npending; i++) {
+		if (j_mgr->pendsector[i] == sector && j_mgr->pendoffset[i] == offset) {
+			return true;
+		}
+	}
+	return false;
+}
+#endif
+
 /****************************************************************************
  * Name: smartfs_set_transaction
  *
@@ -3021,6 +3262,31 @@ static int smartfs_write_transaction(struct smartfs_mountpt_s *fs, struct journa
 	req.offset = *offset;
 	req.count = sizeof(struct smartfs_logging_entry_s);
 	req.buffer = j_mgr->buffer;
+#ifdef CONFIG_SMARTFS_JOURNAL_GROUP_COMMIT
+	if (entry->datalen > 0 && GET_TRANS_TYPE(entry->trans_info) != T_DELETE) {
+		req.count += entry->datalen;
+	}
+
+	if (req.offset + req.count <= j_mgr->availbytes) {
+		/* The whole record fits in this sector, so write the header and the
+		 * data in one go.  It is then marked as STARTED as usual.
+		 */
+
+		ret = FS_IOCTL(fs, BIOC_WRITESECT, (unsigned long)&req);
+		if (ret != OK) {
+			fdbg("write entry failed ret : %d\n", ret);
+			return ret;
+		}
+		j_mgr->offset += req.count;
+
+		ret = smartfs_set_transaction(fs, *sector, *offset, TRANS_STARTED);
+		if (ret != OK) {
+			fdbg("setting status failed : %d\n", ret);
+		}
+		return ret;
+	}
+	req.count = sizeof(struct smartfs_logging_entry_s);
+#endif
 	/* Write the entry */
 	ret = FS_IOCTL(fs, BIOC_WRITESECT, (unsigned long)&req);
 	if (ret != OK) {
@@ -3271,6 +3537,19 @@ int smartfs_create_journalentry(struct smartfs_mountpt_s *fs, enum logging_trans
 		return OK;
 	}
 
+#ifdef CONFIG_SMARTFS_JOURNAL_GROUP_COMMIT
+	/* Only writes may be logged while finish marks are pending.  Anything
+	 * else must not be ordered behind a replay of older writes.
+	 */
+
+	if (type != T_WRITE || smartfs_journal_expired(j_mgr)) {
+		ret = smartfs_journal_flush(fs);
+		if (ret != OK) {
+			return ret;
+		}
+	}
+#endif
+
 	entry = (struct smartfs_logging_entry_s *)(j_mgr->buffer);
 
 	T_STATUS_RESET(entry->trans_info);
@@ -3502,6 +3781,145 @@ int smartfs_finish_journalentry(struct smartfs_mountpt_s *fs, uint16_t curr_sect
 	if (IS_ACTIVE(j_mgr->active_sectors, curr_sector) && type == T_SYNC) {
 		remove_from_list(j_mgr, curr_sector);
 	}
+#ifdef CONFIG_SMARTFS_JOURNAL_GROUP_COMMIT
+	if (type == T_WRITE) {
+		/* Replaying a finished overwrite is harmless, so hold the mark and
+		 * commit it together with the next ones.
+		 */
+
+		if (j_mgr->npending == 0) {
+			j_mgr->pendtime = clock_systimer();
+
+			/* Commit the marks when they expire even if no further journal
+			 * operation comes along.
+			 */
+
+			if (!j_mgr->flushqueued && work_queue(LPWORK, &j_mgr->flushwork, smartfs_journal_worker, fs, MSEC2TICK(CONFIG_SMARTFS_JOURNAL_GROUP_MSEC)) == OK) {
+				j_mgr->flushqueued = true;
+			}
+		}
+		j_mgr->pendsector[j_mgr->npending] = sector;
+		j_mgr->pendoffset[j_mgr->npending] = offset;
+		j_mgr->npending++;
+
+		if (j_mgr->npending >= CONFIG_SMARTFS_JOURNAL_GROUP_MAX || smartfs_journal_expired(j_mgr)) {
+			return smartfs_journal_flush(fs);
+		}
+		return OK;
+	}
+#endif
 	return smartfs_set_transaction(fs, sector, offset, TRANS_FINISHED);
 }
+
+#ifdef CONFIG_SMARTFS_JOURNAL_GROUP_COMMIT
+/****************************************************************************
+ * Name: smartfs_journal_flush
+ *
+ * Description: Marks all pending finished transactions in the journal.
+ *              Marks that share a journal sector are committed with a
+ *              single write of the range that covers them.
+ *
+ ****************************************************************************/
+int smartfs_journal_flush(struct smartfs_mountpt_s *fs)
+{
+	int ret;
+	uint8_t i;
+	uint8_t first;
+	uint16_t base;
+	struct smart_read_write_s req;
+	struct journal_transaction_manager_s *j_mgr;
+
+	j_mgr = fs->journal;
+	if (!j_mgr || !(j_mgr->enabled)) {
+		return OK;
+	}
+
+	/* Entries are logged in order, so marks for one sector are adjacent */
+
+	first = 0;
+	while (first < j_mgr->npending) {
+		base = j_mgr->pendoffset[first];
+		for (i = first + 1; i < j_mgr->npending && j_mgr->pendsector[i] == j_mgr->pendsector[first]; i++) {
+			if (j_mgr->pendoffset[i] < base) {
+				base = j_mgr->pendoffset[i];
+			}
+		}
+
+		req.logsector = j_mgr->pendsector[first];
+		req.offset = base + offsetof(struct smartfs_logging_entry_s, trans_info);
+		req.count = j_mgr->pendoffset[i - 1] - base + sizeof(((struct smartfs_logging_entry_s *)0)->trans_info);
+		req.buffer = j_mgr->buffer;
+		ret = FS_IOCTL(fs, BIOC_READSECT, (unsigned long)&req);
+		if (ret < 0) {
+			return ERROR;
+		}
+
+		for (; first < i; first++) {
+			T_SET_TRANSACTION(j_mgr->buffer[j_mgr->pendoffset[first] - base], TRANS_FINISHED);
+		}
+
+		ret = FS_IOCTL(fs, BIOC_WRITESECT, (unsigned long)&req);
+		if (ret != OK) {
+			fdbg("Writing failed %u %u\n", req.logsector, req.offset);
+			return ERROR;
+		}
+	}
+
+	j_mgr->npending = 0;
+
+	/* Nothing is left for the flush work to do */
+
+	if (j_mgr->flushqueued && work_cancel(LPWORK, &j_mgr->flushwork) == OK) {
+		j_mgr->flushqueued = false;
+	}
+	return OK;
+}
+
+/****************************************************************************
+ * Name: smartfs_journal_stop
+ *
+ * Description: Commits the pending marks and makes sure that the flush work
+ *              no longer refers to the volume.  Called with the volume
+ *              semaphore held, before the journal manager is freed.
+ *
+ ****************************************************************************/
+void smartfs_journal_stop(struct smartfs_mountpt_s *fs)
+{
+	struct journal_transaction_manager_s *j_mgr;
+
+	j_mgr = fs->journal;
+	if (!j_mgr || !(j_mgr->enabled)) {
+		return;
+	}
+
+	(void)smartfs_journal_flush(fs);
+
+	/* If the work could not be cancelled, the worker has already been taken
+	 * off the queue and is waiting for the semaphore.  Let it run.
+	 */
+
+	while (j_mgr->flushqueued) {
+		smartfs_semgive(fs);
+		usleep(USEC_PER_TICK);
+		smartfs_semtake(fs);
+	}
+}
+
+/****************************************************************************
+ * Name: smartfs_journal_worker
+ *
+ * Description: Work queue callback that commits expired pending marks.
+ *
+ ****************************************************************************/
+static void smartfs_journal_worker(FAR void *arg)
+{
+	struct smartfs_mountpt_s *fs = (struct smartfs_mountpt_s *)arg;
+
+	smartfs_semtake(fs);
+	(void)smartfs_journal_flush(fs);
+	fs->journal->flushqueued = false;
+	smartfs_semgive(fs);
+}
+#endif
+
 #endif /* END OF CONFIG_SMARTFS_JOURNALING */
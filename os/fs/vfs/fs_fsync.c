@@ -64,6 +64,7 @@
 #include <tinyara/sched.h>
 #include <tinyara/cancelpt.h>
 #include <tinyara/fs/fs.h>
+#include <tinyara/fs/ioctl.h>
 
 #include "inode/inode.h"
 
@@ -117,6 +118,24 @@ int file_fsync(FAR struct file *filep)
 	 */
 
 	inode = filep->f_inode;
+	if (inode && INODE_IS_DRIVER(inode)) {
+		/* A character driver that caches written data (e.g. BCH) writes it
+		 * back on DIOC_FLUSH.  Other drivers can not be synced.
+		 */
+
+		ret = -ENOTTY;
+		if (inode->u.i_ops && inode->u.i_ops->ioctl) {
+			ret = inode->u.i_ops->ioctl(filep, DIOC_FLUSH, 0);
+		}
+
+		if (ret >= 0) {
+			return OK;
+		}
+
+		ret = EINVAL;
+		goto errout;
+	}
+
 	if (!inode || !INODE_IS_MOUNTPT(inode) || !inode->u.i_mops || !inode->u.i_mops->sync) {
 		ret = EINVAL;
 		goto errout;
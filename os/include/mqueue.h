@@ -67,6 +67,8 @@
  * Included Files
  ********************************************************************************/
 
+#include <tinyara/config.h>
+
 #include <sys/types.h>
 #include <signal.h>
 #include "queue.h"
@@ -189,6 +191,60 @@ int mq_setattr(mqd_t mqdes, FAR const struct mq_attr *mq_stat, FAR struct mq_att
  */
 int mq_getattr(mqd_t mqdes, FAR struct mq_attr *mq_stat);
 
+#ifdef CONFIG_MQ_BUFFER
+/**
+ * @brief allocate a message queue buffer
+ * @details @b #include <mqueue.h> \n
+ * SYSTEM CALL API \n
+ * Takes a buffer of at least 'size' bytes from the message queue buffer
+ * pool.  The calling task holds the only reference to it.  On failure NULL
+ * is returned and errno is set to EINVAL (size is larger than
+ * CONFIG_MQ_BUFFER_SIZE) or ENOBUFS (the pool is empty).
+ * @since TizenRT v2.1 PRE
+ */
+FAR void *mq_bufalloc(size_t size);
+/**
+ * @brief take another reference to a message queue buffer
+ * @details @b #include <mqueue.h> \n
+ * SYSTEM CALL API \n
+ * Each mq_bufsend() passes one of the references of the calling task to
+ * the message, so a task takes one reference for each queue it sends the
+ * same buffer to.
+ * @since TizenRT v2.1 PRE
+ */
+int mq_bufref(FAR void *buf);
+/**
+ * @brief drop a reference to a message queue buffer
+ * @details @b #include <mqueue.h> \n
+ * SYSTEM CALL API \n
+ * The buffer is returned to the pool when its last reference is dropped.
+ * @since TizenRT v2.1 PRE
+ */
+int mq_buffree(FAR void *buf);
+/**
+ * @brief send a message queue buffer to a message queue
+ * @details @b #include <mqueue.h> \n
+ * SYSTEM CALL API \n
+ * Like mq_send(), but only the buffer handle is queued: one reference of
+ * the calling task moves to the message and the 'len' bytes at 'buf' are
+ * not copied.  The sender must not change the buffer after sending it.
+ * @since TizenRT v2.1 PRE
+ */
+int mq_bufsend(mqd_t mqdes, FAR void *buf, size_t len, int prio);
+/**
+ * @brief receive a message queue buffer from a message queue
+ * @details @b #include <mqueue.h> \n
+ * SYSTEM CALL API \n
+ * Like mq_receive(), but the message must have been sent by mq_bufsend().
+ * The reference held by the message moves to the calling task, which must
+ * drop it with mq_buffree().  The length of the payload is returned.  A
+ * message sent by mq_send() is left in the queue and fails with EBADMSG,
+ * as does a buffer message passed to mq_receive().
+ * @since TizenRT v2.1 PRE
+ */
+ssize_t mq_bufreceive(mqd_t mqdes, FAR void **buf, FAR int *prio);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
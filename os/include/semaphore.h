@@ -91,10 +91,11 @@
  * Public Type Declarations
  ****************************************************************************/
 
+struct tcb_s;					/* Forward reference */
+
 /* This structure contains information about the holder of a semaphore */
 
 #ifdef SAVE_SEM_HOLDER
-struct tcb_s;					/* Forward reference */
 /**
  * @ingroup SEMAPHORE_KERNEL
  * @brief Structure of semholder
@@ -136,6 +137,7 @@ struct sem_s {
 	struct semholder_s holder;	/* Single holder */
 #endif
 #endif
+	FAR struct tcb_s *waitlist;	/* Waiting tasks, highest priority first */
 };
 
 typedef struct sem_s sem_t;
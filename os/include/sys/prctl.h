@@ -102,6 +102,9 @@ enum prctl_type_e {
 	PR_CHECK_PREFERENCE,
 	PR_SET_PREFERENCE_CB,
 	PR_UNSET_PREFERENCE_CB,
+	PR_MSG_REPLY_SAVE,
+	PR_MSG_REPLY_READ,
+	PR_MSG_REPLY_REMOVE,
 };
 
 /****************************************************************************
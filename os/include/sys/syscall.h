@@ -434,7 +434,18 @@
 #define SYS_mq_timedreceive            (__SYS_mqueue + 7)
 #define SYS_mq_timedsend               (__SYS_mqueue + 8)
 #define SYS_mq_unlink                  (__SYS_mqueue + 9)
+
+#ifdef CONFIG_MQ_BUFFER
+#define SYS_mq_bufalloc                (__SYS_mqueue + 10)
+#define SYS_mq_buffree                 (__SYS_mqueue + 11)
+#define SYS_mq_bufreceive              (__SYS_mqueue + 12)
+#define SYS_mq_bufref                  (__SYS_mqueue + 13)
+#define SYS_mq_bufsend                 (__SYS_mqueue + 14)
+#define __SYS_environ                  (__SYS_mqueue + 15)
+#else
 #define __SYS_environ                  (__SYS_mqueue + 10)
+#endif
+
 #else
 #define __SYS_environ                  __SYS_mqueue
 #endif
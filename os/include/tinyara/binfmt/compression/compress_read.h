@@ -22,6 +22,15 @@
 /****************************************************************************
  * Included Files
  ****************************************************************************/
+#include <tinyara/config.h>
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#ifdef CONFIG_COMPRESSION_PIPELINE
+#include <semaphore.h>
+#include <tinyara/fs/fs.h>
+#include <tinyara/wqueue.h>
+#endif
 #include <tinyara/binfmt/compression/compression.h>
 
 /****************************************************************************
@@ -36,6 +45,17 @@
 struct s_buffer {
 	unsigned char *read_buffer;
 	unsigned char *out_buffer;
+	int out_block;				/* Block decompressed in out_buffer, -1 if none */
+#ifdef CONFIG_COMPRESSION_PIPELINE
+	unsigned char *next_buffer;		/* Compressed block read ahead */
+	int next_block;				/* Block read into next_buffer, -1 if none */
+	ssize_t next_size;			/* Bytes read into next_buffer, negative on failure */
+	bool next_pending;			/* Read into next_buffer is queued or running */
+	FAR struct file *next_filep;		/* File the block is read ahead from */
+	uint16_t next_header_size;		/* Binary header size of that file */
+	sem_t next_sem;				/* Posted when the read ahead is done */
+	struct work_s next_work;
+#endif
 };
 
 /****************************************************************************
@@ -80,6 +100,19 @@ int compress_init(int filfd, uint16_t offset, off_t *filelen);
  ****************************************************************************/
 int compress_read(int filfd, uint16_t binary_header_size, FAR uint8_t *buffer, size_t readsize, off_t offset);
 
+/****************************************************************************
+ * Name: lz4_decompress
+ *
+ * Description:
+ *   Decompress the LZ4 block of 'srclen' bytes in 'src' into 'dst' of
+ *   'dstlen' bytes.
+ *
+ * Returned Value:
+ *   Number of bytes written into dst on Success
+ *   ERROR (-1) if the block is corrupted or does not fit in dst
+ ****************************************************************************/
+int lz4_decompress(FAR const uint8_t *src, unsigned int srclen, FAR uint8_t *dst, unsigned int dstlen);
+
 /****************************************************************************
  * Name: get_compression_header
  *
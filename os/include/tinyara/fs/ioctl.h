@@ -180,6 +180,11 @@
 										 * OUT: None
 										 */
 
+#define DIOC_FLUSH      _DIOC(0x0005)	/* IN:  None
+										 * OUT: None, cached data written back
+										 *      to the underlying device.
+										 */
+
 /* TinyAra block driver ioctl definitions *************************************/
 
 #define _BIOCVALID(c)   (_IOC_TYPE(c) == _BIOCBASE)
@@ -191,6 +191,24 @@
 #define MM_MAX_CHUNK     (1 << MM_MAX_SHIFT)
 #define MM_NNODES        (MM_MAX_SHIFT - MM_MIN_SHIFT + 1)
 
+/* With the TLSF lookup, free chunks are kept in MM_FLI_COUNT first level
+ * ranges, each split into MM_SLI_COUNT second level lists.  Chunks smaller
+ * than 1 << MM_FLI_SHIFT share first level 0, which is split linearly by
+ * the granule.  Chunks of MM_MAX_CHUNK bytes or more are kept in one list
+ * at the last first level index.  Otherwise, MM_NNODES size-ordered lists
+ * are used.
+ */
+
+#ifdef CONFIG_MM_NODELIST_TLSF
+#define MM_SLI_SHIFT     CONFIG_MM_TLSF_SLI
+#define MM_SLI_COUNT     (1 << MM_SLI_SHIFT)
+#define MM_FLI_SHIFT     (MM_MIN_SHIFT + MM_SLI_SHIFT)
+#define MM_FLI_COUNT     (MM_MAX_SHIFT - MM_FLI_SHIFT + 2)
+#define MM_NLISTS        (MM_FLI_COUNT * MM_SLI_COUNT)
+#else
+#define MM_NLISTS        MM_NNODES
+#endif
+
 #define MM_GRAN_MASK     (MM_MIN_CHUNK-1)
 #define MM_ALIGN_UP(a)   (((a) + MM_GRAN_MASK) & ~MM_GRAN_MASK)
 #define MM_ALIGN_DOWN(a) ((a) & ~MM_GRAN_MASK)
@@ -216,6 +234,7 @@
 #define HEAPINFO_DETAIL_FREE 4
 #define HEAPINFO_DETAIL_SPECIFIC_HEAP 5
 #define HEAPINFO_INIT_PEAK 6
+#define HEAPINFO_SAMPLE 7
 #define HEAPINFO_PID_ALL -1
 
 #define HEAPINFO_INIT_INFO -1
@@ -340,6 +359,30 @@ struct mm_freenode_s {
 #define CHECK_FREENODE_SIZE \
 	DEBUGASSERT(sizeof(struct mm_freenode_s) == SIZEOF_MM_FREENODE)
 
+#ifdef CONFIG_MM_SLAB
+/* Released chunks up to MM_SLAB_MAXCHUNK bytes are kept in per size-class
+ * lists.  There is one size class per MM_MIN_CHUNK granule, so the class
+ * of a chunk is simply its size divided by the granule.
+ */
+
+#define MM_SLAB_MAXCHUNK  MM_ALIGN_UP(CONFIG_MM_SLAB_MAXSIZE + SIZEOF_MM_ALLOCNODE)
+#define MM_SLAB_NCLASSES  ((MM_SLAB_MAXCHUNK >> MM_MIN_SHIFT) + 1)
+#define MM_SLAB_NDX(s)    ((s) >> MM_MIN_SHIFT)
+
+/* Value of the reserved field of a cached chunk's header */
+
+#define MM_SLAB_MARK      0x51ab
+
+/* This describes a cached chunk.  It is still marked as allocated so that
+ * its neighbours never merge with it, and the link is kept in the payload.
+ */
+
+struct mm_slabnode_s {
+	struct mm_allocnode_s hdr;		/* Header of the allocated chunk */
+	FAR struct mm_slabnode_s *flink;	/* Next cached chunk of this class */
+};
+#endif
+
 #ifdef CONFIG_DEBUG_MM_HEAPINFO
 struct heapinfo_tcb_info_s {
 	int pid;
@@ -363,6 +406,66 @@ struct heapinfo_group_s {
 };
 #endif
 #endif
+#ifdef CONFIG_MM_TASK_CACHE
+/* Released chunks up to MM_TCACHE_MAXCHUNK bytes are kept in a cache of
+ * the releasing task, with one size class per MM_MIN_CHUNK granule.
+ */
+
+#define MM_TCACHE_MAXCHUNK  MM_ALIGN_UP(CONFIG_MM_TASK_CACHE_MAXSIZE + SIZEOF_MM_ALLOCNODE)
+#define MM_TCACHE_NCLASSES  ((MM_TCACHE_MAXCHUNK >> MM_MIN_SHIFT) + 1)
+#define MM_TCACHE_NDX(s)    ((s) >> MM_MIN_SHIFT)
+
+/* This describes a chunk in a task cache.  Like a chunk in the size-class
+ * cache, it is still marked as allocated.
+ */
+
+struct mm_tcachenode_s {
+	struct mm_allocnode_s hdr;		/* Header of the allocated chunk */
+	FAR struct mm_tcachenode_s *flink;	/* Next cached chunk of this class */
+};
+
+/* This describes the cache of one task */
+
+struct mm_tcache_s {
+	FAR struct mm_tcachenode_s *list[MM_TCACHE_NCLASSES];
+	uint8_t count[MM_TCACHE_NCLASSES];
+};
+#endif
+#ifdef CONFIG_MM_SAMPLING
+/* This describes one call site of the sampled allocations.  A sample
+ * stands for about CONFIG_MM_SAMPLING_INTERVAL bytes, or for its own size
+ * if it is larger, so the byte counts are estimates.
+ */
+
+struct mm_sample_site_s {
+	uintptr_t caller;			/* Return address into the caller */
+	uint32_t nsamples;			/* Number of sampled allocations */
+	size_t allocated;			/* Estimated bytes allocated */
+	size_t live;				/* Estimated bytes not freed yet */
+};
+
+/* This describes a sampled allocation which is not freed yet */
+
+struct mm_sample_live_s {
+	FAR void *mem;				/* Allocated memory, NULL if unused */
+	size_t weight;				/* Estimated bytes it stands for */
+	uint16_t site;				/* Index of its call site */
+};
+
+/* This describes the sampling state of one heap.  It is accessed with
+ * interrupts disabled instead of the mm semaphore.
+ */
+
+struct mm_sample_s {
+	ssize_t countdown;			/* Bytes to allocate until the next sample */
+	uint32_t seed;				/* State of the random generator */
+	uint32_t ndropped;			/* Samples not recorded, tables full */
+	uint16_t nlive;				/* Number of used entries in live[] */
+	struct mm_sample_site_s site[CONFIG_MM_SAMPLING_NSITES];
+	struct mm_sample_live_s live[CONFIG_MM_SAMPLING_NLIVE];
+};
+#endif
+
 /* This describes one heap (possibly with multiple regions) */
 
 struct mm_heap_s {
@@ -405,7 +508,55 @@ struct mm_heap_s {
 	 * speed searches for free nodes.
 	 */
 
-	struct mm_freenode_s mm_nodelist[MM_NNODES + 1];
+	struct mm_freenode_s mm_nodelist[MM_NLISTS + 1];
+
+#ifdef CONFIG_MM_NODELIST_TLSF
+	/* Bitmaps of the non-empty lists.  Bit n of mm_flbitmap is set when
+	 * any list of first level n is non-empty, and bit m of mm_slbitmap[n]
+	 * is set when list m of first level n is non-empty.
+	 */
+
+	uint32_t mm_flbitmap;
+	uint32_t mm_slbitmap[MM_FLI_COUNT];
+#endif
+
+#ifdef CONFIG_MM_SLAB
+	/* Released small chunks are cached here per size class.  They can be
+	 * handed out again without searching, splitting or merging.
+	 */
+
+	FAR struct mm_slabnode_s *mm_slablist[MM_SLAB_NCLASSES];
+	uint16_t mm_slabcount[MM_SLAB_NCLASSES];
+	size_t mm_slabsize;			/* Total size of the cached chunks */
+#endif
+
+#ifdef CONFIG_MM_TASK_CACHE
+	/* Per-task caches of released small chunks, indexed by the pid hash
+	 * like alloc_list.  They are accessed with interrupts disabled instead
+	 * of the mm semaphore.
+	 */
+
+	struct mm_tcache_s mm_tcache[CONFIG_MAX_TASKS];
+	size_t mm_tcachesize;			/* Total size of the cached chunks */
+	clock_t mm_tcacheflush;			/* System time of the last drain */
+#endif
+
+#ifdef CONFIG_MM_SAMPLING
+	/* Allocation sampling profiler */
+
+	struct mm_sample_s mm_sample;
+#endif
+};
+
+/* This describes the free chunks of one heap, see mm_fraginfo() */
+
+struct mm_fraginfo_s {
+	size_t freesize;			/* Total size of the free chunks */
+	size_t largest;				/* Size of the largest free chunk */
+	int nfree;				/* Number of free chunks */
+	int fragindex;				/* 0 (not fragmented) to 100 */
+	int count[MM_NNODES];			/* Number of free chunks per bucket */
+	size_t size[MM_NNODES];			/* Size of the free chunks per bucket */
 };
 
 /****************************************************************************
@@ -526,6 +677,7 @@ FAR void *kmm_malloc(size_t size);
 /* Functions contained in mm_free.c *****************************************/
 
 void mm_free(FAR struct mm_heap_s *heap, FAR void *mem);
+void mm_freechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node);
 
 /* Functions contained in kmm_free.c ****************************************/
 
@@ -660,6 +812,10 @@ void kmm_extend(FAR void *mem, size_t size, int region);
 struct mallinfo;				/* Forward reference */
 int mm_mallinfo(FAR struct mm_heap_s *heap, FAR struct mallinfo *info);
 
+/* Functions contained in mm_fraginfo.c *************************************/
+
+int mm_fraginfo(FAR struct mm_heap_s *heap, FAR struct mm_fraginfo_s *info);
+
 /* Functions contained in kmm_mallinfo.c ************************************/
 
 #ifdef CONFIG_MM_KERNEL_HEAP
@@ -686,6 +842,41 @@ void mm_addfreechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node)
 
 int mm_size2ndx(size_t size);
 
+/* Functions contained in mm_tcache.c ***************************************/
+
+#ifdef CONFIG_MM_TASK_CACHE
+FAR void *mm_tcache_alloc(FAR struct mm_heap_s *heap, size_t size);
+bool mm_tcache_free(FAR struct mm_heap_s *heap, FAR struct mm_allocnode_s *node);
+int mm_tcache_drain(FAR struct mm_heap_s *heap);
+void mm_tcache_age(FAR struct mm_heap_s *heap);
+void mm_tcache_recover(pid_t pid);
+#endif
+
+/* Functions contained in mm_tlsf.c *****************************************/
+
+#ifdef CONFIG_MM_NODELIST_TLSF
+int mm_tlsf_size2ndx(size_t size);
+FAR struct mm_freenode_s *mm_tlsf_search(FAR struct mm_heap_s *heap, size_t size);
+void mm_removefreechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node);
+#endif
+
+/* Functions contained in mm_sample.c ***************************************/
+
+#ifdef CONFIG_MM_SAMPLING
+void mm_sample_initialize(FAR struct mm_heap_s *heap);
+void mm_sample_alloc(FAR struct mm_heap_s *heap, FAR void *mem, size_t size, uintptr_t caller);
+void mm_sample_free(FAR struct mm_heap_s *heap, FAR void *mem);
+void mm_sample_dump(FAR struct mm_heap_s *heap);
+#endif
+
+/* Functions contained in mm_slab.c *****************************************/
+
+#ifdef CONFIG_MM_SLAB
+FAR struct mm_allocnode_s *mm_slab_alloc(FAR struct mm_heap_s *heap, size_t size);
+bool mm_slab_free(FAR struct mm_heap_s *heap, FAR struct mm_allocnode_s *node);
+int mm_slab_drain(FAR struct mm_heap_s *heap);
+#endif
+
 #ifdef CONFIG_DEBUG_MM_HEAPINFO
 /* Functions contained in kmm_mallinfo.c . Used to display memory allocation details */
 void heapinfo_parse(FAR struct mm_heap_s *heap, int mode, pid_t pid);
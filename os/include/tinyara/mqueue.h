@@ -81,6 +81,7 @@
 /* This structure defines a message queue */
 
 struct mq_des;					/* forward reference */
+struct tcb_s;					/* forward reference */
 
 struct mqueue_inode_s {
 	FAR struct inode *inode;	/* Containing inode */
@@ -89,6 +90,8 @@ struct mqueue_inode_s {
 	int16_t nmsgs;				/* Number of message in the queue */
 	int16_t nwaitnotfull;		/* Number tasks waiting for not full */
 	int16_t nwaitnotempty;		/* Number tasks waiting for not empty */
+	FAR struct tcb_s *waitnotfull;	/* Prioritized list of tasks waiting for not full */
+	FAR struct tcb_s *waitnotempty;	/* Prioritized list of tasks waiting for not empty */
 #if CONFIG_MQ_MAXMSGSIZE < 256
 	uint8_t maxmsgsize;			/* Max size of message in message queue */
 #else
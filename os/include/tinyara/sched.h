@@ -176,7 +176,8 @@
  #  define TCB_FLAG_SCHED_OTHER     (3 << TCB_FLAG_POLICY_SHIFT) /* Other scheding policy */
 #define TCB_FLAG_CPU_LOCKED        (1 << 7) /* Bit 7: Locked to this CPU */
 #define TCB_FLAG_EXIT_PROCESSING   (1 << 8) /* Bit 8: Exitting */
-											/* Bits 9-15: Available */
+#define TCB_FLAG_EXITING           (1 << 9) /* Bit 9: Exit processing has started */
+											/* Bits 10-15: Available */
 
 /* Values for struct task_group tg_flags */
 
@@ -579,6 +580,11 @@ struct tcb_s {
 
 	sem_t *waitsem;				/* Semaphore ID waiting on             */
 
+	/* Links in the wait list of the semaphore or message queue waited on */
+
+	FAR struct tcb_s *wflink;	/* Next (lower priority) waiter        */
+	FAR struct tcb_s *wblink;	/* Previous (higher priority) waiter   */
+
 	/* POSIX Signal Control Fields *********************************************** */
 
 #ifndef CONFIG_DISABLE_SIGNALS
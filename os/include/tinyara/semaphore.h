@@ -57,6 +57,8 @@
  ****************************************************************************/
 
 #include <tinyara/config.h>
+
+#include <stdbool.h>
 #include <semaphore.h>
 #include <tinyara/fs/fs.h>
 #include <tinyara/clock.h>
@@ -253,6 +255,102 @@ void sem_register(FAR sem_t *sem);
 void sem_unregister(FAR sem_t *sem);
 #endif
 
+#ifdef CONFIG_SEM_FASTPATH
+/****************************************************************************
+ * Name: sem_fastpath
+ *
+ * Description:
+ *   Return true if the counts of a semaphore may be taken and given without
+ *   recording the holder, i.e. sem_addholder() would not record it either.
+ *
+ ****************************************************************************/
+
+static inline bool sem_fastpath(FAR sem_t *sem)
+{
+	if (!sem || (sem->flags & FLAGS_INITIALIZED) == 0) {
+		return false;
+	}
+
+#ifdef SAVE_SEM_HOLDER
+	if ((sem->flags & FLAGS_SIGSEM) != 0) {
+		return true;
+	}
+
+#if defined(CONFIG_PRIORITY_INHERITANCE) && !defined(CONFIG_BINMGR_RECOVERY)
+	return (sem->flags & PRIOINHERIT_FLAGS_DISABLE) != 0;
+#else
+	return false;
+#endif
+#else
+	return true;
+#endif
+}
+
+/****************************************************************************
+ * Name: sem_fasttake
+ *
+ * Description:
+ *   Take a count of a semaphore with one atomic operation if a count is
+ *   available.  This is safe against the interrupt-disabled updates of the
+ *   normal path: an exception between the load and the store makes the
+ *   store fail and the operation is retried.
+ *
+ * Return Value:
+ *   true if a count was taken, false if the caller must use the normal
+ *   path.
+ *
+ ****************************************************************************/
+
+static inline bool sem_fasttake(FAR sem_t *sem)
+{
+	int16_t count;
+
+	if (!sem_fastpath(sem)) {
+		return false;
+	}
+
+	count = __atomic_load_n(&sem->semcount, __ATOMIC_RELAXED);
+	while (count > 0) {
+		if (__atomic_compare_exchange_n(&sem->semcount, &count, count - 1, true, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/****************************************************************************
+ * Name: sem_fastgive
+ *
+ * Description:
+ *   Give a count back to a semaphore with one atomic operation if no task
+ *   is waiting for it.
+ *
+ * Return Value:
+ *   true if the count was given, false if the caller must use the normal
+ *   path to wake up a waiter.
+ *
+ ****************************************************************************/
+
+static inline bool sem_fastgive(FAR sem_t *sem)
+{
+	int16_t count;
+
+	if (!sem_fastpath(sem)) {
+		return false;
+	}
+
+	count = __atomic_load_n(&sem->semcount, __ATOMIC_RELAXED);
+	while (count >= 0 && count < SEM_VALUE_MAX) {
+		if (__atomic_compare_exchange_n(&sem->semcount, &count, count + 1, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+#endif
+
 
 #undef EXTERN
 #ifdef __cplusplus
@@ -56,6 +56,7 @@
 #define TTRACE_BUFFER              'b'
 #define TTRACE_DUMP                'd'
 #define TTRACE_PRINT               'p'
+#define TTRACE_STREAM              'e'
 
 #define TTRACE_CODE_VARIABLE        0
 #define TTRACE_CODE_UNIQUE         (1 << 7)
@@ -76,6 +77,15 @@
 #define TTRACE_TAG_TASK            (1 << 3)
 #define TTRACE_TAG_IPC             (1 << 4)
 
+#define TTRACE_EVENT_MSG_BYTES      20
+
+/* Types of the records of the binary event ring */
+
+#define TTRACE_EVENT_SCHED          1
+#define TTRACE_EVENT_BEGIN          2
+#define TTRACE_EVENT_BEGIN_UID      3
+#define TTRACE_EVENT_END            4
+
 /****************************************************************************
  * Public Variables
  ****************************************************************************/
@@ -103,6 +113,28 @@ struct trace_packet {        // total 44 byte(message), 12byte(uid)
 	union trace_message msg;   // 32B
 };
 
+struct ttrace_event_sched_s {         // total 16B
+	pid_t next_pid;                     // 2B
+	uint8_t next_prio;                  // 1B
+	uint8_t prev_state;                 // 1B
+	char next_comm[TTRACE_COMM_BYTES];  // 12B
+};
+
+union ttrace_event_msg {                   // total 20B
+	struct ttrace_event_sched_s sched;       // 16B
+	char message[TTRACE_EVENT_MSG_BYTES];    // 20B, not terminated if full
+	int8_t uid;                              // 1B
+};
+
+struct ttrace_event_s {      // total 32B, record of the binary event ring
+	uint32_t seq;              // 4B, sequence number + 1, 0 while being written
+	uint32_t ts;               // 4B, timestamp in microseconds
+	pid_t pid;                 // 2B, running task, or previous task of a switch
+	uint8_t type;              // 1B, TTRACE_EVENT_xxx
+	uint8_t prio;              // 1B, priority of pid
+	union ttrace_event_msg u;  // 20B
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -162,6 +194,21 @@ int trace_end_uid(int tag);
  * @since TizenRT v1.1
  */
 int trace_sched(struct tcb_s *prev, struct tcb_s *next);
+
+#ifdef CONFIG_TTRACE_EVENTS
+/* These are called by the kernel and by the library trace points in kernel
+ * space.  They record into the binary event ring without any lock, also
+ * from interrupt handlers.
+ */
+
+bool ttrace_tag_enabled(int tag);
+int ttrace_event_init(void);
+void ttrace_event_start(void);
+int ttrace_event_sched(FAR struct tcb_s *prev, FAR struct tcb_s *next);
+int ttrace_event_begin(int tag, FAR const char *str);
+int ttrace_event_begin_uid(int tag, int8_t uniqueid);
+int ttrace_event_end(int tag);
+#endif
 #else
 #define trace_begin(a, b, ...)
 #define trace_begin_uid(a, b)
@@ -61,6 +61,7 @@
 
 #include <sys/types.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <semaphore.h>
 #include <queue.h>
 
@@ -80,6 +81,8 @@
  *   (which runs at the lowest of priority and may not be appropriate
  *   if memory reclamation is of high priority).  If CONFIG_SCHED_HPWORK
  *   is enabled, then the following options can also be used:
+ * CONFIG_SCHED_HPNTHREADS - The number of thread in the high-priority
+ *   queue's thread pool.  Default: 1
  * CONFIG_SCHED_HPWORKPRIORITY - The execution priority of the high-
  *   priority worker thread.  Default: 224
  * CONFIG_SCHED_HPWORKSTACKSIZE - The stack size allocated for the worker
@@ -153,6 +156,10 @@
 
 #ifdef CONFIG_SCHED_HPWORK
 
+#ifndef CONFIG_SCHED_HPNTHREADS
+#define CONFIG_SCHED_HPNTHREADS 1
+#endif
+
 #ifndef CONFIG_SCHED_HPWORKPRIORITY
 #define CONFIG_SCHED_HPWORKPRIORITY 224
 #endif
@@ -284,6 +291,7 @@ struct work_s {
 	FAR void *arg;				/* Callback argument */
 	clock_t qtime;			/* Time work queued */
 	clock_t delay;			/* Delay until work performed */
+	bool queued;				/* Set while the work is in a work queue */
 };
 
 /****************************************************************************
@@ -383,7 +391,8 @@ int work_lpstart(void);
  *            is invoked. Zero means to perform the work immediately.
  *
  * Returned Value:
- *   Zero on success, a negated errno on failure
+ *   Zero on success, a negated errno on failure.  -EALREADY is returned if
+ *   the work is still queued.
  *
  ****************************************************************************/
 
@@ -367,7 +367,7 @@ void os_start(void)
 
 	/* Then add the idle task's TCB to the head of the ready to run list */
 
-	dq_addfirst((FAR dq_entry_t *)&g_idletcb, (FAR dq_queue_t *)&g_readytorun);
+	sched_addready(&g_idletcb.cmn);
 
 	/* Initialize the processor-specific portion of the TCB */
 
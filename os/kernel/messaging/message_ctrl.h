@@ -58,9 +58,17 @@
  ****************************************************************************/
 
 #include <sys/types.h>
+#include <stdbool.h>
+#include <mqueue.h>
+
+struct tcb_s;
 
 int messaging_save_receiver(char *port_name, pid_t recv_pid, int recv_prio);
 int messaging_read_list(char *port_name, int *recv_arr, int *total_cnt);
 int messaging_remove_list(char *port_name);
+int messaging_save_reply(char *port_name, pid_t pid, mqd_t mqdes, int msgsize);
+int messaging_read_reply(char *port_name, pid_t pid, mqd_t *mqdes, int *msgsize);
+int messaging_remove_reply(char *port_name, pid_t pid);
+void messaging_release(FAR struct tcb_s *tcb, bool nonblocking);
 void messaging_initialize(void);
 #endif							/* __KERNEL_MESSAGING_MESSAGE_CTRL_H */
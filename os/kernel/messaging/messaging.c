@@ -61,6 +61,11 @@
 #include <string.h>
 #include <queue.h>
 #include <semaphore.h>
+#include <sched.h>
+#include <stdio.h>
+#include <mqueue.h>
+#include <tinyara/sched.h>
+#include <tinyara/mqueue.h>
 #include <tinyara/kmalloc.h>
 #include <tinyara/mm/mm.h>
 
@@ -94,6 +99,19 @@ struct msg_recv_node_s {
 };
 typedef struct msg_recv_node_s msg_recv_node_t;
 
+/* A reply port that a sender keeps open across synchronous sends.  The
+ * message queue is named "port_name + pid + _r" and is owned by the task
+ * with that pid.
+ */
+struct msg_reply_node_s {
+	struct msg_reply_node_s *flink;
+	char port_name[MSG_MAX_PORT_NAME];
+	pid_t pid;
+	mqd_t mqdes;
+	int msgsize;
+};
+typedef struct msg_reply_node_s msg_reply_node_t;
+
 static sem_t port_list_sem;
 
 /****************************************************************************
@@ -104,6 +122,7 @@ static sem_t port_list_sem;
  * Private Variables
  ****************************************************************************/
 static sq_queue_t g_port_node_list;
+static sq_queue_t g_reply_node_list;
 static int curr_recv_cnt;;
 /****************************************************************************
  * Private Functions
@@ -153,6 +172,21 @@ static int messaging_append_receiver(pid_t pid, int prio, sq_queue_t *queue)
 	return OK;
 }
 
+static msg_reply_node_t *messaging_find_reply(char *port_name, pid_t pid)
+{
+	msg_reply_node_t *reply_node;
+
+	reply_node = (msg_reply_node_t *)sq_peek(&g_reply_node_list);
+	while (reply_node != NULL) {
+		if (reply_node->pid == pid && strncmp(reply_node->port_name, port_name, MSG_MAX_PORT_NAME) == 0) {
+			return reply_node;
+		}
+		reply_node = (msg_reply_node_t *)sq_next(reply_node);
+	}
+
+	return NULL;
+}
+
 static int messaging_check_recv_exist(int recv_pid, sq_queue_t *queue)
 {
 	msg_recv_node_t *recv_node;
@@ -378,6 +412,177 @@ int messaging_remove_list(char *port_name)
 	return ret;
 }
 
+/****************************************************************************
+ * Name: messaging_save_reply
+ *
+ * Description:
+ *   Save the reply port which a sender keeps open for synchronous sends.
+ *
+ * Parameters:
+ *   port_name - A message port name
+ *   pid       - A pid of sender
+ *   mqdes     - The message queue descriptor of the reply port
+ *   msgsize   - The message size of the reply port
+ *
+ * Return Value:
+ *   OK on success, ERROR on failure.
+ *
+ * Assumptions:
+ *
+ ****************************************************************************/
+int messaging_save_reply(char *port_name, pid_t pid, mqd_t mqdes, int msgsize)
+{
+	msg_reply_node_t *reply_node;
+
+	if (strlen(port_name) >= MSG_MAX_PORT_NAME) {
+		msgdbg("[Messaging] fail to save reply port : too long port name.\n");
+		return ERROR;
+	}
+
+	sched_lock();
+	reply_node = messaging_find_reply(port_name, pid);
+	if (reply_node == NULL) {
+		reply_node = (msg_reply_node_t *)kmm_malloc(sizeof(msg_reply_node_t));
+		if (reply_node == NULL) {
+			sched_unlock();
+			msgdbg("[Messaging] fail to save reply port : out of memory.\n");
+			return ERROR;
+		}
+		strncpy(reply_node->port_name, port_name, MSG_MAX_PORT_NAME);
+		reply_node->pid = pid;
+		sq_addlast((FAR sq_entry_t *)reply_node, &g_reply_node_list);
+	}
+	reply_node->mqdes = mqdes;
+	reply_node->msgsize = msgsize;
+	sched_unlock();
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: messaging_read_reply
+ *
+ * Description:
+ *   Read the reply port which a sender saved for a message port.
+ *
+ * Parameters:
+ *   port_name - A message port name
+ *   pid       - A pid of sender
+ *   mqdes     - The location to return the message queue descriptor
+ *   msgsize   - The location to return the message size
+ *
+ * Return Value:
+ *   OK on success, ERROR if there is no saved reply port.
+ *
+ * Assumptions:
+ *
+ ****************************************************************************/
+int messaging_read_reply(char *port_name, pid_t pid, mqd_t *mqdes, int *msgsize)
+{
+	msg_reply_node_t *reply_node;
+	int ret = ERROR;
+
+	sched_lock();
+	reply_node = messaging_find_reply(port_name, pid);
+	if (reply_node != NULL) {
+		*mqdes = reply_node->mqdes;
+		*msgsize = reply_node->msgsize;
+		ret = OK;
+	}
+	sched_unlock();
+
+	return ret;
+}
+
+/****************************************************************************
+ * Name: messaging_remove_reply
+ *
+ * Description:
+ *   Forget the reply port of a sender.  The sender closes and unlinks the
+ *   message queue itself.
+ *
+ * Parameters:
+ *   port_name - A message port name
+ *   pid       - A pid of sender
+ *
+ * Return Value:
+ *   OK always.
+ *
+ * Assumptions:
+ *
+ ****************************************************************************/
+int messaging_remove_reply(char *port_name, pid_t pid)
+{
+	msg_reply_node_t *reply_node;
+
+	sched_lock();
+	reply_node = messaging_find_reply(port_name, pid);
+	if (reply_node != NULL) {
+		sq_rem((FAR sq_entry_t *)reply_node, &g_reply_node_list);
+	}
+	sched_unlock();
+
+	if (reply_node != NULL) {
+		kmm_free(reply_node);
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: messaging_release
+ *
+ * Description:
+ *   Close and unlink the reply ports of an exiting task.
+ *
+ * Parameters:
+ *   tcb         - The TCB of the exiting task
+ *   nonblocking - True if the exit must not block.  Then the reply ports
+ *                 are only forgotten: the message queues are closed with
+ *                 the task group and a later sender with the same pid
+ *                 re-creates the stale names.
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from task_exithook() before the task leaves its group.
+ *
+ ****************************************************************************/
+void messaging_release(FAR struct tcb_s *tcb, bool nonblocking)
+{
+	msg_reply_node_t *reply_node;
+	msg_reply_node_t *next_node;
+	sq_queue_t release_list;
+	char reply_portname[MSG_MAX_PORT_NAME + 16];
+
+	/* Take the nodes of this task off the list first */
+
+	sq_init(&release_list);
+	sched_lock();
+	reply_node = (msg_reply_node_t *)sq_peek(&g_reply_node_list);
+	while (reply_node != NULL) {
+		next_node = (msg_reply_node_t *)sq_next(reply_node);
+		if (reply_node->pid == tcb->pid) {
+			sq_rem((FAR sq_entry_t *)reply_node, &g_reply_node_list);
+			sq_addlast((FAR sq_entry_t *)reply_node, &release_list);
+		}
+		reply_node = next_node;
+	}
+	sched_unlock();
+
+	while ((reply_node = (msg_reply_node_t *)sq_remfirst(&release_list)) != NULL) {
+		if (!nonblocking) {
+#ifdef HAVE_TASK_GROUP
+			(void)mq_close_group(reply_node->mqdes, tcb->group);
+#endif
+			snprintf(reply_portname, sizeof(reply_portname), "%s%d%s", reply_node->port_name, reply_node->pid, "_r");
+			(void)mq_unlink(reply_portname);
+		}
+		kmm_free(reply_node);
+	}
+}
+
 void messaging_initialize(void)
 {
 	/* Initialize a sempahore for port list */
@@ -0,0 +1,507 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <queue.h>
+#include <assert.h>
+#include <errno.h>
+#include <mqueue.h>
+#include <debug.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/kmalloc.h>
+
+#include "sched/sched.h"
+#include "mqueue/mqueue.h"
+
+#ifdef CONFIG_MQ_BUFFER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The buffers are laid out back to back in one block, each one aligned */
+
+#define MQ_BUFFER_STRIDE  ((CONFIG_MQ_BUFFER_SIZE + 7) & ~7)
+
+/****************************************************************************
+ * Private Variables
+ ****************************************************************************/
+
+/* The buffer descriptors, the list of the free ones and the block of
+ * memory that holds the buffers themselves.
+ */
+
+static struct mq_buffer_s g_mqbuffers[CONFIG_MQ_BUFFER_NBUFS];
+static sq_queue_t g_mqbuffree;
+static FAR uint8_t *g_mqbufpool;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mq_bufholder
+ *
+ * Description:
+ *   Return the holder entry of a task in a buffer, or NULL if the task
+ *   holds no reference to it.
+ *
+ ****************************************************************************/
+
+static FAR struct mq_bufholder_s *mq_bufholder(FAR struct mq_buffer_s *buffer, pid_t pid)
+{
+	int i;
+
+	for (i = 0; i < CONFIG_MQ_BUFFER_NHOLDERS; i++) {
+		if (buffer->holder[i].pid == pid) {
+			return &buffer->holder[i];
+		}
+	}
+
+	return NULL;
+}
+
+/****************************************************************************
+ * Name: mq_buffreebuffer
+ *
+ * Description:
+ *   Return a buffer without references to the free list.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+static void mq_buffreebuffer(FAR struct mq_buffer_s *buffer)
+{
+	int i;
+
+	DEBUGASSERT(buffer->crefs == 0);
+
+	for (i = 0; i < CONFIG_MQ_BUFFER_NHOLDERS; i++) {
+		buffer->holder[i].pid = INVALID_PROCESS_ID;
+		buffer->holder[i].crefs = 0;
+	}
+
+	sq_addlast((FAR sq_entry_t *)buffer, &g_mqbuffree);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mq_bufinitialize
+ *
+ * Description:
+ *   Allocate the message queue buffer pool.  Called from mq_initialize().
+ *
+ ****************************************************************************/
+
+void mq_bufinitialize(void)
+{
+	int i;
+
+	sq_init(&g_mqbuffree);
+
+	g_mqbufpool = (FAR uint8_t *)kmm_malloc(MQ_BUFFER_STRIDE * CONFIG_MQ_BUFFER_NBUFS);
+	if (!g_mqbufpool) {
+		sdbg("Failed to allocate the message queue buffer pool\n");
+		return;
+	}
+
+	for (i = 0; i < CONFIG_MQ_BUFFER_NBUFS; i++) {
+		g_mqbuffers[i].crefs = 0;
+		mq_buffreebuffer(&g_mqbuffers[i]);
+	}
+}
+
+/****************************************************************************
+ * Name: mq_bufhandle
+ *
+ * Description:
+ *   Return the descriptor of an allocated buffer from the address of its
+ *   data, or NULL if the address is not the start of an allocated buffer.
+ *
+ ****************************************************************************/
+
+FAR struct mq_buffer_s *mq_bufhandle(FAR void *buf)
+{
+	FAR struct mq_buffer_s *buffer;
+	uintptr_t offset;
+
+	if (!g_mqbufpool || (FAR uint8_t *)buf < g_mqbufpool) {
+		return NULL;
+	}
+
+	offset = (uintptr_t)buf - (uintptr_t)g_mqbufpool;
+	if (offset >= MQ_BUFFER_STRIDE * CONFIG_MQ_BUFFER_NBUFS || (offset % MQ_BUFFER_STRIDE) != 0) {
+		return NULL;
+	}
+
+	buffer = &g_mqbuffers[offset / MQ_BUFFER_STRIDE];
+	return buffer->crefs > 0 ? buffer : NULL;
+}
+
+/****************************************************************************
+ * Name: mq_bufdata
+ *
+ * Description:
+ *   Return the address of the data of a buffer.
+ *
+ ****************************************************************************/
+
+FAR void *mq_bufdata(FAR struct mq_buffer_s *buffer)
+{
+	return g_mqbufpool + (buffer - g_mqbuffers) * MQ_BUFFER_STRIDE;
+}
+
+/****************************************************************************
+ * Name: mq_bufhold
+ *
+ * Description:
+ *   Record that a task holds one more of the references to a buffer.  The
+ *   reference count itself is not changed: the reference is either new or
+ *   moved from a message.
+ *
+ * Return Value:
+ *   OK, or -ENOSPC if CONFIG_MQ_BUFFER_NHOLDERS other tasks already hold
+ *   references.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+int mq_bufhold(FAR struct mq_buffer_s *buffer, pid_t pid)
+{
+	FAR struct mq_bufholder_s *holder;
+
+	holder = mq_bufholder(buffer, pid);
+	if (!holder) {
+		holder = mq_bufholder(buffer, INVALID_PROCESS_ID);
+		if (!holder) {
+			return -ENOSPC;
+		}
+
+		holder->pid = pid;
+	}
+
+	holder->crefs++;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: mq_bufunhold
+ *
+ * Description:
+ *   Take one reference to a buffer away from a task.  The reference count
+ *   is not changed: the caller either moves the reference to a message or
+ *   drops it with mq_bufdrop().
+ *
+ * Return Value:
+ *   OK, or -EPERM if the task holds no reference to the buffer.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+int mq_bufunhold(FAR struct mq_buffer_s *buffer, pid_t pid)
+{
+	FAR struct mq_bufholder_s *holder;
+
+	holder = mq_bufholder(buffer, pid);
+	if (!holder) {
+		return -EPERM;
+	}
+
+	if (--holder->crefs == 0) {
+		holder->pid = INVALID_PROCESS_ID;
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: mq_bufdrop
+ *
+ * Description:
+ *   Drop a reference that is not held by a task, and return the buffer to
+ *   the pool if it was the last one.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void mq_bufdrop(FAR struct mq_buffer_s *buffer)
+{
+	DEBUGASSERT(buffer->crefs > 0);
+
+	if (--buffer->crefs == 0) {
+		mq_buffreebuffer(buffer);
+	}
+}
+
+/****************************************************************************
+ * Name: mq_bufrelease
+ *
+ * Description:
+ *   Drop all of the buffer references still held by a task.  Called from
+ *   mq_recover() when the task exits or is deleted.
+ *
+ ****************************************************************************/
+
+void mq_bufrelease(pid_t pid)
+{
+	FAR struct mq_bufholder_s *holder;
+	FAR struct mq_buffer_s *buffer;
+	irqstate_t flags;
+	int i;
+
+	flags = irqsave();
+	for (i = 0; i < CONFIG_MQ_BUFFER_NBUFS; i++) {
+		buffer = &g_mqbuffers[i];
+		if (buffer->crefs == 0) {
+			continue;
+		}
+
+		holder = mq_bufholder(buffer, pid);
+		if (holder) {
+			DEBUGASSERT(buffer->crefs >= holder->crefs);
+			svdbg("pid %d drops %d references to buffer %d\n", pid, holder->crefs, i);
+
+			buffer->crefs -= holder->crefs;
+			holder->pid = INVALID_PROCESS_ID;
+			holder->crefs = 0;
+
+			if (buffer->crefs == 0) {
+				mq_buffreebuffer(buffer);
+			}
+		}
+	}
+
+	irqrestore(flags);
+}
+
+/****************************************************************************
+ * Name: mq_bufverifymsg
+ *
+ * Description:
+ *   Check that a message taken from a queue is of the kind the receiver
+ *   expects: a buffer message for mq_bufreceive() or an ordinary one for
+ *   mq_receive() and mq_timedreceive().  For a buffer message, the
+ *   reference held by the message is moved to the calling task.
+ *
+ *   If the message cannot be received, it is put back at the head of the
+ *   queue where it came from and the errno is set to EBADMSG (wrong kind
+ *   of message) or ENOSPC (too many tasks hold the buffer).
+ *
+ * Parameters:
+ *   msgq   - The message queue that the message was taken from
+ *   mqmsg  - The message returned by mq_waitreceive()
+ *   buffer - True if the receiver expects a buffer message
+ *
+ * Return Value:
+ *   The message, or NULL if it was put back.
+ *
+ * Assumptions:
+ *   Interrupts are disabled, as they are around mq_waitreceive().
+ *
+ ****************************************************************************/
+
+FAR struct mqueue_msg_s *mq_bufverifymsg(FAR struct mqueue_inode_s *msgq, FAR struct mqueue_msg_s *mqmsg, bool buffer)
+{
+	int errcode;
+
+	if (!buffer) {
+		if (!mqmsg->buffer) {
+			return mqmsg;
+		}
+
+		errcode = EBADMSG;
+	} else if (!mqmsg->buffer) {
+		errcode = EBADMSG;
+	} else {
+		errcode = -mq_bufhold(mqmsg->buffer, getpid());
+		if (errcode == OK) {
+			return mqmsg;
+		}
+	}
+
+	sq_addfirst((FAR sq_entry_t *)mqmsg, &msgq->msglist);
+	msgq->nmsgs++;
+
+	set_errno(errcode);
+	return NULL;
+}
+
+/****************************************************************************
+ * Name: mq_bufalloc
+ *
+ * Description:
+ *   Take a buffer from the message queue buffer pool.  The calling task
+ *   holds the only reference to it.
+ *
+ * Parameters:
+ *   size - The number of bytes needed
+ *
+ * Return Value:
+ *   The address of the buffer.  On failure NULL is returned and the errno
+ *   is set appropriately:
+ *
+ *   EINVAL   'size' is larger than CONFIG_MQ_BUFFER_SIZE.
+ *   ENOBUFS  All of the buffers are in use.
+ *
+ ****************************************************************************/
+
+FAR void *mq_bufalloc(size_t size)
+{
+	FAR struct mq_buffer_s *buffer;
+	irqstate_t flags;
+
+	DEBUGASSERT(up_interrupt_context() == false);
+
+	if (size > CONFIG_MQ_BUFFER_SIZE) {
+		set_errno(EINVAL);
+		return NULL;
+	}
+
+	flags = irqsave();
+	buffer = (FAR struct mq_buffer_s *)sq_remfirst(&g_mqbuffree);
+	if (buffer) {
+		buffer->crefs = 1;
+		(void)mq_bufhold(buffer, getpid());
+	}
+
+	irqrestore(flags);
+
+	if (!buffer) {
+		set_errno(ENOBUFS);
+		return NULL;
+	}
+
+	return mq_bufdata(buffer);
+}
+
+/****************************************************************************
+ * Name: mq_bufref
+ *
+ * Description:
+ *   Take one more reference to a buffer that the calling task already
+ *   holds, typically to send the same buffer to another message queue.
+ *
+ * Parameters:
+ *   buf - The address returned by mq_bufalloc() or mq_bufreceive()
+ *
+ * Return Value:
+ *   0 (OK) on success.  On failure -1 (ERROR) is returned and the errno is
+ *   set appropriately:
+ *
+ *   EINVAL   'buf' is not an allocated buffer.
+ *   EPERM    The calling task holds no reference to the buffer.
+ *
+ ****************************************************************************/
+
+int mq_bufref(FAR void *buf)
+{
+	FAR struct mq_buffer_s *buffer;
+	irqstate_t flags;
+	int ret = -EINVAL;
+
+	DEBUGASSERT(up_interrupt_context() == false);
+
+	flags = irqsave();
+	buffer = mq_bufhandle(buf);
+	if (buffer) {
+		ret = -EPERM;
+		if (mq_bufholder(buffer, getpid())) {
+			(void)mq_bufhold(buffer, getpid());
+			buffer->crefs++;
+			ret = OK;
+		}
+	}
+
+	irqrestore(flags);
+
+	if (ret < 0) {
+		set_errno(-ret);
+		return ERROR;
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: mq_buffree
+ *
+ * Description:
+ *   Drop a reference of the calling task to a buffer.  The buffer goes
+ *   back to the pool when its last reference is dropped.
+ *
+ * Parameters:
+ *   buf - The address returned by mq_bufalloc() or mq_bufreceive()
+ *
+ * Return Value:
+ *   0 (OK) on success.  On failure -1 (ERROR) is returned and the errno is
+ *   set appropriately:
+ *
+ *   EINVAL   'buf' is not an allocated buffer.
+ *   EPERM    The calling task holds no reference to the buffer.
+ *
+ ****************************************************************************/
+
+int mq_buffree(FAR void *buf)
+{
+	FAR struct mq_buffer_s *buffer;
+	irqstate_t flags;
+	int ret = -EINVAL;
+
+	DEBUGASSERT(up_interrupt_context() == false);
+
+	flags = irqsave();
+	buffer = mq_bufhandle(buf);
+	if (buffer) {
+		ret = mq_bufunhold(buffer, getpid());
+		if (ret == OK) {
+			mq_bufdrop(buffer);
+		}
+	}
+
+	irqrestore(flags);
+
+	if (ret < 0) {
+		set_errno(-ret);
+		return ERROR;
+	}
+
+	return OK;
+}
+
+#endif							/* CONFIG_MQ_BUFFER */
@@ -0,0 +1,131 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <mqueue.h>
+#include <debug.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/cancelpt.h>
+
+#include "mqueue/mqueue.h"
+
+#ifdef CONFIG_MQ_BUFFER
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mq_bufreceive
+ *
+ * Description:
+ *   This function receives the oldest of the highest priority messages
+ *   from the message queue, like mq_receive(), but the message must have
+ *   been sent by mq_bufsend().  The reference to the buffer that the
+ *   message held moves to the calling task, which drops it with
+ *   mq_buffree() or passes it on with mq_bufsend().  No data is copied.
+ *
+ * Parameters:
+ *   mqdes - Message Queue Descriptor
+ *   buf - The location to return the address of the buffer
+ *   prio - If not NULL, the location to store message priority.
+ *
+ * Return Value:
+ *   On success, the length of the payload in the buffer is returned.  On
+ *   failure, -1 (ERROR) is returned and the errno is set appropriately:
+ *
+ *   EAGAIN   The queue was empty, and the O_NONBLOCK flag was set
+ *            for the message queue description referred to by 'mqdes'.
+ *   EPERM    Message queue opened not opened for reading.
+ *   EINVAL   Invalid 'buf' or 'mqdes'
+ *   EINTR    The call was interrupted by a signal handler.
+ *   EBADMSG  The next message was sent by mq_send().  It is left in the
+ *            queue.
+ *   ENOSPC   CONFIG_MQ_BUFFER_NHOLDERS other tasks hold the buffer.  The
+ *            message is left in the queue.
+ *
+ * Assumptions:
+ *   Not callable from interrupt handlers.
+ *
+ ****************************************************************************/
+
+ssize_t mq_bufreceive(mqd_t mqdes, FAR void **buf, FAR int *prio)
+{
+	FAR struct mqueue_msg_s *mqmsg;
+	irqstate_t saved_state;
+	ssize_t ret = ERROR;
+	char dummy;
+
+	DEBUGASSERT(up_interrupt_context() == false);
+
+	/* mq_bufreceive() is a cancellation point */
+	(void)enter_cancellation_point();
+
+	if (!buf || !mqdes) {
+		set_errno(EINVAL);
+		leave_cancellation_point();
+		return ERROR;
+	}
+
+	if ((mqdes->oflags & O_RDOK) == 0) {
+		set_errno(EPERM);
+		leave_cancellation_point();
+		return ERROR;
+	}
+
+	/* Get the next message from the message queue, with pre-emption and
+	 * interrupts disabled as in mq_receive().
+	 */
+
+	sched_lock();
+	saved_state = irqsave();
+
+	mqmsg = mq_waitreceive(mqdes);
+	if (mqmsg) {
+		mqmsg = mq_bufverifymsg(mqdes->msgq, mqmsg, true);
+	}
+
+	irqrestore(saved_state);
+
+	if (mqmsg) {
+		/* The reference is now held by the calling task, take it out of the
+		 * message before the message is freed.
+		 */
+
+		*buf = mq_bufdata(mqmsg->buffer);
+		ret = mqmsg->buflen;
+		mqmsg->buffer = NULL;
+
+		(void)mq_doreceive(mqdes, mqmsg, &dummy, prio);
+	}
+
+	sched_unlock();
+	leave_cancellation_point();
+	return ret;
+}
+
+#endif							/* CONFIG_MQ_BUFFER */
@@ -0,0 +1,151 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <unistd.h>
+#include <mqueue.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/cancelpt.h>
+
+#include "mqueue/mqueue.h"
+
+#ifdef CONFIG_MQ_BUFFER
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mq_bufsend
+ *
+ * Description:
+ *   This function passes a buffer from the message queue buffer pool to
+ *   the message queue.  It works like mq_send(), except that the message
+ *   only carries the buffer: one reference of the calling task moves to
+ *   the message and the data is not copied.  The payload may be larger
+ *   than the maxmsgsize attribute of the message queue, up to
+ *   CONFIG_MQ_BUFFER_SIZE bytes.
+ *
+ *   The sender must not modify the buffer once it is sent.  To send the
+ *   same buffer to several message queues, take one more reference with
+ *   mq_bufref() for each additional queue.
+ *
+ * Parameters:
+ *   mqdes - Message queue descriptor
+ *   buf - The address returned by mq_bufalloc() or mq_bufreceive()
+ *   len - The length of the payload in the buffer
+ *   prio - The priority of the message
+ *
+ * Return Value:
+ *   On success, mq_bufsend() returns 0 (OK); on error, -1 (ERROR) is
+ *   returned, with errno set to indicate the error:
+ *
+ *   EAGAIN   The queue was full and the O_NONBLOCK flag was set for the
+ *            message queue description referred to by mqdes.
+ *   EINVAL   Either 'buf' is not an allocated buffer, mqdes is NULL or the
+ *            value of prio is invalid.
+ *   EPERM    Message queue opened not opened for writing, or the calling
+ *            task holds no reference to the buffer.
+ *   EMSGSIZE 'len' was greater than CONFIG_MQ_BUFFER_SIZE.
+ *   EINTR    The call was interrupted by a signal handler.
+ *
+ *   On error the calling task keeps its reference to the buffer.
+ *
+ * Assumptions/restrictions:
+ *   Not callable from interrupt handlers.
+ *
+ ****************************************************************************/
+
+int mq_bufsend(mqd_t mqdes, FAR void *buf, size_t len, int prio)
+{
+	FAR struct mq_buffer_s *buffer;
+	FAR struct mqueue_inode_s *msgq;
+	FAR struct mqueue_msg_s *mqmsg = NULL;
+	irqstate_t saved_state;
+	int ret = ERROR;
+
+	DEBUGASSERT(up_interrupt_context() == false);
+
+	/* mq_bufsend() is a cancellation point */
+	(void)enter_cancellation_point();
+
+	/* The message itself carries no data, only the buffer */
+
+	if (mq_verifysend(mqdes, buf, 0, prio) != OK) {
+		leave_cancellation_point();
+		return ERROR;
+	}
+
+	if (len > CONFIG_MQ_BUFFER_SIZE) {
+		set_errno(EMSGSIZE);
+		leave_cancellation_point();
+		return ERROR;
+	}
+
+	sched_lock();
+	msgq = mqdes->msgq;
+
+	/* Allocate a message structure, waiting for the message queue to become
+	 * non-full if needed, exactly as mq_send() does.
+	 */
+
+	saved_state = irqsave();
+	if (msgq->nmsgs < msgq->maxmsgs || mq_waitsend(mqdes) == OK) {
+		irqrestore(saved_state);
+		mqmsg = mq_msgalloc();
+	} else {
+		irqrestore(saved_state);
+	}
+
+	if (mqmsg) {
+		/* Move the reference of the calling task to the message.  This is
+		 * done only now so that the reference is still accounted to the
+		 * task if it is deleted while waiting above.
+		 */
+
+		saved_state = irqsave();
+		buffer = mq_bufhandle(buf);
+		ret = buffer ? mq_bufunhold(buffer, getpid()) : -EINVAL;
+		irqrestore(saved_state);
+
+		if (ret == OK) {
+			mqmsg->buffer = buffer;
+			mqmsg->buflen = len;
+			ret = mq_dosend(mqdes, mqmsg, (FAR const char *)buf, 0, prio);
+		} else {
+			mq_msgfree(mqmsg);
+			set_errno(-ret);
+			ret = ERROR;
+		}
+	}
+
+	sched_unlock();
+	leave_cancellation_point();
+	return ret;
+}
+
+#endif							/* CONFIG_MQ_BUFFER */
@@ -200,6 +200,12 @@ void mq_initialize(void)
 	/* Allocate a block of message queue descriptors */
 
 	mq_desblockalloc();
+
+#ifdef CONFIG_MQ_BUFFER
+	/* Allocate the pool of buffers passed by mq_bufsend() */
+
+	mq_bufinitialize();
+#endif
 }
 
 /************************************************************************
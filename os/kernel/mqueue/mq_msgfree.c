@@ -107,6 +107,19 @@ void mq_msgfree(FAR struct mqueue_msg_s *mqmsg)
 {
 	irqstate_t saved_state;
 
+#ifdef CONFIG_MQ_BUFFER
+	/* A buffer message that was never received still holds a reference to
+	 * its buffer, e.g. when the message queue is destroyed.
+	 */
+
+	if (mqmsg->buffer) {
+		saved_state = irqsave();
+		mq_bufdrop(mqmsg->buffer);
+		mqmsg->buffer = NULL;
+		irqrestore(saved_state);
+	}
+#endif
+
 	/* If this is a generally available pre-allocated message,
 	 * then just put it back in the free list.
 	 */
@@ -206,6 +206,7 @@ FAR struct mqueue_msg_s *mq_waitreceive(mqd_t mqdes)
 			rtcb = this_task();
 			rtcb->msgwaitq = msgq;
 			msgq->nwaitnotempty++;
+			sched_addwaiter(rtcb, &msgq->waitnotempty);
 
 			set_errno(OK);
 			up_block_task(rtcb, TSTATE_WAIT_MQNOTEMPTY);
@@ -301,13 +302,14 @@ ssize_t mq_doreceive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg, FAR char *ubuf
 	msgq = mqdes->msgq;
 	if (msgq->nwaitnotfull > 0) {
 		/* Find the highest priority task that is waiting for
-		 * this queue to be not-full in g_waitingformqnotfull list.
+		 * this queue to be not-full.  It is at the head of the
+		 * queue's not-full wait list.
 		 * This must be performed in a critical section because
 		 * messages can be sent from interrupt handlers.
 		 */
 
 		saved_state = irqsave();
-		for (btcb = (FAR struct tcb_s *)g_waitingformqnotfull.head; btcb && btcb->msgwaitq != msgq; btcb = btcb->flink) ;
+		btcb = msgq->waitnotfull;
 
 		/* If one was found, unblock it.  NOTE:  There is a race
 		 * condition here:  the queue might be full again by the
@@ -316,6 +318,7 @@ ssize_t mq_doreceive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg, FAR char *ubuf
 
 		ASSERT(btcb);
 
+		sched_removewaiter(btcb, &msgq->waitnotfull);
 		btcb->msgwaitq = NULL;
 		msgq->nwaitnotfull--;
 		up_unblock_task(btcb);
@@ -168,6 +168,13 @@ ssize_t mq_receive(mqd_t mqdes, FAR char *msg, size_t msglen, FAR int *prio)
 	/* Get the message from the message queue */
 
 	mqmsg = mq_waitreceive(mqdes);
+#ifdef CONFIG_MQ_BUFFER
+	/* A message sent by mq_bufsend() is left for mq_bufreceive() */
+
+	if (mqmsg) {
+		mqmsg = mq_bufverifymsg(mqdes->msgq, mqmsg, false);
+	}
+#endif
 	irqrestore(saved_state);
 
 	/* Check if we got a message from the message queue.  We might
@@ -61,6 +61,7 @@
 #include <tinyara/mqueue.h>
 #include <tinyara/sched.h>
 
+#include "sched/sched.h"
 #include "mqueue/mqueue.h"
 
 /************************************************************************
@@ -119,7 +120,9 @@ void mq_recover(FAR struct tcb_s *tcb)
 		/* Decrement the count of waiters */
 
 		DEBUGASSERT(tcb->msgwaitq && tcb->msgwaitq->nwaitnotempty > 0);
+		sched_removewaiter(tcb, &tcb->msgwaitq->waitnotempty);
 		tcb->msgwaitq->nwaitnotempty--;
+		tcb->msgwaitq = NULL;
 	}
 
 	/* Was the task waiting for a message queue to become non-full? */
@@ -128,6 +131,14 @@ void mq_recover(FAR struct tcb_s *tcb)
 		/* Decrement the count of waiters */
 
 		DEBUGASSERT(tcb->msgwaitq && tcb->msgwaitq->nwaitnotfull > 0);
+		sched_removewaiter(tcb, &tcb->msgwaitq->waitnotfull);
 		tcb->msgwaitq->nwaitnotfull--;
+		tcb->msgwaitq = NULL;
 	}
+
+#ifdef CONFIG_MQ_BUFFER
+	/* Return the buffers that only this task still referenced to the pool */
+
+	mq_bufrelease(tcb->pid);
+#endif
 }
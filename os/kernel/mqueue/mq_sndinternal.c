@@ -220,6 +220,12 @@ FAR struct mqueue_msg_s *mq_msgalloc(void)
 		}
 	}
 
+#ifdef CONFIG_MQ_BUFFER
+	if (mqmsg) {
+		mqmsg->buffer = NULL;
+	}
+#endif
+
 	return mqmsg;
 }
 
@@ -302,6 +308,7 @@ int mq_waitsend(mqd_t mqdes)
 				rtcb = this_task();
 				rtcb->msgwaitq = msgq;
 				msgq->nwaitnotfull++;
+				sched_addwaiter(rtcb, &msgq->waitnotfull);
 
 				set_errno(OK);
 				up_block_task(rtcb, TSTATE_WAIT_MQNOTFULL);
@@ -431,17 +438,18 @@ int mq_dosend(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg, FAR const char *msg,
 	saved_state = irqsave();
 	if (msgq->nwaitnotempty > 0) {
 		/* Find the highest priority task that is waiting for
-		 * this queue to be non-empty in g_waitingformqnotempty
-		 * list. sched_lock() should give us sufficent protection since
+		 * this queue to be non-empty.  It is at the head of the
+		 * queue's not-empty wait list. sched_lock() should give us sufficent protection since
 		 * interrupts should never cause a change in this list
 		 */
 
-		for (btcb = (FAR struct tcb_s *)g_waitingformqnotempty.head; btcb && btcb->msgwaitq != msgq; btcb = btcb->flink) ;
+		btcb = msgq->waitnotempty;
 
 		/* If one was found, unblock it */
 
 		ASSERT(btcb);
 
+		sched_removewaiter(btcb, &msgq->waitnotempty);
 		btcb->msgwaitq = NULL;
 		msgq->nwaitnotempty--;
 		up_unblock_task(btcb);
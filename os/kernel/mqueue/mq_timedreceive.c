@@ -292,6 +292,14 @@ ssize_t mq_timedreceive(mqd_t mqdes, FAR char *msg, size_t msglen, FAR int *prio
 
 	mqmsg = mq_waitreceive(mqdes);
 
+#ifdef CONFIG_MQ_BUFFER
+	/* A message sent by mq_bufsend() is left for mq_bufreceive() */
+
+	if (mqmsg) {
+		mqmsg = mq_bufverifymsg(mqdes->msgq, mqmsg, false);
+	}
+#endif
+
 	/* Stop the watchdog timer (this is not harmful in the case where
 	 * it was never started)
 	 */
@@ -62,6 +62,7 @@
 #include <tinyara/arch.h>
 #include <tinyara/mqueue.h>
 
+#include "sched/sched.h"
 #include "mqueue/mqueue.h"
 
 /****************************************************************************
@@ -136,9 +137,11 @@ void mq_waitirq(FAR struct tcb_s *wtcb, int errcode)
 
 		if (wtcb->task_state == TSTATE_WAIT_MQNOTEMPTY) {
 			DEBUGASSERT(msgq->nwaitnotempty > 0);
+			sched_removewaiter(wtcb, &msgq->waitnotempty);
 			msgq->nwaitnotempty--;
 		} else {
 			DEBUGASSERT(msgq->nwaitnotfull > 0);
+			sched_removewaiter(wtcb, &msgq->waitnotfull);
 			msgq->nwaitnotfull--;
 		}
 
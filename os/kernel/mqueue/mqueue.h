@@ -112,10 +112,33 @@ struct mqueue_msg_s {
 	uint8_t msglen;					/* Message data length */
 #else
 	uint16_t msglen;				/* Message data length */
+#endif
+#ifdef CONFIG_MQ_BUFFER
+	FAR struct mq_buffer_s *buffer;	/* Buffer passed by mq_bufsend() or NULL */
+	size_t buflen;					/* Length of the data in the buffer */
 #endif
 	char mail[MQ_MAX_BYTES];		/* Message data */
 };
 
+#ifdef CONFIG_MQ_BUFFER
+/* One task that holds references to a message queue buffer */
+
+struct mq_bufholder_s {
+	pid_t pid;						/* The task or INVALID_PROCESS_ID */
+	uint16_t crefs;					/* References held by the task */
+};
+
+/* The descriptor of a message queue buffer.  A buffer is referenced by the
+ * tasks listed in holder[] and by the queued messages that carry it.
+ */
+
+struct mq_buffer_s {
+	FAR struct mq_buffer_s *flink;	/* Link in the list of free buffers */
+	uint16_t crefs;					/* Number of references of all kinds */
+	struct mq_bufholder_s holder[CONFIG_MQ_BUFFER_NHOLDERS];
+};
+#endif
+
 /****************************************************************************
  * Public Variables
  ****************************************************************************/
@@ -186,6 +209,19 @@ void mq_release(FAR struct task_group_s *group);
 
 void mq_recover(FAR struct tcb_s *tcb);
 
+#ifdef CONFIG_MQ_BUFFER
+/* mq_buffer.c *************************************************************/
+
+void mq_bufinitialize(void);
+FAR struct mq_buffer_s *mq_bufhandle(FAR void *buf);
+FAR void *mq_bufdata(FAR struct mq_buffer_s *buffer);
+int mq_bufhold(FAR struct mq_buffer_s *buffer, pid_t pid);
+int mq_bufunhold(FAR struct mq_buffer_s *buffer, pid_t pid);
+void mq_bufdrop(FAR struct mq_buffer_s *buffer);
+void mq_bufrelease(pid_t pid);
+FAR struct mqueue_msg_s *mq_bufverifymsg(FAR struct mqueue_inode_s *msgq, FAR struct mqueue_msg_s *mqmsg, bool buffer);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
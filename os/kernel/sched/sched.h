@@ -243,8 +243,26 @@ bool sched_addreadytorun(FAR struct tcb_s *rtrtcb);
 bool sched_removereadytorun(FAR struct tcb_s *rtrtcb);
 bool sched_addprioritized(FAR struct tcb_s *newTcb, DSEG dq_queue_t *list);
 bool sched_mergepending(void);
+#ifdef CONFIG_SCHED_READYBITMAP
+bool sched_addready(FAR struct tcb_s *tcb);
+void sched_removeready(FAR struct tcb_s *tcb);
+void sched_reprioritizehead(FAR struct tcb_s *tcb, uint8_t priority);
+void sched_removetasklist(FAR struct tcb_s *tcb);
+#else
+#define sched_addready(tcb) \
+		sched_addprioritized(tcb, (FAR dq_queue_t *)&g_readytorun)
+#define sched_removeready(tcb) \
+		dq_rem((FAR dq_entry_t *)(tcb), (FAR dq_queue_t *)&g_readytorun)
+#define sched_reprioritizehead(tcb, priority) \
+		((tcb)->sched_priority = (uint8_t)(priority))
+#define sched_removetasklist(tcb) \
+		dq_rem((FAR dq_entry_t *)(tcb), (FAR dq_queue_t *)g_tasklisttable[(tcb)->task_state].list)
+#endif
 void sched_addblocked(FAR struct tcb_s *btcb, tstate_t task_state);
 void sched_removeblocked(FAR struct tcb_s *btcb);
+void sched_addwaiter(FAR struct tcb_s *tcb, FAR struct tcb_s **waitlist);
+void sched_removewaiter(FAR struct tcb_s *tcb, FAR struct tcb_s **waitlist);
+FAR struct tcb_s **sched_getwaitlist(FAR struct tcb_s *tcb);
 int sched_setpriority(FAR struct tcb_s *tcb, int sched_priority);
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
@@ -113,10 +113,30 @@ bool sched_mergepending(void)
 {
 	FAR struct tcb_s *pndtcb;
 	FAR struct tcb_s *pndnext;
+#ifndef CONFIG_SCHED_READYBITMAP
 	FAR struct tcb_s *rtrtcb;
 	FAR struct tcb_s *rtrprev;
+#endif
 	bool ret = false;
 
+#ifdef CONFIG_SCHED_READYBITMAP
+	/* Each pending task is placed directly using the priority bitmap */
+
+	for (pndtcb = (FAR struct tcb_s *)g_pendingtasks.head; pndtcb; pndtcb = pndnext) {
+		pndnext = pndtcb->flink;
+
+		if (sched_addready(pndtcb)) {
+			/* The pndtcb was added at the head of the list */
+
+			pndtcb->flink->task_state = TSTATE_TASK_READYTORUN;
+			pndtcb->task_state = TSTATE_TASK_RUNNING;
+			ret = true;
+		} else {
+			pndtcb->task_state = TSTATE_TASK_READYTORUN;
+		}
+	}
+#else
+
 	/* Initialize the inner search loop */
 
 	rtrtcb = this_task();
@@ -169,6 +189,7 @@ bool sched_mergepending(void)
 
 		rtrtcb = pndtcb;
 	}
+#endif
 
 	/* Mark the input list empty */
 
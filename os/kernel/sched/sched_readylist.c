@@ -0,0 +1,287 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/************************************************************************
+ * Included Files
+ ************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <queue.h>
+#include <assert.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_READYBITMAP
+
+/************************************************************************
+ * Pre-processor Definitions
+ ************************************************************************/
+
+#define READYMAP_NWORDS   ((SCHED_PRIORITY_MAX + 32) / 32)
+#define READYMAP_WORD(p)  ((p) >> 5)
+#define READYMAP_BIT(p)   (1u << ((p) & 31))
+
+/************************************************************************
+ * Private Variables
+ ************************************************************************/
+
+/* g_readytorun is still a single list sorted by priority.  The TCBs of
+ * one priority form a FIFO run inside of it, and the last TCB of each
+ * run is kept in g_readytail[].  A bit is set in g_readymap[] for each
+ * priority that has a run, and a bit is set in g_readygroup for each
+ * word of g_readymap[] that is not zero.
+ */
+
+static FAR struct tcb_s *g_readytail[SCHED_PRIORITY_MAX + 1];
+static uint32_t g_readymap[READYMAP_NWORDS];
+static uint32_t g_readygroup;
+
+/************************************************************************
+ * Private Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name: sched_readyhigher
+ *
+ * Description:
+ *   Return the lowest priority that is higher than 'priority' and has
+ *   ready-to-run tasks, or -1 if there is none.
+ *
+ ************************************************************************/
+
+static int sched_readyhigher(int priority)
+{
+	uint32_t bits;
+	uint32_t group;
+	int word;
+
+	if (priority >= SCHED_PRIORITY_MAX) {
+		return -1;
+	}
+
+	/* Look for the higher priorities in the same word first */
+
+	priority++;
+	word = READYMAP_WORD(priority);
+	bits = g_readymap[word] & ~(READYMAP_BIT(priority) - 1);
+	if (bits) {
+		return (word << 5) + __builtin_ctz(bits);
+	}
+
+	/* Then find the next non-empty word */
+
+	group = g_readygroup & ~((2u << word) - 1);
+	if (!group) {
+		return -1;
+	}
+
+	word = __builtin_ctz(group);
+	return (word << 5) + __builtin_ctz(g_readymap[word]);
+}
+
+/************************************************************************
+ * Name: sched_readyunindex
+ *
+ * Description:
+ *   Drop a TCB from the priority index before it is unlinked from the
+ *   g_readytorun list or its priority is changed.
+ *
+ ************************************************************************/
+
+static void sched_readyunindex(FAR struct tcb_s *tcb)
+{
+	FAR struct tcb_s *prev;
+	uint8_t priority = tcb->sched_priority;
+
+	if (g_readytail[priority] != tcb) {
+		return;
+	}
+
+	prev = (FAR struct tcb_s *)tcb->blink;
+	if (prev && prev->sched_priority == priority) {
+		g_readytail[priority] = prev;
+	} else {
+		g_readytail[priority] = NULL;
+		g_readymap[READYMAP_WORD(priority)] &= ~READYMAP_BIT(priority);
+		if (!g_readymap[READYMAP_WORD(priority)]) {
+			g_readygroup &= ~(1u << READYMAP_WORD(priority));
+		}
+	}
+}
+
+/************************************************************************
+ * Public Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name: sched_addready
+ *
+ * Description:
+ *   Add a TCB to the g_readytorun list in priority order, after all of
+ *   the TCBs of the same priority.  This is the same ordering that
+ *   sched_addprioritized() gives, but the location is found from the
+ *   priority bitmap instead of by walking the list.
+ *
+ * Inputs:
+ *   tcb - Points to the TCB to add to the ready-to-run list
+ *
+ * Return Value:
+ *   true if the head of the list has changed.
+ *
+ * Assumptions:
+ * - The caller has established a critical section.
+ * - The caller has already removed the TCB from whatever list it was in.
+ *
+ ************************************************************************/
+
+bool sched_addready(FAR struct tcb_s *tcb)
+{
+	FAR struct tcb_s *prev;
+	FAR struct tcb_s *next;
+	uint8_t priority = tcb->sched_priority;
+	int higher;
+
+	/* Insert after the last TCB of the same priority or, if there is
+	 * none, after the last TCB of the next higher priority.
+	 */
+
+	prev = g_readytail[priority];
+	if (!prev) {
+		higher = sched_readyhigher(priority);
+		if (higher >= 0) {
+			prev = g_readytail[higher];
+		}
+	}
+
+	if (prev) {
+		next = (FAR struct tcb_s *)prev->flink;
+		prev->flink = tcb;
+	} else {
+		next = (FAR struct tcb_s *)g_readytorun.head;
+		g_readytorun.head = (FAR dq_entry_t *)tcb;
+	}
+
+	tcb->blink = prev;
+	tcb->flink = next;
+
+	if (next) {
+		next->blink = tcb;
+	} else {
+		g_readytorun.tail = (FAR dq_entry_t *)tcb;
+	}
+
+	/* This TCB is now the last one of its priority */
+
+	g_readytail[priority] = tcb;
+	g_readymap[READYMAP_WORD(priority)] |= READYMAP_BIT(priority);
+	g_readygroup |= 1u << READYMAP_WORD(priority);
+
+	return prev == NULL;
+}
+
+/************************************************************************
+ * Name: sched_removeready
+ *
+ * Description:
+ *   Remove a TCB from the g_readytorun list.
+ *
+ * Inputs:
+ *   tcb - Points to the TCB to remove
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ * - The caller has established a critical section.
+ *
+ ************************************************************************/
+
+void sched_removeready(FAR struct tcb_s *tcb)
+{
+	sched_readyunindex(tcb);
+	dq_rem((FAR dq_entry_t *)tcb, (FAR dq_queue_t *)&g_readytorun);
+}
+
+/************************************************************************
+ * Name: sched_reprioritizehead
+ *
+ * Description:
+ *   Change the priority of the running task without moving it.  This is
+ *   only valid when the new priority is still higher than the priority
+ *   of the next task in the g_readytorun list.
+ *
+ * Inputs:
+ *   tcb - The TCB at the head of the ready-to-run list
+ *   priority - The new task priority
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ * - The caller has established a critical section.
+ *
+ ************************************************************************/
+
+void sched_reprioritizehead(FAR struct tcb_s *tcb, uint8_t priority)
+{
+	DEBUGASSERT(tcb->blink == NULL);
+
+	sched_readyunindex(tcb);
+	tcb->sched_priority = priority;
+
+	/* No other task can have the new priority, so the running task is the
+	 * only TCB of its priority.
+	 */
+
+	DEBUGASSERT(g_readytail[priority] == NULL);
+
+	g_readytail[priority] = tcb;
+	g_readymap[READYMAP_WORD(priority)] |= READYMAP_BIT(priority);
+	g_readygroup |= 1u << READYMAP_WORD(priority);
+}
+
+/************************************************************************
+ * Name: sched_removetasklist
+ *
+ * Description:
+ *   Remove a TCB from the task list associated with its current state.
+ *
+ * Inputs:
+ *   tcb - Points to the TCB to remove
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ * - The caller has established a critical section.
+ *
+ ************************************************************************/
+
+void sched_removetasklist(FAR struct tcb_s *tcb)
+{
+	if (tcb->task_state == TSTATE_TASK_READYTORUN || tcb->task_state == TSTATE_TASK_RUNNING) {
+		sched_removeready(tcb);
+	} else {
+		dq_rem((FAR dq_entry_t *)tcb, (FAR dq_queue_t *)g_tasklisttable[tcb->task_state].list);
+	}
+}
+
+#endif /* CONFIG_SCHED_READYBITMAP */
@@ -121,6 +121,7 @@
 int sched_setpriority(FAR struct tcb_s *tcb, int sched_priority)
 {
 	FAR struct tcb_s *rtcb = this_task();
+	FAR struct tcb_s **waitlist;
 	tstate_t task_state;
 	irqstate_t saved_state;
 
@@ -163,7 +164,7 @@ int sched_setpriority(FAR struct tcb_s *tcb, int sched_priority)
 		else {
 			/* Change the task priority */
 
-			tcb->sched_priority = (uint8_t)sched_priority;
+			sched_reprioritizehead(tcb, (uint8_t)sched_priority);
 		}
 		break;
 
@@ -211,6 +212,15 @@ int sched_setpriority(FAR struct tcb_s *tcb, int sched_priority)
 		/* CASE 3a. The task resides in a prioritized list. */
 
 		if (g_tasklisttable[task_state].prioritized) {
+			/* If the task is waiting on a semaphore or message queue, it
+			 * must also be re-sorted in that object's wait list.
+			 */
+
+			waitlist = sched_getwaitlist(tcb);
+			if (waitlist) {
+				sched_removewaiter(tcb, waitlist);
+			}
+
 			/* Remove the TCB from the prioritized task list */
 
 			dq_rem((FAR dq_entry_t *)tcb, (FAR dq_queue_t *)g_tasklisttable[task_state].list);
@@ -224,6 +234,10 @@ int sched_setpriority(FAR struct tcb_s *tcb, int sched_priority)
 			 */
 
 			sched_addprioritized(tcb, (FAR dq_queue_t *)g_tasklisttable[task_state].list);
+
+			if (waitlist) {
+				sched_addwaiter(tcb, waitlist);
+			}
 		}
 
 		/* CASE 3b. The task resides in a non-prioritized list. */
@@ -0,0 +1,170 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/************************************************************************
+ * Included Files
+ ************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <semaphore.h>
+
+#include <tinyara/mqueue.h>
+
+#include "sched/sched.h"
+
+/************************************************************************
+ * Public Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name: sched_addwaiter
+ *
+ * Description:
+ *   Add a task to the wait list of the object (semaphore or message
+ *   queue) that it is about to block on.  The list is kept in priority
+ *   order so that the highest priority waiter is always at the head;
+ *   waiters of equal priority are kept in FIFO order.
+ *
+ * Inputs:
+ *   tcb      - The task that will wait.
+ *   waitlist - The head of the object's wait list.
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ * - The caller has interrupts disabled.
+ * - The task is not in any other object's wait list.
+ *
+ ************************************************************************/
+
+void sched_addwaiter(FAR struct tcb_s *tcb, FAR struct tcb_s **waitlist)
+{
+	FAR struct tcb_s *prev = NULL;
+	FAR struct tcb_s *next = *waitlist;
+
+	/* Skip over all waiters of the same or higher priority */
+
+	while (next && next->sched_priority >= tcb->sched_priority) {
+		prev = next;
+		next = next->wflink;
+	}
+
+	/* Link the task in between prev and next */
+
+	tcb->wblink = prev;
+	tcb->wflink = next;
+
+	if (prev) {
+		prev->wflink = tcb;
+	} else {
+		*waitlist = tcb;
+	}
+
+	if (next) {
+		next->wblink = tcb;
+	}
+}
+
+/************************************************************************
+ * Name: sched_removewaiter
+ *
+ * Description:
+ *   Remove a task from the wait list of the object it is waiting on.
+ *
+ * Inputs:
+ *   tcb      - The waiting task.
+ *   waitlist - The head of the object's wait list.
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ * - The caller has interrupts disabled.
+ *
+ ************************************************************************/
+
+void sched_removewaiter(FAR struct tcb_s *tcb, FAR struct tcb_s **waitlist)
+{
+	if (tcb->wblink) {
+		tcb->wblink->wflink = tcb->wflink;
+	} else {
+		DEBUGASSERT(*waitlist == tcb);
+		*waitlist = tcb->wflink;
+	}
+
+	if (tcb->wflink) {
+		tcb->wflink->wblink = tcb->wblink;
+	}
+
+	tcb->wflink = NULL;
+	tcb->wblink = NULL;
+}
+
+/************************************************************************
+ * Name: sched_getwaitlist
+ *
+ * Description:
+ *   Return the head of the wait list that a blocked task is linked
+ *   into, if any.
+ *
+ * Inputs:
+ *   tcb - The task to examine.
+ *
+ * Return Value:
+ *   A pointer to the head of the wait list or NULL if the task is not
+ *   waiting on a semaphore or message queue.
+ *
+ * Assumptions:
+ * - The caller has interrupts disabled.
+ *
+ ************************************************************************/
+
+FAR struct tcb_s **sched_getwaitlist(FAR struct tcb_s *tcb)
+{
+	switch (tcb->task_state) {
+	case TSTATE_WAIT_SEM:
+		if (tcb->waitsem) {
+			return &tcb->waitsem->waitlist;
+		}
+		break;
+
+#ifndef CONFIG_DISABLE_MQUEUE
+	case TSTATE_WAIT_MQNOTEMPTY:
+		if (tcb->msgwaitq) {
+			return &tcb->msgwaitq->waitnotempty;
+		}
+		break;
+
+	case TSTATE_WAIT_MQNOTFULL:
+		if (tcb->msgwaitq) {
+			return &tcb->msgwaitq->waitnotfull;
+		}
+		break;
+#endif
+
+	default:
+		break;
+	}
+
+	return NULL;
+}
@@ -128,6 +128,14 @@ int sem_post(FAR sem_t *sem)
 	irqstate_t saved_state;
 	int ret = ERROR;
 
+#ifdef CONFIG_SEM_FASTPATH
+	/* Give the count back without disabling interrupts if nobody waits */
+
+	if (sem_fastgive(sem)) {
+		return OK;
+	}
+#endif
+
 	/* Make sure we were supplied with a valid semaphore. */
 
 	if (sem && ((sem->flags & FLAGS_INITIALIZED) != 0)) {
@@ -162,15 +170,14 @@ int sem_post(FAR sem_t *sem)
 		 */
 
 		if (sem->semcount <= 0) {
-			/* Check if there are any tasks in the waiting for semaphore
-			 * task list that are waiting for this semaphore. This is a
-			 * prioritized list so the first one we encounter is the one
-			 * that we want.
+			/* Check if there are any tasks waiting for this semaphore.
+			 * The semaphore's wait list is prioritized so the first one
+			 * is the one that we want.
 			 */
 
-			for (stcb = (FAR struct tcb_s *)g_waitingforsemaphore.head; (stcb && stcb->waitsem != sem); stcb = stcb->flink) ;
-
+			stcb = sem->waitlist;
 			if (stcb) {
+				sched_removewaiter(stcb, &sem->waitlist);
 				sem_addholder_tcb(stcb, sem);
 
 				/* It is, let the task take the semaphore */
@@ -59,6 +59,7 @@
 #include <tinyara/arch.h>
 #include <tinyara/sched.h>
 
+#include "sched/sched.h"
 #include "semaphore/semaphore.h"
 
 #ifdef CONFIG_SEMAPHORE_HISTORY
@@ -161,6 +162,7 @@ void sem_recover(FAR struct tcb_s *tcb)
 		 * semaphore list.
 		 */
 
+		sched_removewaiter(tcb, &sem->waitlist);
 		tcb->waitsem = NULL;
 
 #ifdef CONFIG_SEMAPHORE_HISTORY
@@ -203,6 +203,15 @@ int sem_timedwait(FAR sem_t *sem, FAR const struct timespec *abstime)
 	}
 #endif
 
+#ifdef CONFIG_SEM_FASTPATH
+	/* Take an available count without creating the watchdog */
+
+	if (sem_fasttake(sem)) {
+		leave_cancellation_point();
+		return OK;
+	}
+#endif
+
 	/* Create a watchdog.  We will not actually need this watchdog
 	 * unless the semaphore is unavailable, but we will reserve it up
 	 * front before we enter the following critical section.
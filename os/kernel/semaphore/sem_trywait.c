@@ -125,6 +125,14 @@ int sem_trywait(FAR sem_t *sem)
 
 	DEBUGASSERT(sem != NULL && up_interrupt_context() == false);
 
+#ifdef CONFIG_SEM_FASTPATH
+	/* Take an available count without disabling interrupts */
+
+	if (sem_fasttake(sem)) {
+		return OK;
+	}
+#endif
+
 	if ((sem != NULL) && ((sem->flags & FLAGS_INITIALIZED) != 0)) {
 		/* The following operations must be performed with interrupts disabled
 		 * because sem_post() may be called from an interrupt handler.
@@ -135,6 +135,14 @@ int sem_wait(FAR sem_t *sem)
 	DEBUGASSERT(sem != NULL && up_interrupt_context() == false);
 #endif
 
+#ifdef CONFIG_SEM_FASTPATH
+	/* Take an available count without disabling interrupts */
+
+	if (sem_fasttake(sem)) {
+		return OK;
+	}
+#endif
+
 	/* The following operations must be performed with interrupts
 	 * disabled because sem_post() may be called from an interrupt
 	 * handler.
@@ -212,6 +220,7 @@ int sem_wait(FAR sem_t *sem)
 #endif
 			/* Add the TCB to the prioritized semaphore wait queue */
 
+			sched_addwaiter(rtcb, &sem->waitlist);
 			set_errno(0);
 			up_block_task(rtcb, TSTATE_WAIT_SEM);
 
@@ -60,6 +60,7 @@
 #include <errno.h>
 #include <tinyara/arch.h>
 
+#include "sched/sched.h"
 #include "semaphore/semaphore.h"
 
 #ifdef CONFIG_SEMAPHORE_HISTORY
@@ -151,6 +152,7 @@ void sem_waitirq(FAR struct tcb_s *wtcb, int errcode)
 
 		/* Indicate that the semaphore wait is over. */
 
+		sched_removewaiter(wtcb, &sem->waitlist);
 		wtcb->waitsem = NULL;
 
 #ifdef CONFIG_SEMAPHORE_HISTORY
@@ -66,6 +66,8 @@
 #include <sched.h>
 #include <queue.h>
 
+#include <tinyara/semaphore.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -70,6 +70,9 @@
 #include "signal/signal.h"
 #include "task/task.h"
 
+#ifdef CONFIG_MESSAGING_IPC
+#include "messaging/message_ctrl.h"
+#endif
 #ifdef CONFIG_TASK_MANAGER
 #include <task_manager/task_manager.h>
 #include <tinyara/task_manager_drv.h>
@@ -553,6 +556,12 @@ void task_exithook(FAR struct tcb_s *tcb, int status, bool nonblocking)
 		return;
 	}
 
+	/* Memory released from now on in the context of the exiting task must
+	 * not be kept for it (see mm_tcache_free()).
+	 */
+
+	tcb->flags |= TCB_FLAG_EXITING;
+
 #ifdef CONFIG_CANCELLATION_POINTS
 	/* Mark the task as non-cancelable to avoid additional calls to exit()
 	 * due to any cancellation point logic that might get kicked off by
@@ -588,6 +597,12 @@ void task_exithook(FAR struct tcb_s *tcb, int status, bool nonblocking)
 	}
 #endif
 
+#ifdef CONFIG_MESSAGING_IPC
+	/* Close and unlink the messaging reply ports that the task kept open */
+
+	messaging_release(tcb, nonblocking);
+#endif
+
 	/* If the task was terminated by another task, it may be in an unknown
 	 * state.  Make some feeble effort to recover the state.
 	 */
@@ -72,6 +72,7 @@
 
 #ifdef CONFIG_MESSAGING_IPC
 #include <sys/types.h>
+#include <unistd.h>
 #include <messaging/messaging.h>
 #include "messaging/message_ctrl.h"
 #endif
@@ -227,10 +228,44 @@ int prctl(int option, ...)
 		return ret;
 	}
 	break;
+	case PR_MSG_REPLY_SAVE:
+	{
+		int ret;
+		char *port_name = va_arg(ap, char *);
+		mqd_t mqdes = va_arg(ap, mqd_t);
+		int msgsize = va_arg(ap, int);
+		ret = messaging_save_reply(port_name, getpid(), mqdes, msgsize);
+		va_end(ap);
+		return ret;
+	}
+	break;
+	case PR_MSG_REPLY_READ:
+	{
+		int ret;
+		char *port_name = va_arg(ap, char *);
+		mqd_t *mqdes = va_arg(ap, mqd_t *);
+		int *msgsize = va_arg(ap, int *);
+		ret = messaging_read_reply(port_name, getpid(), mqdes, msgsize);
+		va_end(ap);
+		return ret;
+	}
+	break;
+	case PR_MSG_REPLY_REMOVE:
+	{
+		int ret;
+		char *port_name = va_arg(ap, char *);
+		ret = messaging_remove_reply(port_name, getpid());
+		va_end(ap);
+		return ret;
+	}
+	break;
 #else /* CONFIG_MESSAGING_IPC */
 	case PR_MSG_SAVE:
 	case PR_MSG_READ:
 	case PR_MSG_REMOVE:
+	case PR_MSG_REPLY_SAVE:
+	case PR_MSG_REPLY_READ:
+	case PR_MSG_REPLY_REMOVE:
 	{
 		sdbg("Not supported.\n");
 		err = ENOSYS;
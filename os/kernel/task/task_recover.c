@@ -59,6 +59,9 @@
 #include <tinyara/arch.h>
 #include <tinyara/wdog.h>
 #include <tinyara/sched.h>
+#ifdef CONFIG_MM_TASK_CACHE
+#include <tinyara/mm/mm.h>
+#endif
 
 #include "semaphore/semaphore.h"
 #include "wdog/wdog.h"
@@ -129,4 +132,10 @@ void task_recover(FAR struct tcb_s *tcb)
 
 	mq_recover(tcb);
 #endif
+
+#ifdef CONFIG_MM_TASK_CACHE
+	/* Return the small chunks that the thread kept in its cache */
+
+	mm_tcache_recover(tcb->pid);
+#endif
 }
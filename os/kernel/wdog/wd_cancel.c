@@ -108,8 +108,10 @@
 
 int wd_cancel(WDOG_ID wdog)
 {
+#ifndef CONFIG_WDOG_TIMERWHEEL
 	FAR struct wdog_s *curr;
 	FAR struct wdog_s *prev;
+#endif
 	irqstate_t state;
 	int ret = ERROR;
 
@@ -124,6 +126,14 @@ int wd_cancel(WDOG_ID wdog)
 	 */
 
 	if (wdog && WDOG_ISACTIVE(wdog)) {
+#ifdef CONFIG_WDOG_TIMERWHEEL
+		/* Take the watchdog out of its slot of the timer wheel.  The interval
+		 * timer is not reassessed: if it was set for this watchdog, the
+		 * wheel just finds nothing to do and sets the next interval.
+		 */
+
+		wd_wheel_remove(wdog);
+#else
 		/* Search the g_wdactivelist for the target FCB.  We can't use sq_rem
 		 * to do this because there are additional operations that need to be
 		 * done.
@@ -169,9 +179,11 @@ int wd_cancel(WDOG_ID wdog)
 			sched_timer_reassess();
 		}
 
+		wdog->next = NULL;
+#endif
+
 		/* Mark the watchdog inactive */
 
-		wdog->next = NULL;
 		WDOG_CLRACTIVE(wdog);
 
 		/* Return success */
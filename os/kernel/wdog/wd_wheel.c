@@ -0,0 +1,398 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+
+#include <tinyara/wdog.h>
+
+#include "wdog/wdog.h"
+
+#ifdef CONFIG_WDOG_TIMERWHEEL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The wheel has WDOG_WHEEL_LEVELS levels of 64 slots.  A watchdog that
+ * expires within 64 ticks is in level 0, in the slot of its expiration
+ * tick.  Otherwise it is in level L, the lowest level whose span of
+ * 64^(L+1) ticks contains the expiration tick, and it is moved down
+ * ("cascaded") when the lower levels wrap around to its slot.
+ */
+
+#define WDOG_WHEEL_BITS    6
+#define WDOG_WHEEL_SIZE    (1 << WDOG_WHEEL_BITS)
+#define WDOG_WHEEL_MASK    (WDOG_WHEEL_SIZE - 1)
+#define WDOG_WHEEL_LEVELS  5
+
+/* Delays beyond the span of the top level are parked in the farthest slot
+ * of the top level and placed again when that slot is cascaded.
+ */
+
+#define WDOG_WHEEL_MAXDELTA \
+	((uint32_t)1 << (WDOG_WHEEL_BITS * WDOG_WHEEL_LEVELS))
+
+#define WDOG_WHEEL_SHIFT(l)  ((l) * WDOG_WHEEL_BITS)
+#define WDOG_WHEEL_INDEX(t, l) \
+	(((t) >> WDOG_WHEEL_SHIFT(l)) & WDOG_WHEEL_MASK)
+
+/****************************************************************************
+ * Private Variables
+ ****************************************************************************/
+
+/* The slots of the wheel and a bitmap of the non-empty slots of each level */
+
+static FAR struct wdog_s *g_wdwheel[WDOG_WHEEL_LEVELS][WDOG_WHEEL_SIZE];
+static uint64_t g_wdwheelmap[WDOG_WHEEL_LEVELS];
+
+/* The current tick of the wheel.  Expiration ticks are kept in the lag
+ * field of the watchdog and compared with this modulo 2^32.
+ */
+
+static uint32_t g_wdtick;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_link
+ *
+ * Description:
+ *   Put a watchdog in the slot that matches its expiration tick.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_link(FAR struct wdog_s *wdog)
+{
+	FAR struct wdog_s **slot;
+	uint32_t expires = (uint32_t)wdog->lag;
+	uint32_t delta = expires - g_wdtick;
+	int level;
+	int index;
+
+	if (delta >= WDOG_WHEEL_MAXDELTA) {
+		expires = g_wdtick + WDOG_WHEEL_MAXDELTA - 1;
+		delta = WDOG_WHEEL_MAXDELTA - 1;
+	}
+
+	for (level = 0; level < WDOG_WHEEL_LEVELS - 1; level++) {
+		if (delta < ((uint32_t)1 << WDOG_WHEEL_SHIFT(level + 1))) {
+			break;
+		}
+	}
+
+	index = WDOG_WHEEL_INDEX(expires, level);
+	slot = &g_wdwheel[level][index];
+
+	wdog->next = *slot;
+	wdog->pprev = slot;
+	if (*slot) {
+		(*slot)->pprev = &wdog->next;
+	}
+
+	*slot = wdog;
+	g_wdwheelmap[level] |= (uint64_t)1 << index;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_unlink
+ *
+ * Description:
+ *   Take a watchdog out of its slot.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_unlink(FAR struct wdog_s *wdog)
+{
+	FAR struct wdog_s **pprev = wdog->pprev;
+	int slot;
+
+	*pprev = wdog->next;
+	if (wdog->next) {
+		wdog->next->pprev = pprev;
+	}
+
+	wdog->next = NULL;
+	wdog->pprev = NULL;
+
+	/* If this emptied a slot, clear it in the bitmap of its level */
+
+	if (*pprev == NULL && pprev >= &g_wdwheel[0][0] && pprev < &g_wdwheel[0][0] + WDOG_WHEEL_LEVELS * WDOG_WHEEL_SIZE) {
+		slot = pprev - &g_wdwheel[0][0];
+		g_wdwheelmap[slot / WDOG_WHEEL_SIZE] &= ~((uint64_t)1 << (slot % WDOG_WHEEL_SIZE));
+	}
+}
+
+/****************************************************************************
+ * Name: wd_wheel_cascade
+ *
+ * Description:
+ *   Move the watchdogs of the current slot of a level to the lower levels.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_cascade(int level)
+{
+	FAR struct wdog_s *wdog;
+	FAR struct wdog_s *next;
+	int index = WDOG_WHEEL_INDEX(g_wdtick, level);
+
+	wdog = g_wdwheel[level][index];
+	g_wdwheel[level][index] = NULL;
+	g_wdwheelmap[level] &= ~((uint64_t)1 << index);
+
+	for (; wdog; wdog = next) {
+		next = wdog->next;
+		wd_wheel_link(wdog);
+	}
+}
+
+/****************************************************************************
+ * Name: wd_wheel_tick
+ *
+ * Description:
+ *   Advance the wheel by one tick, cascade the upper levels if the lower
+ *   levels wrapped around and run the watchdogs that expire now.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_tick(void)
+{
+	FAR struct wdog_s **slot;
+	FAR struct wdog_s *wdog;
+	int level;
+
+	g_wdtick++;
+
+	for (level = 1; level < WDOG_WHEEL_LEVELS; level++) {
+		if (WDOG_WHEEL_INDEX(g_wdtick, level - 1) != 0) {
+			break;
+		}
+
+		if (g_wdwheelmap[level] & ((uint64_t)1 << WDOG_WHEEL_INDEX(g_wdtick, level))) {
+			wd_wheel_cascade(level);
+		}
+	}
+
+	/* The watchdogs in the current slot of level 0 expire now.  A watchdog
+	 * function may start or cancel other watchdogs, so take them off one
+	 * at a time.
+	 */
+
+	slot = &g_wdwheel[0][WDOG_WHEEL_INDEX(g_wdtick, 0)];
+	while ((wdog = *slot) != NULL) {
+		wd_wheel_unlink(wdog);
+		WDOG_CLRACTIVE(wdog);
+		wd_execute(wdog);
+	}
+}
+
+#ifdef CONFIG_SCHED_TICKLESS
+/****************************************************************************
+ * Name: wd_wheel_nextslot
+ *
+ * Description:
+ *   Return how many slots after 'from' the next non-empty slot of a level
+ *   is (1 to 64), or zero if the level is empty.
+ *
+ ****************************************************************************/
+
+static unsigned int wd_wheel_nextslot(uint64_t map, unsigned int from)
+{
+	from = (from + 1) & WDOG_WHEEL_MASK;
+	if (from) {
+		map = (map >> from) | (map << (WDOG_WHEEL_SIZE - from));
+	}
+
+	return map ? __builtin_ctzll(map) + 1 : 0;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_nextdelay
+ *
+ * Description:
+ *   Return the number of ticks until the wheel next has work to do, either
+ *   watchdogs to run or a non-empty slot to cascade, or zero if there are
+ *   no active watchdogs.
+ *
+ ****************************************************************************/
+
+static unsigned int wd_wheel_nextdelay(void)
+{
+	unsigned int delay = 0;
+	unsigned int next;
+	uint32_t base;
+	int level;
+
+	for (level = 0; level < WDOG_WHEEL_LEVELS; level++) {
+		next = wd_wheel_nextslot(g_wdwheelmap[level], WDOG_WHEEL_INDEX(g_wdtick, level));
+		if (next == 0) {
+			continue;
+		}
+
+		/* Level L is next visited at the tick where its slot index
+		 * advances by 'next' and the lower bits are all zero.
+		 */
+
+		base = (g_wdtick >> WDOG_WHEEL_SHIFT(level)) + next;
+		next = (base << WDOG_WHEEL_SHIFT(level)) - g_wdtick;
+
+		if (delay == 0 || next < delay) {
+			delay = next;
+		}
+	}
+
+	return delay;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   Add a watchdog to the timer wheel.
+ *
+ * Parameters:
+ *   wdog  - The watchdog to add
+ *   delay - The number of ticks until it expires, at least one
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void wd_wheel_insert(FAR struct wdog_s *wdog, int delay)
+{
+	DEBUGASSERT(delay > 0);
+
+	wdog->lag = (int)(g_wdtick + (uint32_t)delay);
+	wd_wheel_link(wdog);
+}
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ *
+ * Description:
+ *   Remove a watchdog from the timer wheel.
+ *
+ * Parameters:
+ *   wdog - The watchdog to remove
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled and the watchdog is active.
+ *
+ ****************************************************************************/
+
+void wd_wheel_remove(FAR struct wdog_s *wdog)
+{
+	DEBUGASSERT(wdog->pprev != NULL);
+
+	wd_wheel_unlink(wdog);
+}
+
+/****************************************************************************
+ * Name: wd_wheel_remaining
+ *
+ * Description:
+ *   Return the number of ticks until an active watchdog expires.
+ *
+ ****************************************************************************/
+
+int wd_wheel_remaining(FAR struct wdog_s *wdog)
+{
+	return (int)((uint32_t)wdog->lag - g_wdtick);
+}
+
+/****************************************************************************
+ * Name: wd_timer
+ *
+ * Description:
+ *   This function is called from the timer interrupt handler to determine
+ *   if it is time to execute a watchdog function.  If so, the watchdog
+ *   function will be executed in the context of the timer interrupt
+ *   handler.
+ *
+ * Parameters:
+ *   ticks - If CONFIG_SCHED_TICKLESS is defined then the number of ticks
+ *     in the the interval that just expired is provided.  Otherwise,
+ *     this function is called on each timer interrupt and a value of one
+ *     is implicit.
+ *
+ * Return Value:
+ *   If CONFIG_SCHED_TICKLESS is defined then the number of ticks for the
+ *   next delay is provided (zero if no delay).  Otherwise, this function
+ *   has no returned value.
+ *
+ * Assumptions:
+ *   Called from interrupt handler logic with interrupts disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_TICKLESS
+unsigned int wd_timer(int ticks)
+{
+	unsigned int next;
+
+	/* Skip over the ticks where the wheel has nothing to do */
+
+	while (ticks > 0) {
+		next = wd_wheel_nextdelay();
+		if (next == 0 || next > (unsigned int)ticks) {
+			g_wdtick += ticks;
+			break;
+		}
+
+		g_wdtick += next - 1;
+		ticks -= next;
+		wd_wheel_tick();
+	}
+
+	/* The next delay may only be for a cascade, which is harmless: the
+	 * wheel is then visited again and a new delay is returned.
+	 */
+
+	return wd_wheel_nextdelay();
+}
+
+#else
+void wd_timer(void)
+{
+	wd_wheel_tick();
+}
+#endif							/* CONFIG_SCHED_TICKLESS */
+
+#endif							/* CONFIG_WDOG_TIMERWHEEL */
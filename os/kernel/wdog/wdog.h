@@ -182,6 +182,33 @@ void wd_timer(void);
 struct tcb_s;
 void wd_recover(FAR struct tcb_s *tcb);
 
+/****************************************************************************
+ * Name: wd_execute
+ *
+ * Description:
+ *   Call the function of a watchdog that has expired.  The watchdog must
+ *   already be removed from the active watchdogs.
+ *
+ ****************************************************************************/
+
+void wd_execute(FAR struct wdog_s *wdog);
+
+#ifdef CONFIG_WDOG_TIMERWHEEL
+/****************************************************************************
+ * Name: wd_wheel_insert, wd_wheel_remove, wd_wheel_remaining
+ *
+ * Description:
+ *   Add a watchdog to the timer wheel, remove it, or get the number of
+ *   ticks until it expires.  Used instead of g_wdactivelist when
+ *   CONFIG_WDOG_TIMERWHEEL is enabled.  Interrupts must be disabled.
+ *
+ ****************************************************************************/
+
+void wd_wheel_insert(FAR struct wdog_s *wdog, int delay);
+void wd_wheel_remove(FAR struct wdog_s *wdog);
+int wd_wheel_remaining(FAR struct wdog_s *wdog);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -39,6 +39,12 @@ int g_logm_overflow_offset = -1;
 
 static void logm_putc(FAR struct lib_outstream_s *this, int ch)
 {
+#ifdef CONFIG_LOGM_DEFERRED
+	if (ch == LOGM_DEFER_MARK) {
+		return;
+	}
+#endif
+
 	if ((g_logm_tail + this->nput + 1) % logm_bufsize != g_logm_head) {
 		g_logm_rsvbuf[(g_logm_tail + this->nput++) % logm_bufsize] = ch;
 	}
@@ -59,6 +65,12 @@ static void logm_flush(struct lib_outstream_s *stream)
 	sched_lock();
 
 	while (g_logm_head != g_logm_tail) {
+#ifdef CONFIG_LOGM_DEFERRED
+		if (g_logm_rsvbuf[g_logm_head] == LOGM_DEFER_MARK) {
+			g_logm_head = (g_logm_head + logm_defer_print(stream, g_logm_head)) % logm_bufsize;
+			continue;
+		}
+#endif
 		stream->put(stream, g_logm_rsvbuf[g_logm_head]);
 		g_logm_head = (g_logm_head + 1) % logm_bufsize;
 	}
@@ -134,6 +146,20 @@ int logm(int flag, int indx, int priority, const char *fmt, ...)
 
 	/* LOGIC for initial test here */
 
+#ifdef CONFIG_LOGM_DEFERRED
+	/* The format of logm() is a literal of the debug macros, so formatting
+	 * can be left to the logm task.  printf and syslog go through
+	 * logm_internal() as their format may not outlive the call.
+	 */
+
+	va_start(ap, fmt);
+	ret = logm_defer(flag, fmt, ap);
+	va_end(ap);
+	if (ret >= 0) {
+		return ret;
+	}
+#endif
+
 	va_start(ap, fmt);
 	ret = logm_internal(flag, indx, priority, fmt, ap);
 	va_end(ap);
@@ -20,6 +20,10 @@
 
 #include <tinyara/config.h>
 #include <stdint.h>
+#ifdef CONFIG_LOGM_DEFERRED
+#include <stdarg.h>
+#include <tinyara/streams.h>
+#endif
 
 /****************************************************************************
  * Preprocessor Definitions
@@ -47,6 +51,15 @@
 #define LOGM_BUFFER_RESIZE_REQ BIT(1)
 #define LOGM_BUFFER_OVERFLOW BIT(2)
 
+#ifdef CONFIG_LOGM_DEFERRED
+/* A byte of LOGM_DEFER_MARK in the buffer starts a deferred record of at
+ * most LOGM_DEFER_MAXREC bytes.  It is never queued as text.
+ */
+
+#define LOGM_DEFER_MARK '\0'
+#define LOGM_DEFER_MAXREC 255
+#endif
+
 #define LOGM_STATUS(a) (logm_status & (a))
 #define LOGM_STATUS_SET(a) (logm_status |= (a))
 #define LOGM_STATUS_CLEAR(a) (logm_status &= ~(a))
@@ -80,6 +93,10 @@ EXTERN volatile int logm_print_interval;
  ************************************************************************************/
 int logm_task(int argc, char *argv[]);
 void logm_register_tashcmds(void);
+#ifdef CONFIG_LOGM_DEFERRED
+int logm_defer(int flag, FAR const char *fmt, va_list ap);
+int logm_defer_print(FAR struct lib_outstream_s *stream, int offset);
+#endif
 
 #undef EXTERN
 #if defined(__cplusplus)
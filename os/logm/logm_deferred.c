@@ -0,0 +1,364 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <arch/irq.h>
+#include <tinyara/arch.h>
+#include <tinyara/logm.h>
+#include <tinyara/streams.h>
+#ifdef CONFIG_LOGM_TIMESTAMP
+#include <tinyara/clock.h>
+#endif
+#include "logm.h"
+
+/****************************************************************************
+ * Preprocessor Definitions
+ ****************************************************************************/
+
+/* A deferred record is laid out as
+ *
+ *   LOGM_DEFER_MARK, length of the record, format pointer,
+ *   [seconds, tenths of milliseconds,] arguments
+ *
+ * The arguments are stored unaligned in the order of the format, with
+ * strings copied including their terminator.
+ */
+
+#define LOGM_DEFER_HDRSIZE (2 + sizeof(FAR const char *))
+
+/* Characters ending the qualifiers of a conversion, as in lib_vsprintf() */
+
+#define LOGM_DEFER_CONVS   "diuxXpobeEfgGlLsc%"
+
+/* Longest conversion which is deferred, and its size once its two '*' at
+ * most are replaced by their values
+ */
+
+#define LOGM_DEFER_SPECMAX   12
+#define LOGM_DEFER_STARMAX   2
+#define LOGM_DEFER_SPECBUF   (LOGM_DEFER_SPECMAX + LOGM_DEFER_STARMAX * 11 + 1)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static bool logm_defer_put(FAR uint8_t *rec, FAR int *len, FAR const void *value, size_t size)
+{
+	if (*len + size > LOGM_DEFER_MAXREC) {
+		return false;
+	}
+
+	memcpy(&rec[*len], value, size);
+	*len += size;
+	return true;
+}
+
+#define LOGM_DEFER_PUT(type, value) \
+	do { \
+		type _v = (value); \
+		if (!logm_defer_put(rec, &len, &_v, sizeof(type))) { \
+			return ERROR; \
+		} \
+	} while (0)
+
+#define LOGM_DEFER_GET(type, value) \
+	do { \
+		memcpy(&(value), &rec[pos], sizeof(type)); \
+		pos += sizeof(type); \
+	} while (0)
+
+/* Store the arguments of 'fmt' into 'rec'.  Returns the length of the
+ * record, or ERROR if the format can not be deferred or the arguments do
+ * not fit.
+ */
+
+static int logm_defer_encode(FAR uint8_t *rec, FAR const char *fmt, va_list ap)
+{
+	FAR const char *ptr;
+	FAR const char *spec;
+	FAR const char *str;
+	int len = LOGM_DEFER_HDRSIZE;
+	bool islong;
+	bool islonglong;
+	int nstars;
+#ifdef CONFIG_LOGM_TIMESTAMP
+	struct timespec ts;
+	int32_t stamp[2] = { -1, 0 };
+#endif
+
+	rec[0] = LOGM_DEFER_MARK;
+	memcpy(&rec[2], &fmt, sizeof(fmt));
+
+#ifdef CONFIG_LOGM_TIMESTAMP
+	if (clock_systimespec(&ts) == OK) {
+		stamp[0] = ts.tv_sec;
+		stamp[1] = ts.tv_nsec / 100000;
+	}
+	logm_defer_put(rec, &len, stamp, sizeof(stamp));
+#endif
+
+	for (ptr = fmt; *ptr; ptr++) {
+		if (*ptr != '%') {
+			continue;
+		}
+
+		spec = ptr;
+		nstars = 0;
+		for (ptr++; *ptr && !strchr(LOGM_DEFER_CONVS, *ptr); ptr++) {
+			if (*ptr == '*') {
+				if (++nstars > LOGM_DEFER_STARMAX) {
+					return ERROR;
+				}
+				LOGM_DEFER_PUT(int, va_arg(ap, int));
+			}
+		}
+
+		islong = false;
+		islonglong = false;
+		if (*ptr == 'L') {
+			islonglong = true;
+			ptr++;
+		} else if (*ptr == 'l') {
+			islong = true;
+			ptr++;
+			if (*ptr == 'l') {
+				islonglong = true;
+				ptr++;
+			}
+		}
+
+		if (*ptr == '\0' || ptr - spec >= LOGM_DEFER_SPECMAX) {
+			return ERROR;
+		}
+
+		if (*ptr == '%') {
+			continue;
+		} else if (*ptr == 's' && !islong && !islonglong) {
+			str = va_arg(ap, FAR const char *);
+			if (!logm_defer_put(rec, &len, str ? str : "(null)", strlen(str ? str : "(null)") + 1)) {
+				return ERROR;
+			}
+		} else if (*ptr == 'c' && !islong && !islonglong) {
+			LOGM_DEFER_PUT(int, va_arg(ap, int));
+		} else if (*ptr == 'p') {
+			LOGM_DEFER_PUT(FAR void *, va_arg(ap, FAR void *));
+		} else if (strchr("diuxXob", *ptr)) {
+			if (islonglong) {
+				LOGM_DEFER_PUT(long long, va_arg(ap, long long));
+			} else if (islong) {
+				LOGM_DEFER_PUT(long, va_arg(ap, long));
+			} else {
+				LOGM_DEFER_PUT(int, va_arg(ap, int));
+			}
+		}
+#ifdef CONFIG_LIBC_FLOATINGPOINT
+		else if (strchr("eEfgG", *ptr)) {
+			LOGM_DEFER_PUT(double, va_arg(ap, double));
+		}
+#endif
+		else {
+			return ERROR;
+		}
+	}
+
+	rec[1] = (uint8_t)len;
+	return len;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: logm_defer
+ *
+ * Description:
+ *   Queue a message as its format pointer and raw arguments.  It is
+ *   formatted later by logm_defer_print() in the logm task, so only the
+ *   copy into the ring is done with interrupts disabled.  'fmt' must stay
+ *   valid until then, which is the case for the string literals of the
+ *   debug macros.
+ *
+ * Returned Value:
+ *   The length of the queued record, 0 if the message was dropped because
+ *   the buffer is full, or ERROR if the message has to be formatted now.
+ *   On ERROR, 'ap' may have been partly consumed.
+ *
+ ****************************************************************************/
+
+int logm_defer(int flag, FAR const char *fmt, va_list ap)
+{
+	uint8_t rec[LOGM_DEFER_MAXREC];
+	irqstate_t flags;
+	int space;
+	int len;
+	int first;
+
+	if (!LOGM_STATUS(LOGM_READY) || LOGM_STATUS(LOGM_BUFFER_RESIZE_REQ) \
+		|| flag != LOGM_NORMAL || up_interrupt_context()) {
+		return ERROR;
+	}
+
+	len = logm_defer_encode(rec, fmt, ap);
+	if (len < 0) {
+		return ERROR;
+	}
+
+	flags = irqsave();
+
+	if (LOGM_STATUS(LOGM_BUFFER_OVERFLOW)) {
+		g_logm_dropmsg_count++;
+		irqrestore(flags);
+		return 0;
+	}
+
+	space = (g_logm_head - g_logm_tail - 1 + logm_bufsize) % logm_bufsize;
+	if (len > space) {
+		LOGM_STATUS_SET(LOGM_BUFFER_OVERFLOW);
+		g_logm_dropmsg_count = 1;
+		g_logm_overflow_offset = g_logm_tail;
+		irqrestore(flags);
+		return 0;
+	}
+
+	first = logm_bufsize - g_logm_tail;
+	if (first >= len) {
+		memcpy(&g_logm_rsvbuf[g_logm_tail], rec, len);
+	} else {
+		memcpy(&g_logm_rsvbuf[g_logm_tail], rec, first);
+		memcpy(g_logm_rsvbuf, &rec[first], len - first);
+	}
+
+	g_logm_tail = (g_logm_tail + len) % logm_bufsize;
+
+	irqrestore(flags);
+	return len;
+}
+
+/****************************************************************************
+ * Name: logm_defer_print
+ *
+ * Description:
+ *   Format the deferred record starting at 'offset' of the logm buffer
+ *   into 'stream'.
+ *
+ * Returned Value:
+ *   The length of the record.
+ *
+ ****************************************************************************/
+
+int logm_defer_print(FAR struct lib_outstream_s *stream, int offset)
+{
+	uint8_t rec[LOGM_DEFER_MAXREC];
+	char spec[LOGM_DEFER_SPECBUF];
+	FAR const char *fmt;
+	FAR const char *ptr;
+	int speclen;
+	int pos;
+	int len;
+	int i;
+
+	len = (uint8_t)g_logm_rsvbuf[(offset + 1) % logm_bufsize];
+	for (i = 0; i < len; i++) {
+		rec[i] = g_logm_rsvbuf[(offset + i) % logm_bufsize];
+	}
+
+	pos = 2;
+	LOGM_DEFER_GET(FAR const char *, fmt);
+
+#ifdef CONFIG_LOGM_TIMESTAMP
+	{
+		int32_t stamp[2];
+
+		LOGM_DEFER_GET(int32_t[2], stamp);
+		if (stamp[0] >= 0) {
+			(void)lib_sprintf(stream, "[%4d.%4d] ", stamp[0], stamp[1]);
+		}
+	}
+#endif
+
+	for (ptr = fmt; *ptr; ptr++) {
+		if (*ptr != '%') {
+			stream->put(stream, *ptr);
+			continue;
+		}
+
+		/* Rebuild the conversion with the values of the '*' in place */
+
+		speclen = 0;
+		spec[speclen++] = *ptr;
+		for (ptr++; *ptr && !strchr(LOGM_DEFER_CONVS, *ptr); ptr++) {
+			if (*ptr == '*') {
+				int value;
+
+				LOGM_DEFER_GET(int, value);
+				speclen += snprintf(&spec[speclen], LOGM_DEFER_SPECBUF - speclen, "%d", value);
+			} else {
+				spec[speclen++] = *ptr;
+			}
+		}
+
+		while (*ptr == 'l' || *ptr == 'L') {
+			spec[speclen++] = *ptr++;
+		}
+
+		spec[speclen++] = *ptr;
+		spec[speclen] = '\0';
+
+		if (*ptr == '%') {
+			stream->put(stream, '%');
+		} else if (*ptr == 's') {
+			(void)lib_sprintf(stream, spec, (FAR const char *)&rec[pos]);
+			pos += strlen((FAR const char *)&rec[pos]) + 1;
+		} else if (*ptr == 'p') {
+			FAR void *value;
+
+			LOGM_DEFER_GET(FAR void *, value);
+			(void)lib_sprintf(stream, spec, value);
+		} else if (strchr("eEfgG", *ptr)) {
+#ifdef CONFIG_LIBC_FLOATINGPOINT
+			double value;
+
+			LOGM_DEFER_GET(double, value);
+			(void)lib_sprintf(stream, spec, value);
+#endif
+		} else if (strstr(spec, "ll") || strchr(spec, 'L')) {
+			long long value;
+
+			LOGM_DEFER_GET(long long, value);
+			(void)lib_sprintf(stream, spec, value);
+		} else if (strchr(spec, 'l')) {
+			long value;
+
+			LOGM_DEFER_GET(long, value);
+			(void)lib_sprintf(stream, spec, value);
+		} else {
+			int value;
+
+			LOGM_DEFER_GET(int, value);
+			(void)lib_sprintf(stream, spec, value);
+		}
+	}
+
+	return len;
+}
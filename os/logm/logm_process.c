@@ -23,6 +23,9 @@
 #include <arch/irq.h>
 #include <tinyara/logm.h>
 #include <tinyara/config.h>
+#ifdef CONFIG_LOGM_DEFERRED
+#include <tinyara/streams.h>
+#endif
 #include "logm.h"
 #ifdef CONFIG_LOGM_TEST
 #include "logm_test.h"
@@ -65,6 +68,11 @@ static int logm_change_bufsize(int buflen)
 int logm_task(int argc, char *argv[])
 {
 	irqstate_t flags;
+#ifdef CONFIG_LOGM_DEFERRED
+	struct lib_stdoutstream_s strm;
+
+	lib_stdoutstream(&strm, stdout);
+#endif
 
 	g_logm_rsvbuf = (char *)malloc(logm_bufsize);
 	memset(g_logm_rsvbuf, 0, logm_bufsize);
@@ -78,8 +86,15 @@ int logm_task(int argc, char *argv[])
 
 	while (1) {
 		while (g_logm_head != g_logm_tail) {
-			fputc(g_logm_rsvbuf[g_logm_head], stdout);
-			g_logm_head = (g_logm_head + 1) % logm_bufsize;
+#ifdef CONFIG_LOGM_DEFERRED
+			if (g_logm_rsvbuf[g_logm_head] == LOGM_DEFER_MARK) {
+				g_logm_head = (g_logm_head + logm_defer_print(&strm.public, g_logm_head)) % logm_bufsize;
+			} else
+#endif
+			{
+				fputc(g_logm_rsvbuf[g_logm_head], stdout);
+				g_logm_head = (g_logm_head + 1) % logm_bufsize;
+			}
 			if (LOGM_STATUS(LOGM_BUFFER_OVERFLOW)) {
 				LOGM_STATUS_CLEAR(LOGM_BUFFER_OVERFLOW);
 			}
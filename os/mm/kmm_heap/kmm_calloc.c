@@ -80,6 +80,9 @@ static void *kheap_calloc(size_t n, size_t elem_size, size_t retaddr)
 		ret = mm_calloc(&kheap[heap_idx], n, elem_size);
 #endif
 		if (ret != NULL) {
+#ifdef CONFIG_MM_SAMPLING
+			mm_sample_alloc(&kheap[heap_idx], ret, n * elem_size, retaddr);
+#endif
 			return ret;
 		}
 	}
@@ -134,6 +137,8 @@ FAR void *kmm_calloc(size_t n, size_t elem_size)
 {
 #ifdef CONFIG_DEBUG_MM_HEAPINFO
 	ARCH_GET_RET_ADDRESS
+#elif defined(CONFIG_MM_SAMPLING)
+	size_t retaddr = (size_t)__builtin_return_address(0);
 #else
 	size_t retaddr = 0;
 #endif
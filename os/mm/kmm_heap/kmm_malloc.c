@@ -93,6 +93,9 @@ static void *kheap_malloc(size_t size, size_t retaddr)
 		ret = mm_malloc(&kheap[heap_idx], size);
 #endif
 		if (ret != NULL) {
+#ifdef CONFIG_MM_SAMPLING
+			mm_sample_alloc(&kheap[heap_idx], ret, size, retaddr);
+#endif
 			return ret;
 		}
 	}
@@ -157,6 +160,8 @@ FAR void *kmm_malloc(size_t size)
 {
 #ifdef CONFIG_DEBUG_MM_HEAPINFO
 	ARCH_GET_RET_ADDRESS
+#elif defined(CONFIG_MM_SAMPLING)
+	size_t retaddr = (size_t)__builtin_return_address(0);
 #else
 	size_t retaddr = 0;
 #endif
@@ -132,6 +132,9 @@ FAR void *kmm_memalign(size_t alignment, size_t size)
 		ret = mm_memalign(&kheap[kheap_idx], alignment, size);
 #endif
 		if (ret != NULL) {
+#ifdef CONFIG_MM_SAMPLING
+			mm_sample_alloc(&kheap[kheap_idx], ret, size, (uintptr_t)__builtin_return_address(0));
+#endif
 			return ret;
 		}
 	}
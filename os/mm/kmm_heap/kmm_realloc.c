@@ -130,6 +130,9 @@ FAR void *kmm_realloc(FAR void *oldmem, size_t newsize)
 	ret = mm_realloc(kheap_origin, oldmem, newsize);
 #endif
 	if (ret != NULL) {
+#ifdef CONFIG_MM_SAMPLING
+		mm_sample_alloc(kheap_origin, ret, newsize, (uintptr_t)__builtin_return_address(0));
+#endif
 		return ret;
 	}
 
@@ -143,6 +146,9 @@ FAR void *kmm_realloc(FAR void *oldmem, size_t newsize)
 #endif
 		if (ret != NULL) {
 			kmm_free(oldmem);
+#ifdef CONFIG_MM_SAMPLING
+			mm_sample_alloc(&kheap_new[kheap_idx], ret, newsize, (uintptr_t)__builtin_return_address(0));
+#endif
 			return ret;
 		}
 	}
@@ -126,6 +126,9 @@ FAR void *kmm_zalloc(size_t size)
 		ret = mm_zalloc(&kheap[kheap_idx], size);
 #endif
 		if (ret != NULL) {
+#ifdef CONFIG_MM_SAMPLING
+			mm_sample_alloc(&kheap[kheap_idx], ret, size, (uintptr_t)__builtin_return_address(0));
+#endif
 			return ret;
 		}
 	}
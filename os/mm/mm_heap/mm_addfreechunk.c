@@ -84,6 +84,21 @@ void mm_addfreechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node)
 	FAR struct mm_freenode_s *next;
 	FAR struct mm_freenode_s *prev;
 
+#ifdef CONFIG_MM_NODELIST_TLSF
+	/* Convert the size to a segregated list index */
+
+	int ndx = mm_tlsf_size2ndx(node->size);
+
+	/* The lists are not ordered, put the new free node at the head and
+	 * mark the list as non-empty.
+	 */
+
+	prev = &heap->mm_nodelist[ndx];
+	next = prev->flink;
+
+	heap->mm_slbitmap[ndx / MM_SLI_COUNT] |= 1u << (ndx % MM_SLI_COUNT);
+	heap->mm_flbitmap |= 1u << (ndx / MM_SLI_COUNT);
+#else
 	/* Convert the size to a nodelist index */
 
 	int ndx = mm_size2ndx(node->size);
@@ -91,6 +106,7 @@ void mm_addfreechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node)
 	/* Now put the new free node in a descending order */
 
 	for (prev = &heap->mm_nodelist[ndx], next = prev->flink; next && next->size > node->size; prev = next, next = next->flink) ;
+#endif
 
 	/* Does it go in mid next or at the end? */
 
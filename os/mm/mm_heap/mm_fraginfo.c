@@ -0,0 +1,82 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <tinyara/mm/mm.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_fraginfo
+ *
+ * Description:
+ *   Collect the free chunk statistics of a heap: the total free space, the
+ *   largest free chunk and a histogram of the free chunks per nodelist
+ *   bucket.  The fragmentation index is the share of the free space that
+ *   is not in the largest free chunk, from 0 (all free space is contiguous)
+ *   to 100.  Chunks held in the allocation caches are not counted as free.
+ *
+ ****************************************************************************/
+
+int mm_fraginfo(FAR struct mm_heap_s *heap, FAR struct mm_fraginfo_s *info)
+{
+	FAR struct mm_freenode_s *node;
+	int ndx;
+
+	DEBUGASSERT(info);
+
+	memset(info, 0, sizeof(struct mm_fraginfo_s));
+
+	/* Walking the free lists is cheaper than walking the whole heap */
+
+	mm_takesemaphore(heap);
+
+	for (ndx = 0; ndx < MM_NLISTS; ndx++) {
+		for (node = heap->mm_nodelist[ndx].flink; node && node->size; node = node->flink) {
+			info->nfree++;
+			info->freesize += node->size;
+			if (node->size > info->largest) {
+				info->largest = node->size;
+			}
+
+			info->count[mm_size2ndx(node->size)]++;
+			info->size[mm_size2ndx(node->size)] += node->size;
+		}
+	}
+
+	mm_givesemaphore(heap);
+
+	if (info->freesize > 0) {
+		info->fragindex = 100 - (int)(((uint64_t)info->largest * 100) / info->freesize);
+	}
+
+	return OK;
+}
@@ -78,6 +78,72 @@
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: mm_freechunk
+ *
+ * Description:
+ *   Returns an allocated chunk to the list of free nodes, merging with
+ *   adjacent free chunks if possible.  It is assumed that the caller holds
+ *   the mm semaphore and has already updated the heap information.
+ *
+ ****************************************************************************/
+void mm_freechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node)
+{
+	FAR struct mm_freenode_s *prev;
+	FAR struct mm_freenode_s *next;
+
+	node->preceding &= ~MM_ALLOC_BIT;
+
+	/* Check if the following node is free and, if so, merge it */
+
+	next = (FAR struct mm_freenode_s *)((char *)node + node->size);
+	if ((next->preceding & MM_ALLOC_BIT) == 0) {
+		FAR struct mm_allocnode_s *andbeyond;
+
+		/* Get the node following the next node (which will
+		 * become the new next node). We know that we can never
+		 * index past the tail chunk because it is always allocated.
+		 */
+
+		andbeyond = (FAR struct mm_allocnode_s *)((char *)next + next->size);
+
+		/* Remove the next node.  There must be a predecessor,
+		 * but there may not be a successor node.
+		 */
+
+		REMOVE_NODE_FROM_LIST(heap, next);
+
+		/* Then merge the two chunks */
+
+		node->size          += next->size;
+		andbeyond->preceding = node->size | (andbeyond->preceding & MM_ALLOC_BIT);
+		next                 = (FAR struct mm_freenode_s *)andbeyond;
+	}
+
+	/* Check if the preceding node is also free and, if so, merge
+	 * it with this node
+	 */
+
+	prev = (FAR struct mm_freenode_s *)((char *)node - node->preceding);
+	if ((prev->preceding & MM_ALLOC_BIT) == 0) {
+		/* Remove the node.  There must be a predecessor, but there may
+		 * not be a successor node.
+		 */
+
+		REMOVE_NODE_FROM_LIST(heap, prev);
+
+		/* Then merge the two chunks */
+
+		prev->size     += node->size;
+		next->preceding = prev->size | (next->preceding & MM_ALLOC_BIT);
+		node            = prev;
+	}
+
+	/* Add the merged node to the nodelist */
+
+	mm_addfreechunk(heap, node);
+}
+
 /****************************************************************************
  * Name: mm_free
  *
@@ -89,8 +155,6 @@
 void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
 {
 	FAR struct mm_freenode_s *node;
-	FAR struct mm_freenode_s *prev;
-	FAR struct mm_freenode_s *next;
 #ifdef CONFIG_DEBUG_MM_HEAPINFO
 	struct mm_allocnode_s *alloc_node;
 #endif
@@ -113,12 +177,6 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
 		return;
 	}
 
-	/* We need to hold the MM semaphore while we muck with the
-	 * nodelist.
-	 */
-
-	mm_takesemaphore(heap);
-
 	/* Map the memory chunk into a free node */
 
 	node = (FAR struct mm_freenode_s *)((char *)mem - SIZEOF_MM_ALLOCNODE);
@@ -138,63 +196,47 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
 	}
 
 #endif
-#ifdef CONFIG_DEBUG_MM_HEAPINFO
-	alloc_node = (struct mm_allocnode_s *)node;
+#ifdef CONFIG_MM_SAMPLING
+	/* Forget the chunk if it was sampled.  Nothing to look up while no
+	 * sample is live.
+	 */
 
-	if ((alloc_node->preceding & MM_ALLOC_BIT) != 0) {
-		heapinfo_subtract_size(heap, alloc_node->pid, alloc_node->size);
-		heapinfo_update_total_size(heap, ((-1) * alloc_node->size), alloc_node->pid);
+	if (heap->mm_sample.nlive > 0) {
+		mm_sample_free(heap, mem);
 	}
-#endif
-	node->preceding &= ~MM_ALLOC_BIT;
-
-	/* Check if the following node is free and, if so, merge it */
-
-	next = (FAR struct mm_freenode_s *)((char *)node + node->size);
-	if ((next->preceding & MM_ALLOC_BIT) == 0) {
-		FAR struct mm_allocnode_s *andbeyond;
-
-		/* Get the node following the next node (which will
-		 * become the new next node). We know that we can never
-		 * index past the tail chunk because it is always allocated.
-		 */
-
-		andbeyond = (FAR struct mm_allocnode_s *)((char *)next + next->size);
-
-		/* Remove the next node.  There must be a predecessor,
-		 * but there may not be a successor node.
-		 */
-
-		REMOVE_NODE_FROM_LIST(next);
 
-		/* Then merge the two chunks */
+#endif
+#ifdef CONFIG_MM_TASK_CACHE
+	/* Small chunks are kept in the cache of the calling task for reuse */
 
-		node->size          += next->size;
-		andbeyond->preceding = node->size | (andbeyond->preceding & MM_ALLOC_BIT);
-		next                 = (FAR struct mm_freenode_s *)andbeyond;
+	if (mm_tcache_free(heap, (FAR struct mm_allocnode_s *)node)) {
+		return;
 	}
 
-	/* Check if the preceding node is also free and, if so, merge
-	 * it with this node
+#endif
+	/* We need to hold the MM semaphore while we muck with the
+	 * nodelist.
 	 */
 
-	prev = (FAR struct mm_freenode_s *)((char *)node - node->preceding);
-	if ((prev->preceding & MM_ALLOC_BIT) == 0) {
-		/* Remove the node.  There must be a predecessor, but there may
-		 * not be a successor node.
-		 */
-
-		REMOVE_NODE_FROM_LIST(prev);
+	mm_takesemaphore(heap);
 
-		/* Then merge the two chunks */
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+	alloc_node = (struct mm_allocnode_s *)node;
 
-		prev->size     += node->size;
-		next->preceding = prev->size | (next->preceding & MM_ALLOC_BIT);
-		node            = prev;
+	if ((alloc_node->preceding & MM_ALLOC_BIT) != 0) {
+		heapinfo_subtract_size(heap, alloc_node->pid, alloc_node->size);
+		heapinfo_update_total_size(heap, ((-1) * alloc_node->size), alloc_node->pid);
 	}
+#endif
+#ifdef CONFIG_MM_SLAB
+	/* Small chunks are kept in the size-class cache for reuse */
 
-	/* Add the merged node to the nodelist */
+	if (mm_slab_free(heap, (FAR struct mm_allocnode_s *)node)) {
+		mm_givesemaphore(heap);
+		return;
+	}
 
-	mm_addfreechunk(heap, node);
+#endif
+	mm_freechunk(heap, node);
 	mm_givesemaphore(heap);
 }
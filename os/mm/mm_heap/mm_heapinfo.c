@@ -103,6 +103,9 @@ void heapinfo_parse(FAR struct mm_heap_s *heap, int mode, pid_t pid)
 	int nonsched_idx;
 	struct sched_param sched_data;
 	size_t heap_size;
+#ifdef CONFIG_MM_SLAB
+	size_t cachedblks = 0;		/* Total space held in the size-class cache */
+#endif
 
 	/* This nonsched can be 3 types : group resources, freed when child task finished, leak */
 	pid_t nonsched_list[CONFIG_MAX_TASKS];
@@ -116,9 +119,7 @@ void heapinfo_parse(FAR struct mm_heap_s *heap, int mode, pid_t pid)
 
 #ifdef CONFIG_DEBUG_CHECK_FRAGMENTATION
 	int ndx;
-	int nodelist_cnt[MM_NNODES] = {0, };
-	size_t nodelist_size[MM_NNODES] = {0, };
-	FAR struct mm_freenode_s *fnode;
+	struct mm_fraginfo_s fraginfo;
 #endif
 
 	/* initialize the heap, stack and nonsched resource */
@@ -155,6 +156,17 @@ void heapinfo_parse(FAR struct mm_heap_s *heap, int mode, pid_t pid)
 
 		for (node = heap->mm_heapstart[region]; node < heap->mm_heapend[region]; node = (struct mm_allocnode_s *)((char *)node + node->size)) {
 
+#ifdef CONFIG_MM_SLAB
+			/* Check if the node is held in the size-class cache */
+			if ((node->preceding & MM_ALLOC_BIT) != 0 && node->reserved == MM_SLAB_MARK) {
+				cachedblks += node->size;
+				if (mode == HEAPINFO_DETAIL_ALL || mode == HEAPINFO_DETAIL_FREE || mode == HEAPINFO_DETAIL_SPECIFIC_HEAP) {
+					printf("0x%x | %8d |   %c    |            |       |\n", node, node->size, 'C');
+				}
+				continue;
+			}
+#endif
+
 			/* Check if the node corresponds to an allocated memory chunk */
 			if ((pid == HEAPINFO_PID_ALL || node->pid == pid) && (node->preceding & MM_ALLOC_BIT) != 0) {
 				if (mode == HEAPINFO_DETAIL_ALL || mode == HEAPINFO_DETAIL_PID || mode == HEAPINFO_DETAIL_SPECIFIC_HEAP) {
@@ -195,7 +207,11 @@ void heapinfo_parse(FAR struct mm_heap_s *heap, int mode, pid_t pid)
 		}
 
 		if (mode != HEAPINFO_SIMPLE) {
-			printf("** PID(S) in Pid colum means that mem is used for stack of PID\n\n");
+			printf("** PID(S) in Pid colum means that mem is used for stack of PID\n");
+#ifdef CONFIG_MM_SLAB
+			printf("** Status C means that mem is kept in the size-class cache\n");
+#endif
+			printf("\n");
 		}
 		mm_givesemaphore(heap);
 	}
@@ -227,6 +243,9 @@ void heapinfo_parse(FAR struct mm_heap_s *heap, int mode, pid_t pid)
 		heap->total_alloc_size, (size_t)((uint64_t)(heap->total_alloc_size) * 100 / heap_size),\
 		heap->peak_alloc_size,  (size_t)((uint64_t)(heap->peak_alloc_size) * 100 / heap_size));
 	printf("  - Free (Current)              : %u (%d%%)\n", fordblks, (size_t)((uint64_t)fordblks * 100 / heap_size));
+#ifdef CONFIG_MM_SLAB
+	printf("  - Cached (Current)            : %u (%d%%)\n", cachedblks, (size_t)((uint64_t)cachedblks * 100 / heap_size));
+#endif
 	printf("  - Reserved                    : %u\n", SIZEOF_MM_ALLOCNODE * 2);
 
 	printf("\n****************************************************************\n");
@@ -235,6 +254,7 @@ void heapinfo_parse(FAR struct mm_heap_s *heap, int mode, pid_t pid)
 	printf("< Free >\n");
 	printf("  - Number of Free Node               : %d\n", ordblks);
 	printf("  - Largest Free Node Size            : %u\n", mxordblk);
+	printf("  - Fragmentation Index               : %d%%\n", fordblks > 0 ? 100 - (int)((uint64_t)mxordblk * 100 / fordblks) : 0);
 	printf("\n< Allocation >\n");
 	printf("  - Current Size (Alive Allocation) = (1) + (2) + (3)\n");
 	printf("     . by Dead Threads (*) (1)        : %u\n", nonsched_resource);
@@ -250,19 +270,10 @@ void heapinfo_parse(FAR struct mm_heap_s *heap, int mode, pid_t pid)
 #ifdef CONFIG_DEBUG_CHECK_FRAGMENTATION
 	printf("\nAvailable fragmented memory segments in heap memory\n");
 
-	mm_takesemaphore(heap);
-
-	for (ndx = 0; ndx < MM_NNODES; ++ndx) {
-		for (fnode = heap->mm_nodelist[ndx].flink; fnode && fnode->size; fnode = fnode->flink) {
-			++nodelist_cnt[ndx];
-			nodelist_size[ndx] += fnode->size;
-		}
-	}
-
-	mm_givesemaphore(heap);
+	mm_fraginfo(heap, &fraginfo);
 
 	for (ndx = 0; ndx < MM_NNODES; ++ndx) {
-		printf("Nodelist[%d] ranging [%u, %u] : num %d, size %u [Bytes]\n", ndx, ((ndx > 0 ? (1 << (ndx + MM_MIN_SHIFT)) : 0) + 1), 1 << (ndx + MM_MIN_SHIFT + 1), nodelist_cnt[ndx], nodelist_size[ndx]);
+		printf("Nodelist[%d] ranging [%u, %u] : num %d, size %u [Bytes]\n", ndx, ((ndx > 0 ? (1 << (ndx + MM_MIN_SHIFT)) : 0) + 1), 1 << (ndx + MM_MIN_SHIFT + 1), fraginfo.count[ndx], fraginfo.size[ndx]);
 	}
 #endif
 
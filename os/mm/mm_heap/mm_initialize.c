@@ -61,6 +61,9 @@
 #include <debug.h>
 
 #include <tinyara/mm/mm.h>
+#ifdef CONFIG_MM_TASK_CACHE
+#include <tinyara/clock.h>
+#endif
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -220,7 +223,31 @@ void mm_initialize(FAR struct mm_heap_s *heap, FAR void *heapstart, size_t heaps
 
 	/* Initialize the node array */
 
-	memset(heap->mm_nodelist, 0, sizeof(struct mm_freenode_s) * (MM_NNODES + 1));
+	memset(heap->mm_nodelist, 0, sizeof(struct mm_freenode_s) * (MM_NLISTS + 1));
+#ifdef CONFIG_MM_NODELIST_TLSF
+	heap->mm_flbitmap = 0;
+	memset(heap->mm_slbitmap, 0, sizeof(heap->mm_slbitmap));
+#endif
+
+#ifdef CONFIG_MM_SLAB
+	/* Initialize the size-class cache */
+
+	memset(heap->mm_slablist, 0, sizeof(heap->mm_slablist));
+	memset(heap->mm_slabcount, 0, sizeof(heap->mm_slabcount));
+	heap->mm_slabsize = 0;
+#endif
+
+#ifdef CONFIG_MM_TASK_CACHE
+	/* Initialize the per-task caches */
+
+	memset(heap->mm_tcache, 0, sizeof(heap->mm_tcache));
+	heap->mm_tcachesize = 0;
+	heap->mm_tcacheflush = clock_systimer();
+#endif
+
+#ifdef CONFIG_MM_SAMPLING
+	mm_sample_initialize(heap);
+#endif
 
 	/* Initialize the malloc semaphore to one (to support one-at-
 	 * a-time access to private data sets).
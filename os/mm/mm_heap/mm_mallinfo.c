@@ -137,6 +137,22 @@ int mm_mallinfo(FAR struct mm_heap_s *heap, FAR struct mallinfo *info)
 
 	DEBUGASSERT(uordblks + fordblks == heap->mm_heapsize);
 
+#ifdef CONFIG_MM_SLAB
+	/* Chunks held in the size-class cache look allocated in the heap walk,
+	 * but they are available for new allocations.
+	 */
+
+	uordblks -= heap->mm_slabsize;
+	fordblks += heap->mm_slabsize;
+#endif
+
+#ifdef CONFIG_MM_TASK_CACHE
+	/* Likewise for the chunks held in the per-task caches */
+
+	uordblks -= heap->mm_tcachesize;
+	fordblks += heap->mm_tcachesize;
+#endif
+
 #if CONFIG_MM_NHEAPS > 1
 	info->arena    += heap->mm_heapsize;
 	info->ordblks  += ordblks;
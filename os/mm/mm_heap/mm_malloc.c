@@ -111,7 +111,9 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 {
 	FAR struct mm_freenode_s *node;
 	void *ret = NULL;
+#ifndef CONFIG_MM_NODELIST_TLSF
 	int ndx;
+#endif
 
 	/* Handle bad sizes */
 
@@ -132,10 +134,59 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 
 	size = MM_ALIGN_UP(size + SIZEOF_MM_ALLOCNODE);
 
+#ifdef CONFIG_MM_TASK_CACHE
+	/* Small requests are served from the cache of the calling task when
+	 * possible, without the MM semaphore.
+	 */
+
+	ret = mm_tcache_alloc(heap, size);
+	if (ret) {
+		mvdbg("Allocated %p, size %u\n", ret, size);
+		return ret;
+	}
+
+#endif
 	/* We need to hold the MM semaphore while we muck with the nodelist. */
 
 	mm_takesemaphore(heap);
 
+#ifdef CONFIG_MM_TASK_CACHE
+	/* Give the chunks held in the task caches back to the heap from time
+	 * to time, so that they can merge with their free neighbours.
+	 */
+
+	mm_tcache_age(heap);
+#endif
+
+#ifdef CONFIG_MM_SLAB
+	/* Small requests are served from the size-class cache when possible */
+
+	node = (FAR struct mm_freenode_s *)mm_slab_alloc(heap, size);
+	if (node) {
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+		heapinfo_update_node((struct mm_allocnode_s *)node, caller_retaddr);
+		heapinfo_add_size(heap, ((struct mm_allocnode_s *)node)->pid, node->size);
+		heapinfo_update_total_size(heap, node->size, ((struct mm_allocnode_s *)node)->pid);
+#endif
+		mm_givesemaphore(heap);
+
+		ret = (void *)((char *)node + SIZEOF_MM_ALLOCNODE);
+		mvdbg("Allocated %p, size %u\n", ret, size);
+		return ret;
+	}
+
+#endif
+#if defined(CONFIG_MM_SLAB) || defined(CONFIG_MM_TASK_CACHE)
+search:
+#endif
+
+#ifdef CONFIG_MM_NODELIST_TLSF
+	/* Find a large enough chunk through the bitmaps of the segregated
+	 * lists.  This takes a bounded time however the heap is fragmented.
+	 */
+
+	node = mm_tlsf_search(heap, size);
+#else
 	/* Get the location in the node list to start the search
 	 * by converting the request size into a nodelist index.
 	 */
@@ -159,13 +210,14 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 	if (!(node && node->size == size)) {
 		node = prev;
 	}
+#endif
 
 	/* If we found a node with non-zero size, then this is one to use. Since
 	 * the list is ordered, we know that is must be best fitting chunk
 	 * available.
 	 */
 
-	if (node->size) {
+	if (node && node->size) {
 		FAR struct mm_freenode_s *remainder;
 		FAR struct mm_freenode_s *next;
 		size_t remaining;
@@ -174,7 +226,7 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 		 * a successor node.
 		 */
 
-		REMOVE_NODE_FROM_LIST(node);
+		REMOVE_NODE_FROM_LIST(heap, node);
 
 		/* Check if we have to split the free node into one of the allocated
 		 * size and another smaller freenode.  In some cases, the remaining
@@ -221,6 +273,22 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 #endif
 		ret = (void *)((char *)node + SIZEOF_MM_ALLOCNODE);
 	}
+#ifdef CONFIG_MM_SLAB
+	else if (heap->mm_slabsize > 0 && mm_slab_drain(heap) > 0) {
+		/* The cached chunks may merge into a large enough free chunk once
+		 * they are returned to the nodelist.  Search again.
+		 */
+
+		goto search;
+	}
+#endif
+#ifdef CONFIG_MM_TASK_CACHE
+	else if (heap->mm_tcachesize > 0 && mm_tcache_drain(heap) > 0) {
+		/* Likewise for the chunks cached by the tasks */
+
+		goto search;
+	}
+#endif
 
 	mm_givesemaphore(heap);
 
@@ -70,6 +70,10 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifndef CONFIG_REALLOC_SHRINK_MOVE_THRESHOLD
+#define CONFIG_REALLOC_SHRINK_MOVE_THRESHOLD 256
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -84,16 +88,24 @@
  * Description:
  *   If the reallocation is for less space, then:
  *
- *     (1) the current allocation is reduced in size
+ *     (1) the current allocation is reduced in size, moving it down to the
+ *         start of the preceding chunk if that chunk is free and at least
+ *         CONFIG_REALLOC_SHRINK_MOVE_THRESHOLD bytes are released, and
  *     (2) the remainder at the end of the allocation is returned to the
- *         free list.
+ *         free list, merged with the following chunk if that one is free.
+ *
+ *  Moving down into a free preceding chunk leaves a single free chunk
+ *  instead of one on each side of the allocation.
  *
  *  If the request is for more space and the current allocation can be
  *  extended, it will be extended by:
  *
  *     (1) Taking the additional space from the following free chunk, or
- *     (2) Taking the additional space from the preceding free chunk.
- *     (3) Or both
+ *     (2) Taking the whole following free chunk and the rest from the
+ *         preceding free chunk, or
+ *     (3) Taking the additional space from the preceding free chunk.
+ *
+ *  The following chunk is preferred because the user data stays in place.
  *
  *  If the request is for more space but the current chunk cannot be
  *  extended, then malloc a new buffer, copy the data into the new buffer,
@@ -159,6 +171,7 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem, size_t size)
 		 * of the allocation.
 		 */
 
+		newmem = oldmem;
 		if (newsize < oldsize) {
 #ifdef CONFIG_DEBUG_MM_HEAPINFO
 			/* modify the current allocated size of old node */
@@ -166,6 +179,48 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem, size_t size)
 			heapinfo_update_total_size(heap, (-1) * oldsize, oldnode->pid);
 #endif
 
+#ifndef CONFIG_REALLOC_DISABLE_NEIGHBOR_EXTENSION
+			/* If the preceding chunk is free, take all of it and move the
+			 * data down to its start.  The trailing memory released below
+			 * then holds both the freed part of the allocation and the
+			 * preceding chunk.  The copy is only worth it for a large
+			 * enough shrink; a small one stays in place.
+			 */
+
+			prev = (FAR struct mm_freenode_s *)((FAR char *)oldnode - (oldnode->preceding & ~MM_ALLOC_BIT));
+			if ((prev->preceding & MM_ALLOC_BIT) == 0 && oldsize - newsize >= SIZEOF_MM_FREENODE && oldsize - newsize >= CONFIG_REALLOC_SHRINK_MOVE_THRESHOLD) {
+				FAR struct mm_allocnode_s *newnode;
+
+				next = (FAR struct mm_freenode_s *)((FAR char *)oldnode + oldsize);
+
+				/* Remove the previous node.  There must be a predecessor,
+				 * but there may not be a successor node.
+				 */
+
+				REMOVE_NODE_FROM_LIST(heap, prev);
+
+				newnode             = (FAR struct mm_allocnode_s *)prev;
+				newnode->size      += oldsize;
+				newnode->preceding |= MM_ALLOC_BIT;
+				next->preceding     = newnode->size | (next->preceding & MM_ALLOC_BIT);
+
+				/* Move the retained part of the user contents 'down' in
+				 * memory.  The regions overlap if the preceding chunk is
+				 * smaller than the new size.
+				 */
+
+				newmem = (FAR void *)((FAR char *)newnode + SIZEOF_MM_ALLOCNODE);
+				memmove(newmem, oldmem, newsize - SIZEOF_MM_ALLOCNODE);
+#ifdef CONFIG_MM_SAMPLING
+				if (heap->mm_sample.nlive > 0) {
+					mm_sample_free(heap, oldmem);
+				}
+#endif
+
+				oldnode = newnode;
+			}
+#endif
+
 			mm_shrinkchunk(heap, oldnode, newsize);
 #ifdef CONFIG_DEBUG_MM_HEAPINFO
 			/* update the chunk to realloc task information */
@@ -176,10 +231,10 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem, size_t size)
 #endif
 		}
 
-		/* Then return the original address */
+		/* Then return the (possibly moved) address */
 
 		mm_givesemaphore(heap);
-		return oldmem;
+		return newmem;
 	}
 
 #ifndef CONFIG_REALLOC_DISABLE_NEIGHBOR_EXTENSION
@@ -211,50 +266,26 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem, size_t size)
 		heapinfo_update_total_size(heap, (-1) * oldsize, oldnode->pid);
 #endif
 
-		/* Check if we can extend into the previous chunk and if the
-		 * previous chunk is smaller than the next chunk.
+		/* Prefer the next chunk: growing into it keeps the user data in
+		 * place.  The previous chunk is only used for what the next chunk
+		 * can not provide, because taking from it means moving the data.
 		 */
 
-		if (prevsize > 0 && (nextsize >= prevsize || nextsize < 1)) {
-			/* Can we get everything we need from the previous chunk? */
-
-			if (needed > prevsize) {
-				/* No, take the whole previous chunk and get the
-				 * rest that we need from the next chunk.
-				 */
-
-				takeprev = prevsize;
-				takenext = needed - prevsize;
-			} else {
-				/* Yes, take what we need from the previous chunk */
-
-				takeprev = needed;
-				takenext = 0;
-			}
-
-			needed = 0;
+		if (nextsize >= needed) {
+			takenext = needed;
+		} else {
+			takenext = nextsize;
+			takeprev = needed - nextsize;
 		}
 
-		/* Check if we can extend into the next chunk and if we still need
-		 * more memory.
+		/* Do not leave a remainder in the previous chunk that is too small
+		 * to be a free chunk.  It would be absorbed anyway, so take it now
+		 * and take less from the next chunk instead.
 		 */
 
-		if (nextsize > 0 && needed) {
-			/* Can we get everything we need from the next chunk? */
-
-			if (needed > nextsize) {
-				/* No, take the whole next chunk and get the rest that we
-				 * need from the previous chunk.
-				 */
-
-				takeprev = needed - nextsize;
-				takenext = nextsize;
-			} else {
-				/* Yes, take what we need from the previous chunk */
-
-				takeprev = 0;
-				takenext = needed;
-			}
+		if (takeprev && (prevsize - takeprev) < SIZEOF_MM_FREENODE) {
+			takeprev = prevsize;
+			takenext = needed > prevsize ? needed - prevsize : 0;
 		}
 
 		/* Extend into the previous free chunk */
@@ -267,7 +298,7 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem, size_t size)
 			 * there may not be a successor node.
 			 */
 
-			REMOVE_NODE_FROM_LIST(prev);
+			REMOVE_NODE_FROM_LIST(heap, prev);
 
 			/* Extend the node into the previous free chunk */
 			/* Did we consume the entire preceding chunk? */
@@ -294,15 +325,20 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem, size_t size)
 				next->preceding     = newnode->size | (next->preceding & MM_ALLOC_BIT);
 			}
 
-			oldnode = newnode;
-			oldsize = newnode->size;
-
-			/* Now we have to move the user contents 'down' in memory.  memcpy should
-			 * should be save for this.
+			/* Now we have to move the user contents 'down' in memory.  The
+			 * regions overlap if less than the old size was taken.
 			 */
 
 			newmem = (FAR void *)((FAR char *)newnode + SIZEOF_MM_ALLOCNODE);
-			memcpy(newmem, oldmem, oldsize - SIZEOF_MM_ALLOCNODE);
+			memmove(newmem, oldmem, oldsize - SIZEOF_MM_ALLOCNODE);
+#ifdef CONFIG_MM_SAMPLING
+			if (heap->mm_sample.nlive > 0) {
+				mm_sample_free(heap, oldmem);
+			}
+#endif
+
+			oldnode = newnode;
+			oldsize = newnode->size;
 		}
 
 		/* Extend into the next free chunk */
@@ -321,7 +357,7 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem, size_t size)
 			 * may not be a successor node.
 			 */
 
-			REMOVE_NODE_FROM_LIST(next);
+			REMOVE_NODE_FROM_LIST(heap, next);
 
 			/* Extend the node into the next chunk */
 			/* Did we consume the entire preceding chunk? */
@@ -0,0 +1,345 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <tinyara/irq.h>
+#include <tinyara/mm/mm.h>
+
+#ifdef CONFIG_MM_SAMPLING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define MM_SAMPLE_MEAN    CONFIG_MM_SAMPLING_INTERVAL
+#define MM_SAMPLE_NSITES  CONFIG_MM_SAMPLING_NSITES
+#define MM_SAMPLE_NLIVE   CONFIG_MM_SAMPLING_NLIVE
+
+/* Constants in 16.16 fixed point: ln(2), log2(e) and the coefficient of
+ * the quadratic correction of log2(1 + f) ~ f + c * f * (1 - f).
+ */
+
+#define MM_SAMPLE_LN2     45426
+#define MM_SAMPLE_LOG2E   94548
+#define MM_SAMPLE_LOG2C   22713
+
+/* Hash slots of a call site and of an allocated memory */
+
+#define MM_SAMPLE_HASH(v, n) ((uint32_t)(v) * 2654435761u % (n))
+#define MM_SAMPLE_SITE_HASH(caller) MM_SAMPLE_HASH((caller) >> 1, MM_SAMPLE_NSITES)
+#define MM_SAMPLE_LIVE_HASH(mem) MM_SAMPLE_HASH((uintptr_t)(mem) >> MM_MIN_SHIFT, MM_SAMPLE_NLIVE)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_sample_interval
+ *
+ * Description:
+ *   Draw the number of bytes to allocate until the next sample.  Taking the
+ *   intervals from an exponential distribution makes the samples a Poisson
+ *   process over the allocated bytes, so allocation patterns that repeat
+ *   with a fixed period can not hide from the sampler.
+ *
+ *   The interval is -ln(u) * mean for u uniform in ]0, 1].  -log2(u) is
+ *   computed in 16.16 fixed point from a 32 bit xorshift random number,
+ *   with the fraction approximated from the bits below the most
+ *   significant one.
+ *
+ ****************************************************************************/
+
+static ssize_t mm_sample_interval(FAR struct mm_sample_s *sample)
+{
+	uint32_t r;
+	uint32_t frac;
+	uint32_t neglog2;
+	uint32_t interval;
+	int msb;
+
+	r = sample->seed;
+	r ^= r << 13;
+	r ^= r >> 17;
+	r ^= r << 5;
+	sample->seed = r;
+
+	msb = 31 - __builtin_clz(r);
+	frac = ((r << (31 - msb)) & 0x7fffffff) >> 15;
+	frac += (((frac * (65536 - frac)) >> 16) * MM_SAMPLE_LOG2C) >> 16;
+	neglog2 = ((uint32_t)(32 - msb) << 16) - frac;
+
+	interval = (uint32_t)(((uint64_t)MM_SAMPLE_MEAN * neglog2 * MM_SAMPLE_LN2) >> 32);
+	return interval > 0 ? (ssize_t)interval : 1;
+}
+
+/****************************************************************************
+ * Name: mm_sample_weight
+ *
+ * Description:
+ *   An allocation of s bytes is sampled with the probability
+ *   p = 1 - exp(-x) where x = s / mean, so it stands for s / p bytes, that
+ *   is mean * x / (1 - exp(-x)).  The factor is taken from its series
+ *   1 + x/2 + x^2/12 - x^4/720 for small x and as x + x * exp(-x)
+ *   otherwise, which is within 1% of the exact value.
+ *
+ ****************************************************************************/
+
+static size_t mm_sample_weight(size_t size)
+{
+	uint64_t x;
+	uint64_t x2;
+	uint64_t e;
+	uint64_t y;
+	uint64_t g;
+
+	x = ((uint64_t)size << 16) / MM_SAMPLE_MEAN;
+	if (x < (3 << 16)) {
+		x2 = (x * x) >> 16;
+		g = (1 << 16) + x / 2 + x2 / 12 - ((x2 * x2) >> 16) / 720;
+	} else {
+		/* exp(-x) = 2^-y with y = x * log2(e), taking 2^-f as 1 - f/2 */
+
+		y = (x * MM_SAMPLE_LOG2E) >> 16;
+		e = (y >> 16) >= 32 ? 0 : ((1 << 16) - (y & 0xffff) / 2) >> (y >> 16);
+		g = x + ((x * e) >> 16);
+	}
+
+	return (size_t)((g * MM_SAMPLE_MEAN) >> 16);
+}
+
+/****************************************************************************
+ * Name: mm_sample_forget
+ *
+ * Description:
+ *   Remove a sampled allocation from the live table, if it is there.  The
+ *   entries following it in its probe sequence are shifted back, so the
+ *   table needs no tombstones.  Interrupts must be disabled.
+ *
+ ****************************************************************************/
+
+static void mm_sample_forget(FAR struct mm_sample_s *sample, FAR void *mem)
+{
+	FAR struct mm_sample_live_s *live = sample->live;
+	int hole;
+	int ndx;
+	int home;
+
+	for (hole = MM_SAMPLE_LIVE_HASH(mem); live[hole].mem != mem; hole = (hole + 1) % MM_SAMPLE_NLIVE) {
+		if (!live[hole].mem) {
+			return;
+		}
+	}
+
+	sample->site[live[hole].site].live -= live[hole].weight;
+	sample->nlive--;
+
+	for (ndx = (hole + 1) % MM_SAMPLE_NLIVE; live[ndx].mem; ndx = (ndx + 1) % MM_SAMPLE_NLIVE) {
+		/* The entry can fill the hole unless its home slot lies cyclically
+		 * between the hole and the entry.
+		 */
+
+		home = MM_SAMPLE_LIVE_HASH(live[ndx].mem);
+		if ((ndx > hole) ? (home <= hole || home > ndx) : (home <= hole && home > ndx)) {
+			live[hole] = live[ndx];
+			hole = ndx;
+		}
+	}
+
+	live[hole].mem = NULL;
+}
+
+/****************************************************************************
+ * Name: mm_sample_record
+ *
+ * Description:
+ *   Account a sampled allocation to its call site and remember it until it
+ *   is freed.  Interrupts must be disabled.
+ *
+ ****************************************************************************/
+
+static void mm_sample_record(FAR struct mm_sample_s *sample, FAR void *mem, size_t weight, uintptr_t caller)
+{
+	FAR struct mm_sample_site_s *site;
+	int ndx;
+	int i;
+
+	/* The memory may have been sampled before and reallocated in place */
+
+	mm_sample_forget(sample, mem);
+
+	/* Find the call site, or an unused entry for it */
+
+	ndx = MM_SAMPLE_SITE_HASH(caller);
+	for (i = 0; i < MM_SAMPLE_NSITES; i++) {
+		site = &sample->site[ndx];
+		if (site->nsamples == 0 || site->caller == caller) {
+			break;
+		}
+
+		ndx = (ndx + 1) % MM_SAMPLE_NSITES;
+	}
+
+	if (i == MM_SAMPLE_NSITES) {
+		sample->ndropped++;
+		return;
+	}
+
+	site->caller = caller;
+	site->nsamples++;
+	site->allocated += weight;
+
+	/* Keep one live entry unused so that a lookup always terminates */
+
+	if (sample->nlive >= MM_SAMPLE_NLIVE - 1) {
+		sample->ndropped++;
+		return;
+	}
+
+	for (i = MM_SAMPLE_LIVE_HASH(mem); sample->live[i].mem; i = (i + 1) % MM_SAMPLE_NLIVE) {
+	}
+
+	sample->live[i].mem = mem;
+	sample->live[i].weight = weight;
+	sample->live[i].site = ndx;
+	sample->nlive++;
+	site->live += weight;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_sample_initialize
+ *
+ * Description:
+ *   Clear the sampling state of a heap and draw the first interval.
+ *
+ ****************************************************************************/
+
+void mm_sample_initialize(FAR struct mm_heap_s *heap)
+{
+	FAR struct mm_sample_s *sample = &heap->mm_sample;
+
+	memset(sample, 0, sizeof(struct mm_sample_s));
+
+	/* Any non-zero seed will do, but differ between the heaps */
+
+	sample->seed = (uint32_t)(uintptr_t)heap | 1;
+	sample->countdown = mm_sample_interval(sample);
+}
+
+/****************************************************************************
+ * Name: mm_sample_alloc
+ *
+ * Description:
+ *   Count an allocation of 'size' bytes made by 'caller', and record it if
+ *   the sampling interval has elapsed.  It is called by the allocation
+ *   APIs after the allocation succeeded.  The mm semaphore is not needed.
+ *
+ ****************************************************************************/
+
+void mm_sample_alloc(FAR struct mm_heap_s *heap, FAR void *mem, size_t size, uintptr_t caller)
+{
+	FAR struct mm_sample_s *sample = &heap->mm_sample;
+	irqstate_t flags;
+
+	if (!mem) {
+		return;
+	}
+
+	flags = irqsave();
+
+	sample->countdown -= size;
+	if (sample->countdown > 0) {
+		irqrestore(flags);
+		return;
+	}
+
+	sample->countdown = mm_sample_interval(sample);
+	mm_sample_record(sample, mem, mm_sample_weight(size), caller);
+
+	irqrestore(flags);
+}
+
+/****************************************************************************
+ * Name: mm_sample_free
+ *
+ * Description:
+ *   Forget a sampled allocation when it is freed.  Callers may skip this
+ *   while no sampled allocation is live.  The mm semaphore is not needed.
+ *
+ ****************************************************************************/
+
+void mm_sample_free(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+	irqstate_t flags;
+
+	flags = irqsave();
+	mm_sample_forget(&heap->mm_sample, mem);
+	irqrestore(flags);
+}
+
+/****************************************************************************
+ * Name: mm_sample_dump
+ *
+ * Description:
+ *   Print the call site table of a heap.
+ *
+ ****************************************************************************/
+
+void mm_sample_dump(FAR struct mm_heap_s *heap)
+{
+	FAR struct mm_sample_s *sample = &heap->mm_sample;
+	struct mm_sample_site_s site;
+	irqstate_t flags;
+	int ndx;
+
+	printf("\n****************************************************************\n");
+	printf("     Sampled Allocations (Size in Bytes, estimated)\n");
+	printf("****************************************************************\n");
+	printf("Sampling interval : %d\n", MM_SAMPLE_MEAN);
+	printf("Live samples      : %u\n", sample->nlive);
+	printf("Dropped samples   : %u\n", sample->ndropped);
+	printf("\n   Caller   | Samples | Allocated |    Live\n");
+	printf("------------|---------|-----------|----------\n");
+
+	for (ndx = 0; ndx < MM_SAMPLE_NSITES; ndx++) {
+		flags = irqsave();
+		site = sample->site[ndx];
+		irqrestore(flags);
+
+		if (site.nsamples > 0) {
+			printf(" 0x%08x | %7u | %9u | %8u\n", site.caller, site.nsamples, site.allocated, site.live);
+		}
+	}
+}
+
+#endif /* CONFIG_MM_SAMPLING */
@@ -0,0 +1,170 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdbool.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <tinyara/mm/mm.h>
+
+#ifdef CONFIG_MM_SLAB
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_slab_alloc
+ *
+ * Description:
+ *   Take a cached chunk of exactly 'size' bytes from the size-class cache.
+ *   'size' is the chunk size including the allocation header, already
+ *   aligned to the granule.  It is assumed that the caller holds the mm
+ *   semaphore.
+ *
+ * Return Value:
+ *   The allocated chunk, or NULL if there is no cached chunk of that size.
+ *
+ ****************************************************************************/
+
+FAR struct mm_allocnode_s *mm_slab_alloc(FAR struct mm_heap_s *heap, size_t size)
+{
+	FAR struct mm_slabnode_s *node;
+	int ndx;
+
+	if (size > MM_SLAB_MAXCHUNK) {
+		return NULL;
+	}
+
+	ndx = MM_SLAB_NDX(size);
+	node = heap->mm_slablist[ndx];
+	if (!node) {
+		return NULL;
+	}
+
+	heap->mm_slablist[ndx] = node->flink;
+	heap->mm_slabcount[ndx]--;
+	heap->mm_slabsize -= node->hdr.size;
+
+	DEBUGASSERT((node->hdr.preceding & MM_ALLOC_BIT) != 0);
+	return &node->hdr;
+}
+
+/****************************************************************************
+ * Name: mm_slab_free
+ *
+ * Description:
+ *   Put a released chunk into the size-class cache.  The chunk keeps its
+ *   allocated mark, so adjacent free chunks will not merge with it.  It is
+ *   assumed that the caller holds the mm semaphore.
+ *
+ * Return Value:
+ *   true if the chunk was cached, false if it has to be returned to the
+ *   nodelist because it is too large or its size class is full.
+ *
+ ****************************************************************************/
+
+bool mm_slab_free(FAR struct mm_heap_s *heap, FAR struct mm_allocnode_s *node)
+{
+	FAR struct mm_slabnode_s *slab = (FAR struct mm_slabnode_s *)node;
+#ifdef CONFIG_DEBUG_DOUBLE_FREE
+	FAR struct mm_slabnode_s *cached;
+#endif
+	int ndx;
+
+	if (node->size > MM_SLAB_MAXCHUNK) {
+		return false;
+	}
+
+	ndx = MM_SLAB_NDX(node->size);
+	if (heap->mm_slabcount[ndx] >= CONFIG_MM_SLAB_MAXCACHED) {
+		return false;
+	}
+
+#ifdef CONFIG_DEBUG_DOUBLE_FREE
+	/* A cached chunk is still marked as allocated, so releasing it twice
+	 * can only be caught by looking into its size class.
+	 */
+
+	for (cached = heap->mm_slablist[ndx]; cached; cached = cached->flink) {
+		if (cached == slab) {
+			dbg("Attempt for double freeing a pointer\n");
+			PANIC();
+		}
+	}
+#endif
+
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+	/* Let heapinfo tell cached chunks from the live ones */
+
+	node->reserved = MM_SLAB_MARK;
+#endif
+
+	slab->flink = heap->mm_slablist[ndx];
+	heap->mm_slablist[ndx] = slab;
+	heap->mm_slabcount[ndx]++;
+	heap->mm_slabsize += node->size;
+	return true;
+}
+
+/****************************************************************************
+ * Name: mm_slab_drain
+ *
+ * Description:
+ *   Return every cached chunk to the nodelist, merging it with its free
+ *   neighbours.  This is done when an allocation can not be satisfied from
+ *   the nodelist.  It is assumed that the caller holds the mm semaphore.
+ *
+ * Return Value:
+ *   The number of chunks returned to the nodelist.
+ *
+ ****************************************************************************/
+
+int mm_slab_drain(FAR struct mm_heap_s *heap)
+{
+	FAR struct mm_slabnode_s *node;
+	int count = 0;
+	int ndx;
+
+	for (ndx = 0; ndx < MM_SLAB_NCLASSES; ndx++) {
+		while ((node = heap->mm_slablist[ndx]) != NULL) {
+			heap->mm_slablist[ndx] = node->flink;
+			mm_freechunk(heap, (FAR struct mm_freenode_s *)node);
+			count++;
+		}
+
+		heap->mm_slabcount[ndx] = 0;
+	}
+
+	heap->mm_slabsize = 0;
+
+	mvdbg("Drained %d cached chunks\n", count);
+	return count;
+}
+
+#endif /* CONFIG_MM_SLAB */
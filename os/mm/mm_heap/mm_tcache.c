@@ -0,0 +1,287 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdbool.h>
+#include <unistd.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <tinyara/irq.h>
+#include <tinyara/clock.h>
+#include <tinyara/sched.h>
+#include <tinyara/mm/mm.h>
+
+#ifdef CONFIG_MM_TASK_CACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The cache of the calling task */
+
+#define MM_TCACHE_SELF(heap) (&(heap)->mm_tcache[PIDHASH(getpid())])
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_tcache_drainslot
+ *
+ * Description:
+ *   Return the cached chunks of one pid hash slot to the nodelist.  It is
+ *   assumed that the caller holds the mm semaphore.
+ *
+ ****************************************************************************/
+
+static int mm_tcache_drainslot(FAR struct mm_heap_s *heap, int tndx)
+{
+	FAR struct mm_tcachenode_s *node;
+	FAR struct mm_tcachenode_s *next;
+	irqstate_t flags;
+	int count = 0;
+	int ndx;
+
+	for (ndx = 0; ndx < MM_TCACHE_NCLASSES; ndx++) {
+		/* Detach the list with interrupts disabled, then release its
+		 * chunks with interrupts enabled.
+		 */
+
+		flags = irqsave();
+		node = heap->mm_tcache[tndx].list[ndx];
+		heap->mm_tcache[tndx].list[ndx] = NULL;
+		heap->mm_tcache[tndx].count[ndx] = 0;
+		for (next = node; next; next = next->flink) {
+			heap->mm_tcachesize -= next->hdr.size;
+		}
+		irqrestore(flags);
+
+		for (; node; node = next) {
+			next = node->flink;
+			mm_freechunk(heap, (FAR struct mm_freenode_s *)node);
+			count++;
+		}
+	}
+
+	return count;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_tcache_alloc
+ *
+ * Description:
+ *   Take a chunk of exactly 'size' bytes from the cache of the calling
+ *   task.  'size' is the chunk size including the allocation header,
+ *   already aligned to the granule.  The mm semaphore is not needed.
+ *
+ * Return Value:
+ *   The address of the allocated memory, or NULL if the task has no cached
+ *   chunk of that size.
+ *
+ ****************************************************************************/
+
+FAR void *mm_tcache_alloc(FAR struct mm_heap_s *heap, size_t size)
+{
+	FAR struct mm_tcache_s *tcache;
+	FAR struct mm_tcachenode_s *node;
+	irqstate_t flags;
+	int ndx;
+
+	if (size > MM_TCACHE_MAXCHUNK) {
+		return NULL;
+	}
+
+	ndx = MM_TCACHE_NDX(size);
+	tcache = MM_TCACHE_SELF(heap);
+
+	flags = irqsave();
+	node = tcache->list[ndx];
+	if (node) {
+		tcache->list[ndx] = node->flink;
+		tcache->count[ndx]--;
+		heap->mm_tcachesize -= node->hdr.size;
+	}
+	irqrestore(flags);
+
+	if (!node) {
+		return NULL;
+	}
+
+	DEBUGASSERT((node->hdr.preceding & MM_ALLOC_BIT) != 0);
+	return (FAR void *)((FAR char *)node + SIZEOF_MM_ALLOCNODE);
+}
+
+/****************************************************************************
+ * Name: mm_tcache_free
+ *
+ * Description:
+ *   Put a released chunk into the cache of the calling task.  The chunk
+ *   keeps its allocated mark.  The mm semaphore is not needed.
+ *
+ *   A task that is exiting does not cache: its slot has been drained by
+ *   mm_tcache_recover(), and the rest of the teardown must not fill it
+ *   again for the next task with the same pid hash.
+ *
+ * Return Value:
+ *   true if the chunk was cached, false if it has to be returned to the
+ *   heap because it is too large, its size class is full or the calling
+ *   task is exiting.
+ *
+ ****************************************************************************/
+
+bool mm_tcache_free(FAR struct mm_heap_s *heap, FAR struct mm_allocnode_s *node)
+{
+	FAR struct mm_tcachenode_s *cnode = (FAR struct mm_tcachenode_s *)node;
+	FAR struct mm_tcache_s *tcache;
+#ifdef CONFIG_DEBUG_DOUBLE_FREE
+	FAR struct mm_tcachenode_s *check;
+#endif
+	irqstate_t flags;
+	bool cached = false;
+	int ndx;
+
+	if (node->size > MM_TCACHE_MAXCHUNK) {
+		return false;
+	}
+
+	if ((sched_self()->flags & TCB_FLAG_EXITING) != 0) {
+		return false;
+	}
+
+	ndx = MM_TCACHE_NDX(node->size);
+	tcache = MM_TCACHE_SELF(heap);
+
+	flags = irqsave();
+
+#ifdef CONFIG_DEBUG_DOUBLE_FREE
+	/* A cached chunk is still marked as allocated, so releasing it twice
+	 * can only be caught by looking into the cache.
+	 */
+
+	for (check = tcache->list[ndx]; check; check = check->flink) {
+		if (check == cnode) {
+			dbg("Attempt for double freeing a pointer\n");
+			PANIC();
+		}
+	}
+#endif
+
+	if (tcache->count[ndx] < CONFIG_MM_TASK_CACHE_MAXCACHED) {
+		cnode->flink = tcache->list[ndx];
+		tcache->list[ndx] = cnode;
+		tcache->count[ndx]++;
+		heap->mm_tcachesize += node->size;
+		cached = true;
+	}
+
+	irqrestore(flags);
+	return cached;
+}
+
+/****************************************************************************
+ * Name: mm_tcache_drain
+ *
+ * Description:
+ *   Return the cached chunks of every task to the nodelist.  This is done
+ *   when an allocation can not be satisfied from the nodelist, and every
+ *   CONFIG_MM_TASK_CACHE_FLUSH_MSEC.  It is assumed that the caller holds
+ *   the mm semaphore.
+ *
+ * Return Value:
+ *   The number of chunks returned to the nodelist.
+ *
+ ****************************************************************************/
+
+int mm_tcache_drain(FAR struct mm_heap_s *heap)
+{
+	int count = 0;
+	int tndx;
+
+	for (tndx = 0; tndx < CONFIG_MAX_TASKS; tndx++) {
+		count += mm_tcache_drainslot(heap, tndx);
+	}
+
+	heap->mm_tcacheflush = clock_systimer();
+	mvdbg("Drained %d cached chunks\n", count);
+	return count;
+}
+
+/****************************************************************************
+ * Name: mm_tcache_age
+ *
+ * Description:
+ *   Drain all caches if they were last drained more than
+ *   CONFIG_MM_TASK_CACHE_FLUSH_MSEC ago, so that chunks held by idle tasks
+ *   are merged back into the heap.  Called from the allocation path with
+ *   the mm semaphore held.
+ *
+ ****************************************************************************/
+
+void mm_tcache_age(FAR struct mm_heap_s *heap)
+{
+#if CONFIG_MM_TASK_CACHE_FLUSH_MSEC > 0
+	if (heap->mm_tcachesize > 0 && clock_systimer() - heap->mm_tcacheflush >= MSEC2TICK(CONFIG_MM_TASK_CACHE_FLUSH_MSEC)) {
+		(void)mm_tcache_drain(heap);
+	}
+#endif
+}
+
+/****************************************************************************
+ * Name: mm_tcache_recover
+ *
+ * Description:
+ *   Return the chunks cached by a terminated task to the heaps, so that
+ *   they are not left to whichever task gets the same pid hash next.
+ *   Called from task_recover().  The task is marked TCB_FLAG_EXITING by
+ *   then, so the memory it releases afterwards is not cached again.
+ *
+ ****************************************************************************/
+
+void mm_tcache_recover(pid_t pid)
+{
+	FAR struct mm_heap_s *heap;
+	int heap_idx;
+
+	for (heap_idx = 0; heap_idx < CONFIG_MM_NHEAPS; heap_idx++) {
+		heap = &BASE_HEAP[heap_idx];
+		mm_takesemaphore(heap);
+		(void)mm_tcache_drainslot(heap, PIDHASH(pid));
+		mm_givesemaphore(heap);
+	}
+
+#ifdef CONFIG_MM_KERNEL_HEAP
+	heap = kmm_get_heap();
+	for (heap_idx = 0; heap_idx < CONFIG_KMM_NHEAPS; heap_idx++) {
+		mm_takesemaphore(&heap[heap_idx]);
+		(void)mm_tcache_drainslot(&heap[heap_idx], PIDHASH(pid));
+		mm_givesemaphore(&heap[heap_idx]);
+	}
+#endif
+}
+
+#endif /* CONFIG_MM_TASK_CACHE */
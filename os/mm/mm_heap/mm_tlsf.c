@@ -0,0 +1,214 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <assert.h>
+#include <debug.h>
+
+#include <tinyara/mm/mm.h>
+
+#ifdef CONFIG_MM_NODELIST_TLSF
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Index of the list that holds chunks of MM_MAX_CHUNK bytes or more */
+
+#define MM_HUGE_NDX  ((MM_FLI_COUNT - 1) * MM_SLI_COUNT)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* Find last set: index of the most significant bit set in a non-zero size */
+
+static inline int mm_fls(size_t size)
+{
+	return (int)(sizeof(unsigned long) * 8 - 1) - __builtin_clzl((unsigned long)size);
+}
+
+/* Find first set: index of the least significant bit set in a non-zero word */
+
+static inline int mm_ffs(uint32_t word)
+{
+	return __builtin_ctz(word);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_tlsf_size2ndx
+ *
+ * Description:
+ *   Convert the size of a free chunk to the index of the segregated list
+ *   that holds it.  The first level index is ndx / MM_SLI_COUNT and the
+ *   second level index is ndx % MM_SLI_COUNT.
+ *
+ ****************************************************************************/
+
+int mm_tlsf_size2ndx(size_t size)
+{
+	int fl;
+	int sl;
+
+	if (size < (1 << MM_FLI_SHIFT)) {
+		/* Small chunks are split linearly by the granule */
+
+		return size >> MM_MIN_SHIFT;
+	}
+
+	fl = mm_fls(size);
+	if (fl >= MM_MAX_SHIFT) {
+		return MM_HUGE_NDX;
+	}
+
+	/* The second level index is given by the MM_SLI_SHIFT bits following
+	 * the most significant one.
+	 */
+
+	sl = (size >> (fl - MM_SLI_SHIFT)) ^ MM_SLI_COUNT;
+	fl = fl - MM_FLI_SHIFT + 1;
+
+	return fl * MM_SLI_COUNT + sl;
+}
+
+/****************************************************************************
+ * Name: mm_removefreechunk
+ *
+ * Description:
+ *   Remove a free chunk from its segregated list, clearing the bitmaps when
+ *   the list becomes empty.  It must be called before the size of the node
+ *   is modified.  It is assumed that the caller holds the mm semaphore.
+ *
+ ****************************************************************************/
+
+void mm_removefreechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node)
+{
+	int ndx;
+
+	DEBUGASSERT(node->blink);
+	node->blink->flink = node->flink;
+	if (node->flink) {
+		node->flink->blink = node->blink;
+	}
+
+	ndx = mm_tlsf_size2ndx(node->size);
+	if (!heap->mm_nodelist[ndx].flink) {
+		heap->mm_slbitmap[ndx / MM_SLI_COUNT] &= ~(1u << (ndx % MM_SLI_COUNT));
+		if (!heap->mm_slbitmap[ndx / MM_SLI_COUNT]) {
+			heap->mm_flbitmap &= ~(1u << (ndx / MM_SLI_COUNT));
+		}
+	}
+}
+
+/****************************************************************************
+ * Name: mm_tlsf_search
+ *
+ * Description:
+ *   Find a free chunk of at least 'size' bytes.  The request is rounded up
+ *   to the next list boundary so that the first chunk of any non-empty list
+ *   found through the bitmaps fits, which bounds the search time.  Only if
+ *   there is no such list, the list of the request itself is searched for
+ *   a chunk that fits.  The chunk is not removed from its list.  It is
+ *   assumed that the caller holds the mm semaphore.
+ *
+ *   The search is not O(1) in two cases, where a list is walked:
+ *   - a request of MM_MAX_CHUNK bytes or more walks the huge list, whose
+ *     chunks are not bounded in size;
+ *   - when no list is guaranteed to fit, which happens only when the heap
+ *     is nearly exhausted or fragmented, the list of the request itself
+ *     is walked rather than failing an allocation that a chunk there fits.
+ *
+ * Return Value:
+ *   The free chunk, or NULL if there is no chunk large enough.
+ *
+ ****************************************************************************/
+
+FAR struct mm_freenode_s *mm_tlsf_search(FAR struct mm_heap_s *heap, size_t size)
+{
+	FAR struct mm_freenode_s *node;
+	uint32_t map;
+	size_t rounded = size;
+	int ndx;
+	int fl;
+	int sl;
+
+	if (size >= (1 << MM_FLI_SHIFT) && mm_fls(size) < MM_MAX_SHIFT) {
+		rounded += ((size_t)1 << (mm_fls(size) - MM_SLI_SHIFT)) - 1;
+	}
+
+	ndx = mm_tlsf_size2ndx(rounded);
+	fl = ndx / MM_SLI_COUNT;
+	sl = ndx % MM_SLI_COUNT;
+
+	/* Look for a non-empty list at or above the rounded index, first within
+	 * the same first level, then in the larger first levels.
+	 */
+
+	map = heap->mm_slbitmap[fl] & (~0u << sl);
+	if (!map) {
+		map = (fl + 1 < MM_FLI_COUNT) ? heap->mm_flbitmap & (~0u << (fl + 1)) : 0;
+		if (map) {
+			fl = mm_ffs(map);
+			map = heap->mm_slbitmap[fl];
+		}
+	}
+
+	if (map) {
+		ndx = fl * MM_SLI_COUNT + mm_ffs(map);
+		node = heap->mm_nodelist[ndx].flink;
+		if (ndx != MM_HUGE_NDX) {
+			return node;
+		}
+
+		/* Chunks of the huge list are not bounded by the list, but any of
+		 * them fits unless the request itself is huge.
+		 */
+
+		for (; node; node = node->flink) {
+			if (node->size >= size) {
+				return node;
+			}
+		}
+
+		return NULL;
+	}
+
+	/* No list is guaranteed to fit.  A chunk in the list of the request
+	 * itself may still be large enough.
+	 */
+
+	ndx = mm_tlsf_size2ndx(size);
+	for (node = heap->mm_nodelist[ndx].flink; node; node = node->flink) {
+		if (node->size >= size) {
+			return node;
+		}
+	}
+
+	return NULL;
+}
+
+#endif /* CONFIG_MM_NODELIST_TLSF */
@@ -125,6 +125,9 @@ static void *heap_calloc(size_t n, size_t elem_size, int s, int e, size_t retadd
 		ret = mm_calloc(&USR_HEAP[heap_idx], n, elem_size);
 #endif
 		if (ret != NULL) {
+#ifdef CONFIG_MM_SAMPLING
+			mm_sample_alloc(&USR_HEAP[heap_idx], ret, n * elem_size, retaddr);
+#endif
 			return ret;
 		}
 	}
@@ -147,6 +150,8 @@ FAR void *calloc(size_t n, size_t elem_size)
 
 #ifdef CONFIG_DEBUG_MM_HEAPINFO
 	ARCH_GET_RET_ADDRESS
+#elif defined(CONFIG_MM_SAMPLING)
+	size_t retaddr = (size_t)__builtin_return_address(0);
 #else
 	size_t retaddr = 0;
 #endif
@@ -146,6 +146,9 @@ static void *heap_malloc(size_t size, int s, int e, size_t retaddr)
 		ret = mm_malloc(&USR_HEAP[heap_idx], size);
 #endif
 		if (ret != NULL) {
+#ifdef CONFIG_MM_SAMPLING
+			mm_sample_alloc(&USR_HEAP[heap_idx], ret, size, retaddr);
+#endif
 			return ret;
 		}
 	}
@@ -203,6 +206,8 @@ FAR void *malloc(size_t size)
 
 #ifdef CONFIG_DEBUG_MM_HEAPINFO
 	ARCH_GET_RET_ADDRESS
+#elif defined(CONFIG_MM_SAMPLING)
+	size_t retaddr = (size_t)__builtin_return_address(0);
 #else
 	size_t retaddr = 0;
 #endif
@@ -118,6 +118,8 @@ FAR void *memalign(size_t alignment, size_t size)
 	void *ret;
 #ifdef CONFIG_DEBUG_MM_HEAPINFO
 	ARCH_GET_RET_ADDRESS
+#elif defined(CONFIG_MM_SAMPLING)
+	size_t retaddr = (size_t)__builtin_return_address(0);
 #endif
 	for (heap_idx = 0; heap_idx < CONFIG_MM_NHEAPS; heap_idx++) {
 #ifdef CONFIG_DEBUG_MM_HEAPINFO
@@ -126,6 +128,9 @@ FAR void *memalign(size_t alignment, size_t size)
 		ret = mm_memalign(&USR_HEAP[heap_idx], alignment, size);
 #endif
 		if (ret != NULL) {
+#ifdef CONFIG_MM_SAMPLING
+			mm_sample_alloc(&USR_HEAP[heap_idx], ret, size, retaddr);
+#endif
 			return ret;
 		}
 	}
@@ -121,6 +121,8 @@ FAR void *realloc(FAR void *oldmem, size_t size)
 	void *ret;
 #ifdef CONFIG_DEBUG_MM_HEAPINFO
 	ARCH_GET_RET_ADDRESS
+#elif defined(CONFIG_MM_SAMPLING)
+	size_t retaddr = (size_t)__builtin_return_address(0);
 #endif
 	heap_idx = mm_get_heapindex(oldmem);
 	if (heap_idx < 0) {
@@ -132,6 +134,9 @@ FAR void *realloc(FAR void *oldmem, size_t size)
 	ret = mm_realloc(&USR_HEAP[heap_idx], oldmem, size);
 #endif
 	if (ret != NULL) {
+#ifdef CONFIG_MM_SAMPLING
+		mm_sample_alloc(&USR_HEAP[heap_idx], ret, size, retaddr);
+#endif
 		return ret;
 	}
 	/* Try to mm_malloc to another heap */
@@ -145,6 +150,9 @@ FAR void *realloc(FAR void *oldmem, size_t size)
 #endif
 		if (ret != NULL) {
 			mm_free(&USR_HEAP[prev_heap_idx], oldmem);
+#ifdef CONFIG_MM_SAMPLING
+			mm_sample_alloc(&USR_HEAP[heap_idx], ret, size, retaddr);
+#endif
 			return ret;
 		}
 	}
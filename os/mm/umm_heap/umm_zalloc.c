@@ -125,6 +125,9 @@ static void *heap_zalloc(size_t size, int s, int e, size_t retaddr)
 		ret = mm_zalloc(&USR_HEAP[heap_idx], size);
 #endif
 		if (ret != NULL) {
+#ifdef CONFIG_MM_SAMPLING
+			mm_sample_alloc(&USR_HEAP[heap_idx], ret, size, retaddr);
+#endif
 			return ret;
 		}
 	}
@@ -166,6 +169,8 @@ FAR void *zalloc(size_t size)
 
 #ifdef CONFIG_DEBUG_MM_HEAPINFO
 	ARCH_GET_RET_ADDRESS
+#elif defined(CONFIG_MM_SAMPLING)
+	size_t retaddr = (size_t)__builtin_return_address(0);
 #else
 	size_t retaddr = 0;
 #endif
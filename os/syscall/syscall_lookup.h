@@ -312,6 +312,13 @@ SYSCALL_LOOKUP(mq_setattr,              3, STUB_mq_setattr)
 SYSCALL_LOOKUP(mq_timedreceive,         5, STUB_mq_timedreceive)
 SYSCALL_LOOKUP(mq_timedsend,            5, STUB_mq_timedsend)
 SYSCALL_LOOKUP(mq_unlink,               1, STUB_mq_unlink)
+#  ifdef CONFIG_MQ_BUFFER
+SYSCALL_LOOKUP(mq_bufalloc,             1, STUB_mq_bufalloc)
+SYSCALL_LOOKUP(mq_buffree,              1, STUB_mq_buffree)
+SYSCALL_LOOKUP(mq_bufreceive,           3, STUB_mq_bufreceive)
+SYSCALL_LOOKUP(mq_bufref,               1, STUB_mq_bufref)
+SYSCALL_LOOKUP(mq_bufsend,              4, STUB_mq_bufsend)
+#  endif
 #endif
 
 /* The following are defined only if environment variables are supported */
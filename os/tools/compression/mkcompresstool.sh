@@ -29,13 +29,11 @@ SRCDIR=$COMPRESSION_TOOL_PATH/src
 #load .config file
 source $OS_PATH/.config
 
-# Compression Algorithm specific initialization
-if [ $CONFIG_COMPRESSION_TYPE == 1 ]
-then
-	mkdir -p $SRCDIR/lzma
-	TMPDIR=$SRCDIR/lzma
-	SOURCEDIR=$OS_PATH/../external/lzma
-fi
+# The tool compresses with any of the supported algorithms, whatever
+# CONFIG_COMPRESSION_TYPE is, so that it can be chosen per binary
+mkdir -p $SRCDIR/lzma
+TMPDIR=$SRCDIR/lzma
+SOURCEDIR=$OS_PATH/../external/lzma
 
 APPNAME=mkcompressimg
 
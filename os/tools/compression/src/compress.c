@@ -30,9 +30,8 @@
 #include "../config.h"
 #include "../compression.h"
 
-#if CONFIG_COMPRESSION_TYPE == 1
 #include "lzma/LzmaLib.h"
-#endif
+#include "lz4.h"
 
 #define MAX_BLOCK_SIZE 8192
 
@@ -147,19 +146,28 @@ static void compress(int block_size, int type, char *in_file, char *out_file)
 			}
 		}
 		writesize = block_size;
-#if CONFIG_COMPRESSION_TYPE == 1
-		/* LZMA Compression for data in read_buf into out_buf */
-		ret = LzmaCompress(&out_buf[LZMA_PROPS_SIZE], &writesize, read_buf, (block_size - readsize), out_buf, &propsSize, 0, 1<<13 , -1, -1, -1, -1, 1);
-		if (ret != SZ_OK) {
-			printf("LZMA Compress failed, ret = %d\n", ret);
-		}
+		if (type == COMPRESSION_TYPE_LZMA) {
+			/* LZMA Compression for data in read_buf into out_buf */
+			ret = LzmaCompress(&out_buf[LZMA_PROPS_SIZE], &writesize, read_buf, (block_size - readsize), out_buf, &propsSize, 0, 1<<13 , -1, -1, -1, -1, 1);
+			if (ret != SZ_OK) {
+				printf("LZMA Compress failed, ret = %d\n", ret);
+			}
 
-		printf("==> lzma_compress %d writesize %lu\n", index, writesize);
-#else
-		printf("Compression for type %d not supported\n", CONFIG_COMPRESSION_TYPE);
-		printf("Set CONFIG_COMPRESSION_TYPE to %d, then generate mkcompressimg again for this type", CONFIG_COMPRESSION_TYPE);
-		exit(1);
-#endif
+			printf("==> lzma_compress %d writesize %lu\n", index, writesize);
+		} else {
+			/* LZ4 Compression for data in read_buf into out_buf.
+			 * Blocks which do not shrink are stored uncompressed.
+			 */
+			ret = lz4_compress(read_buf, (block_size - readsize), out_buf, (block_size - readsize) - 1);
+			if (ret < 0) {
+				memcpy(out_buf, read_buf, (block_size - readsize));
+				writesize = block_size - readsize;
+			} else {
+				writesize = ret;
+			}
+
+			printf("==> lz4_compress %d writesize %lu\n", index, writesize);
+		}
 		phdr->secoff[index + 1] = phdr->secoff[index] + writesize;
 
 		/* Write out_buf to output file */
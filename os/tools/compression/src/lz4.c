@@ -0,0 +1,151 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+* Included Files
+****************************************************************************/
+#include <string.h>
+#include "lz4.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Limits of the LZ4 block format: matches are at least LZ4_MINMATCH bytes
+ * and at most LZ4_MAXOFFSET bytes back, the last match starts at least
+ * LZ4_MFLIMIT bytes before the end and the last LZ4_LASTLITERALS bytes are
+ * literals.
+ */
+#define LZ4_MINMATCH		4
+#define LZ4_MAXOFFSET		65535
+#define LZ4_MFLIMIT		12
+#define LZ4_LASTLITERALS	5
+#define LZ4_RUNMASK		15
+
+#define LZ4_HASHBITS		12
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+static unsigned int lz4_read32(const unsigned char *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int)p[3] << 24);
+}
+
+static unsigned int lz4_hash(unsigned int sequence)
+{
+	return (sequence * 2654435761U) >> (32 - LZ4_HASHBITS);
+}
+
+/* Write the token nibble 'length', then its extension bytes */
+static int lz4_putlength(unsigned char *dst, int *op, int dstlen, int length)
+{
+	if (length < LZ4_RUNMASK) {
+		return 0;
+	}
+
+	for (length -= LZ4_RUNMASK; ; length -= 255) {
+		if (*op >= dstlen) {
+			return -1;
+		}
+		dst[(*op)++] = length >= 255 ? 255 : length;
+		if (length < 255) {
+			return 0;
+		}
+	}
+}
+
+/* Write a sequence of 'nlit' literals from 'lit', followed by a match of
+ * 'mlen' bytes at 'offset' unless 'mlen' is 0.
+ */
+static int lz4_putsequence(unsigned char *dst, int *op, int dstlen, const unsigned char *lit, int nlit, int offset, int mlen)
+{
+	int token = *op;
+
+	if (*op >= dstlen) {
+		return -1;
+	}
+	dst[token] = (nlit < LZ4_RUNMASK ? nlit : LZ4_RUNMASK) << 4;
+	(*op)++;
+
+	if (lz4_putlength(dst, op, dstlen, nlit) < 0 || *op + nlit > dstlen) {
+		return -1;
+	}
+	memcpy(&dst[*op], lit, nlit);
+	*op += nlit;
+
+	if (mlen == 0) {
+		return 0;
+	}
+
+	if (*op + 2 > dstlen) {
+		return -1;
+	}
+	dst[(*op)++] = offset & 0xff;
+	dst[(*op)++] = offset >> 8;
+
+	mlen -= LZ4_MINMATCH;
+	dst[token] |= mlen < LZ4_RUNMASK ? mlen : LZ4_RUNMASK;
+	return lz4_putlength(dst, op, dstlen, mlen);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+int lz4_compress(const unsigned char *src, int srclen, unsigned char *dst, int dstlen)
+{
+	int table[1 << LZ4_HASHBITS];
+	int anchor = 0;
+	int ip = 0;
+	int op = 0;
+	int ref;
+	int len;
+	unsigned int h;
+
+	memset(table, 0xff, sizeof(table));
+
+	/* Greedy parsing: take the most recent position with the same hash */
+	while (ip < srclen - LZ4_MFLIMIT) {
+		h = lz4_hash(lz4_read32(&src[ip]));
+		ref = table[h];
+		table[h] = ip;
+
+		if (ref < 0 || ip - ref > LZ4_MAXOFFSET || lz4_read32(&src[ref]) != lz4_read32(&src[ip])) {
+			ip++;
+			continue;
+		}
+
+		len = LZ4_MINMATCH;
+		while (ip + len < srclen - LZ4_LASTLITERALS && src[ref + len] == src[ip + len]) {
+			len++;
+		}
+
+		if (lz4_putsequence(dst, &op, dstlen, &src[anchor], ip - anchor, ip - ref, len) < 0) {
+			return -1;
+		}
+
+		ip += len;
+		anchor = ip;
+	}
+
+	if (lz4_putsequence(dst, &op, dstlen, &src[anchor], srclen - anchor, 0, 0) < 0) {
+		return -1;
+	}
+
+	return op;
+}
@@ -0,0 +1,39 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __LZ4_H
+#define __LZ4_H
+
+/****************************************************************************
+ * Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lz4_compress
+ *
+ * Description:
+ *   Compress 'srclen' bytes of 'src' into the LZ4 block format, decoded by
+ *   lz4_decompress() in os/compression/compress_lz4.c
+ *
+ * Returned Value:
+ *   Number of bytes written into dst on Success
+ *   -1 if the block does not fit in 'dstlen' bytes
+ ****************************************************************************/
+int lz4_compress(const unsigned char *src, int srclen, unsigned char *dst, int dstlen);
+
+#endif							/* __LZ4_H */
@@ -56,6 +56,9 @@
 
 #include <tinyara/config.h>
 
+#include <unistd.h>
+#include <sched.h>
+#include <string.h>
 #include <errno.h>
 #include <queue.h>
 #include <debug.h>
@@ -119,6 +122,23 @@ struct hp_wqueue_s g_hpwork;
 
 static int work_hpthread(int argc, char *argv[])
 {
+	int wndx = 0;
+#if CONFIG_SCHED_HPNTHREADS > 1
+	pid_t me = getpid();
+	int i;
+
+	/* Find out thread index by search the workers in g_hpwork */
+
+	for (i = 0; i < CONFIG_SCHED_HPNTHREADS; i++) {
+		if (g_hpwork.worker[i].pid == me) {
+			wndx = i;
+			break;
+		}
+	}
+
+	DEBUGASSERT(i < CONFIG_SCHED_HPNTHREADS);
+#endif
+
 	/* Loop forever */
 
 	for (;;) {
@@ -131,10 +151,12 @@ static int work_hpthread(int argc, char *argv[])
 		 * NOTE: If the work thread is disabled, this clean-up is performed by
 		 * the IDLE thread (at a very, very low priority).  If the low-priority
 		 * work thread is enabled, then the garbage collection is done on that
-		 * thread instead.
+		 * thread instead.  Only thread 0 of the pool does this.
 		 */
 
-		sched_garbagecollection();
+		if (wndx == 0) {
+			sched_garbagecollection();
+		}
 #endif
 
 		/* Then process queued work.  work_process will not return until: (1)
@@ -142,7 +164,7 @@ static int work_hpthread(int argc, char *argv[])
 		 * period provided by g_hpwork.delay expires.
 		 */
 
-		work_process((FAR struct wqueue_s *)&g_hpwork, 0);
+		work_process((FAR struct wqueue_s *)&g_hpwork, wndx);
 	}
 
 	return OK;					/* To keep some compilers happy */
@@ -170,27 +192,42 @@ static int work_hpthread(int argc, char *argv[])
 int work_hpstart(void)
 {
 	int pid;
+	int wndx;
 
 	/* Initialize work queue data structures */
 
+	memset(&g_hpwork, 0, sizeof(g_hpwork));
+
 	dq_init(&g_hpwork.q);
+	dq_init(&g_hpwork.ready);
+
+	/* Don't permit any of the threads to run until we have fully initialized
+	 * g_hpwork.
+	 */
+
+	sched_lock();
+
+	/* Start the high-priority, kernel mode worker thread(s) */
 
-	/* Start the high-priority, kernel mode worker thread */
+	svdbg("Starting high-priority kernel worker thread(s)\n");
 
-	svdbg("Starting high-priority kernel worker thread\n");
+	for (wndx = 0; wndx < CONFIG_SCHED_HPNTHREADS; wndx++) {
+		pid = kernel_thread(HPWORKNAME, CONFIG_SCHED_HPWORKPRIORITY, CONFIG_SCHED_HPWORKSTACKSIZE, (main_t)work_hpthread, (FAR char *const *)NULL);
 
-	pid = kernel_thread(HPWORKNAME, CONFIG_SCHED_HPWORKPRIORITY, CONFIG_SCHED_HPWORKSTACKSIZE, (main_t)work_hpthread, (FAR char *const *)NULL);
+		DEBUGASSERT(pid > 0);
+		if (pid < 0) {
+			int errcode = errno;
+			DEBUGASSERT(errcode > 0);
 
-	DEBUGASSERT(pid > 0);
-	if (pid < 0) {
-		int errcode = errno;
-		DEBUGASSERT(errcode > 0);
+			slldbg("kernel_thread %d failed: %d\n", wndx, errcode);
+			sched_unlock();
+			return -errcode;
+		}
 
-		slldbg("kernel_thread failed: %d\n", errcode);
-		return -errcode;
+		g_hpwork.worker[wndx].pid = (pid_t)pid;
+		g_hpwork.worker[wndx].busy = true;
 	}
 
-	g_hpwork.worker[0].pid = pid;
-	g_hpwork.worker[0].busy = true;
-	return pid;
+	sched_unlock();
+	return g_hpwork.worker[0].pid;
 }
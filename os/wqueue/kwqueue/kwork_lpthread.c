@@ -206,9 +206,10 @@ int work_lpstart(void)
 
 	/* Initialize work queue data structures */
 
-	memset(&g_lpwork, 0, sizeof(struct wqueue_s));
+	memset(&g_lpwork, 0, sizeof(g_lpwork));
 
 	dq_init(&g_lpwork.q);
+	dq_init(&g_lpwork.ready);
 
 	/* Don't permit any of the threads to run until we have fully initialized
 	 * g_lpwork.
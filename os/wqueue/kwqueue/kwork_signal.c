@@ -29,6 +29,36 @@
 
 #include "wqueue.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_idleworker
+ *
+ * Description:
+ *   Return the process ID of an IDLE worker thread of a thread pool, or the
+ *   ID of worker thread 0 if all of the worker threads are busy.
+ *
+ ****************************************************************************/
+
+static pid_t work_idleworker(FAR struct worker_s *worker, int nthreads)
+{
+	int i;
+
+	for (i = 0; i < nthreads; i++) {
+		/* Is this worker thread busy? */
+
+		if (!worker[i].busy) {
+			/* No.. select this thread */
+
+			return worker[i].pid;
+		}
+	}
+
+	return worker[0].pid;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -51,35 +81,15 @@
 int work_signal(int qid)
 {
 	pid_t pid;
-	/* Get the process ID of the worker thread */
+	/* Get the process ID of an IDLE worker thread */
 #ifdef CONFIG_SCHED_HPWORK
 	if (qid == HPWORK) {
-		pid = g_hpwork.worker[0].pid;
+		pid = work_idleworker(g_hpwork.worker, CONFIG_SCHED_HPNTHREADS);
 	} else
 #endif
 #ifdef CONFIG_SCHED_LPWORK
 	if (qid == LPWORK) {
-		int wndx;
-		int i;
-
-		/* Find an IDLE worker thread */
-
-		for (wndx = 0, i = 0; i < CONFIG_SCHED_LPNTHREADS; i++) {
-			/* Is this worker thread busy? */
-
-			if (!g_lpwork.worker[i].busy) {
-				/* No.. select this thread */
-
-				wndx = i;
-				break;
-			}
-		}
-
-		/* Use the process ID of the IDLE worker thread (or the ID of worker
-			* thread 0 if all of the worker threads are busy).
-			*/
-
-		pid = g_lpwork.worker[wndx].pid;
+		pid = work_idleworker(g_lpwork.worker, CONFIG_SCHED_LPNTHREADS);
 	} else
 #endif
 	{
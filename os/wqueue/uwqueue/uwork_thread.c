@@ -168,6 +168,7 @@ int work_usrstart(void)
 	/* Initialize work queue data structures */
 
 	dq_init(&g_usrwork.q);
+	dq_init(&g_usrwork.ready);
 
 #ifdef CONFIG_BUILD_PROTECTED
 	{
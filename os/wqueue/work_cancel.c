@@ -112,7 +112,7 @@
 
 int work_qcancel(FAR struct wqueue_s *wqueue, FAR struct work_s *work)
 {
-	struct work_s *cur_work;
+	FAR struct dq_queue_s *queue;
 	int ret = -ENOENT;
 
 	DEBUGASSERT(work != NULL);
@@ -128,35 +128,25 @@ int work_qcancel(FAR struct wqueue_s *wqueue, FAR struct work_s *work)
 	irqstate_t flags;
 	flags = irqsave();
 #endif
-	if (work->worker != NULL) {
-		/* A little test of the integrity of the work queue */
+	if (work_qqueued(wqueue, work)) {
+		/* Work is moved to the ready FIFO with a delay of zero, so the delay
+		 * tells which list the work is in.
+		 */
 
-		DEBUGASSERT(work->dq.flink || (FAR dq_entry_t *)work == wqueue->q.tail);
-		DEBUGASSERT(work->dq.blink || (FAR dq_entry_t *)work == wqueue->q.head);
+		queue = work->delay == 0 ? &wqueue->ready : &wqueue->q;
 
-		/* check whether requested work is in queue list or not */
-		cur_work = (struct work_s *)wqueue->q.head;
-		do {
-			if (cur_work == NULL) {
-#if defined(CONFIG_SCHED_USRWORK) && !defined(__KERNEL__)
-				work_unlock();
-#else
-				irqrestore(flags);
-#endif
-				return -ENOENT;
-			} else if (cur_work == work) {
-				break;
-			}
+		/* A little test of the integrity of the work queue */
 
-			cur_work = (struct work_s *)cur_work->dq.flink;
-		} while (1);
+		DEBUGASSERT(work->dq.flink || (FAR dq_entry_t *)work == queue->tail);
+		DEBUGASSERT(work->dq.blink || (FAR dq_entry_t *)work == queue->head);
 
 		/* Remove the entry from the work queue and make sure that it is
-		 * mark as available (i.e., the worker field is nullified).
+		 * mark as available.
 		 */
 
-		dq_rem((FAR dq_entry_t *)work, &wqueue->q);
+		dq_rem((FAR dq_entry_t *)work, queue);
 		work->worker = NULL;
+		work->queued = false;
 		ret = OK;
 	}
 
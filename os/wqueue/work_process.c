@@ -122,8 +122,6 @@ void work_process(FAR struct wqueue_s *wqueue, int wndx)
 	 * we process items in the work list.
 	 */
 
-	next = 0;
-
 #if defined(CONFIG_SCHED_USRWORK) && !defined(__KERNEL__)
 	while (work_lock() < 0);
 #else
@@ -132,83 +130,81 @@ void work_process(FAR struct wqueue_s *wqueue, int wndx)
 #endif
 
 
-	/* And check each entry in the work queue.  Since we have disabled
-	 * interrupts we know:  (1) we will not be suspended unless we do
-	 * so ourselves, and (2) there will be no changes to the work queue
+	/* Since we have disabled interrupts we know:  (1) we will not be
+	 * suspended unless we do so ourselves, and (2) there will be no changes
+	 * to the work queue
 	 */
 
-	work = (FAR struct work_s *)wqueue->q.head;
-	
-	while (work) {
-		
-		/* Is this work ready?  It is ready if there is no delay or if
-		 * the delay has elapsed. qtime is the time that the work was added
-		 * to the work queue.  It will always be greater than or equal to
-		 * zero.  Therefore a delay of zero will always execute immediately.
+	for (;;) {
+		/* Move the delayed work that is now due to the end of the ready
+		 * FIFO.  The delayed work is sorted by due time, so stop at the
+		 * first work that is not due yet.  qtime is the time that the work
+		 * was added to the work queue.
 		 */
 
 		ctick = clock();
-		elapsed = ctick - work->qtime;
+		next = 0;
 
-		if (elapsed >= work->delay) {
-			/* Remove the ready-to-execute work from the list */
+		while ((work = (FAR struct work_s *)wqueue->q.head) != NULL) {
+			elapsed = ctick - work->qtime;
+			if (elapsed < work->delay) {
+				next = work->delay - elapsed;
+				break;
+			}
 
 			(void)dq_rem((struct dq_entry_s *)work, &wqueue->q);
+			work->delay = 0;
+			dq_addlast((struct dq_entry_s *)work, &wqueue->ready);
+		}
 
-			/* Extract the work description from the entry (in case the work
-			 * instance by the re-used after it has been de-queued).
-			 */
+		/* Take the oldest ready-to-execute work from the ready FIFO */
+
+		work = (FAR struct work_s *)dq_remfirst(&wqueue->ready);
+		if (work == NULL) {
+			break;
+		}
 
-			worker = work->worker;
+		work->queued = false;
 
-			/* Check for a race condition where the work may be nullified
-			 * before it is removed from the queue.
-			 */
+		/* Extract the work description from the entry (in case the work
+		 * instance by the re-used after it has been de-queued).
+		 */
+
+		worker = work->worker;
 
-			if (worker != NULL) {
-				/* Extract the work argument (before re-enabling interrupts) */
+		/* Check for a race condition where the work may be nullified
+		 * before it is removed from the queue.
+		 */
+
+		if (worker != NULL) {
+			/* Extract the work argument (before re-enabling interrupts) */
 
-				arg = work->arg;
+			arg = work->arg;
 
-				/* Mark the work as no longer being queued */
+			/* Mark the work as no longer being queued */
 
-				work->worker = NULL;
+			work->worker = NULL;
+
+			/* Do the work.  Re-enable interrupts while the work is being
+			 * performed... we don't have any idea how long this will take!
+			 */
 
-				/* Do the work.  Re-enable interrupts while the work is being
-				 * performed... we don't have any idea how long this will take!
-				 */
-				
 #if defined(CONFIG_SCHED_USRWORK) && !defined(__KERNEL__)
-				work_unlock();
+			work_unlock();
 #else
-				irqrestore(flags);
+			irqrestore(flags);
 #endif
-				worker(arg);
+			worker(arg);
 
-				/* Now, unfortunately, since we re-enabled interrupts we don't
-				 * know the state of the work list and we will have to start
-				 * back at the head of the list.
-				 */
+			/* Now, unfortunately, since we re-enabled interrupts we don't
+			 * know the state of the work lists, so look at them again.
+			 */
 
 #if defined(CONFIG_SCHED_USRWORK) && !defined(__KERNEL__)
-				while (work_lock() < 0);
+			while (work_lock() < 0);
 #else
-				flags = irqsave();
+			flags = irqsave();
 #endif
-				work = (FAR struct work_s *)wqueue->q.head;
-			} else {
-				/* Cancelled.. Just move to the next work in the list with
-				 * interrupts still disabled.
-				 */
-
-				work = (FAR struct work_s *)work->dq.flink;
-			}
-		} else {				/* elapsed < work->delay */
-
-			next = work->delay - elapsed;
-
-			/* Then break at while loop due to sorted list */
-			break;
 		}
 	}
 
@@ -57,6 +57,7 @@
 
 #include <sys/types.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <queue.h>
 #include <assert.h>
 #include <errno.h>
@@ -87,6 +88,41 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: work_qqueued
+ *
+ * Description:
+ *   Check if the work is in one of the lists of the work queue.
+ *   work_process() and work_qcancel() clear the queued flag when the work
+ *   leaves the queue, so a clear flag is always right.  A set flag may be
+ *   left over in a work structure that was never queued, so it is checked
+ *   against the list that the work would be in.
+ *
+ ****************************************************************************/
+
+bool work_qqueued(FAR struct wqueue_s *wqueue, FAR struct work_s *work)
+{
+	FAR dq_entry_t *entry;
+
+	if (!work->queued) {
+		return false;
+	}
+
+	/* Work is moved to the ready FIFO with a delay of zero */
+
+	entry = work->delay == 0 ? wqueue->ready.head : wqueue->q.head;
+	while (entry != NULL) {
+		if (entry == (FAR dq_entry_t *)work) {
+			return true;
+		}
+
+		entry = entry->flink;
+	}
+
+	work->queued = false;
+	return false;
+}
+
 /****************************************************************************
  * Name: work_qqueue
  *
@@ -120,8 +156,7 @@ int work_qqueue(FAR struct wqueue_s *wqueue, FAR struct work_s *work, worker_t w
 {
 	DEBUGASSERT(work != NULL);
 
-	struct work_s *next_work = NULL;
-	struct work_s *cur_work;
+	struct work_s *prev_work;
 	clock_t elapsed;
 	clock_t ctick;
 	ctick = clock();
@@ -133,37 +168,46 @@ int work_qqueue(FAR struct wqueue_s *wqueue, FAR struct work_s *work, worker_t w
 	flags = irqsave();
 #endif
 
-	/* check whether requested work is in queue list or not */
-	cur_work = (struct work_s *)wqueue->q.head;
-	while (cur_work != NULL) {
-		if (cur_work == work) {
+	if (work_qqueued(wqueue, work)) {
 #if defined(CONFIG_SCHED_USRWORK) && !defined(__KERNEL__)
-			work_unlock();
+		work_unlock();
 #else
-			irqrestore(flags);
+		irqrestore(flags);
 #endif
-			return -EALREADY;
-		}
-
-		if (next_work == NULL) {
-			elapsed = ctick - cur_work->qtime;
-			if (cur_work->delay > elapsed && cur_work->delay - elapsed > delay) {
-				next_work = cur_work;
-			}
-		}
-
-		cur_work = (struct work_s *)cur_work->dq.flink;
+		return -EALREADY;
 	}
 
 	work->worker = worker;		/* Work callback */
 	work->arg = arg;		/* Callback argument */
 	work->delay = delay;		/* Delay until work performed */
 	work->qtime = ctick;		/* Time work queued */
+	work->queued = true;
+
+	if (delay == 0) {
+		/* Work with no delay goes to the end of the ready FIFO */
 
-	if (next_work) {
-		dq_addbefore((FAR dq_entry_t *)next_work, (FAR dq_entry_t *)work, &wqueue->q);
+		dq_addlast((FAR dq_entry_t *)work, &wqueue->ready);
 	} else {
-		dq_addlast((FAR dq_entry_t *)work, &wqueue->q);
+		/* Keep the delayed work sorted by the time it is due.  New work is
+		 * usually due after the work that is already queued, so search
+		 * backward from the tail for the last work that is due no later.
+		 */
+
+		prev_work = (struct work_s *)wqueue->q.tail;
+		while (prev_work != NULL) {
+			elapsed = ctick - prev_work->qtime;
+			if (prev_work->delay <= elapsed || prev_work->delay - elapsed <= delay) {
+				break;
+			}
+
+			prev_work = (struct work_s *)prev_work->dq.blink;
+		}
+
+		if (prev_work) {
+			dq_addafter((FAR dq_entry_t *)prev_work, (FAR dq_entry_t *)work, &wqueue->q);
+		} else {
+			dq_addfirst((FAR dq_entry_t *)work, &wqueue->q);
+		}
 	}
 #if defined(CONFIG_SCHED_USRWORK) && !defined(__KERNEL__)
 	work_unlock();
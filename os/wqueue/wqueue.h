@@ -88,8 +88,15 @@ struct worker_s {
 
 /* This structure defines the state of work queue */
 
+/* Work that is queued with no delay goes straight to the 'ready' FIFO.
+ * Delayed work is kept in 'q' sorted by the time it is due and is moved
+ * to the 'ready' FIFO when that time comes, so a worker never has to scan
+ * past work that is not ready to run.
+ */
+
 struct wqueue_s {
-	struct dq_queue_s q;		/* The queue of pending work */
+	struct dq_queue_s q;		/* The queue of delayed work, sorted by due time */
+	struct dq_queue_s ready;	/* The FIFO of work that is ready to run */
 	struct worker_s worker[1];	/* Describes a worker thread */
 };
 
@@ -99,8 +106,11 @@ struct wqueue_s {
 
 #ifdef CONFIG_SCHED_HPWORK
 struct hp_wqueue_s {
-	struct dq_queue_s q;		/* The queue of pending work */
-	struct worker_s worker[1];	/* Describes the single high priority worker */
+	struct dq_queue_s q;		/* The queue of delayed work, sorted by due time */
+	struct dq_queue_s ready;	/* The FIFO of work that is ready to run */
+
+	/* Describes each thread in the high priority queue's thread pool */
+	struct worker_s worker[CONFIG_SCHED_HPNTHREADS];
 };
 #endif
 
@@ -110,7 +120,8 @@ struct hp_wqueue_s {
 
 #ifdef CONFIG_SCHED_LPWORK
 struct lp_wqueue_s {
-	struct dq_queue_s q;		/* The queue of pending work */
+	struct dq_queue_s q;		/* The queue of delayed work, sorted by due time */
+	struct dq_queue_s ready;	/* The FIFO of work that is ready to run */
 
 	/* Describes each thread in the low priority queue's thread pool */
 	struct worker_s worker[CONFIG_SCHED_LPNTHREADS];
@@ -208,6 +219,26 @@ void work_unlock(void);
 
 int work_qcancel(FAR struct wqueue_s *wqueue, FAR struct work_s *work);
 
+/****************************************************************************
+ * Name: work_qqueued
+ *
+ * Description:
+ *   Check if the work is in one of the lists of the work queue.  The queued
+ *   flag of the work is trusted only when it is clear; a set flag is
+ *   checked against the list, since a work structure that was never queued
+ *   may hold any value.  The caller must hold the work queue lock.
+ *
+ * Input parameters:
+ *   wqueue - The work queue
+ *   work   - The work structure to check
+ *
+ * Returned Value:
+ *   true if the work is queued.
+ *
+ ****************************************************************************/
+
+bool work_qqueued(FAR struct wqueue_s *wqueue, FAR struct work_s *work);
+
 /****************************************************************************
  * Name: work_qqueue
  *
@@ -0,0 +1,182 @@
+#!/usr/bin/python
+###########################################################################
+#
+# Copyright 2019 Samsung Electronics All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+# either express or implied. See the License for the specific
+# language governing permissions and limitations under the License.
+#
+###########################################################################
+
+# Convert the records of the T-trace binary event ring, streamed by
+# 'ttrace -e', to the JSON trace format read by chrome://tracing and by
+# the Perfetto UI (https://ui.perfetto.dev).
+#
+# The input is either the binary file written by 'ttrace -e <file>' or a
+# console log of 'ttrace -e', from which the lines starting with 'E ' are
+# taken.
+
+from __future__ import print_function
+import re
+import sys
+import json
+import struct
+import optparse
+
+RECORD_SIZE = 32
+RECORD_FORMAT = '<IIhBB20s'
+SCHED_FORMAT = '<hBB12s'
+
+TYPE_SCHED = 1
+TYPE_BEGIN = 2
+TYPE_BEGIN_UID = 3
+TYPE_END = 4
+
+TEXT_TYPES = {'s': TYPE_SCHED, 'b': TYPE_BEGIN, 'u': TYPE_BEGIN_UID, 'e': TYPE_END}
+TEXT_RECORD = re.compile(r'E (\d+) (\d+) (-?\d+) (\d+) ([sbue])(?: (.*))?$')
+
+# Trace process holding the task tracks, and the one showing the CPU
+TASKS_PID = 0
+CPU_PID = 1
+
+
+def cstring(raw):
+    return raw.split(b'\0', 1)[0].decode('ascii', 'replace')
+
+
+def read_binary(path):
+    records = []
+    with open(path, 'rb') as f:
+        data = f.read()
+    for off in range(0, len(data) - RECORD_SIZE + 1, RECORD_SIZE):
+        seq, ts, pid, rtype, prio, msg = struct.unpack_from(RECORD_FORMAT, data, off)
+        record = {'seq': seq - 1, 'ts': ts, 'pid': pid, 'prio': prio, 'type': rtype}
+        if rtype == TYPE_SCHED:
+            next_pid, next_prio, prev_state, comm = struct.unpack_from(SCHED_FORMAT, msg)
+            record.update(next_pid=next_pid, next_prio=next_prio,
+                          prev_state=prev_state, comm=cstring(comm))
+        elif rtype == TYPE_BEGIN:
+            record['name'] = cstring(msg)
+        elif rtype == TYPE_BEGIN_UID:
+            record['name'] = 'uid %d' % struct.unpack_from('<b', msg)[0]
+        records.append(record)
+    return records
+
+
+def read_text(path):
+    records = []
+    with open(path, 'r') as f:
+        for line in f:
+            m = TEXT_RECORD.search(line.rstrip('\r\n'))
+            if not m:
+                continue
+            rtype = TEXT_TYPES[m.group(5)]
+            rest = m.group(6) or ''
+            record = {'seq': int(m.group(1)), 'ts': int(m.group(2)),
+                      'pid': int(m.group(3)), 'prio': int(m.group(4)), 'type': rtype}
+            if rtype == TYPE_SCHED:
+                fields = rest.split(' ', 3)
+                record.update(next_pid=int(fields[0]), next_prio=int(fields[1]),
+                              prev_state=int(fields[2]),
+                              comm=fields[3] if len(fields) > 3 else '')
+            elif rtype == TYPE_BEGIN:
+                record['name'] = rest
+            elif rtype == TYPE_BEGIN_UID:
+                record['name'] = 'uid %s' % rest
+            records.append(record)
+    return records
+
+
+def unwrap(records):
+    # Sequence numbers and microsecond timestamps are 32 bits wide
+    seq_base = ts_base = 0
+    last_seq = last_ts = None
+    for record in records:
+        if last_seq is not None and record['seq'] + seq_base < last_seq - (1 << 31):
+            seq_base += 1 << 32
+        if last_ts is not None and record['ts'] + ts_base < last_ts - (1 << 31):
+            ts_base += 1 << 32
+        record['seq'] += seq_base
+        record['ts'] += ts_base
+        last_seq = record['seq']
+        last_ts = record['ts']
+    return records
+
+
+def convert(records):
+    events = [
+        {'name': 'process_name', 'ph': 'M', 'pid': TASKS_PID, 'args': {'name': 'Tasks'}},
+        {'name': 'process_name', 'ph': 'M', 'pid': CPU_PID, 'args': {'name': 'CPU'}},
+        {'name': 'thread_name', 'ph': 'M', 'pid': CPU_PID, 'tid': 0, 'args': {'name': 'CPU 0'}},
+    ]
+    names = {}
+    running = None
+    since = None
+    last_seq = None
+
+    for record in records:
+        ts = record['ts']
+        if last_seq is not None and record['seq'] != last_seq + 1:
+            events.append({'name': 'lost %d records' % (record['seq'] - last_seq - 1),
+                           'ph': 'i', 's': 'g', 'pid': CPU_PID, 'tid': 0, 'ts': ts})
+        last_seq = record['seq']
+
+        if record['type'] == TYPE_SCHED:
+            prev = record['pid'] if record['pid'] >= 0 else running
+            if prev is not None and since is not None:
+                name = names.get(prev, 'pid %d' % prev)
+                args = {'prev_state': record['prev_state']} if record['pid'] >= 0 else {}
+                events.append({'name': 'running', 'ph': 'X', 'pid': TASKS_PID, 'tid': prev,
+                               'ts': since, 'dur': ts - since, 'args': args})
+                events.append({'name': name, 'ph': 'X', 'pid': CPU_PID, 'tid': 0,
+                               'ts': since, 'dur': ts - since})
+            running = record['next_pid']
+            since = ts
+            if record['comm'] and names.get(running) != record['comm']:
+                names[running] = record['comm']
+                events.append({'name': 'thread_name', 'ph': 'M', 'pid': TASKS_PID,
+                               'tid': running, 'args': {'name': record['comm']}})
+        elif record['type'] in (TYPE_BEGIN, TYPE_BEGIN_UID):
+            events.append({'name': record['name'], 'ph': 'B', 'pid': TASKS_PID,
+                           'tid': record['pid'], 'ts': ts, 'args': {'prio': record['prio']}})
+        elif record['type'] == TYPE_END:
+            events.append({'ph': 'E', 'pid': TASKS_PID, 'tid': record['pid'], 'ts': ts})
+
+    return {'traceEvents': events, 'displayTimeUnit': 'ms'}
+
+
+def main():
+    parser = optparse.OptionParser(usage='%prog [-t] -i <input> [-o <output.json>]')
+    parser.add_option('-i', '--input', dest='input', help='records streamed by ttrace -e')
+    parser.add_option('-o', '--output', dest='output', default='trace.json',
+                      help='Chrome/Perfetto JSON trace to write (default: trace.json)')
+    parser.add_option('-t', '--text', dest='text', action='store_true', default=False,
+                      help='the input is a console log instead of a binary file')
+    (options, args) = parser.parse_args()
+    if not options.input:
+        parser.print_help()
+        return 1
+
+    if options.text:
+        records = read_text(options.input)
+    else:
+        records = read_binary(options.input)
+
+    trace = convert(unwrap(records))
+    with open(options.output, 'w') as f:
+        json.dump(trace, f)
+    print('%d records, written to %s' % (len(records), options.output))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())